@@ -0,0 +1,378 @@
+/*
+  ==============================================================================
+
+    AdaptiveJustTuner.cpp
+    Created: 20 Oct 2026 4:06:41am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "AdaptiveJustTuner.h"
+
+namespace
+{
+    // Size of 2, 3, 5 and 7 in octaves
+    const double primeOctaves[] = { 1.0, std::log2(3.0), std::log2(5.0), std::log2(7.0) };
+
+    // Complexity added per semitone that a note moves from the static tuning, 0.1 per cent
+    const double deviationWeight = 10.0;
+
+    // Complexity of a note that has no ratio within tolerance, and stays on the static tuning
+    const double unmatchedPenalty = 16.0;
+
+    // Farthest that held notes can drift from the static tuning before the chord is centered again
+    const double maxDriftSemitones = 0.5;
+
+    const double defaultBudgetMs = 0.25;
+
+    const int maxShapes = 512;
+
+    // Shape intervals are compared in tenths of a cent
+    const double shapeResolution = 1000.0;
+}
+
+AdaptiveJustTuner::AdaptiveJustTuner(int maxThrees, int maxFives, int maxSevens, double toleranceCents)
+    : tolerance(toleranceCents / 100.0)
+{
+    auto addRatio = [&](const Exponents& exponents)
+    {
+        lattice.add({ exponents, semitonesOf(exponents), complexity(exponents) });
+    };
+
+    for (int threes = -maxThrees; threes <= maxThrees; threes++)
+    {
+        for (int fives = -maxFives; fives <= maxFives; fives++)
+        {
+            for (int sevens = -maxSevens; sevens <= maxSevens; sevens++)
+            {
+                Exponents exponents { 0, threes, fives, sevens };
+                exponents[0] = -(int)std::floor(semitonesOf(exponents) / 12.0);
+                addRatio(exponents);
+
+                // Ratios near the octave are also found from the other side of it
+                auto reduced = semitonesOf(exponents);
+                if (reduced < tolerance)
+                {
+                    exponents[0]++;
+                    addRatio(exponents);
+                }
+                else if (reduced > 12.0 - tolerance)
+                {
+                    exponents[0]--;
+                    addRatio(exponents);
+                }
+            }
+        }
+    }
+
+    std::sort(lattice.begin(), lattice.end(), [](const Ratio& a, const Ratio& b) { return a.semitones < b.semitones; });
+
+    shapes.resize(maxShapes);
+
+    setTimeBudget(defaultBudgetMs);
+}
+
+void AdaptiveJustTuner::setTimeBudget(double milliseconds)
+{
+    budgetTicks = (milliseconds > 0)
+        ? juce::jmax((juce::int64)1, (juce::int64)(milliseconds * 0.001 * juce::Time::getHighResolutionTicksPerSecond()))
+        : 0;
+}
+
+double AdaptiveJustTuner::getTimeBudget() const
+{
+    return budgetTicks * 1000.0 / juce::Time::getHighResolutionTicksPerSecond();
+}
+
+void AdaptiveJustTuner::startBlock()
+{
+    usedTicks = 0;
+}
+
+bool AdaptiveJustTuner::tune(juce::Array<Note>& notes)
+{
+    // The voice controller tunes one note per output channel
+    jassert(notes.size() <= maxNotes);
+    auto numNotes = juce::jmin(notes.size(), maxNotes);
+    if (numNotes == 0)
+        return true;
+
+    int numHeld = 0;
+    for (int i = 0; i < numNotes; i++)
+        numHeld += notes.getReference(i).isHeld ? 1 : 0;
+
+    // Released notes leave the rest of the chord in place
+    if (numHeld == numNotes)
+        return true;
+
+    auto leaveNewNotes = [&]()
+    {
+        for (int i = 0; i < numNotes; i++)
+        {
+            auto& note = notes.getReference(i);
+            if (!note.isHeld)
+                note.offset = 0;
+        }
+        return false;
+    };
+
+    auto start = juce::Time::getHighResolutionTicks();
+    auto deadline = (budgetTicks > 0) ? start + budgetTicks - usedTicks : 0;
+
+    if (numHeld > 0)
+    {
+        bool added = (budgetTicks == 0 || usedTicks < budgetTicks) && addNotes(notes, numNotes, deadline);
+        usedTicks += juce::Time::getHighResolutionTicks() - start;
+
+        if (!added)
+            return leaveNewNotes();
+
+        bool drifted = false;
+        for (int i = 0; i < numNotes; i++)
+            drifted = drifted || (!notes.getReference(i).isHeld && std::abs(offsets[i]) > maxDriftSemitones);
+
+        if (!drifted)
+        {
+            for (int i = 0; i < numNotes; i++)
+            {
+                auto& note = notes.getReference(i);
+                if (!note.isHeld)
+                    note.offset = offsets[i];
+            }
+            return true;
+        }
+
+        // The whole chord is centered on the static tuning again
+        start = juce::Time::getHighResolutionTicks();
+    }
+
+    for (int i = 0; i < numNotes; i++)
+        order[i] = i;
+
+    std::sort(order.begin(), order.begin() + numNotes, [&](int a, int b) { return notes.getReference(a).mts < notes.getReference(b).mts; });
+
+    juce::uint64 hash = 0xcbf29ce484222325;
+
+    for (int i = 0; i < numNotes; i++)
+    {
+        sortedMts[i] = notes.getReference(order[i]).mts;
+        intervals[i] = juce::roundToInt((sortedMts[i] - sortedMts[0]) * shapeResolution);
+        hash = (hash ^ (juce::uint32)intervals[i]) * 0x100000001b3;
+    }
+
+    auto& cached = shapes.getReference((int)(hash % (juce::uint64)shapes.size()));
+    if (cached.numNotes == numNotes && cached.hash == hash
+        && std::equal(intervals.begin(), intervals.begin() + numNotes, cached.intervals.begin()))
+    {
+        std::copy(cached.offsets.begin(), cached.offsets.begin() + numNotes, offsets.begin());
+    }
+    else
+    {
+        bool solved = (budgetTicks == 0 || usedTicks < budgetTicks) && solveShape(numNotes, deadline);
+        usedTicks += juce::Time::getHighResolutionTicks() - start;
+
+        if (!solved)
+            return leaveNewNotes();
+
+        if (cached.numNotes == 0)
+            numCachedShapes++;
+
+        cached.hash = hash;
+        cached.numNotes = numNotes;
+        cached.intervals = intervals;
+        cached.offsets = offsets;
+    }
+
+    double meanOffset = 0;
+    for (int i = 0; i < numNotes; i++)
+        meanOffset += offsets[i];
+    meanOffset /= numNotes;
+
+    for (int i = 0; i < numNotes; i++)
+        notes.getReference(order[i]).offset = offsets[i] - meanOffset;
+
+    return true;
+}
+
+void AdaptiveJustTuner::clearCache()
+{
+    for (auto& shape : shapes)
+        shape.numNotes = 0;
+
+    numCachedShapes = 0;
+}
+
+bool AdaptiveJustTuner::findRatio(double semitones, Ratio& ratio) const
+{
+    auto octaves = std::floor(semitones / 12.0);
+    auto reduced = semitones - octaves * 12.0;
+
+    auto first = std::lower_bound(lattice.begin(), lattice.end(), reduced - tolerance,
+                                  [](const Ratio& r, double s) { return r.semitones < s; });
+
+    const Ratio* best = nullptr;
+    double bestCost = 0;
+
+    for (auto candidate = first; candidate != lattice.end() && candidate->semitones <= reduced + tolerance; candidate++)
+    {
+        auto cost = candidate->complexity + deviationWeight * std::abs(candidate->semitones - reduced);
+        if (best == nullptr || cost < bestCost)
+        {
+            best = candidate;
+            bestCost = cost;
+        }
+    }
+
+    if (best == nullptr)
+        return false;
+
+    ratio.exponents = best->exponents;
+    ratio.exponents[0] += (int)octaves;
+    ratio.semitones = best->semitones + octaves * 12.0;
+    ratio.complexity = complexity(ratio.exponents);
+    return true;
+}
+
+bool AdaptiveJustTuner::solveShape(int numNotes, juce::int64 deadline)
+{
+    std::fill(offsets.begin(), offsets.begin() + numNotes, 0.0);
+
+    double bestScore = std::numeric_limits<double>::max();
+
+    // Every note is tried as the root that the others are found from
+    for (int root = 0; root < numNotes; root++)
+    {
+        if (deadline > 0 && juce::Time::getHighResolutionTicks() >= deadline)
+            return false;
+
+        double score = 0;
+
+        for (int i = 0; i < numNotes; i++)
+        {
+            auto interval = sortedMts[i] - sortedMts[root];
+
+            Ratio ratio;
+            if (i == root || findRatio(interval, ratio))
+            {
+                exponents[i] = ratio.exponents;
+                pitches[i] = ratio.semitones;
+                matched[i] = true;
+                score += deviationWeight * std::abs(ratio.semitones - interval);
+            }
+            else
+            {
+                pitches[i] = interval;
+                matched[i] = false;
+                score += unmatchedPenalty;
+            }
+        }
+
+        for (int i = 0; i < numNotes; i++)
+        {
+            for (int j = i + 1; j < numNotes && matched[i]; j++)
+            {
+                if (!matched[j])
+                    continue;
+
+                Exponents between;
+                for (int p = 0; p < 4; p++)
+                    between[p] = exponents[j][p] - exponents[i][p];
+
+                score += complexity(between);
+            }
+        }
+
+        if (score < bestScore)
+        {
+            bestScore = score;
+            for (int i = 0; i < numNotes; i++)
+                offsets[i] = pitches[i] - (sortedMts[i] - sortedMts[root]);
+        }
+    }
+
+    return true;
+}
+
+bool AdaptiveJustTuner::addNotes(const juce::Array<Note>& notes, int numNotes, juce::int64 deadline)
+{
+    int numPlaced = 0;
+    int numNew = 0;
+    double heldOffset = 0;
+
+    for (int i = 0; i < numNotes; i++)
+    {
+        auto& note = notes.getReference(i);
+        if (note.isHeld)
+        {
+            pitches[numPlaced++] = note.mts + note.offset;
+            heldOffset += note.offset;
+        }
+        else
+        {
+            order[numNew++] = i;
+        }
+    }
+
+    heldOffset /= numPlaced;
+
+    std::sort(order.begin(), order.begin() + numNew, [&](int a, int b) { return notes.getReference(a).mts < notes.getReference(b).mts; });
+
+    // Each new note takes the ratio from a placed note that is simplest against all of them,
+    // and is placed in turn for the notes above it
+    for (int n = 0; n < numNew; n++)
+    {
+        if (deadline > 0 && juce::Time::getHighResolutionTicks() >= deadline)
+            return false;
+
+        // Where the note would be if it moved with the held notes, as it stays if nothing matches
+        auto staticPitch = notes.getReference(order[n]).mts + heldOffset;
+        auto bestPitch = staticPitch;
+        double bestScore = std::numeric_limits<double>::max();
+
+        for (int anchor = 0; anchor < numPlaced; anchor++)
+        {
+            Ratio ratio;
+            if (!findRatio(staticPitch - pitches[anchor], ratio))
+                continue;
+
+            auto pitch = pitches[anchor] + ratio.semitones;
+            double score = deviationWeight * std::abs(pitch - staticPitch);
+
+            for (int placed = 0; placed < numPlaced; placed++)
+            {
+                Ratio between;
+                score += findRatio(pitch - pitches[placed], between)
+                    ? between.complexity + deviationWeight * std::abs(between.semitones - (pitch - pitches[placed]))
+                    : unmatchedPenalty;
+            }
+
+            if (score < bestScore)
+            {
+                bestScore = score;
+                bestPitch = pitch;
+            }
+        }
+
+        pitches[numPlaced++] = bestPitch;
+        offsets[order[n]] = bestPitch - notes.getReference(order[n]).mts;
+    }
+
+    return true;
+}
+
+double AdaptiveJustTuner::complexity(const Exponents& exponents)
+{
+    double height = 0;
+    for (int p = 0; p < 4; p++)
+        height += std::abs(exponents[p]) * primeOctaves[p];
+    return height;
+}
+
+double AdaptiveJustTuner::semitonesOf(const Exponents& exponents)
+{
+    double octaves = 0;
+    for (int p = 0; p < 4; p++)
+        octaves += exponents[p] * primeOctaves[p];
+    return octaves * 12.0;
+}
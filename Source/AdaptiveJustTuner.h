@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    AdaptiveJustTuner.h
+    Created: 20 Oct 2026 4:06:41am
+    Author:  Vincenzo
+
+    Tunes the sounding notes to a chord of just intonation ratios, which are
+    found on a bounded 3, 5 and 7-limit lattice around each note of the chord.
+    The chord with the lowest total Tenney height between its notes is used,
+    with a penalty for how far each note moves from the static tuning.
+
+    Results are kept by chord shape, the intervals of the notes from the
+    lowest one, so repeated chords in any transposition aren't solved again.
+    Notes added to held notes are tuned one at a time against the pitches of
+    the held chord, which stays in place, unless the chord would drift too
+    far from the static tuning and is solved again as a whole. Released
+    notes leave the rest of the chord in place.
+
+    Chords have at most one note per output channel, and tuning them uses
+    storage allocated once, so it can run on the audio thread.
+
+    Solving is limited to a time budget per audio block. If a chord can't be
+    solved in time, new notes use the static tuning until the next block.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include <array>
+
+class AdaptiveJustTuner
+{
+public:
+
+    struct Note
+    {
+        double mts = 0;             /* Pitch in the static tuning */
+        double offset = 0;          /* Semitones added to the static pitch */
+        bool isHeld = false;        /* The note was sounding before this change, and its offset was sent */
+    };
+
+    // Powers of 2, 3, 5 and 7
+    using Exponents = std::array<int, 4>;
+
+    struct Ratio
+    {
+        Exponents exponents { 0, 0, 0, 0 };
+        double semitones = 0;
+        double complexity = 0;      /* Tenney height, log2(numerator * denominator) */
+    };
+
+    // Most notes tuned together, one for each output channel
+    static const int maxNotes = 16;
+
+private:
+
+    struct Shape
+    {
+        juce::uint64 hash = 0;
+        int numNotes = 0;           /* Zero if the slot is empty */
+        std::array<int, maxNotes> intervals;
+        std::array<double, maxNotes> offsets;
+    };
+
+    juce::Array<Ratio> lattice;     /* Ratios within an octave, and within tolerance of the octave on both sides, sorted by size */
+
+    double tolerance;               /* Largest difference in semitones between a static interval and its ratio */
+
+    // Slots indexed by shape hash, allocated once. A new shape replaces the one in its slot.
+    juce::Array<Shape> shapes;
+    int numCachedShapes = 0;
+
+    // The chord being tuned, sorted by pitch
+    std::array<int, maxNotes> order;
+    std::array<double, maxNotes> sortedMts;
+    std::array<int, maxNotes> intervals;
+    std::array<double, maxNotes> offsets;
+
+    // Lattice positions tried by solveShape, and pitches placed by addNotes
+    std::array<Exponents, maxNotes> exponents;
+    std::array<double, maxNotes> pitches;
+    std::array<bool, maxNotes> matched;
+
+    juce::int64 budgetTicks = 0;
+    juce::int64 usedTicks = 0;
+
+private:
+
+    // The cheapest ratio within tolerance of an interval of any size
+    bool findRatio(double semitones, Ratio& ratio) const;
+
+    // Offsets of the sorted notes, relative to the lowest note. Returns false if the deadline passed.
+    bool solveShape(int numNotes, juce::int64 deadline);
+
+    // Offsets of the new notes, indexed like the notes, with the held notes in place. Returns false if the deadline passed.
+    bool addNotes(const juce::Array<Note>& notes, int numNotes, juce::int64 deadline);
+
+public:
+
+    AdaptiveJustTuner(int maxThrees = 4, int maxFives = 2, int maxSevens = 1, double toleranceCents = 30.0);
+
+    // Zero or less to solve every chord, however long it takes
+    void setTimeBudget(double milliseconds);
+    double getTimeBudget() const;
+
+    // Resets the time used by the current block
+    void startBlock();
+
+    // Sets the offset of each note, of up to maxNotes. Returns false if there wasn't time to solve the chord
+    // in this block, in which case held notes are unchanged, and new notes are left on the static tuning.
+    bool tune(juce::Array<Note>& notes);
+
+    int getNumCachedShapes() const { return numCachedShapes; }
+
+    void clearCache();
+
+public:
+
+    static double complexity(const Exponents& exponents);
+
+    static double semitonesOf(const Exponents& exponents);
+};
@@ -59,6 +59,14 @@ namespace Everytone
         static juce::Identifier BendMode("BendMode");
         static juce::Identifier VoiceLimit("VoiceLimit");
         static juce::Identifier PitchbendRange("PitchbendRange");
+        static juce::Identifier InputPitchbendRange("InputPitchbendRange");
+        static juce::Identifier SharedTuning("SharedTuning");
+        static juce::Identifier InputPitchMode("InputPitchMode");
+        static juce::Identifier QuantiseHysteresis("QuantiseHysteresis");
+        static juce::Identifier QuantiseGlide("QuantiseGlide");
+        static juce::Identifier PortamentoTime("PortamentoTime");
+        static juce::Identifier PortamentoThreshold("PortamentoThreshold");
+        static juce::Identifier OutputBaudRate("OutputBaudRate");
 
 
         static juce::Identifier Value("Value");
@@ -73,6 +81,8 @@ namespace Everytone
         OpenTuning,
         EditReference,
         ShowOptions,
+        CaptureMidi,
+        ScaleLibrary,
     };
 
     enum class MappingMode
@@ -117,7 +127,21 @@ namespace Everytone
     {
         Static = 1,        // Send one pitchbend per note Note On
         Persistent,        // Send pitchbend messages while notes are on
-        Dynamic            // Send pitchbend messages to active notes when tuning changes
+        Dynamic,           // Send pitchbend messages to active notes when tuning changes
+        Adaptive           // Send pitchbend messages to active notes to tune held chords in just intonation
+    };
+
+    enum class SharedTuningMode
+    {
+        Off = 1,
+        Master,         // Publish the target tuning to other instances
+        Client          // Follow the target tuning of the master instance
+    };
+
+    enum class InputPitchMode
+    {
+        Bend = 1,       // Input pitchbend is added to the tuned pitch
+        Quantise        // Input note and pitchbend snap to the nearest degree of the target tuning
     };
 
     struct Options
@@ -131,6 +155,14 @@ namespace Everytone
         BendMode    bendMode        = BendMode::Static;
         int         voiceLimit      = 16;
         int         pitchbendRange  = 96; // Unsure if this should be +/- 2 or MPE default
+        int         inputPitchbendRange = 96; // MPE default
+        SharedTuningMode sharedTuning = SharedTuningMode::Off;
+        InputPitchMode inputPitchMode = InputPitchMode::Bend;
+        int         quantiseHysteresis = 15; // Cents
+        int         quantiseGlide   = 0; // Milliseconds
+        int         portamentoTime  = 0; // Milliseconds
+        int         portamentoThreshold = 5; // Cents
+        int         outputBaudRate  = 0; // Bits per second of a hardware link, zero for none
 
         juce::ValueTree toValueTree() const
         {
@@ -144,6 +176,14 @@ namespace Everytone
             tree.setProperty(ID::VoiceRule,         (int)voiceRule,         nullptr);
             tree.setProperty(ID::VoiceLimit,        (int)voiceLimit,        nullptr);
             tree.setProperty(ID::PitchbendRange,    (int)pitchbendRange,    nullptr);
+            tree.setProperty(ID::InputPitchbendRange, (int)inputPitchbendRange, nullptr);
+            tree.setProperty(ID::SharedTuning,      (int)sharedTuning,      nullptr);
+            tree.setProperty(ID::InputPitchMode,    (int)inputPitchMode,    nullptr);
+            tree.setProperty(ID::QuantiseHysteresis, (int)quantiseHysteresis, nullptr);
+            tree.setProperty(ID::QuantiseGlide,     (int)quantiseGlide,     nullptr);
+            tree.setProperty(ID::PortamentoTime,    (int)portamentoTime,    nullptr);
+            tree.setProperty(ID::PortamentoThreshold, (int)portamentoThreshold, nullptr);
+            tree.setProperty(ID::OutputBaudRate,    (int)outputBaudRate,    nullptr);
             return tree;
         }
 
@@ -161,6 +201,14 @@ namespace Everytone
                 if (tree.hasProperty(ID::BendMode))         options.bendMode        = BendMode      ((int)tree[ID::BendMode]);
                 if (tree.hasProperty(ID::VoiceLimit))       options.voiceLimit      = (int)tree[ID::VoiceLimit];
                 if (tree.hasProperty(ID::PitchbendRange))   options.pitchbendRange  = (int)tree[ID::PitchbendRange];
+                if (tree.hasProperty(ID::InputPitchbendRange)) options.inputPitchbendRange = (int)tree[ID::InputPitchbendRange];
+                if (tree.hasProperty(ID::SharedTuning))     options.sharedTuning    = SharedTuningMode((int)tree[ID::SharedTuning]);
+                if (tree.hasProperty(ID::InputPitchMode))   options.inputPitchMode  = InputPitchMode((int)tree[ID::InputPitchMode]);
+                if (tree.hasProperty(ID::QuantiseHysteresis)) options.quantiseHysteresis = (int)tree[ID::QuantiseHysteresis];
+                if (tree.hasProperty(ID::QuantiseGlide))    options.quantiseGlide   = (int)tree[ID::QuantiseGlide];
+                if (tree.hasProperty(ID::PortamentoTime))   options.portamentoTime  = (int)tree[ID::PortamentoTime];
+                if (tree.hasProperty(ID::PortamentoThreshold)) options.portamentoThreshold = (int)tree[ID::PortamentoThreshold];
+                if (tree.hasProperty(ID::OutputBaudRate))   options.outputBaudRate  = (int)tree[ID::OutputBaudRate];
             }
 
             return options;
@@ -182,6 +230,9 @@ public:
     virtual void bendModeChanged(Everytone::BendMode newBendMode) = 0;
     virtual void voiceLimitChanged(int newVoiceLimit) = 0;
     virtual void pitchbendRangeChanged(int newPitchbendRange) = 0;
+    virtual void inputPitchbendRangeChanged(int newInputPitchbendRange) = 0;
+    virtual void sharedTuningModeChanged(Everytone::SharedTuningMode mode) = 0;
+    virtual void inputPitchModeChanged(Everytone::InputPitchMode mode) = 0;
 };
 
 class OptionsChanger
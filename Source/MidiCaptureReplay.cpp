@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    MidiCaptureReplay.cpp
+    Created: 20 Oct 2026 1:58:12am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "MidiCaptureReplay.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct Event
+    {
+        int sample;
+        const juce::uint8* data;
+        int numBytes;
+    };
+
+    juce::Array<Event> eventsOf(const juce::MidiBuffer& midi)
+    {
+        juce::Array<Event> events;
+        for (auto metadata : midi)
+            events.add({ metadata.samplePosition, metadata.data, metadata.numBytes });
+        return events;
+    }
+
+    juce::String eventToString(const Event& event)
+    {
+        return juce::String::toHexString(event.data, event.numBytes) + " at " + juce::String(event.sample);
+    }
+}
+
+juce::String MidiCaptureReplay::Difference::toString() const
+{
+    juce::String summary;
+    summary << juce::String(blocksCompared) << " blocks compared, "
+            << juce::String(missingBlocks) << " missing, "
+            << juce::String(byteMismatches) << " byte mismatches, "
+            << juce::String(timingMismatches) << " timing mismatches, "
+            << juce::String(tunerMismatches) << " tuner mismatches";
+
+    if (details.size() > 0)
+        summary << "\n" << details.joinIntoString("\n");
+
+    return summary;
+}
+
+bool MidiCaptureReplay::replay(const MidiCaptureLog::Capture& input, MidiCaptureLog::Capture& output, juce::String& error)
+{
+    if (input.states.size() == 0)
+    {
+        error = "MIDI capture has no initial state";
+        return false;
+    }
+
+    auto processor = std::make_unique<MultimapperAudioProcessor>();
+
+    auto loadState = [&](const MidiCaptureLog::State& state)
+    {
+        processor->setStateInformation(state.data.getData(), (int)state.data.getSize());
+
+        // Replays shouldn't depend on other instances
+        processor->sharedTuningMode(Everytone::SharedTuningMode::Off);
+    };
+
+    loadState(input.states.getReference(0));
+    auto tunerHash = processor->tunerStateHash();
+
+    output = MidiCaptureLog::Capture();
+    output.states = input.states;
+    output.blocks.ensureStorageAllocated(input.blocks.size());
+
+    double preparedSampleRate = 0;
+    int preparedBlockSize = 0;
+    juce::AudioBuffer<float> audio;
+
+    juce::uint64 missingHash = 0;
+    int numMissingStates = 0;
+
+    for (auto& block : input.blocks)
+    {
+        if (block.sampleRate != preparedSampleRate || block.blockSize > preparedBlockSize)
+        {
+            preparedSampleRate = block.sampleRate;
+            preparedBlockSize = juce::jmax(preparedBlockSize, block.blockSize);
+            processor->prepareToPlay(preparedSampleRate, preparedBlockSize);
+        }
+
+        if (block.tunerHash != tunerHash && block.tunerHash != missingHash)
+        {
+            auto state = input.findState(block.tunerHash);
+            if (state != nullptr)
+            {
+                loadState(*state);
+                tunerHash = processor->tunerStateHash();
+            }
+            else
+            {
+                // Keep the current tuner, and only count each missing state once in a row
+                missingHash = block.tunerHash;
+                numMissingStates++;
+            }
+        }
+
+        audio.setSize(juce::jmax(1, processor->getTotalNumOutputChannels()), block.blockSize, false, false, true);
+        audio.clear();
+
+        MidiCaptureLog::Block processed;
+        processed.index = block.index;
+        processed.sampleRate = block.sampleRate;
+        processed.blockSize = block.blockSize;
+        processed.midi = block.midi;
+
+        processor->processBlock(audio, processed.midi);
+
+        tunerHash = processor->tunerStateHash();
+        processed.tunerHash = tunerHash;
+        output.blocks.add(processed);
+    }
+
+    processor->releaseResources();
+
+    if (numMissingStates > 0)
+        juce::Logger::writeToLog("MIDI capture replay was missing the state of " + juce::String(numMissingStates) + " tuner changes");
+
+    return true;
+}
+
+bool MidiCaptureReplay::replay(const juce::File& inputFile, const juce::File& outputFile, juce::String& error)
+{
+    MidiCaptureLog::Capture input;
+    if (!MidiCaptureLog::read(inputFile, input, error))
+        return false;
+
+    MidiCaptureLog::Capture output;
+    if (!replay(input, output, error))
+        return false;
+
+    return MidiCaptureLog::write(outputFile, output, error);
+}
+
+MidiCaptureReplay::Difference MidiCaptureReplay::compare(const MidiCaptureLog::Capture& expected, const MidiCaptureLog::Capture& actual, int maxDetails)
+{
+    Difference difference;
+
+    auto addDetail = [&](juce::int64 blockIndex, const juce::String& detail)
+    {
+        if (difference.details.size() < maxDetails)
+            difference.details.add("Block " + juce::String(blockIndex) + ": " + detail);
+    };
+
+    // Both are sorted by index, with gaps where blocks were dropped
+    int e = 0, a = 0;
+    while (e < expected.blocks.size() || a < actual.blocks.size())
+    {
+        auto expectedIndex = (e < expected.blocks.size()) ? expected.blocks.getReference(e).index : std::numeric_limits<juce::int64>::max();
+        auto actualIndex = (a < actual.blocks.size()) ? actual.blocks.getReference(a).index : std::numeric_limits<juce::int64>::max();
+
+        if (expectedIndex != actualIndex)
+        {
+            difference.missingBlocks++;
+            if (expectedIndex < actualIndex)
+            {
+                addDetail(expectedIndex, "missing from actual");
+                e++;
+            }
+            else
+            {
+                addDetail(actualIndex, "missing from expected");
+                a++;
+            }
+            continue;
+        }
+
+        auto& expectedBlock = expected.blocks.getReference(e++);
+        auto& actualBlock = actual.blocks.getReference(a++);
+        difference.blocksCompared++;
+
+        if (expectedBlock.tunerHash != actualBlock.tunerHash)
+        {
+            difference.tunerMismatches++;
+            addDetail(expectedIndex, "different tuner");
+        }
+
+        auto expectedEvents = eventsOf(expectedBlock.midi);
+        auto actualEvents = eventsOf(actualBlock.midi);
+        auto numEvents = juce::jmin(expectedEvents.size(), actualEvents.size());
+
+        for (int i = 0; i < numEvents; i++)
+        {
+            auto& expectedEvent = expectedEvents.getReference(i);
+            auto& actualEvent = actualEvents.getReference(i);
+
+            if (expectedEvent.numBytes != actualEvent.numBytes
+                || memcmp(expectedEvent.data, actualEvent.data, (size_t)expectedEvent.numBytes) != 0)
+            {
+                difference.byteMismatches++;
+                addDetail(expectedIndex, "expected " + eventToString(expectedEvent) + ", got " + eventToString(actualEvent));
+            }
+            else if (expectedEvent.sample != actualEvent.sample)
+            {
+                difference.timingMismatches++;
+                addDetail(expectedIndex, "expected " + eventToString(expectedEvent) + ", got it at " + juce::String(actualEvent.sample));
+            }
+        }
+
+        if (expectedEvents.size() != actualEvents.size())
+        {
+            difference.byteMismatches += std::abs(expectedEvents.size() - actualEvents.size());
+            addDetail(expectedIndex, "expected " + juce::String(expectedEvents.size()) + " events, got " + juce::String(actualEvents.size()));
+        }
+    }
+
+    return difference;
+}
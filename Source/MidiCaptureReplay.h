@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    MidiCaptureReplay.h
+    Created: 20 Oct 2026 1:58:12am
+    Author:  Vincenzo
+
+    Replays a MIDI capture through a processor without an editor or audio
+    device, and compares the output of two replays, such as of two builds.
+
+    The processor starts with the state the capture started with, and when
+    a block was captured with a different tuner, the state that produced
+    that tuner is loaded before the block. This also covers retuning that
+    happened asynchronously during capture, such as from MTS SysEx.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "io/MidiCaptureLog.h"
+
+class MidiCaptureReplay
+{
+public:
+
+    struct Difference
+    {
+        int blocksCompared = 0;
+        int missingBlocks = 0;      /* Blocks that are only in one of the captures */
+        int byteMismatches = 0;     /* Events with different data, and events that are only in one of the blocks */
+        int timingMismatches = 0;   /* Events with the same data at a different sample */
+        int tunerMismatches = 0;    /* Blocks processed with a different tuner */
+
+        juce::StringArray details;  /* Descriptions of the first mismatches */
+
+        bool isIdentical() const { return missingBlocks == 0 && byteMismatches == 0 && timingMismatches == 0 && tunerMismatches == 0; }
+
+        juce::String toString() const;
+    };
+
+public:
+
+    // Output blocks have the same index as their input blocks, and the hash of the tuner after processing them
+    static bool replay(const MidiCaptureLog::Capture& input, MidiCaptureLog::Capture& output, juce::String& error);
+
+    static bool replay(const juce::File& inputFile, const juce::File& outputFile, juce::String& error);
+
+    // Blocks are matched by index
+    static Difference compare(const MidiCaptureLog::Capture& expected, const MidiCaptureLog::Capture& actual, int maxDetails = 16);
+};
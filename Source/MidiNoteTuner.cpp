@@ -19,18 +19,20 @@ MidiNoteTuner::MidiNoteTuner(
 	int pitchbendRangeIn
 )	: sourceTuning(std::make_unique<MappedTuningTable>(sourceTuningIn, sourceMappingIn)),
       targetTuning(std::make_unique<MappedTuningTable>(targetTuningIn, targetMappingIn)), 
-      pitchbendRange(pitchbendRangeIn) {}
+      pitchbendRange(pitchbendRangeIn),
+      quantiser(*targetTuning) {}
 
 MidiNoteTuner::MidiNoteTuner(const std::shared_ptr<MappedTuningTable>& mappedSource, const std::shared_ptr<MappedTuningTable>& mappedTarget, int pitchbendRangeIn)
 	: sourceTuning(mappedSource),
 	  targetTuning(mappedTarget),
-	  pitchbendRange(pitchbendRangeIn) {}
+	  pitchbendRange(pitchbendRangeIn),
+	  quantiser(*targetTuning) {}
 
 MidiNoteTuner::~MidiNoteTuner() {}
 
-juce::Array<int> MidiNoteTuner::getPitchbendTable() const
+TableView<int> MidiNoteTuner::getPitchbendTable() const
 {
-	return pitchbendTable;
+	return TableView<int>(pitchbendTable.data(), pitchbendTable.size());
 }
 
 int MidiNoteTuner::getPitchbendMax() const
@@ -129,6 +131,26 @@ MidiPitch MidiNoteTuner::getMidiPitch(const juce::MidiMessage& msg) const
 	return getMidiPitch(ch, note);
 }
 
+MidiPitch MidiNoteTuner::getMidiPitch(int midiChannel, int midiNote, int sourceNote) const
+{
+	auto targetMts = targetTuning->mtsAt(midiNote, midiChannel);
+	if (targetMts < 0 || targetMts >= 128)
+		return MidiPitch();
+
+	auto sourceMts = sourceTuning->mtsAt(sourceNote);
+	if (sourceMts < 0 || sourceMts > 127)
+		return MidiPitch();
+
+	double discrepancy = targetMts - sourceMts;
+
+	int pitchbend = 8192;
+	if (std::abs(discrepancy) >= 1e-6)
+		pitchbend = juce::jlimit(0, (1 << 14) - 1, semitonesToPitchbend(discrepancy));
+
+	MidiPitch pitch = { sourceNote, pitchbend, true };
+	return pitch;
+}
+
 int MidiNoteTuner::semitonesToPitchbend(double semitonesIn) const
 {
 	return semitonesToPitchbend(pitchbendRange, semitonesIn);
@@ -162,4 +184,22 @@ double MidiNoteTuner::pitchbendToSemitones(int pitchbendRange, int pitchbendIn)
 int MidiNoteTuner::ratioToPitchbend(int pitchbendRange, double ratioIn)
 {
 	return semitonesToPitchbend(pitchbendRange, ratioToSemitones(ratioIn));
+}
+
+int MidiNoteTuner::rescalePitchbendOffset(int pitchbend, int pitchbendRangeFrom, int pitchbendRangeTo)
+{
+	int offset = pitchbend - 8192;
+	if (offset == 0 || pitchbendRangeFrom == pitchbendRangeTo)
+		return offset;
+
+	// Doubled to round half away from zero
+	int numerator = offset * pitchbendRangeFrom * 2;
+	int denominator = pitchbendRangeTo * 2;
+	int rounding = (offset > 0) ? pitchbendRangeTo : -pitchbendRangeTo;
+	return (numerator + rounding) / denominator;
+}
+
+int MidiNoteTuner::addPitchbendOffset(int pitchbend, int offset)
+{
+	return juce::jlimit(0, (1 << 14) - 1, pitchbend + offset);
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #pragma once
 #include <JuceHeader.h>
 #include "./tuning/MappedTuning.h"
+#include "PitchQuantiser.h"
 
 struct MidiPitch
 {
@@ -36,6 +37,9 @@ class MidiNoteTuner
 	bool cached = false; // TODO
 	juce::Array<int> pitchbendTable;
 
+	// Built with the tuner, so quantising input pitch never builds it on the audio thread
+	PitchQuantiser quantiser;
+
 public:
     
 	MidiNoteTuner(std::shared_ptr<TuningTable> sourceTuning, 
@@ -54,8 +58,10 @@ public:
 
 	const MappedTuningTable* mappedSource() const { return sourceTuning.get(); }
 	const MappedTuningTable* mappedTarget() const { return targetTuning.get(); }
+
+	const PitchQuantiser& getQuantiser() const { return quantiser; }
     
-    juce::Array<int> getPitchbendTable() const;
+    TableView<int> getPitchbendTable() const;
 
     int getPitchbendMax() const;
     
@@ -68,6 +74,10 @@ public:
 	MidiPitch getMidiPitch(int midiChannel, int midiNote) const;
 	MidiPitch getMidiPitch(const juce::MidiMessage& msg) const;
 
+	// Pitch of a note that is already sounding on the given source note, such as a held voice after the tuning changed.
+	// The pitchbend is clipped to its range if the note moved too far.
+	MidiPitch getMidiPitch(int midiChannel, int midiNote, int sourceNote) const;
+
 
 	/******************
 
@@ -95,4 +105,11 @@ public:
 
 	static int ratioToPitchbend(int pitchbendRange, double ratioIn);
 
+	// Converts a pitchbend to another pitchbend range with integer arithmetic, without clipping.
+	// Returns the offset from center, rounded to the nearest step.
+	static int rescalePitchbendOffset(int pitchbend, int pitchbendRangeFrom, int pitchbendRangeTo);
+
+	// The sum of a tuning pitchbend and an offset, clipped to the 14-bit range
+	static int addPitchbendOffset(int pitchbend, int offset);
+
 };
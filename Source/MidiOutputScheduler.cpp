@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+    MidiOutputScheduler.cpp
+    Created: 20 Oct 2026 7:35:52am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "MidiOutputScheduler.h"
+
+namespace
+{
+    // A start bit, eight data bits and a stop bit
+    const int bitsPerByte = 10;
+
+    const int maxEventsPerBlock = 1024;
+
+    // Pitchbend, channel pressure and timbre, as sent before the note on of a voice
+    bool isExpression(const juce::MidiMessage& msg)
+    {
+        return msg.isPitchWheel() || msg.isChannelPressure() || msg.isControllerOfType(74);
+    }
+}
+
+MidiOutputScheduler::MidiOutputScheduler()
+{
+    hasRefresh.fill(false);
+    refreshRequested.fill(0);
+
+    lastBlock.ensureStorageAllocated(maxEventsPerBlock);
+    scheduled.ensureSize(maxEventsPerBlock * 8);
+}
+
+void MidiOutputScheduler::setBaudRate(int bitsPerSecond)
+{
+    baudRate = juce::jmax(0, bitsPerSecond);
+    juce::Logger::writeToLog("Output baud rate set to " + juce::String(baudRate.load()));
+}
+
+void MidiOutputScheduler::reset(double sampleRateIn)
+{
+    if (sampleRateIn > 0)
+        sampleRate = sampleRateIn;
+
+    for (auto& queue : queues)
+        queue.clear();
+    numEventsQueued = 0;
+
+    hasRefresh.fill(false);
+    nextRefreshChannel = 0;
+
+    blockStart = 0;
+    linkFreeAt = 0;
+    lastBlock.clearQuick();
+
+    maxDelayMs = 0;
+    meanDelayMs = 0;
+    numQueued = 0;
+    numOverflowed = 0;
+}
+
+void MidiOutputScheduler::addRefresh(const juce::MidiMessage& pitchbend)
+{
+    auto channel = pitchbend.getChannel();
+    if (channel < 1 || channel > 16)
+        return;
+
+    // An earlier refresh that's replaced is counted as waiting since it was added
+    if (!hasRefresh[channel - 1])
+        refreshRequested[channel - 1] = blockStart;
+
+    refreshes[channel - 1] = pitchbend;
+    hasRefresh[channel - 1] = true;
+}
+
+int MidiOutputScheduler::queueOf(const juce::MidiMessage& msg)
+{
+    auto channel = msg.getChannel();
+    return (channel >= 1 && channel <= 16) ? channel - 1 : 16;
+}
+
+void MidiOutputScheduler::enqueue(const juce::MidiMessage& msg, juce::int64 requested, juce::MidiBuffer& output)
+{
+    auto& queue = queues[queueOf(msg)];
+
+    if (queue.isFull())
+    {
+        auto oldest = queue.removeFirst();
+        numEventsQueued--;
+        numOverflowed++;
+        send(oldest.message, oldest.priority, oldest.requested, (double)blockStart, output);
+    }
+
+    auto priority = Priority::Controller;
+    if (msg.isNoteOn())
+    {
+        priority = Priority::NoteOn;
+
+        // The pitchbend and expression of a new voice go with its note on
+        for (int i = queue.size - 1; i >= 0; i--)
+        {
+            auto& previous = queue[i];
+            if (previous.requested < blockStart || previous.priority != Priority::Controller || !isExpression(previous.message))
+                break;
+
+            previous.priority = Priority::NoteOn;
+        }
+    }
+    else if (msg.isNoteOff(true))
+        priority = Priority::NoteOff;
+
+    queue.add({ msg, priority, requested });
+    numEventsQueued++;
+
+    // Anything newer on a channel makes its refresh unnecessary
+    auto channel = msg.getChannel();
+    if (channel >= 1 && channel <= 16 && (msg.isPitchWheel() || msg.isNoteOnOrOff()))
+        hasRefresh[channel - 1] = false;
+}
+
+int MidiOutputScheduler::nextQueue(double time) const
+{
+    int best = -1;
+    for (int i = 0; i < numQueues; i++)
+    {
+        if (queues[i].isEmpty())
+            continue;
+
+        auto& head = queues[i][0];
+        if (head.requested > time)
+            continue;
+
+        if (best < 0)
+        {
+            best = i;
+            continue;
+        }
+
+        auto& bestHead = queues[best][0];
+        if (head.priority < bestHead.priority || (head.priority == bestHead.priority && head.requested < bestHead.requested))
+            best = i;
+    }
+    return best;
+}
+
+double MidiOutputScheduler::nextRequestTime() const
+{
+    double earliest = -1;
+    for (auto& queue : queues)
+    {
+        if (!queue.isEmpty() && (earliest < 0 || queue[0].requested < earliest))
+            earliest = (double)queue[0].requested;
+    }
+    return earliest;
+}
+
+double MidiOutputScheduler::samplesOf(const juce::MidiMessage& msg, int baud) const
+{
+    return (double)msg.getRawDataSize() * bitsPerByte * sampleRate / baud;
+}
+
+void MidiOutputScheduler::send(const juce::MidiMessage& msg, Priority priority, juce::int64 requested, double time, juce::MidiBuffer& output)
+{
+    auto sent = (juce::int64)std::ceil(time);
+    output.addEvent(msg, (int)(sent - blockStart));
+    lastBlock.add({ msg, priority, requested, sent, (sent - requested) * 1000.0 / sampleRate });
+}
+
+void MidiOutputScheduler::flush(juce::MidiBuffer& output)
+{
+    for (auto& queue : queues)
+    {
+        for (int i = 0; i < queue.size; i++)
+            send(queue[i].message, queue[i].priority, queue[i].requested, (double)blockStart, output);
+        queue.clear();
+    }
+    numEventsQueued = 0;
+
+    for (int ch = 0; ch < 16; ch++)
+    {
+        if (hasRefresh[ch])
+            send(refreshes[ch], Priority::Refresh, refreshRequested[ch], (double)blockStart, output);
+    }
+    hasRefresh.fill(false);
+}
+
+void MidiOutputScheduler::schedule(juce::MidiBuffer& buffer, int blockSize)
+{
+    auto baud = baudRate.load();
+    auto blockEnd = blockStart + blockSize;
+
+    lastBlock.clearQuick();
+
+    // Nothing to reorder or delay
+    if (baud <= 0 && numEventsQueued == 0 && std::find(hasRefresh.begin(), hasRefresh.end(), true) == hasRefresh.end())
+    {
+        maxDelayMs = 0;
+        meanDelayMs = 0;
+        numQueued = 0;
+
+        blockStart = blockEnd;
+        return;
+    }
+
+    auto& output = scheduled;
+    output.clear();
+
+    if (baud <= 0)
+    {
+        // Messages left from a limited link go first
+        flush(output);
+        for (auto metadata : buffer)
+            send(metadata.getMessage(), Priority::Controller, blockStart + metadata.samplePosition, (double)(blockStart + metadata.samplePosition), output);
+
+        linkFreeAt = (double)blockEnd;
+    }
+    else
+    {
+        for (auto metadata : buffer)
+            enqueue(metadata.getMessage(), blockStart + metadata.samplePosition, output);
+
+        auto time = juce::jmax(linkFreeAt, (double)blockStart);
+        int groupQueue = -1; // A note on that was started, with its pitchbend and expression
+
+        while (std::ceil(time) < blockEnd)
+        {
+            auto queueIndex = (groupQueue >= 0) ? groupQueue : nextQueue(time);
+            if (queueIndex < 0)
+            {
+                auto nextTime = nextRequestTime();
+                if (nextTime < 0 || nextTime >= blockEnd)
+                    break;
+
+                time = juce::jmax(time, nextTime);
+                continue;
+            }
+
+            auto& queue = queues[queueIndex];
+            auto event = queue.removeFirst();
+            numEventsQueued--;
+
+            send(event.message, event.priority, event.requested, time, output);
+            time = std::ceil(time) + samplesOf(event.message, baud);
+
+            bool continuesGroup = event.priority == Priority::NoteOn && !event.message.isNoteOn()
+                && !queue.isEmpty() && queue[0].priority == Priority::NoteOn;
+            groupQueue = continuesGroup ? queueIndex : -1;
+        }
+
+        // Refreshes take turns with the time that's left
+        auto firstRefreshChannel = nextRefreshChannel;
+        for (int i = 0; i < 16 && std::ceil(time) < blockEnd; i++)
+        {
+            auto ch = (firstRefreshChannel + i) % 16;
+            if (!hasRefresh[ch] || !queues[ch].isEmpty())
+                continue;
+
+            send(refreshes[ch], Priority::Refresh, refreshRequested[ch], time, output);
+            time = std::ceil(time) + samplesOf(refreshes[ch], baud);
+            hasRefresh[ch] = false;
+            nextRefreshChannel = (ch + 1) % 16;
+        }
+
+        linkFreeAt = time;
+    }
+
+    double maxDelay = 0;
+    double totalDelay = 0;
+    for (auto& event : lastBlock)
+    {
+        maxDelay = juce::jmax(maxDelay, event.delayMs);
+        totalDelay += event.delayMs;
+    }
+
+    maxDelayMs = maxDelay;
+    meanDelayMs = (lastBlock.size() > 0) ? totalDelay / lastBlock.size() : 0.0;
+    numQueued = numEventsQueued;
+
+    blockStart = blockEnd;
+    buffer.swapWith(output);
+}
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+    MidiOutputScheduler.h
+    Created: 20 Oct 2026 7:35:52am
+    Author:  Vincenzo
+
+    Spreads output over time as a hardware MIDI link would carry it.
+
+    A message takes ten bits per byte at the baud rate of the link, so at
+    31250 baud a pitchbend and note on are almost two milliseconds. Each block,
+    the next message sent is the most urgent one that was due: note ons with
+    the pitchbend and expression that come before them, then note offs, then
+    other messages. Messages of a channel stay in order, so a note on can't be
+    sent before the note off of the voice that had its channel. Messages that
+    don't fit in a block are sent in the next one.
+
+    Pitchbend refreshes, as sent in Persistent bend mode, only use the time the
+    link has left, and are replaced by anything newer on their channel.
+
+    Each channel queues up to queueCapacity messages in storage allocated with
+    the scheduler. When a queue is full, its oldest message is sent at once,
+    ahead of the link, so that no note on or note off is ever lost.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+class MidiOutputScheduler
+{
+public:
+
+    static const int dinBaudRate = 31250;
+
+    enum class Priority
+    {
+        NoteOn = 0,     // Note ons, and the pitchbend and expression sent just before them
+        NoteOff,
+        Controller,
+        Refresh
+    };
+
+    struct ScheduledEvent
+    {
+        juce::MidiMessage message;
+        Priority priority;
+        juce::int64 requested;  // Samples since the scheduler was reset
+        juce::int64 sent;
+        double delayMs;
+    };
+
+private:
+
+    struct Event
+    {
+        juce::MidiMessage message;
+        Priority priority = Priority::Controller;
+        juce::int64 requested = 0;
+    };
+
+public:
+
+    // Messages waiting on each channel before the oldest is sent over the link limit
+    static const int queueCapacity = 128;
+
+private:
+
+    // Messages of a channel in the order they were requested
+    struct Queue
+    {
+        std::array<Event, queueCapacity> events;
+        int start = 0;
+        int size = 0;
+
+        bool isEmpty() const { return size == 0; }
+        bool isFull() const { return size == queueCapacity; }
+
+        Event& operator[](int index) { return events[(start + index) % queueCapacity]; }
+        const Event& operator[](int index) const { return events[(start + index) % queueCapacity]; }
+
+        void add(const Event& event) { events[(start + size++) % queueCapacity] = event; }
+
+        Event removeFirst()
+        {
+            auto event = events[start];
+            start = (start + 1) % queueCapacity;
+            size--;
+            return event;
+        }
+
+        void clear() { start = 0; size = 0; }
+    };
+
+    static const int numQueues = 17; // One per channel, and one for system messages
+
+    std::array<Queue, numQueues> queues;
+    int numEventsQueued = 0;
+
+    // The latest refresh of each channel, waiting for a free link
+    std::array<juce::MidiMessage, 16> refreshes;
+    std::array<bool, 16> hasRefresh;
+    std::array<juce::int64, 16> refreshRequested;
+    int nextRefreshChannel = 0;
+
+    std::atomic<int> baudRate { 0 };
+    double sampleRate = 44100.0;
+
+    juce::int64 blockStart = 0;
+    double linkFreeAt = 0; // Sample when the last message sent is finished
+
+    juce::Array<ScheduledEvent> lastBlock;
+    juce::MidiBuffer scheduled;
+
+    std::atomic<double> maxDelayMs { 0 };
+    std::atomic<double> meanDelayMs { 0 };
+    std::atomic<int> numQueued { 0 };
+    std::atomic<int> numOverflowed { 0 };
+
+private:
+
+    static int queueOf(const juce::MidiMessage& msg);
+
+    // Sends the oldest message of a full queue to the output
+    void enqueue(const juce::MidiMessage& msg, juce::int64 requested, juce::MidiBuffer& output);
+
+    // The queue with the most urgent message that was due by a time, or -1
+    int nextQueue(double time) const;
+
+    // The time the earliest queued message is due, or -1 if there are none
+    double nextRequestTime() const;
+
+    double samplesOf(const juce::MidiMessage& msg, int baud) const;
+
+    void send(const juce::MidiMessage& msg, Priority priority, juce::int64 requested, double time, juce::MidiBuffer& output);
+
+    void flush(juce::MidiBuffer& output);
+
+public:
+
+    MidiOutputScheduler();
+
+    // Bits per second of the link, or zero to send everything at once
+    void setBaudRate(int bitsPerSecond);
+    int getBaudRate() const { return baudRate.load(); }
+
+    bool isLimited() const { return baudRate.load() > 0; }
+
+    // Clears the queues and restarts the clock
+    void reset(double sampleRate);
+
+    // Queues a pitchbend that keeps a voice in tune, replacing an earlier refresh of its channel
+    void addRefresh(const juce::MidiMessage& pitchbend);
+
+    // Replaces the messages of a block with the ones that fit on the link.
+    // An unlimited link with nothing left to send leaves the block as it is.
+    void schedule(juce::MidiBuffer& buffer, int blockSize);
+
+    // Messages sent in the last block, with how long each was queued, unless the block was left as it is. Audio thread.
+    const juce::Array<ScheduledEvent>& getLastBlock() const { return lastBlock; }
+
+    // Queueing delay of the last block, and messages left for the next ones
+    double getMaxDelayMs() const { return maxDelayMs.load(); }
+    double getMeanDelayMs() const { return meanDelayMs.load(); }
+    int getNumQueued() const { return numQueued.load(); }
+
+    // Messages sent over the link limit because their queue was full, since the last reset
+    int getNumOverflowed() const { return numOverflowed.load(); }
+};
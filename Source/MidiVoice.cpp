@@ -62,11 +62,117 @@ void MidiVoice::update()
     updatePitch();
 }
 
+bool MidiVoice::retune(std::shared_ptr<MidiNoteTuner> tunerIn, bool tableChanged)
+{
+    bool sameTuner = tunerIn == tuner;
+    if (tunerIn == nullptr || (sameTuner && !tableChanged))
+        return false;
+
+    // Degrees belong to the quantiser of the previous tuner
+    if (!sameTuner)
+        quantisedDegree = -1;
+
+    tuner = tunerIn;
+
+    if (!currentPitch.mapped)
+        return false;
+
+    auto pitch = tuner->getMidiPitch(midiChannel, midiNote, currentPitch.coarse);
+    if (!pitch.mapped || (sameTuner && pitch == currentPitch))
+        return false;
+
+    currentPitch = pitch;
+    return true;
+}
+
+double MidiVoice::getTargetMts() const
+{
+    return tuner->mappedTarget()->mtsAt(midiNote, midiChannel);
+}
+
+void MidiVoice::setTuningOffset(double semitones)
+{
+    tuningOffset = semitones;
+}
+
+void MidiVoice::setPortamentoOffset(double semitones)
+{
+    portamentoOffset = semitones;
+}
+
+double MidiVoice::getInputMts() const
+{
+    auto inputSemitones = (inputPitchbend - 8192) / 16384.0 * inputPitchbendRange;
+    return getTargetMts() + inputSemitones;
+}
+
+bool MidiVoice::quantiseInputPitch(double hysteresisSemitones, double glideMs)
+{
+    auto& quantiser = tuner->getQuantiser();
+    if (!currentPitch.mapped || quantiser.isEmpty())
+        return false;
+
+    bool isFirst = !inputQuantised || quantisedDegree < 0;
+    inputQuantised = true;
+
+    auto degree = quantiser.quantise(getInputMts(), quantisedDegree, hysteresisSemitones);
+    if (degree == quantisedDegree)
+        return false;
+
+    quantisedDegree = degree;
+    quantisedTarget = quantiser.mtsOfDegree(degree) - getTargetMts();
+
+    if (isFirst || glideMs <= 0)
+    {
+        quantisedOffset = quantisedTarget;
+        glideRemainingMs = 0;
+        return true;
+    }
+
+    glideRemainingMs = glideMs;
+    return false;
+}
+
+bool MidiVoice::advanceGlide(double ms)
+{
+    if (glideRemainingMs <= 0)
+        return false;
+
+    auto progress = juce::jmin(1.0, ms / glideRemainingMs);
+    quantisedOffset += (quantisedTarget - quantisedOffset) * progress;
+    glideRemainingMs = juce::jmax(0.0, glideRemainingMs - ms);
+    return true;
+}
+
+void MidiVoice::clearQuantisedPitch()
+{
+    inputQuantised = false;
+    quantisedDegree = -1;
+    quantisedOffset = 0;
+    glideRemainingMs = 0;
+}
+
 void MidiVoice::updateAftertouch(juce::uint8 aftertouchIn)
 {
     aftertouch = aftertouchIn;
 }
 
+void MidiVoice::updateInputPitchbend(int pitchbend, int inputPitchbendRangeIn)
+{
+    inputPitchbend = pitchbend;
+    inputPitchbendRange = inputPitchbendRangeIn;
+}
+
+void MidiVoice::updatePressure(juce::uint8 pressureIn)
+{
+    pressure = pressureIn;
+}
+
+void MidiVoice::updateTimbre(juce::uint8 timbreIn)
+{
+    timbre = timbreIn;
+}
+
 int MidiVoice::findControllerIndex(int number)
 {
     for (int i = 0; i < controllers.size(); i++)
@@ -98,7 +204,15 @@ juce::MidiMessage MidiVoice::getNoteOn() const
 
 juce::MidiMessage MidiVoice::getPitchbend() const
 {
-    return juce::MidiMessage::pitchWheel(assignedChannel, currentPitch.pitchbend);
+    auto offset = inputQuantised ? tuner->semitonesToPitchbend(quantisedOffset) - 8192
+                                 : MidiNoteTuner::rescalePitchbendOffset(inputPitchbend, inputPitchbendRange, tuner->getPitchbendMax());
+    if (tuningOffset != 0)
+        offset += tuner->semitonesToPitchbend(tuningOffset) - 8192;
+    if (portamentoOffset != 0)
+        offset += tuner->semitonesToPitchbend(portamentoOffset) - 8192;
+
+    auto pitchbend = MidiNoteTuner::addPitchbendOffset(currentPitch.pitchbend, offset);
+    return juce::MidiMessage::pitchWheel(assignedChannel, pitchbend);
 }
 
 juce::MidiMessage MidiVoice::getAftertouch(int value) const
@@ -106,6 +220,16 @@ juce::MidiMessage MidiVoice::getAftertouch(int value) const
     return juce::MidiMessage::aftertouchChange(assignedChannel, currentPitch.coarse, value);
 }
 
+juce::MidiMessage MidiVoice::getPressure() const
+{
+    return juce::MidiMessage::channelPressureChange(assignedChannel, pressure);
+}
+
+juce::MidiMessage MidiVoice::getTimbre() const
+{
+    return juce::MidiMessage::controllerEvent(assignedChannel, MULTIMAPPER_MPE_TIMBRE_CC, timbre);
+}
+
 juce::MidiMessage MidiVoice::getNoteOff() const
 {
     return juce::MidiMessage::noteOff(assignedChannel, currentPitch.coarse);
@@ -11,6 +11,8 @@
 #pragma once
 #include "MidiNoteTuner.h"
 
+#define MULTIMAPPER_MPE_TIMBRE_CC 74
+
 struct LinkedController
 {
     int number = -1;
@@ -25,6 +27,25 @@ class MidiVoice
     juce::uint8 velocity = 0;
     juce::uint8 aftertouch = 0;
 
+    // MPE expression from the input channel
+    int inputPitchbend = 8192;
+    int inputPitchbendRange = 96;
+    juce::uint8 pressure = 0;
+    juce::uint8 timbre = 64;
+
+    // Semitones added to the tuned pitch, such as by adaptive tuning
+    double tuningOffset = 0;
+
+    // Semitones from the tuned pitch of the last portamento pitchbend
+    double portamentoOffset = 0;
+
+    // Input pitch snapped to a degree of the target tuning, used instead of the input pitchbend
+    bool inputQuantised = false;
+    int quantisedDegree = -1;
+    double quantisedOffset = 0;     // Semitones from the tuned pitch to the output, which glides to the target
+    double quantisedTarget = 0;
+    double glideRemainingMs = 0;
+
     const int assignedChannel = -1;
 
     juce::Array<LinkedController> controllers;
@@ -61,8 +82,52 @@ public:
 
     void update();
 
+    // Recalculates the pitchbend with a new tuner, keeping the note that was sent.
+    // Returns false if the tuner is the same, or the note is unmapped in the new tuning.
+    // A tuner whose tables changed in place, such as a shared tuning, is read again if tableChanged
+    // is set, and returns false if the pitch stayed the same.
+    bool retune(std::shared_ptr<MidiNoteTuner> tuner, bool tableChanged = false);
+
+    const MidiNoteTuner* getTuner() const { return tuner.get(); }
+
+    bool isMapped() const { return currentPitch.mapped; }
+
+    // The note number sent for the voice
+    int getOutputNote() const { return currentPitch.coarse; }
+
+    // The pitch of the note in the target tuning, without offsets
+    double getTargetMts() const;
+
+    double getTuningOffset() const { return tuningOffset; }
+    void setTuningOffset(double semitones);
+
+    double getPortamentoOffset() const { return portamentoOffset; }
+    void setPortamentoOffset(double semitones);
+
+    // The pitch of the input note and input pitchbend in the target tuning
+    double getInputMts() const;
+
+    // Snaps the input pitch to the nearest degree of the tuner's quantiser, gliding to a new degree over the glide time.
+    // The first degree of a voice is never glided to. Returns true if the output pitch changed.
+    bool quantiseInputPitch(double hysteresisSemitones, double glideMs);
+
+    // Moves the quantised pitch towards its degree. Returns true if it moved.
+    bool advanceGlide(double ms);
+
+    bool isInputQuantised() const { return inputQuantised; }
+
+    // Returns to following the input pitchbend
+    void clearQuantisedPitch();
+
     void updateAftertouch(juce::uint8 aftertouch);
 
+    // The input pitchbend is added to the tuning pitchbend, and rescaled to the output pitchbend range
+    void updateInputPitchbend(int pitchbend, int inputPitchbendRange);
+
+    void updatePressure(juce::uint8 pressure);
+
+    void updateTimbre(juce::uint8 timbre);
+
     void updateController(int number, juce::uint8 value);
 
     juce::uint8 getControllerValue(int number);
@@ -73,6 +138,10 @@ public:
 
     juce::MidiMessage getAftertouch(int value) const;
 
+    juce::MidiMessage getPressure() const;
+
+    juce::MidiMessage getTimbre() const;
+
     juce::MidiMessage getNoteOff() const;
 
     void mapMidiMessage(juce::MidiMessage& msg) const;
@@ -19,9 +19,20 @@ MidiVoiceController::MidiVoiceController(TunerController& tuningControllerIn,
       mpeZone(zoneIn),
       voiceLimit(limitIn)
 {
-    for (int i = 0; i < MULTIMAPPER_MAX_VOICES; i++)
+    for (int i = 0; i < MULTIMAPPER_MAX_POLY_VOICES; i++)
         voices.add(new MidiVoice());
 
+    activeVoices.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+    chordNotes.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+    chordVoices.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+
+    adaptiveVoices.ensureStorageAllocated(AdaptiveJustTuner::maxNotes);
+    adaptiveNotes.ensureStorageAllocated(AdaptiveJustTuner::maxNotes);
+    untunedVoices.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+
+    for (auto& channelVoices : inputChannelVoices)
+        channelVoices.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+
     midiChannelDisabled.resize(16);
     midiChannelDisabled.fill(false);
 }
@@ -41,7 +52,7 @@ const MidiVoice* MidiVoiceController::getVoice(int index) const
 const MidiVoice* MidiVoiceController::getVoice(int midiChannel, int midiNote) const
 {
     auto voiceIndex = indexOfVoice(midiChannel, midiNote);
-    if (voiceIndex >= 0 && voiceIndex < MULTIMAPPER_MAX_VOICES)
+    if (voiceIndex >= 0 && voiceIndex < MULTIMAPPER_MAX_POLY_VOICES)
         return getVoice(voiceIndex);
     return nullptr;
 }
@@ -74,11 +85,531 @@ juce::Array<MidiVoice> MidiVoiceController::getActiveVoices() const
     return activeVoicesCopy;
 }
 
+void MidiVoiceController::retuneActiveVoices(juce::MidiBuffer& output, int& sample, bool tableChanged)
+{
+    bool anyRetuned = false;
+    auto& tuner = tuningController.getTuner();
+
+    for (auto voice : activeVoices)
+    {
+        if (voice->retune(tuner, tableChanged))
+        {
+            if (inputPitchMode == Everytone::InputPitchMode::Quantise)
+                voice->quantiseInputPitch(quantiseHysteresis * 0.01, quantiseGlide);
+
+            output.addEvent(voice->getPitchbend(), sample++);
+            anyRetuned = true;
+
+            // Tuned again from its new static pitch
+            if (adaptiveTuning)
+                untunedVoices.addIfNotAlreadyThere(voice);
+        }
+    }
+
+    if (adaptiveTuning && anyRetuned)
+        adaptivePending = true;
+}
+
+void MidiVoiceController::startAdaptiveBlock(juce::MidiBuffer& output, int& sample)
+{
+    if (!adaptiveTuning)
+        return;
+
+    adaptiveTuner.startBlock();
+
+    if (adaptivePending)
+        adaptActiveVoices({}, output, sample);
+}
+
+void MidiVoiceController::advanceGlides(double ms, juce::MidiBuffer& output, int& sample)
+{
+    if (inputPitchMode != Everytone::InputPitchMode::Quantise)
+        return;
+
+    for (auto voice : activeVoices)
+    {
+        auto previousPitchbend = voice->getPitchbend().getPitchWheelValue();
+        if (voice->advanceGlide(ms) && voice->getPitchbend().getPitchWheelValue() != previousPitchbend)
+            output.addEvent(voice->getPitchbend(), sample++);
+    }
+}
+
+void MidiVoiceController::advancePortamento(int numSamples, juce::MidiBuffer& output, int sample)
+{
+    portamento.advance(numSamples, [&](int channelIndex, int blockSample, double offset)
+    {
+        auto voice = getVoiceOnChannel(channelIndex);
+        if (voice == nullptr)
+            return;
+
+        auto previousPitchbend = voice->getPitchbend().getPitchWheelValue();
+        voice->setPortamentoOffset(offset);
+
+        auto pitchbend = voice->getPitchbend();
+        if (pitchbend.getPitchWheelValue() != previousPitchbend)
+            output.addEvent(pitchbend, juce::jmax(sample, blockSample));
+    });
+}
+
+void MidiVoiceController::adaptActiveVoices(const juce::Array<const MidiVoice*>& newVoices, juce::MidiBuffer& output, int& sample)
+{
+    adaptiveVoices.clearQuick();
+    adaptiveNotes.clearQuick();
+
+    for (auto voice : activeVoices)
+    {
+        // Voices beyond the output channels, which only share channels in Poly mode, stay on the static tuning
+        if (!voice->isMapped() || adaptiveVoices.size() >= AdaptiveJustTuner::maxNotes)
+            continue;
+
+        // Voices left on the static tuning, or retuned, are placed again with the new voices
+        bool isHeld = !newVoices.contains(voice) && !untunedVoices.contains(voice);
+
+        adaptiveVoices.add(voice);
+        adaptiveNotes.add({ voice->getTargetMts(), voice->getTuningOffset(), isHeld });
+    }
+
+    adaptivePending = !adaptiveTuner.tune(adaptiveNotes);
+
+    untunedVoices.clearQuick();
+    for (int i = 0; i < adaptiveVoices.size(); i++)
+    {
+        auto voice = adaptiveVoices[i];
+        if (adaptivePending && !adaptiveNotes.getReference(i).isHeld)
+            untunedVoices.add(voice);
+
+        auto previousPitchbend = voice->getPitchbend().getPitchWheelValue();
+        voice->setTuningOffset(adaptiveNotes.getReference(i).offset);
+
+        if (!newVoices.contains(voice) && voice->getPitchbend().getPitchWheelValue() != previousPitchbend)
+            output.addEvent(voice->getPitchbend(), sample++);
+    }
+}
+
+bool MidiVoiceController::isExpression(const juce::MidiMessage& msg)
+{
+    return msg.isPitchWheel()
+        || msg.isChannelPressure()
+        || msg.isControllerOfType(MULTIMAPPER_MPE_TIMBRE_CC);
+}
+
+void MidiVoiceController::updateExpression(const juce::MidiMessage& msg)
+{
+    auto midiChannel = msg.getChannel();
+    auto& expression = inputExpression[midiChannel - 1];
+
+    for (auto voice : inputChannelVoices[midiChannel - 1])
+    {
+        if (msg.isPitchWheel())
+        {
+            voice->updateInputPitchbend(msg.getPitchWheelValue(), inputPitchbendRange);
+            if (inputPitchMode == Everytone::InputPitchMode::Quantise)
+                voice->quantiseInputPitch(quantiseHysteresis * 0.01, quantiseGlide);
+        }
+        else if (msg.isChannelPressure())
+            voice->updatePressure((juce::uint8)msg.getChannelPressureValue());
+        else
+            voice->updateTimbre((juce::uint8)msg.getControllerValue());
+    }
+
+    if (msg.isPitchWheel())
+        expression.pitchbend = msg.getPitchWheelValue();
+    else if (msg.isChannelPressure())
+        expression.pressure = msg.getChannelPressureValue();
+    else
+        expression.timbre = msg.getControllerValue();
+}
+
+void MidiVoiceController::tuneMessage(juce::MidiMessage msg, juce::MidiBuffer& output, int& sample)
+{
+    // Expression follows the voices of its input channel, or waits for the next note on it
+    if (isExpression(msg))
+    {
+        // Quantised voices only send pitchbend when their pitch changes
+        bool quantised = msg.isPitchWheel() && inputPitchMode == Everytone::InputPitchMode::Quantise;
+        std::array<int, MULTIMAPPER_MAX_VOICES> previousPitchbend;
+        if (quantised)
+        {
+            forEachVoiceOnChannel(msg.getChannel(), [&](const MidiVoice& voice)
+            {
+                previousPitchbend[voice.getAssignedChannel() - 1] = voice.getPitchbend().getPitchWheelValue();
+            });
+        }
+
+        updateExpression(msg);
+
+        // Voices sharing an output channel move together, so each channel is sent once
+        std::array<bool, MULTIMAPPER_MAX_VOICES> channelSent;
+        channelSent.fill(false);
+
+        forEachVoiceOnChannel(msg.getChannel(), [&](const MidiVoice& voice)
+        {
+            auto channelIndex = voice.getAssignedChannel() - 1;
+            if (channelSent[channelIndex])
+                return;
+
+            channelSent[channelIndex] = true;
+
+            if (msg.isPitchWheel())
+            {
+                auto pitchbend = voice.getPitchbend();
+                if (!quantised || pitchbend.getPitchWheelValue() != previousPitchbend[voice.getAssignedChannel() - 1])
+                    output.addEvent(pitchbend, sample++);
+            }
+            else if (msg.isChannelPressure())
+                output.addEvent(voice.getPressure(), sample++);
+            else
+                output.addEvent(voice.getTimbre(), sample++);
+        });
+        return;
+    }
+
+    auto status = msg.getRawData()[0];
+    bool isVoice = status >= 0x80 && status < 0xb0;
+
+    if (isVoice)
+    {
+        // A single note on is a chord of one
+        if (msg.isNoteOn())
+        {
+            chordNotes.clearQuick();
+            chordNotes.add(prepareNote(msg));
+            sendChord(output, sample);
+            return;
+        }
+
+        auto voice = getVoice(msg);
+        if (voice == nullptr)
+            return;
+
+        voice->mapMidiMessage(msg);
+
+        if (msg.isNoteOff())
+        {
+            removeVoice(voice);
+
+            // The remaining chord is tuned after the note stops
+            if (adaptiveTuning)
+            {
+                output.addEvent(msg, sample++);
+                adaptActiveVoices({}, output, sample);
+                return;
+            }
+        }
+    }
+
+    output.addEvent(msg, sample++);
+}
+
+void MidiVoiceController::tuneChord(const juce::Array<juce::MidiMessage>& noteOns, juce::MidiBuffer& output, int& sample)
+{
+    chordNotes.clearQuick();
+    for (const auto& msg : noteOns)
+    {
+        if (chordNotes.size() >= MULTIMAPPER_MAX_POLY_VOICES)
+            break;
+
+        if (msg.isNoteOn())
+            chordNotes.add(prepareNote(msg));
+    }
+
+    sendChord(output, sample);
+}
+
+void MidiVoiceController::sendChord(juce::MidiBuffer& output, int& sample)
+{
+    // What the channels were left with before the chord
+    std::array<bool, MULTIMAPPER_MAX_VOICES> channelWasFree;
+    std::array<int, MULTIMAPPER_MAX_VOICES> previousPitchbend;
+    for (int i = 0; i < MULTIMAPPER_MAX_VOICES; i++)
+    {
+        channelWasFree[i] = outputChannels[i].numVoices == 0;
+        previousPitchbend[i] = outputChannels[i].pitchbend;
+    }
+
+    allocateChord();
+
+    if (adaptiveTuning && chordVoices.size() > 0)
+        adaptActiveVoices(chordVoices, output, sample);
+
+    std::array<bool, MULTIMAPPER_MAX_VOICES> channelStarted;
+    channelStarted.fill(false);
+
+    for (auto& note : chordNotes)
+    {
+        auto voice = note.voice;
+        if (voice == nullptr)
+            continue;
+
+        // Voices joining a channel in use already have its pitchbend and expression
+        auto channelIndex = voice->getAssignedChannel() - 1;
+        if (channelWasFree[channelIndex] && !channelStarted[channelIndex])
+        {
+            channelStarted[channelIndex] = true;
+
+            auto pbmsg = voice->getPitchbend();
+            if (pbmsg.getPitchWheelValue() != previousPitchbend[channelIndex])
+                output.addEvent(pbmsg, sample++);
+
+            // Initial MPE expression is sent before the note on
+            if (hasInputTimbre(voice->getMidiChannel()))
+                output.addEvent(voice->getTimbre(), sample++);
+
+            if (hasInputPressure(voice->getMidiChannel()))
+                output.addEvent(voice->getPressure(), sample++);
+        }
+
+        auto msg = note.message;
+        voice->mapMidiMessage(msg);
+        output.addEvent(msg, sample++);
+    }
+}
+
+const MidiVoice* MidiVoiceController::allocateNote(const ChordNote& note)
+{
+    auto channelIndex = findSharedChannel(note);
+    if (channelIndex < 0)
+        channelIndex = findNextChannel();
+
+    if (channelIndex >= 0)
+        return startVoice(note, channelIndex);
+
+    return nullptr;
+}
+
+void MidiVoiceController::allocateChord()
+{
+    chordVoices.clearQuick();
+
+    // A single note keeps the order of the channel mode
+    if (chordNotes.size() == 1)
+    {
+        auto& note = chordNotes.getReference(0);
+        note.voice = allocateNote(note);
+        if (note.voice != nullptr)
+            chordVoices.add(note.voice);
+        return;
+    }
+
+    // The allocation is greedy: notes are placed one at a time in their order, in two passes.
+    // Notes that can share a channel or find one left with their pitchbend go first,
+    // so the channels they need aren't taken by notes that need a new pitchbend anyway.
+    // Each note checks every channel and active voice once per pass, which bounds a chord of
+    // MULTIMAPPER_MAX_POLY_VOICES notes to a few tens of thousands of comparisons.
+    for (auto& note : chordNotes)
+    {
+        note.voice = nullptr;
+
+        auto channelIndex = findSharedChannel(note);
+        if (channelIndex < 0)
+            channelIndex = findFreeChannel(note, true);
+
+        if (channelIndex >= 0)
+            note.voice = startVoice(note, channelIndex);
+    }
+
+    for (auto& note : chordNotes)
+    {
+        if (note.voice != nullptr)
+            continue;
+
+        auto channelIndex = findSharedChannel(note);
+        if (channelIndex < 0)
+            channelIndex = findFreeChannel(note, false);
+
+        if (channelIndex >= 0)
+            note.voice = startVoice(note, channelIndex);
+    }
+
+    for (auto& note : chordNotes)
+    {
+        if (note.voice != nullptr)
+            chordVoices.add(note.voice);
+    }
+}
+
+std::unique_ptr<MidiVoice> MidiVoiceController::createVoice(int midiChannel, int midiNote, juce::uint8 velocity, int assignedChannel) const
+{
+    auto newVoice = std::make_unique<MidiVoice>(midiChannel, midiNote, velocity, assignedChannel, tuningController.getTuner());
+    applyInputExpression(*newVoice);
+    return newVoice;
+}
+
+void MidiVoiceController::applyInputExpression(MidiVoice& voice) const
+{
+    const auto& expression = inputExpression[voice.getMidiChannel() - 1];
+    voice.updateInputPitchbend(expression.pitchbend, inputPitchbendRange);
+    if (expression.pressure >= 0)
+        voice.updatePressure((juce::uint8)expression.pressure);
+    if (expression.timbre >= 0)
+        voice.updateTimbre((juce::uint8)expression.timbre);
+
+    if (inputPitchMode == Everytone::InputPitchMode::Quantise)
+        voice.quantiseInputPitch(quantiseHysteresis * 0.01, quantiseGlide);
+}
+
+MidiVoiceController::ChordNote MidiVoiceController::prepareNote(const juce::MidiMessage& msg) const
+{
+    ChordNote note;
+    note.message = msg;
+
+    // Only the pitch is needed, so the voice isn't allocated
+    MidiVoice probe(msg.getChannel(), msg.getNoteNumber(), msg.getVelocity(), 1, tuningController.getTuner());
+    applyInputExpression(probe);
+
+    // Legato notes slide from the sounding pitch of the last note held on their input channel.
+    // Notes of the same chord are allocated after this, so they don't slide from each other.
+    if (portamentoTime > 0 && probe.isMapped())
+    {
+        const MidiVoice* heldVoice = nullptr;
+        const auto& channelVoices = inputChannelVoices[msg.getChannel() - 1];
+        for (int i = channelVoices.size() - 1; i >= 0 && heldVoice == nullptr; i--)
+        {
+            if (channelVoices.getUnchecked(i)->isMapped())
+                heldVoice = channelVoices.getUnchecked(i);
+        }
+
+        if (heldVoice != nullptr)
+        {
+            auto maxOffset = probe.getTuner()->getPitchbendMax() * 0.5;
+            auto offset = heldVoice->getTargetMts() + heldVoice->getPortamentoOffset() - probe.getTargetMts();
+            note.slideOffset = juce::jlimit(-maxOffset, maxOffset, offset);
+            note.slides = note.slideOffset != 0 && juce::roundToInt(portamentoTime * 0.001 * sampleRate) > 0;
+
+            if (note.slides)
+                probe.setPortamentoOffset(note.slideOffset);
+        }
+    }
+
+    note.pitchbend = probe.getPitchbend().getPitchWheelValue();
+    note.outputNote = probe.getOutputNote();
+    return note;
+}
+
+const MidiVoice* MidiVoiceController::startVoice(const ChordNote& note, int channelIndex)
+{
+    auto slot = findFreeSlot();
+    if (slot < 0)
+        return nullptr;
+
+    const auto& msg = note.message;
+    auto newVoice = createVoice(msg.getChannel(), msg.getNoteNumber(), msg.getVelocity(), channelIndex + 1);
+
+    auto& channel = outputChannels[channelIndex];
+    if (channel.numVoices == 0)
+    {
+        lastChannelAssigned = channelIndex;
+        portamento.stop(channelIndex);
+
+        if (note.slides)
+        {
+            portamento.start(channelIndex, note.slideOffset, juce::roundToInt(portamentoTime * 0.001 * sampleRate));
+            newVoice->setPortamentoOffset(portamento.getOffset(channelIndex));
+        }
+    }
+
+    channel.numVoices++;
+    channel.lastNote = newVoice->getOutputNote();
+
+    auto voice = newVoice.release();
+    voices.set(slot, voice);
+    activeVoices.add(voice);
+    inputChannelVoices[msg.getChannel() - 1].add(voice);
+    return voice;
+}
+
+bool MidiVoiceController::canShareChannels(const ChordNote& note) const
+{
+    // Dynamic, adaptive and MTS retuning can move held voices to different pitchbends,
+    // and quantised and sliding voices move their pitchbend on their own
+    return midiMode == Everytone::MidiMode::Poly
+        && bendMode != Everytone::BendMode::Dynamic
+        && bendMode != Everytone::BendMode::Adaptive
+        && !adaptiveTuning
+        && !mtsRetuning
+        && inputPitchMode == Everytone::InputPitchMode::Bend
+        && !note.slides;
+}
+
+int MidiVoiceController::findSharedChannel(const ChordNote& note) const
+{
+    if (!canShareChannels(note))
+        return -1;
+
+    std::array<bool, MULTIMAPPER_MAX_VOICES> canJoin;
+    canJoin.fill(true);
+
+    for (auto voice : activeVoices)
+    {
+        auto channelIndex = voice->getAssignedChannel() - 1;
+        if (voice->getMidiChannel() != note.message.getChannel()
+         || voice->getPitchbend().getPitchWheelValue() != note.pitchbend
+         || voice->getOutputNote() == note.outputNote)
+            canJoin[channelIndex] = false;
+    }
+
+    for (int i = 0; i < MULTIMAPPER_MAX_VOICES; i++)
+    {
+        auto channelIndex = channelInOrder(i);
+        if (canJoin[channelIndex] && outputChannels[channelIndex].numVoices > 0
+         && !midiChannelDisabled[channelIndex] && !portamento.isActive(channelIndex))
+            return channelIndex;
+    }
+
+    return -1;
+}
+
+int MidiVoiceController::findNextChannel() const
+{
+    if (numChannelsInUse() >= voiceLimit)
+        return -1;
+
+    for (int i = 0; i < MULTIMAPPER_MAX_VOICES; i++)
+    {
+        auto channelIndex = channelInOrder(i);
+        if (channelIsFree(channelIndex))
+            return channelIndex;
+    }
+
+    return -1;
+}
+
+int MidiVoiceController::findFreeChannel(const ChordNote& note, bool samePitchbendOnly) const
+{
+    if (numChannelsInUse() >= voiceLimit)
+        return -1;
+
+    // A new pitchbend costs more than moving a channel to another note
+    int bestChannel = -1;
+    int bestScore = -1;
+
+    for (int i = 0; i < MULTIMAPPER_MAX_VOICES; i++)
+    {
+        auto channelIndex = channelInOrder(i);
+        if (!channelIsFree(channelIndex))
+            continue;
+
+        const auto& channel = outputChannels[channelIndex];
+        bool pitchbendMatches = channel.pitchbend == note.pitchbend;
+        if (samePitchbendOnly && !pitchbendMatches)
+            continue;
+
+        auto score = (pitchbendMatches ? 2 : 0) + ((channel.lastNote == note.outputNote) ? 1 : 0);
+        if (score > bestScore)
+        {
+            bestChannel = channelIndex;
+            bestScore = score;
+        }
+    }
+
+    return bestChannel;
+}
+
 int MidiVoiceController::channelOfVoice(int midiChannel, int midiNote) const
 {
-    auto index = indexOfVoice(midiChannel, midiNote);
-    if (index >= 0)
-        return index + 1;
+    auto voice = getVoice(midiChannel, midiNote);
+    if (voice != nullptr)
+        return voice->getAssignedChannel();
     return -1;
 }
 
@@ -91,17 +622,7 @@ int MidiVoiceController::channelOfVoice(const juce::MidiMessage& msg) const
 
 const MidiVoice* MidiVoiceController::addVoice(int midiChannel, int midiNote, juce::uint8 velocity)
 {
-    auto newIndex = getNextVoiceIndex();
-    if (newIndex >= 0 && newIndex < MULTIMAPPER_MAX_VOICES)
-    {
-        lastChannelAssigned = newIndex;
-        auto newVoice = new MidiVoice(midiChannel, midiNote, velocity, newIndex + 1, tuningController.getTuner());
-        voices.set(newIndex, newVoice);
-        activeVoices.addIfNotAlreadyThere(newVoice);
-        return getVoice(newIndex);
-    }
-
-    return nullptr;
+    return allocateNote(prepareNote(juce::MidiMessage::noteOn(midiChannel, midiNote, velocity)));
 }
 
 const MidiVoice* MidiVoiceController::addVoice(const juce::MidiMessage& msg)
@@ -114,10 +635,22 @@ const MidiVoice* MidiVoiceController::addVoice(const juce::MidiMessage& msg)
 
 MidiVoice MidiVoiceController::removeVoice(int index)
 {
-    if (index >= 0 && index < MULTIMAPPER_MAX_VOICES)
+    if (index >= 0 && index < MULTIMAPPER_MAX_POLY_VOICES && voices[index]->getAssignedChannel() > 0)
     {
-        activeVoices.removeAllInstancesOf(voices[index]);
         auto voice = *voices[index];
+        activeVoices.removeAllInstancesOf(voices[index]);
+        inputChannelVoices[voice.getMidiChannel() - 1].removeFirstMatchingValue(voices[index]);
+
+        // The last voice of a channel leaves its pitchbend for the next one to compare with
+        auto channelIndex = voice.getAssignedChannel() - 1;
+        auto& channel = outputChannels[channelIndex];
+        channel.numVoices = juce::jmax(0, channel.numVoices - 1);
+        if (channel.numVoices == 0)
+        {
+            channel.pitchbend = voice.getPitchbend().getPitchWheelValue();
+            portamento.stop(channelIndex);
+        }
+
         voices.set(index, new MidiVoice());
         return voice;
     }
@@ -158,18 +691,7 @@ bool MidiVoiceController::channelIsFree(int channelIndex, MidiPitch pitchToAssig
         break;
     }
 
-    if (!notAvailable)
-    {
-        auto voice = getVoice(channelIndex);
-        if (voice != nullptr)
-        {
-            auto ch = voice->getAssignedChannel();
-            if (ch < 1)
-                return true;
-        }
-    }
-
-    return false;
+    return !notAvailable && outputChannels[channelIndex].numVoices == 0;
 }
 
 void MidiVoiceController::setChannelDisabled(int midiChannel, bool disabled)
@@ -198,52 +720,149 @@ void MidiVoiceController::setVoiceLimit(int limit)
     juce::Logger::writeToLog("VoiceLimit set to " + juce::String((int)voiceLimit));
 }
 
-int MidiVoiceController::nextAvailableVoiceIndex() const
+void MidiVoiceController::setMidiMode(Everytone::MidiMode mode)
 {
-    for (int i = 0; i < voices.size(); i++)
+    midiMode = mode;
+    juce::Logger::writeToLog("MidiMode set to " + juce::String((int)midiMode));
+}
+
+void MidiVoiceController::setInputPitchbendRange(int pitchbendRange)
+{
+    if (pitchbendRange > 0 && pitchbendRange < 256)
     {
-        if (channelIsFree(i))
-            return i;
+        inputPitchbendRange = pitchbendRange;
+        juce::Logger::writeToLog("Input pitchbend range set to " + juce::String(inputPitchbendRange));
+        return;
     }
-    return -1;
+
+    juce::Logger::writeToLog("Input pitchbend range of " + juce::String(pitchbendRange) + " was ignored.");
 }
 
-int MidiVoiceController::nextRoundRobinVoiceIndex() const
+void MidiVoiceController::setBendMode(Everytone::BendMode mode)
 {
-    auto i = lastChannelAssigned + 1;
-    int channelsChecked = 0;
-    while (channelsChecked < MULTIMAPPER_MAX_VOICES)
+    bendMode = mode;
+    juce::Logger::writeToLog("BendMode set to " + juce::String((int)bendMode));
+
+    setAdaptiveTuning(bendMode == Everytone::BendMode::Adaptive);
+}
+
+void MidiVoiceController::setAdaptiveTuning(bool enabled)
+{
+    adaptiveTuning = enabled;
+    adaptivePending = false;
+    untunedVoices.clearQuick();
+
+    if (!adaptiveTuning)
     {
-        if (channelIsFree(i))
-            return i;
+        for (auto voice : activeVoices)
+            voice->setTuningOffset(0);
+    }
+
+    juce::Logger::writeToLog("Adaptive tuning " + juce::String(adaptiveTuning ? "enabled" : "disabled"));
+}
+
+void MidiVoiceController::setMtsRetuning(bool enabled)
+{
+    // Set with every received tuning on the audio thread, so only changes are logged
+    if (mtsRetuning == enabled)
+        return;
+
+    mtsRetuning = enabled;
+    juce::Logger::writeToLog("MTS retuning " + juce::String(mtsRetuning ? "enabled" : "disabled"));
+}
+
+void MidiVoiceController::setInputPitchMode(Everytone::InputPitchMode mode)
+{
+    inputPitchMode = mode;
 
-        i = (i + 1) % MULTIMAPPER_MAX_VOICES;
-        channelsChecked++;
+    if (inputPitchMode != Everytone::InputPitchMode::Quantise)
+    {
+        for (auto voice : activeVoices)
+            voice->clearQuantisedPitch();
     }
 
-    return -1;
+    juce::Logger::writeToLog("InputPitchMode set to " + juce::String((int)inputPitchMode));
 }
 
-int MidiVoiceController::getNextVoiceIndex() const
+void MidiVoiceController::setQuantiseHysteresis(int cents)
 {
-    if (currentVoices >= voiceLimit)
-        return -1;
+    quantiseHysteresis = juce::jmax(0, cents);
+    juce::Logger::writeToLog("Quantise hysteresis set to " + juce::String(quantiseHysteresis) + " cents");
+}
 
+void MidiVoiceController::setQuantiseGlide(int ms)
+{
+    quantiseGlide = juce::jmax(0, ms);
+    juce::Logger::writeToLog("Quantise glide set to " + juce::String(quantiseGlide) + " ms");
+}
+
+void MidiVoiceController::setPortamentoTime(int ms)
+{
+    portamentoTime = juce::jmax(0, ms);
+    juce::Logger::writeToLog("Portamento time set to " + juce::String(portamentoTime) + " ms");
+}
+
+void MidiVoiceController::setPortamentoThreshold(int cents)
+{
+    portamento.setThreshold(cents);
+    juce::Logger::writeToLog("Portamento threshold set to " + juce::String(portamento.getThreshold()) + " cents");
+}
+
+void MidiVoiceController::setSampleRate(double sampleRateIn)
+{
+    if (sampleRateIn > 0)
+        sampleRate = sampleRateIn;
+}
+
+void MidiVoiceController::setAdaptiveTimeBudget(double milliseconds)
+{
+    adaptiveTuner.setTimeBudget(milliseconds);
+}
+
+int MidiVoiceController::channelInOrder(int position) const
+{
     switch (channelMode)
     {
     case Everytone::ChannelMode::FirstAvailable:
-        return nextAvailableVoiceIndex();
+        return position;
 
     case Everytone::ChannelMode::RoundRobin:
-        return nextRoundRobinVoiceIndex();
+        return (lastChannelAssigned + 1 + position) % MULTIMAPPER_MAX_VOICES;
 
     default:
         jassertfalse;
     }
 
-    return 0;
+    return position;
 }
 
+int MidiVoiceController::numChannelsInUse() const
+{
+    int num = 0;
+    for (const auto& channel : outputChannels)
+        num += (channel.numVoices > 0) ? 1 : 0;
+    return num;
+}
+
+int MidiVoiceController::findFreeSlot() const
+{
+    for (int i = 0; i < voices.size(); i++)
+    {
+        if (voices.getUnchecked(i)->getAssignedChannel() <= 0)
+            return i;
+    }
+    return -1;
+}
+
+MidiVoice* MidiVoiceController::getVoiceOnChannel(int channelIndex) const
+{
+    for (auto voice : activeVoices)
+    {
+        if (voice->getAssignedChannel() == channelIndex + 1)
+            return voice;
+    }
+    return nullptr;
+}
 
 int MidiVoiceController::midiNoteIndex(int midiChannel, int midiNote) const
 {
@@ -273,14 +892,3 @@ int MidiVoiceController::indexOfVoice(const MidiVoice* voice) const
     return -1;
 }
 
-int MidiVoiceController::effectiveVoiceLimit() const
-{
-    int numDisabled = 0;
-    for (auto isDisabled : midiChannelDisabled)
-        numDisabled += (isDisabled) ? 1 : 0;
-
-    int limit = voiceLimit - numDisabled;
-    limit -= (mpeZone == Everytone::MpeZone::Omnichannel) ? 0 : 1;
-    return limit;
-}
-
@@ -12,8 +12,13 @@
 
 #include "TunerController.h"
 #include "MidiVoice.h"
+#include "AdaptiveJustTuner.h"
+#include "Portamento.h"
+
+#include <array>
 
 #define MULTIMAPPER_MAX_VOICES 16
+#define MULTIMAPPER_MAX_POLY_VOICES 128 // Voices can share output channels in Poly mode
 
 class MidiVoiceController
 {
@@ -29,37 +34,135 @@ public:
 
 
 private:
+
+    // The last expression received on an input channel, given to voices started on it
+    struct InputChannelExpression
+    {
+        int pitchbend = 8192;
+        int pressure = -1;  // -1 until received
+        int timbre = -1;
+    };
+
+    // The state of an output channel, for choosing channels that need no new pitchbend
+    struct OutputChannel
+    {
+        int numVoices = 0;
+        int pitchbend = 8192;   // Pitchbend the channel was left with by its last voice
+        int lastNote = -1;      // Output note of the last voice
+    };
+
+    // A note on of a chord being allocated
+    struct ChordNote
+    {
+        juce::MidiMessage message;
+        int pitchbend = 8192;
+        int outputNote = -1;
+        bool slides = false;
+        double slideOffset = 0;         // Semitones from the held note it slides from
+        const MidiVoice* voice = nullptr;
+    };
+
     TunerController& tuningController;
 
     juce::OwnedArray<MidiVoice> voices;
     juce::Array<MidiVoice*> activeVoices;
 
+    // Active voices of each input channel in the order they started, so expression only visits its own voices
+    std::array<juce::Array<MidiVoice*>, 16> inputChannelVoices;
+
     juce::Array<bool> midiChannelDisabled;
 
+    std::array<OutputChannel, MULTIMAPPER_MAX_VOICES> outputChannels;
+
+    juce::Array<ChordNote> chordNotes;
+    juce::Array<const MidiVoice*> chordVoices;
+
+    std::array<InputChannelExpression, 16> inputExpression;
+    int inputPitchbendRange = 96;
+
     Everytone::ChannelMode channelMode = Everytone::ChannelMode::FirstAvailable;
     Everytone::MpeZone mpeZone = Everytone::MpeZone::Lower;
 
     int voiceLimit = MULTIMAPPER_MAX_VOICES;
 
-    int currentVoices = 0;
+    Everytone::MidiMode midiMode = Everytone::MidiMode::Mono;
+
+    Everytone::InputPitchMode inputPitchMode = Everytone::InputPitchMode::Bend;
+    int quantiseHysteresis = 15;    // Cents
+    int quantiseGlide = 0;          // Milliseconds
+
+    Portamento portamento;
+    int portamentoTime = 0;         // Milliseconds, zero for none
+    double sampleRate = 44100.0;
+
+    Everytone::BendMode bendMode = Everytone::BendMode::Static;
+    bool mtsRetuning = false;       // The target tuning was received over MTS, and can change while voices are held
+
+    AdaptiveJustTuner adaptiveTuner;
+    bool adaptiveTuning = false;
+    bool adaptivePending = false;   // A chord that was over the time budget, solved in the next block
+
+    // Storage of the chord being tuned, allocated with the controller
+    juce::Array<MidiVoice*> adaptiveVoices;
+    juce::Array<AdaptiveJustTuner::Note> adaptiveNotes;
+
+    // Voices whose offsets don't fit their pitch, as they were over the time budget or were retuned
+    juce::Array<const MidiVoice*> untunedVoices;
+
     int lastChannelAssigned = 0;
 
 private:
 
-    int nextAvailableVoiceIndex() const;
-    int nextRoundRobinVoiceIndex() const;
-    int getNextVoiceIndex() const;
+    // Channel index at a position in the order of the channel mode
+    int channelInOrder(int position) const;
+    int numChannelsInUse() const;
+
+    int findFreeSlot() const;
 
     int midiNoteIndex(int midiChannel, int midiNote) const;
 
     int indexOfVoice(int midiChannel, int midiNote) const;
     int indexOfVoice(const MidiVoice* voice) const;
 
-    int effectiveVoiceLimit() const;
-
     const MidiVoice* getVoice(int index) const;
     MidiVoice removeVoice(int index);
 
+    // Tunes the active voices to a just chord, and sends the pitchbend of held voices that moved.
+    // The new voices are left to be sent with their note ons.
+    void adaptActiveVoices(const juce::Array<const MidiVoice*>& newVoices, juce::MidiBuffer& output, int& sample);
+
+    // Voices of a channel share its pitchbend, so new voices only join channels in Poly mode
+    // with voices from the same input channel, the same pitchbend and other output notes,
+    // and only while nothing can retune the held voices to different pitchbends.
+    bool canShareChannels(const ChordNote& note) const;
+    int findSharedChannel(const ChordNote& note) const;
+
+    // The next free channel in the order of the channel mode
+    int findNextChannel() const;
+
+    // For chords, the free channel needing no new pitchbend, else the one last used by the same note, else the next in order
+    int findFreeChannel(const ChordNote& note, bool samePitchbendOnly) const;
+
+    // Pitch of the note on, and whether it slides from a held note
+    ChordNote prepareNote(const juce::MidiMessage& msg) const;
+
+    std::unique_ptr<MidiVoice> createVoice(int midiChannel, int midiNote, juce::uint8 velocity, int assignedChannel) const;
+
+    // Expression received on the voice's input channel before it started
+    void applyInputExpression(MidiVoice& voice) const;
+    const MidiVoice* startVoice(const ChordNote& note, int channelIndex);
+
+    // Assigns a single note to a shared channel, or to the next channel in the order of the channel mode
+    const MidiVoice* allocateNote(const ChordNote& note);
+
+    // Assigns the chord notes to channels, adding the voices to chordVoices
+    void allocateChord();
+
+    // Allocates the chord notes, and adds the pitchbend and expression of newly used channels before the note ons
+    void sendChord(juce::MidiBuffer& output, int& sample);
+
+    MidiVoice* getVoiceOnChannel(int channelIndex) const;
+
 public:
 
     MidiVoiceController(TunerController& tuningController, 
@@ -73,6 +176,21 @@ public:
 
     int getVoiceLimit() const { return voiceLimit; }
 
+    Everytone::MidiMode getMidiMode() const { return midiMode; }
+
+    int getInputPitchbendRange() const { return inputPitchbendRange; }
+
+    Everytone::BendMode getBendMode() const { return bendMode; }
+    bool isAdaptiveTuning() const { return adaptiveTuning; }
+    bool isMtsRetuning() const { return mtsRetuning; }
+
+    Everytone::InputPitchMode getInputPitchMode() const { return inputPitchMode; }
+    int getQuantiseHysteresis() const { return quantiseHysteresis; }
+    int getQuantiseGlide() const { return quantiseGlide; }
+
+    int getPortamentoTime() const { return portamentoTime; }
+    int getPortamentoThreshold() const { return juce::roundToInt(portamento.getThreshold()); }
+
 
     const MidiVoice* getVoice(int midiChannel, int midiNote) const;
     const MidiVoice* getVoice(const juce::MidiMessage& msg) const;
@@ -82,6 +200,47 @@ public:
     int numVoices() const;
     juce::Array<MidiVoice> getActiveVoices() const;
 
+    // Voices started on an input channel, without checking the voices of other channels
+    template <typename Callback>
+    void forEachVoiceOnChannel(int midiChannel, Callback callback) const
+    {
+        for (auto voice : inputChannelVoices[midiChannel - 1])
+            callback(*voice);
+    }
+
+    // Pitchbend, channel pressure and timbre (CC74), which follow the voices of their input channel
+    static bool isExpression(const juce::MidiMessage& msg);
+
+    // Stores the expression for voices started later on the channel, and applies it to active voices
+    void updateExpression(const juce::MidiMessage& msg);
+
+    // Initial pressure and timbre of a new voice, if any were received on its input channel before the note on
+    bool hasInputPressure(int midiChannel) const { return inputExpression[midiChannel - 1].pressure >= 0; }
+    bool hasInputTimbre(int midiChannel) const { return inputExpression[midiChannel - 1].timbre >= 0; }
+
+    // Retunes active voices that were started with another tuner, and adds the pitchbend of the ones that moved.
+    // If the tables of the current tuner changed in place, every voice is read again.
+    void retuneActiveVoices(juce::MidiBuffer& output, int& sample, bool tableChanged = false);
+
+    // Starts the adaptive tuning time budget of a block, and tunes chords that were over the budget in the last one
+    void startAdaptiveBlock(juce::MidiBuffer& output, int& sample);
+
+    // Moves quantised voices towards their degree, and sends the pitchbend of the ones that moved
+    void advanceGlides(double ms, juce::MidiBuffer& output, int& sample);
+
+    // Moves portamento ramps through a block, adding their pitchbends at the samples they're needed,
+    // though not before the given sample
+    void advancePortamento(int numSamples, juce::MidiBuffer& output, int sample);
+
+    // Adds the tuned message to the output, after the pitchbend and expression of a new voice.
+    // Expression is sent to the voices of its input channel, and unassigned notes are dropped.
+    // Events are added at consecutive samples, starting at the given one.
+    void tuneMessage(juce::MidiMessage msg, juce::MidiBuffer& output, int& sample);
+
+    // Tunes note ons that start together, choosing their channels at once to send as few pitchbends
+    // and move as few channels to new notes as possible. Up to MULTIMAPPER_MAX_POLY_VOICES are allocated.
+    void tuneChord(const juce::Array<juce::MidiMessage>& noteOns, juce::MidiBuffer& output, int& sample);
+
     int channelOfVoice(int midiChannel, int midiNote) const;
     int channelOfVoice(const juce::MidiMessage& msg) const;
 
@@ -101,4 +260,40 @@ public:
     void setMpeZone(Everytone::MpeZone zone);
     void setVoiceLimit(int voiceLimit);
 
+    // In Poly mode, notes with the same pitchbend from an input channel can share an output channel
+    void setMidiMode(Everytone::MidiMode mode);
+
+    // Total bipolar range of incoming pitchbend in semitones, 96 for the MPE default of 48 semitones
+    void setInputPitchbendRange(int pitchbendRange);
+
+    // Dynamic and Adaptive retune held voices one by one, so channels are not shared in them.
+    // Adaptive also enables adaptive tuning.
+    void setBendMode(Everytone::BendMode mode);
+
+    // Held chords are retuned to just intonation as notes start and stop
+    void setAdaptiveTuning(bool enabled);
+
+    // The target tuning is received over MTS, so channels are not shared
+    void setMtsRetuning(bool enabled);
+
+    // In Quantise mode, the input note and pitchbend snap to the nearest degree of the target tuning
+    void setInputPitchMode(Everytone::InputPitchMode mode);
+
+    // How far past the boundary between two degrees the input pitch goes before the degree changes
+    void setQuantiseHysteresis(int cents);
+
+    // Time to move to a new degree, or zero to move immediately
+    void setQuantiseGlide(int ms);
+
+    // Time for a note started while another is held on its input channel to slide from its pitch, or zero for none
+    void setPortamentoTime(int ms);
+
+    // Largest difference between the sent pitch of a slide and its ramp, which sets how many pitchbends it needs
+    void setPortamentoThreshold(int cents);
+
+    void setSampleRate(double sampleRate);
+
+    // Time per block to solve new chords in, zero or less for no limit
+    void setAdaptiveTimeBudget(double milliseconds);
+
 };
\ No newline at end of file
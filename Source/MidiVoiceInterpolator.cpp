@@ -52,13 +52,15 @@ void MidiVoiceInterpolator::setBendMode(Everytone::BendMode bendModeIn)
     juce::Logger::writeToLog("Set BendMode to " + juce::String((int)bendModeIn));
     switch (bendMode)
     {
-    case Everytone::BendMode::Dynamic:
     case Everytone::BendMode::Persistent:
         startTimer(updateRateMs);
         return;
 
     default:
         jassertfalse;
+    // Dynamic and Adaptive voices are retuned by MidiVoiceController
+    case Everytone::BendMode::Dynamic:
+    case Everytone::BendMode::Adaptive:
     case Everytone::BendMode::Static:
         stopTimer();
         clearVoiceTargets();
@@ -74,9 +76,7 @@ void MidiVoiceInterpolator::updateTargetVoices()
         activeVoiceTargets = voiceController.getActiveVoices();
         break;
 
-    case Everytone::BendMode::Dynamic:
-        // TODO
-        jassertfalse;
+    default:
         break;
     }
 }
\ No newline at end of file
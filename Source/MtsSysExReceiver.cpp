@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    MtsSysExReceiver.cpp
+    Created: 19 Oct 2026 10:04:51pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "MtsSysExReceiver.h"
+
+namespace
+{
+    const juce::uint8 universalNonRealtime = 0x7e;
+    const juce::uint8 universalRealtime = 0x7f;
+    const juce::uint8 midiTuningStandard = 0x08;
+
+    const juce::uint8 bulkDump = 0x01;
+    const juce::uint8 singleNoteChange = 0x02;
+    const juce::uint8 bulkDumpWithBank = 0x04;
+    const juce::uint8 singleNoteChangeWithBank = 0x07;
+    const juce::uint8 octaveTuning1Byte = 0x08;
+    const juce::uint8 octaveTuning2Byte = 0x09;
+
+    // Returns false for 7F 7F 7F, which leaves the note unchanged
+    bool readTriplet(const juce::uint8* data, double& mts)
+    {
+        MTSTriplet triplet = { data[0], data[1], data[2] };
+        if (triplet.coarse == 0x7f && triplet.fineUpper == 0x7f && triplet.fineLower == 0x7f)
+            return false;
+
+        mts = mtsTripletToMts(triplet);
+        return true;
+    }
+
+    // The XOR of every byte from the universal ID to the last note
+    bool checksumMatches(const juce::uint8* data, int size, juce::uint8 checksum)
+    {
+        juce::uint8 sum = 0;
+        for (int i = 0; i < size; i++)
+            sum ^= data[i];
+
+        return (sum & 0x7f) == checksum;
+    }
+
+    // Bulk dumps have a name, and a frequency for every note
+    bool applyBulkDump(const juce::uint8* data, int size, MtsSysExReceiver::NoteTable& table)
+    {
+        if (size < MtsSysExReceiver::nameLength + 128 * 3)
+            return false;
+
+        for (int i = 0; i < MtsSysExReceiver::nameLength; i++)
+            table.name[i] = (char)(data[i] & 0x7f);
+        table.name[MtsSysExReceiver::nameLength] = '\0';
+
+        data += MtsSysExReceiver::nameLength;
+        for (int note = 0; note < 128; note++)
+            readTriplet(data + note * 3, table.mts[note]);
+
+        return true;
+    }
+
+    bool applySingleNoteChanges(const juce::uint8* data, int size, MtsSysExReceiver::NoteTable& table)
+    {
+        if (size < 1)
+            return false;
+
+        int numChanges = data[0];
+        if (size < 1 + numChanges * 4)
+            return false;
+
+        for (int i = 0; i < numChanges; i++)
+        {
+            auto change = data + 1 + i * 4;
+            int note = change[0] & 0x7f;
+            readTriplet(change + 1, table.mts[note]);
+        }
+
+        return true;
+    }
+
+    // Offsets of each pitch class from 12EDO. The channel mask is ignored, since there is one target tuning.
+    bool applyOctaveTuning(const juce::uint8* data, int size, bool twoBytes, MtsSysExReceiver::NoteTable& table)
+    {
+        const int channelMaskSize = 3;
+        int bytesPerNote = twoBytes ? 2 : 1;
+        if (size < channelMaskSize + 12 * bytesPerNote)
+            return false;
+
+        std::array<double, 12> offsets;
+        data += channelMaskSize;
+        for (int pitchClass = 0; pitchClass < 12; pitchClass++)
+        {
+            if (twoBytes)
+            {
+                auto value = (data[pitchClass * 2] << 7) | data[pitchClass * 2 + 1];
+                offsets[pitchClass] = (value - 8192) / 8192.0;
+            }
+            else
+            {
+                offsets[pitchClass] = (data[pitchClass] - 64) / 100.0;
+            }
+        }
+
+        for (int note = 0; note < 128; note++)
+            table.mts[note] = note + offsets[note % 12];
+
+        return true;
+    }
+}
+
+class MtsSysExReceiver::BuildJob : public juce::ThreadPoolJob
+{
+    juce::WeakReference<MtsSysExReceiver> receiver;
+    int buildId;
+    NoteTable table;
+
+public:
+
+    BuildJob(MtsSysExReceiver* receiverIn, int buildIdIn, const NoteTable& tableIn)
+        : juce::ThreadPoolJob("MtsTuningBuild"),
+          receiver(receiverIn),
+          buildId(buildIdIn),
+          table(tableIn) {}
+
+    JobStatus runJob() override
+    {
+        auto tuning = MtsSysExReceiver::createTuning(table);
+
+        if (auto owner = receiver.get())
+            owner->postTuning(buildId, tuning);
+
+        return JobStatus::jobHasFinished;
+    }
+};
+
+MtsSysExReceiver::NoteTable::NoteTable()
+{
+    for (int note = 0; note < 128; note++)
+        mts[note] = note;
+
+    name.fill('\0');
+}
+
+MtsSysExReceiver::MtsSysExReceiver()
+{
+    startTimer(updateRateMs);
+}
+
+MtsSysExReceiver::~MtsSysExReceiver()
+{
+    stopTimer();
+    listeners.clear();
+    pool.removeAllJobs(true, 2000);
+    masterReference.clear();
+}
+
+bool MtsSysExReceiver::readSysEx(const juce::uint8* messageData, int numBytes)
+{
+    if (numBytes < 2 || messageData[0] != 0xf0)
+        return false;
+
+    // Skip the F0 and F7 bytes
+    auto size = (messageData[numBytes - 1] == 0xf7) ? numBytes - 2 : numBytes - 1;
+    if (!applySysEx(messageData + 1, size, receivedTable, deviceId.load(std::memory_order_relaxed)))
+        return false;
+
+    hasUnsentChanges = true;
+    return true;
+}
+
+void MtsSysExReceiver::sendChanges()
+{
+    if (!hasUnsentChanges)
+        return;
+
+    const juce::SpinLock::ScopedTryLockType lock(pendingLock);
+    if (!lock.isLocked())
+        return;
+
+    pendingTable = receivedTable;
+    hasPendingTable = true;
+    hasUnsentChanges = false;
+}
+
+bool MtsSysExReceiver::applySysEx(const juce::uint8* data, int size, NoteTable& table, int deviceId)
+{
+    // Universal ID, device ID, MTS ID and sub-ID
+    const int headerSize = 4;
+    if (data == nullptr || size < headerSize)
+        return false;
+
+    bool isUniversal = data[0] == universalNonRealtime || data[0] == universalRealtime;
+    if (!isUniversal || data[2] != midiTuningStandard)
+        return false;
+
+    if (deviceId != allDevices && data[1] != allDevices && data[1] != deviceId)
+        return false;
+
+    auto body = data + headerSize;
+    auto bodySize = size - headerSize;
+
+    // Bank and program numbers are skipped, received tunings always replace the target tuning
+    switch (data[3])
+    {
+    case bulkDump:
+    case bulkDumpWithBank:
+    {
+        // Program number, or bank and program number
+        int programSize = (data[3] == bulkDump) ? 1 : 2;
+        int dumpSize = headerSize + programSize + nameLength + 128 * 3;
+        if (size <= dumpSize || !checksumMatches(data, dumpSize, data[dumpSize]))
+            return false;
+
+        return applyBulkDump(body + programSize, bodySize - programSize, table);
+    }
+
+    case singleNoteChange:
+        return applySingleNoteChanges(body + 1, bodySize - 1, table);
+
+    case singleNoteChangeWithBank:
+        return applySingleNoteChanges(body + 2, bodySize - 2, table);
+
+    case octaveTuning1Byte:
+        return applyOctaveTuning(body, bodySize, false, table);
+
+    case octaveTuning2Byte:
+        return applyOctaveTuning(body, bodySize, true, table);
+
+    default:
+        return false;
+    }
+}
+
+std::shared_ptr<TuningTable> MtsSysExReceiver::createTuning(const NoteTable& table)
+{
+    juce::Array<double> frequencies;
+    for (auto mts : table.mts)
+        frequencies.add(mtsToFrequency(mts));
+
+    auto name = juce::String(table.name.data()).trim();
+    if (name.isEmpty())
+        name = "MTS";
+
+    TuningTable::Definition definition =
+    {
+        frequencies,
+        69,
+        name,
+        "Received from MIDI Tuning Standard SysEx.",
+        juce::String(),
+        0,
+        0
+    };
+
+    return std::make_shared<TuningTable>(definition);
+}
+
+void MtsSysExReceiver::timerCallback()
+{
+    if (!hasPendingTable)
+        return;
+
+    NoteTable table;
+    {
+        const juce::SpinLock::ScopedLockType lock(pendingLock);
+        table = pendingTable;
+        hasPendingTable = false;
+    }
+
+    auto buildId = ++currentBuildId;
+    pool.removeAllJobs(true, 0);
+    pool.addJob(new BuildJob(this, buildId, table), true);
+}
+
+void MtsSysExReceiver::postTuning(int buildId, std::shared_ptr<TuningTable> tuning)
+{
+    juce::WeakReference<MtsSysExReceiver> receiver(this);
+    juce::MessageManager::callAsync([receiver, buildId, tuning]()
+    {
+        auto owner = receiver.get();
+        if (owner == nullptr || owner->currentBuildId != buildId)
+            return;
+
+        juce::Logger::writeToLog("Received MTS tuning: " + tuning->getName());
+        owner->listeners.call(&Listener::mtsTuningReceived, owner, tuning);
+    });
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    MtsSysExReceiver.h
+    Created: 19 Oct 2026 10:04:51pm
+    Author:  Vincenzo
+
+    Retunes from MIDI Tuning Standard SysEx sent by upstream devices.
+    Messages are read on the audio thread into a preallocated table of notes,
+    which is handed to the message thread and built into a TuningTable on a
+    background thread.
+
+    Supported messages:
+        Bulk tuning dump (with or without a bank)
+        Single note tuning change (with or without a bank)
+        Scale/octave tuning, 1-byte and 2-byte forms
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "./tuning/TuningTable.h"
+
+#include <array>
+
+class MtsSysExReceiver : private juce::Timer
+{
+public:
+
+    static const int nameLength = 16;
+
+    // Device ID of messages sent to every device, and of receivers that read messages for any device
+    static const int allDevices = 0x7f;
+
+    // The received tuning of each MIDI note, as fractional MIDI note numbers
+    struct NoteTable
+    {
+        std::array<double, 128> mts;
+        std::array<char, nameLength + 1> name;
+
+        NoteTable();
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        // Called on the message thread
+        virtual void mtsTuningReceived(MtsSysExReceiver* receiver, std::shared_ptr<TuningTable> tuning) {}
+    };
+
+private:
+
+    class BuildJob;
+
+    // Only used on the audio thread
+    NoteTable receivedTable;
+    bool hasUnsentChanges = false;
+
+    // Written by the audio thread, read by the message thread
+    NoteTable pendingTable;
+    juce::SpinLock pendingLock;
+    std::atomic<bool> hasPendingTable { false };
+
+    juce::ThreadPool pool { 1 };
+    juce::ListenerList<Listener> listeners;
+
+    // Tunings from jobs that were replaced are not delivered
+    std::atomic<int> currentBuildId { 0 };
+
+    int updateRateMs = 20;
+
+    std::atomic<int> deviceId { allDevices };
+
+public:
+
+    MtsSysExReceiver();
+    ~MtsSysExReceiver();
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    int getDeviceId() const { return deviceId; }
+    void setDeviceId(int newDeviceId) { deviceId = newDeviceId; }
+
+    // Audio thread. Reads the raw bytes of a MIDI message from a MidiBuffer, and returns true if it was
+    // an MTS message, which is applied to the received table. Doesn't allocate or lock.
+    bool readSysEx(const juce::uint8* messageData, int numBytes);
+
+    // Audio thread. Hands changes read since the last call to the message thread,
+    // or keeps them for the next call if the message thread is reading the last ones.
+    void sendChanges();
+
+    // Applies SysEx data, without the F0 and F7 bytes, to the table.
+    // Returns false and leaves the table unchanged if the data isn't a supported MTS message,
+    // is for another device, or is a bulk dump with a wrong checksum.
+    static bool applySysEx(const juce::uint8* data, int size, NoteTable& table, int deviceId = allDevices);
+
+    static std::shared_ptr<TuningTable> createTuning(const NoteTable& table);
+
+private:
+
+    // juce::Timer implementation
+    void timerCallback() override;
+
+    void postTuning(int buildId, std::shared_ptr<TuningTable> tuning);
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(MtsSysExReceiver)
+};
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    PitchQuantiser.cpp
+    Created: 20 Oct 2026 5:32:07am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "PitchQuantiser.h"
+
+namespace
+{
+    const int numSteps = 128 * PitchQuantiser::stepsPerSemitone + 1;
+}
+
+PitchQuantiser::PitchQuantiser(const MappedTuningTable& tuning)
+{
+    for (int i = 0; i < tuning.getTableSize(); i++)
+    {
+        auto mts = tuning.mtsAt(i);
+        if (mts >= 0 && mts <= 128)
+            degrees.add(mts);
+    }
+
+    std::sort(degrees.begin(), degrees.end());
+
+    // Degrees less than a step apart would never be chosen
+    for (int i = degrees.size() - 1; i > 0; i--)
+    {
+        if (degrees[i] - degrees[i - 1] < 1.0 / stepsPerSemitone)
+            degrees.remove(i);
+    }
+
+    if (degrees.size() == 0)
+        return;
+
+    nearestDegree.resize(numSteps);
+
+    int degree = 0;
+    for (int step = 0; step < numSteps; step++)
+    {
+        auto mts = (double)step / stepsPerSemitone;
+        while (degree < degrees.size() - 1 && mts > upperBoundary(degree))
+            degree++;
+
+        nearestDegree.set(step, degree);
+    }
+}
+
+double PitchQuantiser::lowerBoundary(int degree) const
+{
+    if (degree <= 0)
+        return std::numeric_limits<double>::lowest();
+
+    return (degrees[degree - 1] + degrees[degree]) * 0.5;
+}
+
+double PitchQuantiser::upperBoundary(int degree) const
+{
+    if (degree >= degrees.size() - 1)
+        return std::numeric_limits<double>::max();
+
+    return (degrees[degree] + degrees[degree + 1]) * 0.5;
+}
+
+int PitchQuantiser::nearestDegreeTo(double mts) const
+{
+    if (isEmpty())
+        return -1;
+
+    auto step = juce::jlimit(0, numSteps - 1, (int)std::floor(mts * stepsPerSemitone));
+    auto degree = nearestDegree[step];
+
+    // Steps are narrower than the space between degrees, so the pitch is at most one degree away
+    if (mts > upperBoundary(degree))
+        degree++;
+
+    return degree;
+}
+
+int PitchQuantiser::quantise(double mts, int currentDegree, double hysteresisSemitones) const
+{
+    if (currentDegree >= 0 && currentDegree < degrees.size()
+        && mts >= lowerBoundary(currentDegree) - hysteresisSemitones
+        && mts <= upperBoundary(currentDegree) + hysteresisSemitones)
+        return currentDegree;
+
+    return nearestDegreeTo(mts);
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    PitchQuantiser.h
+    Created: 20 Oct 2026 5:32:07am
+    Author:  Vincenzo
+
+    Snaps continuous pitch to the nearest degree of a tuning, in constant time.
+
+    The degrees are the pitches of the tuning table between MTS 0 and 128.
+    A table over that range, in steps of 1/64 semitone, holds the nearest
+    degree to each step, which is then checked against the neighbouring
+    degrees, so a lookup never searches the tuning.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "./tuning/MappedTuning.h"
+
+class PitchQuantiser
+{
+public:
+
+    static const int stepsPerSemitone = 64;
+
+private:
+
+    juce::Array<double> degrees;        /* Sorted pitches of the tuning */
+    juce::Array<int> nearestDegree;     /* The degree nearest to the start of each step */
+
+private:
+
+    // Pitch halfway between a degree and the one below it
+    double lowerBoundary(int degree) const;
+    double upperBoundary(int degree) const;
+
+public:
+
+    PitchQuantiser() {}
+    PitchQuantiser(const MappedTuningTable& tuning);
+
+    bool isEmpty() const { return degrees.size() == 0; }
+
+    int getNumDegrees() const { return degrees.size(); }
+
+    double mtsOfDegree(int degree) const { return degrees[degree]; }
+
+    // The degree nearest to a pitch, or -1 if there are none
+    int nearestDegreeTo(double mts) const;
+
+    // Keeps the current degree until the pitch is past the boundary with the next degree by the hysteresis
+    int quantise(double mts, int currentDegree, double hysteresisSemitones) const;
+};
@@ -47,8 +47,15 @@ MultimapperAudioProcessorEditor::MultimapperAudioProcessorEditor (MultimapperAud
     optionsPanel = std::make_unique<OptionsPanel>(audioProcessor.options());
     optionsPanel->addOptionsWatcher(this);
     addChildComponent(*optionsPanel);
+
+    scaleLibraryPanel = std::make_unique<ScaleLibraryPanel>();
+    scaleLibraryPanel->setLibrary(audioProcessor.getScaleLibrary(), audioProcessor.getScaleLibraryDirectory());
+    scaleLibraryPanel->onScaleChosen = [&](juce::File file) { audioProcessor.importTuningTarget(file); };
+    scaleLibraryPanel->onRescan = [&]() { rescanScaleLibrary(); };
+    addChildComponent(*scaleLibraryPanel);
     
     audioProcessor.addTunerControllerWatcher(this);
+    audioProcessor.addTuningImportListener(this);
 
     contentComponent = overviewPanel.get();
 
@@ -76,7 +83,10 @@ MultimapperAudioProcessorEditor::~MultimapperAudioProcessorEditor()
     logger->setCallback([](juce::StringRef) {});
 #endif
 
+    audioProcessor.removeTuningImportListener(this);
+
     logWindow = nullptr;
+    scaleLibraryPanel = nullptr;
     optionsPanel = nullptr;
     newTuningPanel = nullptr;
     overviewPanel = nullptr;
@@ -172,7 +182,7 @@ void MultimapperAudioProcessorEditor::mpeZoneChanged(Everytone::MpeZone zone)
 
 void MultimapperAudioProcessorEditor::midiModeChanged(Everytone::MidiMode newMidiMode)
 {
-    
+    audioProcessor.midiMode(newMidiMode);
 }
 
 void MultimapperAudioProcessorEditor::voiceLimitChanged(int newVoiceLimit)
@@ -186,11 +196,27 @@ void MultimapperAudioProcessorEditor::pitchbendRangeChanged(int pitchbendRange)
     optionsPanel->setPitchbendRangeText(audioProcessor.pitchbendRange());
 }
 
+void MultimapperAudioProcessorEditor::inputPitchbendRangeChanged(int pitchbendRange)
+{
+    audioProcessor.inputPitchbendRange(pitchbendRange);
+    optionsPanel->setInputPitchbendRangeText(audioProcessor.inputPitchbendRange());
+}
+
 void MultimapperAudioProcessorEditor::bendModeChanged(Everytone::BendMode newBendMode)
 {
     audioProcessor.bendMode(newBendMode);
 }
 
+void MultimapperAudioProcessorEditor::sharedTuningModeChanged(Everytone::SharedTuningMode mode)
+{
+    audioProcessor.sharedTuningMode(mode);
+}
+
+void MultimapperAudioProcessorEditor::inputPitchModeChanged(Everytone::InputPitchMode mode)
+{
+    audioProcessor.inputPitchMode(mode);
+}
+
 juce::ApplicationCommandTarget* MultimapperAudioProcessorEditor::getFirstCommandTarget(juce::CommandID commandID)
 {
     switch (commandID)
@@ -216,7 +242,9 @@ void MultimapperAudioProcessorEditor::getAllCommands(juce::Array<juce::CommandID
         Everytone::NewTuning,
         Everytone::OpenTuning,
         Everytone::EditReference,
-        Everytone::ShowOptions
+        Everytone::ShowOptions,
+        Everytone::CaptureMidi,
+        Everytone::ScaleLibrary
     };
 }
 
@@ -267,6 +295,18 @@ void MultimapperAudioProcessorEditor::getCommandInfo(juce::CommandID commandID,
         result.addDefaultKeypress('p', juce::ModifierKeys::ctrlModifier);
         break;
 
+    case Everytone::CaptureMidi:
+        result = juce::ApplicationCommandInfo(Everytone::Commands::CaptureMidi);
+        result.setInfo("Capture MIDI", "Record MIDI input to a file that can be replayed for profiling", "Options", 0);
+        result.setTicked(audioProcessor.isCapturingMidi());
+        break;
+
+    case Everytone::ScaleLibrary:
+        result = juce::ApplicationCommandInfo(Everytone::Commands::ScaleLibrary);
+        result.setInfo("Scale Library", "Search the .scl files in the scale folder", "Scale", 0);
+        result.addDefaultKeypress('l', juce::ModifierKeys::ctrlModifier);
+        break;
+
     default:
         // Forgot to add commandInfo?
         jassertfalse;
@@ -302,6 +342,12 @@ bool MultimapperAudioProcessorEditor::perform(const juce::ApplicationCommandTarg
         setContentComponent(optionsPanel.get());
         return true;
 
+    case Everytone::CaptureMidi:
+        return performCaptureMidi(info);
+
+    case Everytone::ScaleLibrary:
+        return performScaleLibrary(info);
+
     default:
         // forgot to add command handler?
         jassertfalse;
@@ -348,27 +394,103 @@ bool MultimapperAudioProcessorEditor::performSave(const juce::ApplicationCommand
 
 bool MultimapperAudioProcessorEditor::performOpenTuning(const juce::ApplicationCommandTarget::InvocationInfo& info)
 {
-    fileChooser = std::make_unique<juce::FileChooser>("Choose a .scl or .tun file", juce::File() /* TODO */, "*.scl;*.tun");
+    fileChooser = std::make_unique<juce::FileChooser>("Choose a .scl, .tun, .msf, or .kbm file", juce::File() /* TODO */, "*.scl;*.tun;*.msf;*.kbm");
     fileChooser->launchAsync(
         juce::FileBrowserComponent::FileChooserFlags::openMode | juce::FileBrowserComponent::FileChooserFlags::canSelectFiles,
         [&](const juce::FileChooser& chooser)
         {
             auto result = chooser.getResult();
-            if (result.existsAsFile())
+            if (!result.existsAsFile())
+                return;
+
+            // Keyboard mappings apply to the current tuning
+            if (result.hasFileExtension("kbm"))
             {
-                TuningFileParser parser(result);
-                auto tuning = parser.getTuning();
-                if (tuning != nullptr)
-                {
-                    audioProcessor.setTuningTarget(tuning);
+                juce::String error;
+                if (audioProcessor.loadTargetKeyboardMapping(result, error))
                     setContentComponent(overviewPanel.get());
-                }
+                else
+                    infoBar->setStatusMessage("Error loading " + result.getFileName() + ": " + error);
+                return;
             }
+
+            audioProcessor.importTuningTarget(result);
         });
 
     return true;
 }
 
+bool MultimapperAudioProcessorEditor::performCaptureMidi(const juce::ApplicationCommandTarget::InvocationInfo& info)
+{
+    if (audioProcessor.isCapturingMidi())
+    {
+        auto file = audioProcessor.getMidiCaptureFile();
+        audioProcessor.stopMidiCapture();
+        infoBar->setStatusMessage("Saved MIDI capture to " + file.getFullPathName());
+    }
+    else
+    {
+        auto folder = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("Everytone Tuner").getChildFile("Captures");
+        folder.createDirectory();
+
+        auto name = "capture-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S");
+        auto file = folder.getNonexistentChildFile(name, ".etmc", false);
+
+        juce::String error;
+        if (audioProcessor.startMidiCapture(file, error))
+            infoBar->setStatusMessage("Capturing MIDI to " + file.getFileName());
+        else
+            infoBar->setStatusMessage("Error capturing MIDI: " + error);
+    }
+
+    commandStatusChanged();
+    return true;
+}
+
+bool MultimapperAudioProcessorEditor::performScaleLibrary(const juce::ApplicationCommandTarget::InvocationInfo& info)
+{
+    setContentComponent(scaleLibraryPanel.get());
+    rescanScaleLibrary();
+    return true;
+}
+
+void MultimapperAudioProcessorEditor::rescanScaleLibrary()
+{
+    scaleLibraryPanel->setScanning(true);
+
+    // The panel may be gone by the time the scan finishes
+    juce::Component::SafePointer<ScaleLibraryPanel> panel(scaleLibraryPanel.get());
+    auto directory = audioProcessor.getScaleLibraryDirectory();
+
+    audioProcessor.rescanScaleLibrary([panel, directory](std::shared_ptr<const ScaleLibrary> library)
+    {
+        if (panel == nullptr)
+            return;
+
+        panel->setLibrary(library, directory);
+        panel->setScanning(false);
+    });
+}
+
+void MultimapperAudioProcessorEditor::tuningImportProgressed(TuningFileImporter* importer, const juce::File& file, float progress)
+{
+    infoBar->setStatusMessage("Loading " + file.getFileName() + "... " + juce::String(juce::roundToInt(progress * 100)) + "%");
+}
+
+void MultimapperAudioProcessorEditor::tuningImportFinished(TuningFileImporter* importer, const TuningFileImporter::Result& result)
+{
+    if (result.wasSuccessful())
+    {
+        setContentComponent(overviewPanel.get());
+        return;
+    }
+
+    if (result.wasCancelled)
+        infoBar->setDisplayedTuning(audioProcessor.currentTarget());
+    else
+        infoBar->setStatusMessage("Error loading " + result.request.file.getFileName() + ": " + result.parsed.error);
+}
+
 void MultimapperAudioProcessorEditor::commitTuning(CentsDefinition tuningDefinition)
 {
     audioProcessor.loadTuningTarget(tuningDefinition);
@@ -16,6 +16,7 @@
 #include "ui/NewTuningPanel.h"
 #include "ui/MappingPanel.h"
 #include "ui/OptionsPanel.h"
+#include "ui/ScaleLibraryPanel.h"
 #include "io/TuningFileParser.h"
 
 //==============================================================================
@@ -26,7 +27,8 @@ class MultimapperAudioProcessorEditor  : public juce::AudioProcessorEditor,
                                          public juce::ApplicationCommandTarget,
                                          public TunerController::Watcher,
                                          public TuningWatcher,
-                                         public OptionsWatcher
+                                         public OptionsWatcher,
+                                         public TuningFileImporter::Listener
 {
 public:
     MultimapperAudioProcessorEditor (MultimapperAudioProcessor&);
@@ -69,7 +71,16 @@ public:
     void midiModeChanged(Everytone::MidiMode newMidiMode) override;
     void voiceLimitChanged(int newVoiceLimit) override;
     void pitchbendRangeChanged(int pitchbendRange) override;
+    void inputPitchbendRangeChanged(int pitchbendRange) override;
     void bendModeChanged(Everytone::BendMode newBendMode) override;
+    void sharedTuningModeChanged(Everytone::SharedTuningMode mode) override;
+    void inputPitchModeChanged(Everytone::InputPitchMode mode) override;
+
+    //==============================================================================
+    // TuningFileImporter::Listener implementation
+
+    void tuningImportProgressed(TuningFileImporter* importer, const juce::File& file, float progress) override;
+    void tuningImportFinished(TuningFileImporter* importer, const TuningFileImporter::Result& result) override;
 
     //==============================================================================
     // ApplicationCommandManager implementation
@@ -92,6 +103,10 @@ public:
 
     bool performOpenTuning(const juce::ApplicationCommandTarget::InvocationInfo& info);
 
+    bool performCaptureMidi(const juce::ApplicationCommandTarget::InvocationInfo& info);
+
+    bool performScaleLibrary(const juce::ApplicationCommandTarget::InvocationInfo& info);
+
     //==============================================================================
 
     void commitTuning(CentsDefinition tuningDefinition);
@@ -102,6 +117,9 @@ private:
 
     void setupCommands();
 
+    // Shows the scanned library in the panel when the scan finishes
+    void rescanScaleLibrary();
+
 private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -120,6 +138,7 @@ private:
     std::unique_ptr<NewTuningPanel> newTuningPanel;
     std::unique_ptr<MappingPanel> mappingPanel;
     std::unique_ptr<OptionsPanel> optionsPanel;
+    std::unique_ptr<ScaleLibraryPanel> scaleLibraryPanel;
 
 
     std::unique_ptr<juce::FileChooser> fileChooser;
@@ -10,11 +10,37 @@
 #include "PluginEditor.h"
 #include "TuningHelpers.h"
 
+// everytone-batch builds the processor without the plugin client, to replay MIDI captures
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name                 "Everytone Tuner"
+ #define JucePlugin_WantsMidiInput       1
+ #define JucePlugin_ProducesMidiOutput   1
+ #define JucePlugin_IsMidiEffect         1
+ #define JucePlugin_IsSynth              0
+#endif
+
 #if RUN_MULTIMAPPER_TESTS
     #include "./tests/Map_Test_Generator.h"
     #include "./tests/MultichannelMap_Test.h"
     #include "./tests/Tuning_tests.h"
     #include "./tests/MidiNoteTuner_tests.h"
+    #include "./tests/UmpEncoder_tests.h"
+    #include "./tests/AdaptiveJustTuner_tests.h"
+    #include "./tests/PitchQuantiser_tests.h"
+    #include "./tests/Portamento_tests.h"
+    #include "./tests/MidiOutputScheduler_tests.h"
+    #include "./tests/TuningFileImporter_tests.h"
+    #include "./tests/ScaleLibrary_tests.h"
+    #include "./tests/TuningBundle_tests.h"
+    #include "./tests/ScalaBufferParser_tests.h"
+    #include "./tests/FormulaProgram_tests.h"
+    #include "./tests/TuningFileWriter_tests.h"
+    #include "./tests/TuningFileParser_tests.h"
+    #include "./tests/MtsSysExReceiver_tests.h"
+    #include "./tests/MidiVoiceController_tests.h"
+    #include "./tests/SharedTuning_tests.h"
+    #include "./tests/MidiCaptureLog_tests.h"
+    #include "./tests/MidiFileRetuner_tests.h"
 #endif
 
 
@@ -23,6 +49,10 @@ MultimapperAudioProcessor::MultimapperAudioProcessor()
     : tunerController(std::make_unique<TunerController>()),
       voiceController(std::make_unique<MidiVoiceController>(*tunerController)),
       voiceInterpolator(std::make_unique<MidiVoiceInterpolator>(*voiceController, Everytone::BendMode::Persistent)),
+      outputScheduler(std::make_unique<MidiOutputScheduler>()),
+      tuningImporter(std::make_unique<TuningFileImporter>()),
+      mtsReceiver(std::make_unique<MtsSysExReceiver>()),
+      midiCapture(std::make_unique<MidiCaptureWriter>()),
 
 #ifndef JucePlugin_PreferredChannelConfigurations
      AudioProcessor (BusesProperties()
@@ -40,6 +70,14 @@ MultimapperAudioProcessor::MultimapperAudioProcessor()
     juce::Logger::setCurrentLogger(logger.get());
 #endif
 
+    // Added first so that the tuning is loaded before other listeners are called
+    tuningImporter->addListener(this);
+    mtsReceiver->addListener(this);
+    tunerController->addWatcher(this);
+
+    chordNoteOns.ensureStorageAllocated(MULTIMAPPER_MAX_POLY_VOICES);
+    processedBuffer.ensureSize(4096);
+
 
 #if RUN_MULTIMAPPER_TESTS
     DBG("Running tests...");
@@ -48,12 +86,46 @@ MultimapperAudioProcessor::MultimapperAudioProcessor()
     MultichannelMap_Test multichannelMapTest;
     FunctionalTuning_Test tuningTest;
     MidiNoteTuner_Test midiNoteTunerTest;
+    UmpEncoder_Test umpEncoderTest;
+    AdaptiveJustTuner_Test adaptiveJustTunerTest;
+    PitchQuantiser_Test pitchQuantiserTest;
+    Portamento_Test portamentoTest;
+    MidiOutputScheduler_Test outputSchedulerTest;
+    TuningFileImporter_Test tuningImporterTest;
+    ScaleLibrary_Test scaleLibraryTest;
+    TuningBundle_Test tuningBundleTest;
+    ScalaBufferParser_Test scalaParserTest;
+    FormulaProgram_Test formulaProgramTest;
+    TuningFileWriter_Test tuningFileWriterTest;
+    TuningFileParser_Test tuningFileParserTest;
+    MtsSysExReceiver_Test mtsSysExReceiverTest;
+    MidiVoiceController_Test midiVoiceControllerTest;
+    SharedTuning_Test sharedTuningTest;
+    MidiCaptureLog_Test midiCaptureLogTest;
+    MidiFileRetuner_Test midiFileRetunerTest;
 
     auto tests = juce::Array<juce::UnitTest*>();
     mapTests.addToTests(tests);
     tests.add(&multichannelMapTest);
     tests.add(&tuningTest);
     tests.add(&midiNoteTunerTest);
+    tests.add(&umpEncoderTest);
+    tests.add(&adaptiveJustTunerTest);
+    tests.add(&pitchQuantiserTest);
+    tests.add(&portamentoTest);
+    tests.add(&outputSchedulerTest);
+    tests.add(&tuningImporterTest);
+    tests.add(&scaleLibraryTest);
+    tests.add(&tuningBundleTest);
+    tests.add(&scalaParserTest);
+    tests.add(&formulaProgramTest);
+    tests.add(&tuningFileWriterTest);
+    tests.add(&tuningFileParserTest);
+    tests.add(&mtsSysExReceiverTest);
+    tests.add(&midiVoiceControllerTest);
+    tests.add(&sharedTuningTest);
+    tests.add(&midiCaptureLogTest);
+    tests.add(&midiFileRetunerTest);
 
     juce::UnitTestRunner tester;
     tester.runTests(tests);
@@ -64,6 +136,14 @@ MultimapperAudioProcessor::MultimapperAudioProcessor()
 
 MultimapperAudioProcessor::~MultimapperAudioProcessor()
 {
+    scaleLibraryPool.removeAllJobs(true, 10000);
+
+    midiCapture = nullptr;
+    tuningImporter = nullptr;
+    mtsReceiver = nullptr;
+    sharedTuningClient = nullptr;
+    sharedTuningMaster = nullptr;
+
     juce::Logger::setCurrentLogger(nullptr);
     logger = nullptr;
 
@@ -138,6 +218,9 @@ void MultimapperAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
+    currentSampleRate = sampleRate;
+    voiceController->setSampleRate(sampleRate);
+    outputScheduler->reset(sampleRate);
 }
 
 void MultimapperAudioProcessor::releaseResources()
@@ -200,7 +283,10 @@ void MultimapperAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         // ..do something to the data...
     }
 
-    tuneMidiBuffer(midiMessages);
+    if (midiCapture->isActive())
+        captureMidiBlock(midiMessages, buffer.getNumSamples());
+
+    tuneMidiBuffer(midiMessages, buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -312,9 +398,22 @@ MultimapperLog* MultimapperAudioProcessor::getLog() const
     return logger.get();
 }
 
-void MultimapperAudioProcessor::tuneMidiBuffer(juce::MidiBuffer& buffer)
+void MultimapperAudioProcessor::captureMidiBlock(const juce::MidiBuffer& buffer, int blockSize)
 {
-    juce::MidiBuffer processedBuffer;
+    // Hashing reads every pitch, so it's only done when the tuner changes
+    auto& tuner = tunerController->getTuner();
+    if (capturedTuner.owner_before(tuner) || tuner.owner_before(capturedTuner))
+    {
+        capturedTuner = tuner;
+        capturedTunerHash = MidiCaptureLog::hashTuner(*tuner);
+    }
+
+    midiCapture->addBlock(buffer, blockSize, currentSampleRate, capturedTunerHash);
+}
+
+void MultimapperAudioProcessor::tuneMidiBuffer(juce::MidiBuffer& buffer, int blockSize)
+{
+    processedBuffer.clear();
     int sample = 0;
 
     // Update active voices
@@ -323,54 +422,73 @@ void MultimapperAudioProcessor::tuneMidiBuffer(juce::MidiBuffer& buffer)
     {
         if (voice.getAssignedChannel() >= 0)
         {
-            processedBuffer.addEvent(voice.getPitchbend(), sample++);
+            // A limited link sends refreshes when it has time
+            if (outputScheduler->isLimited())
+                outputScheduler->addRefresh(voice.getPitchbend());
+            else
+                processedBuffer.addEvent(voice.getPitchbend(), sample++);
         }
         else
             jassertfalse;
     }
 
-    // Process new messages
+    // Held voices follow tuning changes in Dynamic and Adaptive modes
+    auto sharedTableChanged = sharedTuningUpdated.exchange(false);
+    auto currentBendMode = voiceInterpolator->getBendMode();
+    if (currentBendMode == Everytone::BendMode::Dynamic || currentBendMode == Everytone::BendMode::Adaptive)
+    {
+        voiceController->retuneActiveVoices(processedBuffer, sample, sharedTableChanged);
+    }
+
+    voiceController->startAdaptiveBlock(processedBuffer, sample);
+
+    if (currentSampleRate > 0)
+        voiceController->advanceGlides(blockSize * 1000.0 / currentSampleRate, processedBuffer, sample);
+
+    // Process new messages. Note ons at the same sample are collected, and
+    // tuned together before any other message.
+    chordNoteOns.clearQuick();
+    int chordPosition = -1;
+
     for (auto metadata : buffer)
     {
         auto msg = metadata.getMessage();
-        auto status = msg.getRawData()[0];
-        bool isVoice = status >= 0x80 && status < 0xb0;
+        bool joinsChord = msg.isNoteOn() && metadata.samplePosition == chordPosition
+                       && chordNoteOns.size() < MULTIMAPPER_MAX_POLY_VOICES;
 
-        if (isVoice)
+        if (chordNoteOns.size() > 0 && !joinsChord)
         {
-            const MidiVoice* voice = nullptr;
-            if (msg.isNoteOn())
-            {
-                // Check if voice already exists??
-                voice = voiceController->addVoice(msg);
-                if (voice == nullptr)
-                    continue;
-
-                auto pbmsg = voice->getPitchbend();
-
-                if (pbmsg.getPitchWheelValue() != 8192)
-                {
-                    processedBuffer.addEvent(pbmsg, sample++);
-                }
-            }
-            else
-            {
-                voice = voiceController->getVoice(msg);
-                if (voice == nullptr)
-                    continue;
-            }
-
-            voice->mapMidiMessage(msg);
-
-            if (msg.isNoteOff())
-            {
-                voiceController->removeVoice(voice);
-            }
+            voiceController->tuneChord(chordNoteOns, processedBuffer, sample);
+            chordNoteOns.clearQuick();
+        }
+
+        if (msg.isNoteOn())
+        {
+            chordNoteOns.add(msg);
+            chordPosition = metadata.samplePosition;
+            continue;
         }
 
-        processedBuffer.addEvent(msg, sample++);
+        // MTS messages retune the target tuning instead of being passed on
+        if (mtsReceiver->readSysEx(metadata.data, metadata.numBytes))
+        {
+            voiceController->setMtsRetuning(true);
+            continue;
+        }
+
+        voiceController->tuneMessage(msg, processedBuffer, sample);
     }
 
+    if (chordNoteOns.size() > 0)
+        voiceController->tuneChord(chordNoteOns, processedBuffer, sample);
+
+    // Slides started in this block begin after its note ons
+    voiceController->advancePortamento(blockSize, processedBuffer, sample);
+
+    mtsReceiver->sendChanges();
+
+    outputScheduler->schedule(processedBuffer, blockSize);
+
     buffer.swapWith(processedBuffer);
 }
 
@@ -400,11 +518,19 @@ Everytone::Options MultimapperAudioProcessor::options() const
         tunerController->getMappingType(),
         voiceController->getChannelMode(),
         voiceController->getMpeZone(),
-        Everytone::MidiMode::Mono,
+        voiceController->getMidiMode(),
         Everytone::VoiceRule::Ignore,
         voiceInterpolator->getBendMode(),
         voiceController->getVoiceLimit(),
-        tunerController->getPitchbendRange()
+        tunerController->getPitchbendRange(),
+        voiceController->getInputPitchbendRange(),
+        sharedTuning,
+        voiceController->getInputPitchMode(),
+        voiceController->getQuantiseHysteresis(),
+        voiceController->getQuantiseGlide(),
+        voiceController->getPortamentoTime(),
+        voiceController->getPortamentoThreshold(),
+        outputScheduler->getBaudRate()
     };
 }
 
@@ -430,6 +556,143 @@ void MultimapperAudioProcessor::setTuningTarget(std::shared_ptr<TuningTable> tar
     tunerController->setTargetTuning(targetTuning);
 }
 
+void MultimapperAudioProcessor::importTuningTarget(juce::File file, juce::File keyboardMappingFile)
+{
+    TuningFileImporter::Request request =
+    {
+        file,
+        tunerController->getMappingMode() == Everytone::MappingMode::Auto,
+        tunerController->getTargetMapRoot(),
+        tunerController->getMappingType(),
+        keyboardMappingFile,
+        tunerController->shareTuningSource(),
+        tunerController->getPitchbendRange(),
+        tunerController->readTuningTarget()->getFrequencyReference()
+    };
+
+    tuningImporter->importFile(request);
+}
+
+void MultimapperAudioProcessor::cancelTuningImport()
+{
+    tuningImporter->cancel();
+}
+
+juce::File MultimapperAudioProcessor::getScaleLibraryDirectory() const
+{
+    return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("Everytone Tuner").getChildFile("Scales");
+}
+
+void MultimapperAudioProcessor::rescanScaleLibrary(std::function<void(std::shared_ptr<const ScaleLibrary>)> onFinished)
+{
+    auto directory = getScaleLibraryDirectory();
+    auto indexFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                        .getChildFile("Everytone Tuner").getChildFile("ScaleLibrary.index");
+
+    scaleLibraryPool.addJob([this, directory, indexFile, onFinished]()
+    {
+        auto library = std::make_shared<ScaleLibrary>(*getScaleLibrary());
+
+        // Only files that changed since the last session are parsed
+        if (library->getNumEntries() == 0 && library->getNumFailedFiles() == 0)
+            library->loadIndex(indexFile);
+
+        directory.createDirectory();
+        library->scanDirectory(directory);
+
+        indexFile.getParentDirectory().createDirectory();
+        library->saveIndex(indexFile);
+
+        std::shared_ptr<const ScaleLibrary> scanned = library;
+        std::atomic_store(&scaleLibrary, scanned);
+
+        juce::MessageManager::callAsync([onFinished, scanned]() { onFinished(scanned); });
+    });
+}
+
+bool MultimapperAudioProcessor::loadTargetKeyboardMapping(juce::File keyboardMappingFile, juce::String& error)
+{
+    ScalaBufferParser::KeyboardMapping keyboardMapping;
+    if (!TuningFileParser::parseKeyboardMappingFile(keyboardMappingFile, keyboardMapping, error))
+        return false;
+
+    auto tuning = tunerController->readTuningTarget()->shareTuning();
+    auto mapping = TuningFileParser::applyKeyboardMapping(keyboardMapping, tuning);
+
+    // The keyboard mapping sets its own reference, so the mapping shouldn't be transposed to another one
+    tunerController->setMappingMode(Everytone::MappingMode::Manual);
+    tunerController->setTargetTuning(tuning, mapping, MappedTuningTable::FrequencyReference());
+    return true;
+}
+
+void MultimapperAudioProcessor::tuningImportFinished(TuningFileImporter* importer, const TuningFileImporter::Result& result)
+{
+    if (!result.wasSuccessful())
+        return;
+
+    // An imported tuning replaces one received over MTS
+    voiceController->setMtsRetuning(false);
+
+    // Only use the prebuilt tuner if the source and pitchbend range didn't change during the import
+    bool tunerIsCurrent = result.tuner != nullptr
+                       && tunerController->readTuningSource() == result.request.source.get()
+                       && tunerController->getPitchbendRange() == result.request.pitchbendRange;
+
+    if (result.hasFileMapping())
+    {
+        tunerController->setMappingMode(Everytone::MappingMode::Manual);
+
+        if (tunerIsCurrent)
+            tunerController->setTargetMappedTuning(result.target, result.tuner);
+        else
+            tunerController->setTargetTuning(result.parsed.tuning, result.mapping, MappedTuningTable::FrequencyReference());
+        return;
+    }
+
+    // Only use the prebuilt mapping if the mapping settings didn't change during the import
+    bool mappingIsCurrent = result.mapping != nullptr
+                         && tunerController->getMappingMode() == Everytone::MappingMode::Auto
+                         && tunerController->getMappingType() == result.request.mappingType
+                         && tunerController->getTargetMapRoot() == result.request.mappingRoot;
+
+    if (mappingIsCurrent && tunerIsCurrent && tunerController->readTuningTarget()->getFrequencyReference() == result.request.targetReference)
+        tunerController->setTargetMappedTuning(result.target, result.tuner);
+    else if (mappingIsCurrent)
+        tunerController->setTargetTuning(result.parsed.tuning, result.mapping);
+    else
+        tunerController->setTargetTuning(result.parsed.tuning);
+}
+
+void MultimapperAudioProcessor::mtsTuningReceived(MtsSysExReceiver* receiver, std::shared_ptr<TuningTable> tuning)
+{
+    // Received tables are tuned by MIDI note, so they're mapped one to one
+    auto mapping = std::make_shared<TuningTableMap>(TuningTableMap::StandardMappingDefinition());
+
+    tunerController->setMappingMode(Everytone::MappingMode::Manual);
+    tunerController->setTargetTuning(tuning, mapping, MappedTuningTable::FrequencyReference());
+}
+
+void MultimapperAudioProcessor::targetTuningChanged(const std::shared_ptr<MappedTuningTable>& target)
+{
+    if (sharedTuningMaster != nullptr)
+        sharedTuningMaster->publish(*target);
+
+    captureTunerState();
+}
+
+void MultimapperAudioProcessor::sharedTuningConnected(SharedTuningClient* client, std::shared_ptr<MappedTuningTable> tuning)
+{
+    // The master's tuning is already mapped
+    tunerController->setMappingMode(Everytone::MappingMode::Manual);
+    tunerController->setTargetMappedTuning(tuning);
+}
+
+void MultimapperAudioProcessor::sharedTuningChanged(SharedTuningClient* client)
+{
+    // The tuner already reads the new tables
+    sharedTuningUpdated = true;
+}
+
 void MultimapperAudioProcessor::setTargetTuningReference(MappedTuningTable::FrequencyReference reference)
 {
     tunerController->setTargetReference(reference);
@@ -480,14 +743,143 @@ void MultimapperAudioProcessor::voiceLimit(int voiceLimit)
     voiceController->setVoiceLimit(voiceLimit);
 }
 
+void MultimapperAudioProcessor::midiMode(Everytone::MidiMode mode)
+{
+    voiceController->setMidiMode(mode);
+}
+
 void MultimapperAudioProcessor::pitchbendRange(int pitchbendRange)
 {
     tunerController->setPitchbendRange(pitchbendRange);
+    captureTunerState();
+}
+
+void MultimapperAudioProcessor::inputPitchbendRange(int pitchbendRange)
+{
+    voiceController->setInputPitchbendRange(pitchbendRange);
 }
 
 void MultimapperAudioProcessor::bendMode(Everytone::BendMode bendMode)
 {
     voiceInterpolator->setBendMode(bendMode);
+    voiceController->setBendMode(bendMode);
+}
+
+void MultimapperAudioProcessor::sharedTuningMode(Everytone::SharedTuningMode mode)
+{
+    if (mode == sharedTuning)
+        return;
+
+    // Keep the last shared tuning, but copy it out of the segment
+    if (sharedTuningClient != nullptr)
+    {
+        bool connected = sharedTuningClient->isConnected();
+        sharedTuningClient = nullptr;
+
+        if (connected)
+        {
+            auto target = tunerController->readTuningTarget();
+            auto copy = std::make_shared<TuningTable>(target->getTuning()->getDefinition());
+            tunerController->setTargetTuning(copy, target->shareMapping(), target->getFrequencyReference());
+        }
+    }
+
+    sharedTuningMaster = nullptr;
+    sharedTuning = mode;
+
+    switch (mode)
+    {
+    case Everytone::SharedTuningMode::Master:
+        sharedTuningMaster = std::make_unique<SharedTuningSegment>(SharedTuningSegment::defaultName, SharedTuningSegment::Access::Publish);
+        if (!sharedTuningMaster->isOpen())
+        {
+            juce::Logger::writeToLog("Could not create shared tuning " + juce::String(SharedTuningSegment::defaultName));
+            sharedTuningMaster = nullptr;
+            return;
+        }
+
+        sharedTuningMaster->publish(*tunerController->readTuningTarget());
+        break;
+
+    case Everytone::SharedTuningMode::Client:
+        sharedTuningClient = std::make_unique<SharedTuningClient>();
+        sharedTuningClient->addListener(this);
+        break;
+
+    default:
+        break;
+    }
+
+    juce::Logger::writeToLog("Shared tuning mode set to " + juce::String((int)mode));
+}
+
+void MultimapperAudioProcessor::inputPitchMode(Everytone::InputPitchMode mode)
+{
+    voiceController->setInputPitchMode(mode);
+}
+
+void MultimapperAudioProcessor::quantiseHysteresis(int cents)
+{
+    voiceController->setQuantiseHysteresis(cents);
+}
+
+void MultimapperAudioProcessor::quantiseGlide(int ms)
+{
+    voiceController->setQuantiseGlide(ms);
+}
+
+void MultimapperAudioProcessor::portamentoTime(int ms)
+{
+    voiceController->setPortamentoTime(ms);
+}
+
+void MultimapperAudioProcessor::portamentoThreshold(int cents)
+{
+    voiceController->setPortamentoThreshold(cents);
+}
+
+void MultimapperAudioProcessor::outputBaudRate(int bitsPerSecond)
+{
+    outputScheduler->setBaudRate(bitsPerSecond);
+}
+
+bool MultimapperAudioProcessor::startMidiCapture(juce::File file, juce::String& error)
+{
+    MidiCaptureLog::State state;
+    state.tunerHash = tunerStateHash();
+    getStateInformation(state.data);
+
+    capturedTunerStates.clearQuick();
+    capturedTunerStates.add(state.tunerHash);
+
+    return midiCapture->start(file, state, error);
+}
+
+void MultimapperAudioProcessor::stopMidiCapture()
+{
+    midiCapture->stop();
+}
+
+juce::uint64 MultimapperAudioProcessor::tunerStateHash() const
+{
+    return MidiCaptureLog::hashTuner(*tunerController->getTuner());
+}
+
+void MultimapperAudioProcessor::captureTunerState()
+{
+    if (!midiCapture->isActive())
+        return;
+
+    auto hash = tunerStateHash();
+    if (capturedTunerStates.contains(hash))
+        return;
+
+    capturedTunerStates.add(hash);
+
+    MidiCaptureLog::State state;
+    state.tunerHash = hash;
+    getStateInformation(state.data);
+    midiCapture->addState(state);
 }
 
 void MultimapperAudioProcessor::options(Everytone::Options optionsIn)
@@ -496,6 +888,15 @@ void MultimapperAudioProcessor::options(Everytone::Options optionsIn)
     mappingMode(optionsIn.mappingMode);
     channelMode(optionsIn.channelMode);
     bendMode(optionsIn.bendMode);
+    midiMode(optionsIn.midiMode);
     voiceLimit(optionsIn.voiceLimit);
     pitchbendRange(optionsIn.pitchbendRange);
+    inputPitchbendRange(optionsIn.inputPitchbendRange);
+    sharedTuningMode(optionsIn.sharedTuning);
+    inputPitchMode(optionsIn.inputPitchMode);
+    quantiseHysteresis(optionsIn.quantiseHysteresis);
+    quantiseGlide(optionsIn.quantiseGlide);
+    portamentoTime(optionsIn.portamentoTime);
+    portamentoThreshold(optionsIn.portamentoThreshold);
+    outputBaudRate(optionsIn.outputBaudRate);
 }
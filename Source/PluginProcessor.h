@@ -12,6 +12,12 @@
 #include "TunerController.h"
 #include "MidiVoiceController.h"
 #include "MidiVoiceInterpolator.h"
+#include "MidiOutputScheduler.h"
+#include "MtsSysExReceiver.h"
+#include "SharedTuning.h"
+#include "io/TuningFileImporter.h"
+#include "io/ScaleLibrary.h"
+#include "io/MidiCaptureLog.h"
 
 class MultimapperLog : public juce::Logger
 {
@@ -36,7 +42,9 @@ public:
 //==============================================================================
 /**
 */
-class MultimapperAudioProcessor  : public juce::AudioProcessor, public TuningChanger
+class MultimapperAudioProcessor  : public juce::AudioProcessor, public TuningChanger,
+                                   private TuningFileImporter::Listener, private MtsSysExReceiver::Listener,
+                                   private TunerController::Watcher, private SharedTuningClient::Listener
 {
 public:
     //==============================================================================
@@ -95,6 +103,25 @@ public:
     void setTuningSource(std::shared_ptr<TuningTable> sourceTuning);
     void setTuningTarget(std::shared_ptr<TuningTable> targetTuning);
 
+    // Reads the file on a background thread, and sets it as the target tuning when finished.
+    // If a Scala keyboard mapping is given, it's used as the mapping instead of the mapping mode.
+    void importTuningTarget(juce::File file, juce::File keyboardMappingFile = juce::File());
+    void cancelTuningImport();
+
+    // Maps the current target tuning with a Scala keyboard mapping, and switches to manual mapping
+    bool loadTargetKeyboardMapping(juce::File keyboardMappingFile, juce::String& error);
+
+    // Scala files in the user's scale folder, which can be loaded with importTuningTarget
+    std::shared_ptr<const ScaleLibrary> getScaleLibrary() const { return std::atomic_load(&scaleLibrary); }
+    juce::File getScaleLibraryDirectory() const;
+
+    // Scans the scale folder on a background thread, starting from the saved index.
+    // The callback gets the new library on the message thread.
+    void rescanScaleLibrary(std::function<void(std::shared_ptr<const ScaleLibrary>)> onFinished);
+
+    void addTuningImportListener(TuningFileImporter::Listener* listener) { tuningImporter->addListener(listener); }
+    void removeTuningImportListener(TuningFileImporter::Listener* listener) { tuningImporter->removeListener(listener); }
+
     void setTargetTuningReference(MappedTuningTable::FrequencyReference reference);
     void setTargetTuningRootFrequency(double frequency);
     void setTargetMappingRoot(TuningTableMap::Root root);
@@ -122,18 +149,87 @@ public:
     int voiceLimit() const { return voiceController->getVoiceLimit(); }
     void voiceLimit(int voiceLimit);
 
+    Everytone::MidiMode midiMode() const { return voiceController->getMidiMode(); }
+    void midiMode(Everytone::MidiMode mode);
+
     int pitchbendRange() const { return tunerController->getPitchbendRange(); }
     void pitchbendRange(int pitchbendRange);
 
+    int inputPitchbendRange() const { return voiceController->getInputPitchbendRange(); }
+    void inputPitchbendRange(int pitchbendRange);
+
     Everytone::BendMode bendMode() const { return voiceInterpolator->getBendMode(); }
     void bendMode(Everytone::BendMode bendMode);
 
+    Everytone::SharedTuningMode sharedTuningMode() const { return sharedTuning; }
+    void sharedTuningMode(Everytone::SharedTuningMode mode);
+
+    Everytone::InputPitchMode inputPitchMode() const { return voiceController->getInputPitchMode(); }
+    void inputPitchMode(Everytone::InputPitchMode mode);
+
+    int quantiseHysteresis() const { return voiceController->getQuantiseHysteresis(); }
+    void quantiseHysteresis(int cents);
+
+    int quantiseGlide() const { return voiceController->getQuantiseGlide(); }
+    void quantiseGlide(int ms);
+
+    int portamentoTime() const { return voiceController->getPortamentoTime(); }
+    void portamentoTime(int ms);
+
+    int portamentoThreshold() const { return voiceController->getPortamentoThreshold(); }
+    void portamentoThreshold(int cents);
+
+    int outputBaudRate() const { return outputScheduler->getBaudRate(); }
+    void outputBaudRate(int bitsPerSecond);
+
+    // Queueing delay of output on a limited link
+    const MidiOutputScheduler& getOutputScheduler() const { return *outputScheduler; }
+
+    //==============================================================================
+
+    // Records the MIDI input of every block to the file until stopped, to be replayed with MidiCaptureReplay
+    bool startMidiCapture(juce::File file, juce::String& error);
+    void stopMidiCapture();
+
+    bool isCapturingMidi() const { return midiCapture->isActive(); }
+    juce::File getMidiCaptureFile() const { return midiCapture->getFile(); }
+
+    // Identifies the current source and target pitches and pitchbend range
+    juce::uint64 tunerStateHash() const;
+
     //==============================================================================
 
 
 private:
 
-    void tuneMidiBuffer(juce::MidiBuffer& buffer);
+    void tuneMidiBuffer(juce::MidiBuffer& buffer, int blockSize);
+
+    // Audio thread
+    void captureMidiBlock(const juce::MidiBuffer& buffer, int blockSize);
+
+    // Adds the current state to the capture, if it produces a tuner that wasn't captured yet
+    void captureTunerState();
+
+    //==============================================================================
+    // TuningFileImporter::Listener implementation
+
+    void tuningImportFinished(TuningFileImporter* importer, const TuningFileImporter::Result& result) override;
+
+    //==============================================================================
+    // MtsSysExReceiver::Listener implementation
+
+    void mtsTuningReceived(MtsSysExReceiver* receiver, std::shared_ptr<TuningTable> tuning) override;
+
+    //==============================================================================
+    // TunerController::Watcher implementation
+
+    void targetTuningChanged(const std::shared_ptr<MappedTuningTable>& target) override;
+
+    //==============================================================================
+    // SharedTuningClient::Listener implementation
+
+    void sharedTuningConnected(SharedTuningClient* client, std::shared_ptr<MappedTuningTable> tuning) override;
+    void sharedTuningChanged(SharedTuningClient* client) override;
 
     //void testMidi();
 
@@ -142,6 +238,36 @@ private:
     std::unique_ptr<TunerController> tunerController;
     std::unique_ptr<MidiVoiceController> voiceController;
     std::unique_ptr<MidiVoiceInterpolator> voiceInterpolator;
+    std::unique_ptr<MidiOutputScheduler> outputScheduler;
+
+    std::unique_ptr<TuningFileImporter> tuningImporter;
+    std::unique_ptr<MtsSysExReceiver> mtsReceiver;
+
+    // Replaced by each rescan, which works on a copy
+    std::shared_ptr<const ScaleLibrary> scaleLibrary = std::make_shared<ScaleLibrary>();
+    juce::ThreadPool scaleLibraryPool { 1 };
+
+    Everytone::SharedTuningMode sharedTuning = Everytone::SharedTuningMode::Off;
+    std::unique_ptr<SharedTuningSegment> sharedTuningMaster;
+    std::unique_ptr<SharedTuningClient> sharedTuningClient;
+
+    // Set when the master published a change, so held voices read the shared tuning again
+    std::atomic<bool> sharedTuningUpdated { false };
+
+    std::unique_ptr<MidiCaptureWriter> midiCapture;
+    juce::Array<juce::uint64> capturedTunerStates;
+
+    // Audio thread. A weak pointer keeps the address of the captured tuner from being reused by a new one.
+    std::weak_ptr<MidiNoteTuner> capturedTuner;
+    juce::uint64 capturedTunerHash = 0;
+
+    double currentSampleRate = 44100.0;
+
+    // Audio thread. Note ons at the same sample, allocated together.
+    juce::Array<juce::MidiMessage> chordNoteOns;
+
+    // Audio thread. Swapped with the host's buffer after each block, so both keep their storage.
+    juce::MidiBuffer processedBuffer;
     
     std::unique_ptr<MultimapperLog> logger;
 
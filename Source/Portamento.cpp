@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    Portamento.cpp
+    Created: 20 Oct 2026 6:41:23am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "Portamento.h"
+
+void Portamento::start(int channelIndex, double fromSemitones, int lengthSamples)
+{
+    if (channelIndex < 0 || channelIndex >= maxChannels)
+        return;
+
+    auto& ramp = ramps[channelIndex];
+    ramp = Ramp();
+
+    if (lengthSamples <= 0 || fromSemitones == 0)
+        return;
+
+    ramp.from = fromSemitones;
+    ramp.length = lengthSamples;
+    ramp.sent = fromSemitones;
+}
+
+void Portamento::stop(int channelIndex)
+{
+    if (channelIndex >= 0 && channelIndex < maxChannels)
+        ramps[channelIndex] = Ramp();
+}
+
+void Portamento::setThreshold(double cents)
+{
+    threshold = juce::jmax(0.1, cents) * 0.01;
+}
+
+double Portamento::offsetAt(const Ramp& ramp, int position) const
+{
+    if (position >= ramp.length)
+        return 0;
+
+    return ramp.from * (1.0 - (double)position / ramp.length);
+}
+
+int Portamento::nextBendPosition(const Ramp& ramp) const
+{
+    if (std::abs(ramp.sent) <= threshold)
+        return ramp.length;
+
+    // The ramp moves towards zero, so the next pitch is the threshold closer to it
+    auto nextOffset = ramp.sent - std::copysign(threshold, ramp.from);
+    auto position = (int)std::ceil(ramp.length * (1.0 - nextOffset / ramp.from));
+
+    return juce::jlimit(ramp.sentPosition + 1, ramp.length, position);
+}
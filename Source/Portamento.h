@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+    Portamento.h
+    Created: 20 Oct 2026 6:41:23am
+    Author:  Vincenzo
+
+    Pitch ramps of output channels, from the pitch of the previous note to the
+    pitch of a new one.
+
+    A ramp only asks for a new pitchbend when the last one sent is the
+    threshold away from the ramp, so a slow or short slide sends few messages.
+    The sample of each pitchbend is solved from the ramp directly, and ramps
+    are kept in a fixed array, so advancing a block never searches or allocates.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+class Portamento
+{
+public:
+
+    static const int maxChannels = 16;
+
+private:
+
+    struct Ramp
+    {
+        double from = 0;        // Semitones from the target pitch at the start
+        int length = 0;         // Samples, zero if inactive
+        int position = 0;       // Samples elapsed at the start of the next block
+        int sentPosition = 0;   // Sample of the last pitchbend
+        double sent = 0;        // Semitones from the target pitch of the last pitchbend
+    };
+
+    std::array<Ramp, maxChannels> ramps;
+
+    double threshold = 0.05; // Semitones
+
+private:
+
+    double offsetAt(const Ramp& ramp, int position) const;
+
+    // The sample of the ramp where the last pitchbend will be the threshold away
+    int nextBendPosition(const Ramp& ramp) const;
+
+public:
+
+    Portamento() {}
+
+    // Starts a ramp on a channel, the pitchbend of the start being sent with the note
+    void start(int channelIndex, double fromSemitones, int lengthSamples);
+
+    void stop(int channelIndex);
+
+    bool isActive(int channelIndex) const { return ramps[channelIndex].length > 0; }
+
+    // Semitones from the target pitch of the last pitchbend of a channel
+    double getOffset(int channelIndex) const { return ramps[channelIndex].sent; }
+
+    double getThreshold() const { return threshold * 100.0; }
+
+    // Largest difference in cents between the sent pitch and the ramp
+    void setThreshold(double cents);
+
+    // Moves every ramp through a block, calling onBend(channelIndex, sample, offsetSemitones)
+    // at each sample of the block that needs a new pitchbend. The last one of a ramp has an offset of zero.
+    template <typename Callback>
+    void advance(int numSamples, Callback onBend)
+    {
+        for (int ch = 0; ch < maxChannels; ch++)
+        {
+            auto& ramp = ramps[ch];
+            if (ramp.length == 0)
+                continue;
+
+            auto blockStart = ramp.position;
+            auto blockEnd = blockStart + numSamples;
+
+            for (auto next = nextBendPosition(ramp); next < blockEnd; next = nextBendPosition(ramp))
+            {
+                ramp.sentPosition = next;
+                ramp.sent = offsetAt(ramp, next);
+                onBend(ch, next - blockStart, ramp.sent);
+
+                if (next >= ramp.length)
+                {
+                    ramp = Ramp();
+                    break;
+                }
+            }
+
+            if (ramp.length > 0)
+                ramp.position = blockEnd;
+        }
+    }
+};
@@ -0,0 +1,502 @@
+/*
+  ==============================================================================
+
+    SharedTuning.cpp
+    Created: 20 Oct 2026 12:41:07am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "SharedTuning.h"
+
+#include <array>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+#else
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <signal.h>
+ #include <errno.h>
+#endif
+
+// Only lock-free atomics can be shared between processes
+static_assert(std::atomic<double>::is_always_lock_free, "Shared tuning needs lock-free doubles");
+static_assert(std::atomic<juce::uint32>::is_always_lock_free, "Shared tuning needs a lock-free sequence");
+static_assert(std::atomic<juce::uint64>::is_always_lock_free, "Shared tuning needs a lock-free master claim");
+
+struct SharedTuningSegment::Layout
+{
+    std::atomic<juce::uint32> magic;
+    std::atomic<juce::uint32> sequence;
+    std::atomic<juce::uint64> master;   /* Process ID and instance of the master, 0 if there is none */
+    std::array<std::atomic<char>, nameLength> name;
+    std::array<std::atomic<double>, tableSize> frequencies;
+    std::array<std::atomic<double>, tableSize> mts;
+};
+
+namespace
+{
+    // "ETS2", changed whenever the layout changes
+    const juce::uint32 layoutMagic = 0x45545332;
+
+    // The layout version is part of the object name, so a segment left by an older
+    // version is never opened with this layout. New segments are zeroed.
+    juce::String objectName(const juce::String& name)
+    {
+        return name + "-2";
+    }
+
+    juce::uint32 currentProcessId()
+    {
+#if JUCE_WINDOWS
+        return (juce::uint32)GetCurrentProcessId();
+#else
+        return (juce::uint32)getpid();
+#endif
+    }
+
+    bool processIsRunning(juce::uint32 processId)
+    {
+        if (processId == currentProcessId())
+            return true;
+
+#if JUCE_WINDOWS
+        auto process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)processId);
+        if (process == nullptr)
+            return false;
+
+        bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return running;
+#else
+        return kill((pid_t)processId, 0) == 0 || errno == EPERM;
+#endif
+    }
+
+    // Several instances of the plugin can be loaded in one process
+    juce::uint64 newMasterClaim()
+    {
+        static std::atomic<juce::uint32> instances { 0 };
+        return ((juce::uint64)currentProcessId() << 32) | ++instances;
+    }
+}
+
+const char* SharedTuningSegment::defaultName = "everytone-tuning";
+
+SharedTuningSegment::SharedTuningSegment(const juce::String& name, Access access)
+    : segmentName(name)
+{
+    const bool publish = access == Access::Publish;
+    const auto size = sizeof(Layout);
+    void* address = nullptr;
+
+#if JUCE_WINDOWS
+    auto mappingName = "Local\\" + objectName(name);
+    if (publish)
+        mappingHandle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)size, mappingName.toWideCharPointer());
+    else
+        mappingHandle = OpenFileMappingW(FILE_MAP_READ, FALSE, mappingName.toWideCharPointer());
+
+    if (mappingHandle == nullptr)
+        return;
+
+    address = MapViewOfFile(mappingHandle, publish ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (address == nullptr)
+    {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+        return;
+    }
+#else
+    auto mappingName = "/" + objectName(name);
+    auto fileDescriptor = publish ? shm_open(mappingName.toRawUTF8(), O_CREAT | O_RDWR, 0600)
+                                  : shm_open(mappingName.toRawUTF8(), O_RDONLY, 0);
+    if (fileDescriptor < 0)
+        return;
+
+    struct stat status;
+    bool sizeIsValid = publish ? ftruncate(fileDescriptor, (off_t)size) == 0
+                               : fstat(fileDescriptor, &status) == 0 && (size_t)status.st_size >= size;
+
+    if (sizeIsValid)
+        address = mmap(nullptr, size, publish ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fileDescriptor);
+
+    if (address == nullptr || address == MAP_FAILED)
+        return;
+#endif
+
+    layout = static_cast<Layout*>(address);
+    mappedSize = size;
+
+    if (!publish)
+        return;
+
+    if (!claimMaster())
+    {
+        juce::Logger::writeToLog("Shared tuning " + name + " already has a master");
+        close();
+        return;
+    }
+
+    // Clients don't read the segment until it's marked
+    layout->magic.store(layoutMagic, std::memory_order_release);
+}
+
+SharedTuningSegment::~SharedTuningSegment()
+{
+    close();
+}
+
+bool SharedTuningSegment::claimMaster()
+{
+    auto claim = newMasterClaim();
+    auto current = layout->master.load(std::memory_order_acquire);
+
+    // A master that crashed can't release its claim, so it's taken over
+    while (current == 0 || !processIsRunning((juce::uint32)(current >> 32)))
+    {
+        if (layout->master.compare_exchange_weak(current, claim, std::memory_order_acq_rel))
+        {
+            masterClaim = claim;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SharedTuningSegment::close()
+{
+    if (layout == nullptr)
+        return;
+
+    // Another instance can become the master, and clients keep the last published tuning
+    if (masterClaim != 0)
+    {
+        auto claim = masterClaim;
+        layout->master.compare_exchange_strong(claim, 0, std::memory_order_acq_rel);
+        masterClaim = 0;
+    }
+
+#if JUCE_WINDOWS
+    UnmapViewOfFile(layout);
+    CloseHandle(mappingHandle);
+    mappingHandle = nullptr;
+#else
+    // The segment isn't unlinked, so that clients and later masters keep using the same one
+    munmap(layout, mappedSize);
+#endif
+
+    layout = nullptr;
+    mappedSize = 0;
+}
+
+void SharedTuningSegment::remove(const juce::String& name)
+{
+#if ! JUCE_WINDOWS
+    auto mappingName = "/" + objectName(name);
+    shm_unlink(mappingName.toRawUTF8());
+#endif
+}
+
+bool SharedTuningSegment::publish(const MappedTuningTable& tuning)
+{
+    if (layout == nullptr || layout->master.load(std::memory_order_acquire) != masterClaim)
+        return false;
+
+    // Stays odd while writing, also if a master crashed and left it odd
+    auto sequence = layout->sequence.load(std::memory_order_relaxed);
+    auto writing = (sequence & 1) ? sequence + 2 : sequence + 1;
+    layout->sequence.store(writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto tuningName = tuning.getTuning()->getName();
+    auto name = tuningName.toRawUTF8();
+    bool ended = false;
+    for (int i = 0; i < nameLength - 1; i++)
+    {
+        ended = ended || name[i] == '\0';
+        layout->name[i].store(ended ? '\0' : name[i], std::memory_order_relaxed);
+    }
+    layout->name[nameLength - 1].store('\0', std::memory_order_relaxed);
+
+    for (int ch = 0; ch < 16; ch++)
+    {
+        for (int note = 0; note < 128; note++)
+        {
+            auto mts = tuning.mtsAt(note, ch + 1);
+            layout->frequencies[ch * 128 + note].store(mts < 0 ? 0.0 : mtsToFrequency(mts), std::memory_order_relaxed);
+            layout->mts[ch * 128 + note].store(mts, std::memory_order_relaxed);
+        }
+    }
+
+    layout->sequence.store(writing + 1, std::memory_order_release);
+    return true;
+}
+
+juce::uint32 SharedTuningSegment::getSequence() const
+{
+    if (layout == nullptr || layout->magic.load(std::memory_order_acquire) != layoutMagic)
+        return 0;
+
+    return layout->sequence.load(std::memory_order_acquire);
+}
+
+bool SharedTuningSegment::readValue(const std::atomic<double>* table, int index, double& value) const
+{
+    if (getSequence() == 0)
+        return false;
+
+    for (int attempt = 0; attempt < maxReadAttempts; attempt++)
+    {
+        auto before = layout->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+
+        auto read = table[index].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (layout->sequence.load(std::memory_order_relaxed) == before)
+        {
+            value = read;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SharedTuningSegment::readTable(const std::atomic<double>* table, juce::Array<double>& values) const
+{
+    if (getSequence() == 0)
+        return false;
+
+    values.resize(tableSize);
+    for (int attempt = 0; attempt < maxReadAttempts; attempt++)
+    {
+        auto before = layout->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+
+        for (int i = 0; i < tableSize; i++)
+            values.setUnchecked(i, table[i].load(std::memory_order_relaxed));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (layout->sequence.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+
+    return false;
+}
+
+bool SharedTuningSegment::readMts(int midiNote, int midiChannel, double& mts) const
+{
+    return layout != nullptr && readValue(layout->mts.data(), (midiChannel - 1) * 128 + midiNote, mts);
+}
+
+bool SharedTuningSegment::readFrequency(int midiNote, int midiChannel, double& frequency) const
+{
+    return layout != nullptr && readValue(layout->frequencies.data(), (midiChannel - 1) * 128 + midiNote, frequency);
+}
+
+bool SharedTuningSegment::readMtsTable(juce::Array<double>& table) const
+{
+    return layout != nullptr && readTable(layout->mts.data(), table);
+}
+
+bool SharedTuningSegment::readFrequencyTable(juce::Array<double>& table) const
+{
+    return layout != nullptr && readTable(layout->frequencies.data(), table);
+}
+
+bool SharedTuningSegment::readName(juce::String& tuningName, juce::uint32& sequence) const
+{
+    if (getSequence() == 0)
+        return false;
+
+    std::array<char, nameLength> name;
+    for (int attempt = 0; attempt < maxReadAttempts; attempt++)
+    {
+        auto before = layout->sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            continue;
+
+        for (int i = 0; i < nameLength; i++)
+            name[i] = layout->name[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (layout->sequence.load(std::memory_order_relaxed) == before)
+        {
+            name[nameLength - 1] = '\0';
+            tuningName = juce::String(name.data());
+            sequence = before;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+
+SharedTuningTable::SharedTuningTable(std::shared_ptr<const SharedTuningSegment> segmentIn, const juce::String& name)
+    : TuningTable(TuningTable::Definition
+        {
+            juce::Array<double>(),
+            69,
+            name.isEmpty() ? juce::String("Shared") : name,
+            "Shared by another Everytone Tuner instance.",
+            juce::String(),
+            0,
+            0
+        }),
+      segment(segmentIn)
+{
+    // Each channel and note has its own entry, and none are cached
+    setTableSize(SharedTuningSegment::tableSize);
+}
+
+juce::Array<double> SharedTuningTable::getFrequencyTable() const
+{
+    juce::Array<double> table;
+    if (!segment->readFrequencyTable(table))
+        table.fill(0.0);
+    return table;
+}
+
+juce::Array<double> SharedTuningTable::getMtsTable() const
+{
+    juce::Array<double> table;
+    if (!segment->readMtsTable(table))
+        table.fill(-1.0);
+    return table;
+}
+
+double SharedTuningTable::getRootFrequency() const
+{
+    return frequencyAt(rootIndex);
+}
+
+double SharedTuningTable::getRootMts() const
+{
+    return mtsAt(rootIndex);
+}
+
+double SharedTuningTable::centsAt(int index) const
+{
+    return ratioToCents(frequencyAt(index) / getRootFrequency());
+}
+
+double SharedTuningTable::frequencyAt(int index) const
+{
+    auto tableIndex = mod(index, SharedTuningSegment::tableSize);
+    double frequency = 0;
+    if (!segment->readFrequency(tableIndex % 128, tableIndex / 128 + 1, frequency))
+        return 0;
+    return frequency;
+}
+
+double SharedTuningTable::mtsAt(int index) const
+{
+    auto tableIndex = mod(index, SharedTuningSegment::tableSize);
+    double mts = -1;
+    if (!segment->readMts(tableIndex % 128, tableIndex / 128 + 1, mts))
+        return -1;
+    return mts;
+}
+
+int SharedTuningTable::closestIndexToFrequency(double frequency) const
+{
+    auto frequencies = getFrequencyTable();
+
+    double difference, discrepancy = 10e10;
+    int closestIndex = -1;
+    for (int i = 0; i < frequencies.size(); i++)
+    {
+        difference = abs(roundN(8, frequency - frequencies[i]));
+        if (difference < discrepancy)
+        {
+            discrepancy = difference;
+            closestIndex = i;
+        }
+    }
+    return closestIndex;
+}
+
+//==============================================================================
+
+SharedTuningClient::SharedTuningClient(const juce::String& segmentNameIn)
+    : segmentName(segmentNameIn)
+{
+    startTimer(updateRateMs);
+}
+
+SharedTuningClient::~SharedTuningClient()
+{
+    stopTimer();
+    listeners.clear();
+}
+
+std::shared_ptr<MappedTuningTable> SharedTuningClient::createTuning(std::shared_ptr<const SharedTuningSegment> segment, const juce::String& name)
+{
+    // The segment is kept mapped while the tuning reads it
+    auto table = std::make_shared<SharedTuningTable>(segment, name);
+
+    // Each channel and note reads its own entry
+    TuningTableMap::Definition mapDefinition =
+    {
+        TuningTableMap::Root { 1, 69 },
+        Map<int>::FromGenerator(SharedTuningSegment::tableSize, 0, [](int x) { return x; })
+    };
+
+    return std::make_shared<MappedTuningTable>(table, std::make_shared<TuningTableMap>(mapDefinition));
+}
+
+void SharedTuningClient::poll()
+{
+    // The master may be started after clients
+    if (segment == nullptr)
+    {
+        auto opened = std::make_shared<SharedTuningSegment>(segmentName, SharedTuningSegment::Access::Read);
+        if (!opened->isOpen())
+            return;
+
+        segment = opened;
+        juce::Logger::writeToLog("Opened shared tuning " + segmentName);
+    }
+
+    auto sequence = segment->getSequence();
+    if (sequence == lastSequence || (sequence & 1))
+        return;
+
+    juce::String name;
+    if (!segment->readName(name, sequence))
+        return;
+
+    lastSequence = sequence;
+
+    if (tuning == nullptr)
+    {
+        tuning = createTuning(segment, name);
+        listeners.call(&Listener::sharedTuningConnected, this, tuning);
+        return;
+    }
+
+    // Only the name is copied, notes are already read from the segment
+    tuning->getTuning()->setName(name.isEmpty() ? juce::String("Shared") : name);
+    listeners.call(&Listener::sharedTuningChanged, this);
+}
+
+void SharedTuningClient::timerCallback()
+{
+    poll();
+}
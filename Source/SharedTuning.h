@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    SharedTuning.h
+    Created: 20 Oct 2026 12:41:07am
+    Author:  Vincenzo
+
+    Shares one target tuning between plugin instances through a named
+    shared memory segment. The master instance publishes the frequency and
+    pitch of every MIDI channel and note of its target tuning, and client
+    instances read them from the segment at note-on instead of building their own tables.
+
+    The segment is written with a seqlock: the sequence is odd while the
+    master is writing, and readers retry if it changed while they read.
+    Readers never lock, and the master never waits for readers.
+    Only one instance can be the master of a segment at a time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "./tuning/MappedTuning.h"
+
+class SharedTuningSegment
+{
+public:
+
+    enum class Access
+    {
+        Publish = 0,    /* Creates the segment if needed, claims it, and writes to it */
+        Read            /* Opens an existing segment read-only */
+    };
+
+    static const int nameLength = 64;
+    static const int tableSize = 16 * 128;
+
+    // Name of the segment that instances share by default
+    static const char* defaultName;
+
+private:
+
+    struct Layout;
+
+    Layout* layout = nullptr;
+    size_t mappedSize = 0;
+    juce::String segmentName;
+
+    // Identifies this instance in the segment while it is the master, 0 otherwise
+    juce::uint64 masterClaim = 0;
+
+#if JUCE_WINDOWS
+    void* mappingHandle = nullptr;
+#endif
+
+    // Readers give up if the master is writing for this many attempts, such as if it crashed while writing
+    static const int maxReadAttempts = 64;
+
+public:
+
+    // A Publish segment is only open if no other live instance is the master
+    SharedTuningSegment(const juce::String& name, Access access);
+    ~SharedTuningSegment();
+
+    bool isOpen() const { return layout != nullptr; }
+
+    bool isMaster() const { return masterClaim != 0; }
+
+    juce::String getName() const { return segmentName; }
+
+    // Removes the name of a segment, instances that have it open keep using it.
+    // Windows removes a segment once its last instance closes it, so this does nothing there.
+    static void remove(const juce::String& name);
+
+    // Master only. Writes every note of every channel, and returns false if this isn't the master.
+    bool publish(const MappedTuningTable& tuning);
+
+    // Changes every time a tuning is published, and is 0 until the first one
+    juce::uint32 getSequence() const;
+
+    // Lock-free. Returns false if nothing was published, or if a consistent value couldn't be read.
+    // Unmapped notes are read as -1, as in MappedTuningTable::mtsAt, and their frequency as 0.
+    bool readMts(int midiNote, int midiChannel, double& mts) const;
+    bool readFrequency(int midiNote, int midiChannel, double& frequency) const;
+
+    // Every channel and note of one published tuning, indexed by (midiChannel - 1) * 128 + midiNote
+    bool readMtsTable(juce::Array<double>& table) const;
+    bool readFrequencyTable(juce::Array<double>& table) const;
+
+    // Name of the published tuning, and the sequence it was read at
+    bool readName(juce::String& tuningName, juce::uint32& sequence) const;
+
+private:
+
+    bool readValue(const std::atomic<double>* table, int index, double& value) const;
+    bool readTable(const std::atomic<double>* table, juce::Array<double>& values) const;
+
+    bool claimMaster();
+
+    void close();
+
+    JUCE_DECLARE_NON_COPYABLE(SharedTuningSegment)
+};
+
+// Reads every value through the segment's seqlock, so it follows the master without being rebuilt.
+// Values that can't be read consistently, such as if the master crashed while writing, are unmapped.
+class SharedTuningTable : public TuningTable
+{
+    std::shared_ptr<const SharedTuningSegment> segment;
+
+public:
+
+    SharedTuningTable(std::shared_ptr<const SharedTuningSegment> segment, const juce::String& name);
+
+    // TuningTable implementation
+
+    virtual juce::Array<double> getFrequencyTable() const override;
+    virtual juce::Array<double> getMtsTable() const override;
+
+    virtual double getRootFrequency() const override;
+    virtual double getRootMts() const override;
+
+    virtual double centsAt(int index) const override;
+    virtual double frequencyAt(int index) const override;
+    virtual double mtsAt(int index) const override;
+
+    virtual int closestIndexToFrequency(double frequency) const override;
+};
+
+class SharedTuningClient : private juce::Timer
+{
+public:
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        // Called on the message thread once the master published. The tuning reads
+        // the segment at every lookup, so it follows every later change without being rebuilt.
+        virtual void sharedTuningConnected(SharedTuningClient* client, std::shared_ptr<MappedTuningTable> tuning) {}
+
+        // Called on the message thread when the master published a change
+        virtual void sharedTuningChanged(SharedTuningClient* client) {}
+    };
+
+private:
+
+    juce::String segmentName;
+    std::shared_ptr<SharedTuningSegment> segment;
+    std::shared_ptr<MappedTuningTable> tuning;
+
+    juce::uint32 lastSequence = 0;
+
+    juce::ListenerList<Listener> listeners;
+
+    int updateRateMs = 20;
+
+public:
+
+    SharedTuningClient(const juce::String& segmentName = SharedTuningSegment::defaultName);
+    ~SharedTuningClient();
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    // False until a master published
+    bool isConnected() const { return tuning != nullptr; }
+
+    // Checks the segment for a new tuning, called by the timer
+    void poll();
+
+    // A tuning of every channel and note, indexed like the segment
+    static std::shared_ptr<MappedTuningTable> createTuning(std::shared_ptr<const SharedTuningSegment> segment, const juce::String& name);
+
+private:
+
+    // juce::Timer implementation
+    void timerCallback() override;
+};
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    TableView.h
+    Created: 19 Oct 2026 10:12:00am
+    Author:  Vincenzo
+
+    A read-only, non-owning view over contiguous table storage, used like
+    std::string_view. std::span would fit, but it is C++20 and the project
+    builds as C++17.
+    Views are invalidated when the table that owns the storage is rebuilt.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+template <typename T>
+class TableView
+{
+    const T* tableData = nullptr;
+    int tableSize = 0;
+
+public:
+
+    TableView() {}
+
+    TableView(const T* dataIn, int sizeIn)
+        : tableData(dataIn), tableSize((dataIn == nullptr) ? 0 : sizeIn) {}
+
+    const T* data() const { return tableData; }
+
+    int size() const { return tableSize; }
+
+    bool isEmpty() const { return tableSize == 0; }
+
+    const T& operator[](int index) const { return tableData[index]; }
+
+    const T* begin() const { return tableData; }
+    const T* end() const { return tableData + tableSize; }
+
+    // A view of part of the table, clamped to its bounds like std::string_view::substr
+    TableView subview(int offset, int count) const
+    {
+        offset = juce::jlimit(0, tableSize, offset);
+        count = juce::jlimit(0, tableSize - offset, count);
+        return TableView(tableData + offset, count);
+    }
+
+    // Returns a default value if the index is out of bounds, like juce::Array
+    T at(int index) const
+    {
+        if (index < 0 || index >= tableSize)
+            return T();
+        return tableData[index];
+    }
+};
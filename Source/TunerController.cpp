@@ -112,6 +112,18 @@ void TunerController::setTunings(std::shared_ptr<TuningTable> sourceTuning, std:
     setTunings(sourceTuning, sourceMapping, targetTuning, targetMapping, true);
 }
 
+void TunerController::setTargetMappedTuning(std::shared_ptr<MappedTuningTable> mappedTuning)
+{
+    setTarget(mappedTuning, true);
+}
+
+void TunerController::setTargetMappedTuning(std::shared_ptr<MappedTuningTable> mappedTuning, std::shared_ptr<MidiNoteTuner> tuner)
+{
+    setTarget(mappedTuning, false);
+    currentTuner = tuner;
+    watchers.call(&Watcher::targetTuningChanged, currentTuningTarget);
+}
+
 void TunerController::remapSource(const TuningTableMap::Definition& mapDefinition)
 {
     auto newMapping = std::make_shared<TuningTableMap>(mapDefinition);
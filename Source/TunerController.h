@@ -69,6 +69,8 @@ public:
     const MappedTuningTable* readTuningSource() const { return currentTuningSource.get(); }
     const MappedTuningTable* readTuningTarget() const { return currentTuningTarget.get(); }
 
+    std::shared_ptr<MappedTuningTable> shareTuningSource() const { return currentTuningSource; }
+
     Everytone::MappingMode getMappingMode() const { return mappingMode; }
     Everytone::MappingType getMappingType() const { return mappingType; }
 
@@ -101,6 +103,12 @@ public:
     void setTunings(std::shared_ptr<TuningTable> sourceTuning, std::shared_ptr<TuningTableMap> sourceMapping, MappedTuningTable::FrequencyReference sourceReference,
                     std::shared_ptr<TuningTable> targetTuning, std::shared_ptr<TuningTableMap> targetMapping, MappedTuningTable::FrequencyReference targetReference);
 
+    // For target tunings that are already mapped, such as one shared by another instance
+    void setTargetMappedTuning(std::shared_ptr<MappedTuningTable> mappedTuning);
+
+    // For tuners that were already built from the current source and this target, such as by TuningFileImporter
+    void setTargetMappedTuning(std::shared_ptr<MappedTuningTable> mappedTuning, std::shared_ptr<MidiNoteTuner> tuner);
+
 
     // Mutators
 
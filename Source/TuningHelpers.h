@@ -54,8 +54,11 @@ static juce::ValueTree tuningTableToValueTree(const TuningTable* tuning, juce::V
     tree.setProperty(Everytone::ID::VirtualPeriod, tuning->getVirtualPeriod(), nullptr);
     tree.setProperty(Everytone::ID::VirtualSize, tuning->getVirtualSize(), nullptr);
 
-    auto frequencies = tuning->getFrequencyTable();
-    auto frequencyNode = arrayToValueTree(frequencies, Everytone::ID::FrequencyTable, Everytone::ID::Frequency);
+    // Walk the cached table if there is one, otherwise the tuning will have to build a copy
+    auto frequencies = tuning->getFrequencyTableView();
+    auto frequencyNode = (frequencies.isEmpty())
+        ? arrayToValueTree(tuning->getFrequencyTable(), Everytone::ID::FrequencyTable, Everytone::ID::Frequency)
+        : arrayToValueTree(frequencies, Everytone::ID::FrequencyTable, Everytone::ID::Frequency);
     tree.addChild(frequencyNode, 0, nullptr);
 
     return tree;
@@ -69,7 +72,7 @@ static juce::ValueTree functionalTuningToValueTree(const FunctionalTuning* tunin
 
     tuningTableToValueTree(tuning, tree);
 
-    auto intervals = tuning->getIntervalCentsList();
+    auto intervals = tuning->getIntervalCentsView();
     auto intervalTree = arrayToValueTree(intervals, Everytone::ID::CentsTable, Everytone::ID::Cents);
     tree.addChild(intervalTree, 0, nullptr);
 
@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+    UmpEncoder.cpp
+    Created: 19 Oct 2026 11:38:15pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "UmpEncoder.h"
+
+namespace
+{
+    const int noteOffStatus = 0x8;
+    const int noteOnStatus = 0x9;
+    const int perNotePitchbendStatus = 0x6;
+
+    const int sysExComplete = 0x0;
+    const int sysExStart = 0x1;
+    const int sysExContinue = 0x2;
+    const int sysExEnd = 0x3;
+    const int sysExBytesPerPacket = 6;
+
+    // Release velocity that MIDI 1.0 implies for a note-on with a velocity of 0
+    const int defaultNoteOffVelocity = 64;
+
+    // Size of MIDI 1.0 messages by their status byte, or 0 if not supported
+    int midi1MessageSize(juce::uint8 status)
+    {
+        switch (status >> 4)
+        {
+        case 0xc:
+        case 0xd:
+            return 2;
+
+        case 0xf:
+            switch (status)
+            {
+            case 0xf1:
+            case 0xf3:
+                return 2;
+            case 0xf2:
+                return 3;
+            case 0xf6:
+            case 0xf8:
+            case 0xfa:
+            case 0xfb:
+            case 0xfc:
+            case 0xfe:
+            case 0xff:
+                return 1;
+            default:
+                return 0;
+            }
+
+        default:
+            return 3;
+        }
+    }
+}
+
+UmpEncoder::UmpEncoder(std::shared_ptr<MappedTuningTable> tuningIn, PitchMode mode, int groupIn)
+    : tuning(tuningIn),
+      pitchMode(mode),
+      group(groupIn & 0xf)
+{
+    jassert(tuning != nullptr);
+    notes.fill(NoteState());
+}
+
+void UmpEncoder::setTuning(std::shared_ptr<MappedTuningTable> newTuning, juce::Array<juce::uint32>& packets)
+{
+    jassert(newTuning != nullptr);
+    tuning = newTuning;
+
+    for (int ch = 0; ch < 16; ch++)
+    {
+        for (int note = 0; note < 128; note++)
+        {
+            auto& state = noteStateAt(ch, note);
+            if (state.basePitch < 0)
+                continue;
+
+            // Notes that are unmapped in the new tuning keep their pitch until released
+            auto mts = tuning->mtsAt(note, ch + 1);
+            if (mts < 0)
+                continue;
+
+            addPerNotePitchbend(ch, note, mts - state.basePitch, packets);
+        }
+    }
+}
+
+bool UmpEncoder::isSounding(int midiChannel, int midiNote) const
+{
+    return notes[(midiChannel - 1) * 128 + midiNote].basePitch >= 0;
+}
+
+bool UmpEncoder::addMessage(const juce::uint8* data, int numBytes, juce::Array<juce::uint32>& packets)
+{
+    if (data == nullptr || numBytes < 1 || data[0] < 0x80)
+        return false;
+
+    auto status = data[0];
+    if (status == 0xf0)
+    {
+        auto size = (data[numBytes - 1] == 0xf7) ? numBytes - 2 : numBytes - 1;
+        addSysEx(data + 1, juce::jmax(0, size), packets);
+        return true;
+    }
+
+    auto size = midi1MessageSize(status);
+    if (size == 0 || numBytes < size)
+        return false;
+
+    auto data1 = (size > 1) ? data[1] & 0x7f : 0;
+    auto data2 = (size > 2) ? data[2] & 0x7f : 0;
+
+    if (status >= 0xf0)
+    {
+        packets.add(((juce::uint32)System << 28) | ((juce::uint32)group << 24) | (status << 16) | (data1 << 8) | data2);
+        return true;
+    }
+
+    auto channelIndex = status & 0xf;
+    switch (status >> 4)
+    {
+    case noteOnStatus:
+        if (data2 > 0)
+            return addNoteOn(channelIndex, data1, data2, packets);
+        return addNoteOff(channelIndex, data1, defaultNoteOffVelocity, packets);
+
+    case noteOffStatus:
+        return addNoteOff(channelIndex, data1, data2, packets);
+
+    default:
+        packets.add(channelVoiceHeader(Midi1ChannelVoice, status >> 4, channelIndex) | (data1 << 8) | data2);
+        return true;
+    }
+}
+
+void UmpEncoder::allNotesOff(juce::Array<juce::uint32>& packets)
+{
+    for (int ch = 0; ch < 16; ch++)
+    {
+        for (int note = 0; note < 128; note++)
+            addNoteOff(ch, note, defaultNoteOffVelocity, packets);
+    }
+}
+
+juce::uint16 UmpEncoder::mtsToPitch7_9(double mts)
+{
+    auto pitch = juce::roundToInt(mts * 512.0);
+    return (juce::uint16)juce::jlimit(0, 0xffff, pitch);
+}
+
+double UmpEncoder::pitch7_9ToMts(juce::uint16 pitch)
+{
+    return pitch / 512.0;
+}
+
+juce::uint32 UmpEncoder::semitonesToPitchbend(double semitones, int pitchbendRange)
+{
+    auto normalized = juce::jlimit(-1.0, 1.0, semitones * 2.0 / pitchbendRange);
+    auto pitchbend = (juce::int64)pitchbendCenter + (juce::int64)std::llround(normalized * pitchbendCenter);
+    return (juce::uint32)juce::jlimit((juce::int64)0, (juce::int64)0xffffffff, pitchbend);
+}
+
+double UmpEncoder::pitchbendToSemitones(juce::uint32 pitchbend, int pitchbendRange)
+{
+    auto normalized = ((juce::int64)pitchbend - (juce::int64)pitchbendCenter) / (double)pitchbendCenter;
+    return normalized * pitchbendRange * 0.5;
+}
+
+juce::uint32 UmpEncoder::scaleUp(juce::uint32 value, int sourceBits, int destinationBits)
+{
+    auto scaleBits = destinationBits - sourceBits;
+    auto shifted = value << scaleBits;
+
+    // Values up to the center are shifted, so that the center stays in the center
+    auto sourceCenter = (juce::uint32)1 << (sourceBits - 1);
+    if (value <= sourceCenter)
+        return shifted;
+
+    // Values above it repeat their lower bits, so that the maximum stays the maximum
+    auto repeatBits = sourceBits - 1;
+    auto repeatValue = value & ((1u << repeatBits) - 1);
+    if (scaleBits > repeatBits)
+        repeatValue <<= scaleBits - repeatBits;
+    else
+        repeatValue >>= repeatBits - scaleBits;
+
+    while (repeatValue != 0)
+    {
+        shifted |= repeatValue;
+        repeatValue >>= repeatBits;
+    }
+
+    return shifted;
+}
+
+int UmpEncoder::packetSize(juce::uint32 firstWord)
+{
+    static const int sizes[16] = { 1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4 };
+    return sizes[getMessageType(firstWord)];
+}
+
+void UmpEncoder::writeByteStream(const juce::uint32* packets, int numWords, juce::MemoryBlock& bytes)
+{
+    auto start = bytes.getSize();
+    bytes.setSize(start + (size_t)numWords * 4, false);
+
+    auto out = static_cast<juce::uint8*>(bytes.getData()) + start;
+    for (int i = 0; i < numWords; i++)
+    {
+        auto word = packets[i];
+        *out++ = (juce::uint8)(word >> 24);
+        *out++ = (juce::uint8)(word >> 16);
+        *out++ = (juce::uint8)(word >> 8);
+        *out++ = (juce::uint8)word;
+    }
+}
+
+bool UmpEncoder::readByteStream(const void* data, size_t numBytes, juce::Array<juce::uint32>& packets)
+{
+    if (numBytes % 4 != 0)
+        return false;
+
+    auto in = static_cast<const juce::uint8*>(data);
+    auto numWords = (int)(numBytes / 4);
+
+    // Check that the stream ends on a packet boundary before appending anything
+    int index = 0;
+    while (index < numWords)
+    {
+        auto word = ((juce::uint32)in[index * 4] << 24) | ((juce::uint32)in[index * 4 + 1] << 16)
+                  | ((juce::uint32)in[index * 4 + 2] << 8) | (juce::uint32)in[index * 4 + 3];
+        index += packetSize(word);
+    }
+
+    if (index != numWords)
+        return false;
+
+    packets.ensureStorageAllocated(packets.size() + numWords);
+    for (int i = 0; i < numWords; i++, in += 4)
+        packets.add(((juce::uint32)in[0] << 24) | ((juce::uint32)in[1] << 16) | ((juce::uint32)in[2] << 8) | (juce::uint32)in[3]);
+
+    return true;
+}
+
+juce::uint32 UmpEncoder::channelVoiceHeader(MessageType type, int status, int channelIndex) const
+{
+    return ((juce::uint32)type << 28) | ((juce::uint32)group << 24) | ((juce::uint32)status << 20) | ((juce::uint32)channelIndex << 16);
+}
+
+bool UmpEncoder::addNoteOn(int channelIndex, int midiNote, int velocity, juce::Array<juce::uint32>& packets)
+{
+    auto mts = tuning->mtsAt(midiNote, channelIndex + 1);
+    if (mts < 0)
+        return false;
+
+    auto& state = noteStateAt(channelIndex, midiNote);
+    auto word0 = channelVoiceHeader(Midi2ChannelVoice, noteOnStatus, channelIndex) | ((juce::uint32)midiNote << 8);
+    auto word1 = scaleUp((juce::uint32)velocity, 7, 16) << 16;
+
+    if (pitchMode == PitchMode::NoteAttribute)
+    {
+        auto pitch = mtsToPitch7_9(mts);
+        state.basePitch = pitch7_9ToMts(pitch);
+
+        // Clear any bend left on this note by a tuning change
+        if (state.pitchbend != 0)
+            addPerNotePitchbend(channelIndex, midiNote, 0, packets);
+
+        word0 |= pitch7_9Attribute;
+        word1 |= pitch;
+    }
+    else
+    {
+        state.basePitch = midiNote;
+        addPerNotePitchbend(channelIndex, midiNote, mts - midiNote, packets);
+    }
+
+    packets.add(word0);
+    packets.add(word1);
+    return true;
+}
+
+bool UmpEncoder::addNoteOff(int channelIndex, int midiNote, int velocity, juce::Array<juce::uint32>& packets)
+{
+    auto& state = noteStateAt(channelIndex, midiNote);
+    if (state.basePitch < 0)
+        return false;
+
+    state.basePitch = -1;
+
+    packets.add(channelVoiceHeader(Midi2ChannelVoice, noteOffStatus, channelIndex) | ((juce::uint32)midiNote << 8));
+    packets.add(scaleUp((juce::uint32)velocity, 7, 16) << 16);
+    return true;
+}
+
+void UmpEncoder::addPerNotePitchbend(int channelIndex, int midiNote, double semitones, juce::Array<juce::uint32>& packets)
+{
+    noteStateAt(channelIndex, midiNote).pitchbend = semitones;
+
+    packets.add(channelVoiceHeader(Midi2ChannelVoice, perNotePitchbendStatus, channelIndex) | ((juce::uint32)midiNote << 8));
+    packets.add(semitonesToPitchbend(semitones, pitchbendRange));
+}
+
+void UmpEncoder::addSysEx(const juce::uint8* data, int size, juce::Array<juce::uint32>& packets)
+{
+    int position = 0;
+    do
+    {
+        auto numBytes = juce::jmin(sysExBytesPerPacket, size - position);
+        auto isFirst = position == 0;
+        auto isLast = position + numBytes >= size;
+
+        auto status = (isFirst && isLast) ? sysExComplete
+                    : isFirst ? sysExStart
+                    : isLast ? sysExEnd
+                    : sysExContinue;
+
+        juce::uint8 payload[sysExBytesPerPacket] = { 0 };
+        for (int i = 0; i < numBytes; i++)
+            payload[i] = data[position + i] & 0x7f;
+
+        packets.add(((juce::uint32)Data64 << 28) | ((juce::uint32)group << 24) | ((juce::uint32)status << 20)
+                    | ((juce::uint32)numBytes << 16) | ((juce::uint32)payload[0] << 8) | payload[1]);
+        packets.add(((juce::uint32)payload[2] << 24) | ((juce::uint32)payload[3] << 16) | ((juce::uint32)payload[4] << 8) | payload[5]);
+
+        position += numBytes;
+    } while (position < size);
+}
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    UmpEncoder.h
+    Created: 19 Oct 2026 11:38:15pm
+    Author:  Vincenzo
+
+    Tunes MIDI 1.0 input into MIDI 2.0 Universal MIDI Packets.
+    Every note keeps its own note number and channel, and gets its pitch
+    from the target tuning, either as a pitch 7.9 note attribute or as a
+    per-note pitchbend. No channels are allocated, so polyphony is only
+    limited to 128 notes per channel.
+
+    Other channel voice messages are passed through as MIDI 1.0 packets,
+    and SysEx is split into 7-bit data packets.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "./tuning/MappedTuning.h"
+
+#include <array>
+
+class UmpEncoder
+{
+public:
+
+    enum class PitchMode
+    {
+        NoteAttribute = 0,      /* Note-on with the pitch 7.9 attribute */
+        PerNotePitchbend,       /* Per-note pitchbend followed by a plain note-on */
+    };
+
+    enum MessageType
+    {
+        Utility = 0x0,
+        System = 0x1,
+        Midi1ChannelVoice = 0x2,
+        Data64 = 0x3,
+        Midi2ChannelVoice = 0x4,
+        Data128 = 0x5,
+    };
+
+    // MIDI 2.0 note attribute type of the pitch of a note, 7 bits of semitones and 9 bits of fraction
+    static const juce::uint8 pitch7_9Attribute = 0x03;
+
+    static const juce::uint32 pitchbendCenter = 0x80000000;
+
+private:
+
+    std::shared_ptr<MappedTuningTable> tuning;
+
+    PitchMode pitchMode;
+    int group;
+
+    int pitchbendRange = 96; // total bipolar range of per-note pitchbend in semitones
+
+    struct NoteState
+    {
+        double basePitch = -1;  /* Pitch of the note number or attribute, or -1 if the note isn't sounding */
+        double pitchbend = 0;   /* Last per-note pitchbend in semitones */
+    };
+
+    std::array<NoteState, 16 * 128> notes;
+
+public:
+
+    UmpEncoder(std::shared_ptr<MappedTuningTable> tuning, PitchMode mode = PitchMode::NoteAttribute, int group = 0);
+
+    const MappedTuningTable* getTuning() const { return tuning.get(); }
+
+    // Appends per-note pitchbends that move sounding notes to the new tuning
+    void setTuning(std::shared_ptr<MappedTuningTable> newTuning, juce::Array<juce::uint32>& packets);
+
+    PitchMode getPitchMode() const { return pitchMode; }
+    void setPitchMode(PitchMode mode) { pitchMode = mode; }
+
+    int getGroup() const { return group; }
+    void setGroup(int groupIn) { group = groupIn & 0xf; }
+
+    int getPitchbendRange() const { return pitchbendRange; }
+    void setPitchbendRange(int range) { pitchbendRange = range; }
+
+    bool isSounding(int midiChannel, int midiNote) const;
+
+    // Appends the packets of one MIDI 1.0 message. Notes that are unmapped in the target tuning are dropped,
+    // as are running status and incomplete messages. Returns false if nothing was appended.
+    bool addMessage(const juce::uint8* data, int numBytes, juce::Array<juce::uint32>& packets);
+
+    // Appends note-offs for every sounding note
+    void allNotesOff(juce::Array<juce::uint32>& packets);
+
+public:
+
+    // Clipped to the range of 7.9 pitch
+    static juce::uint16 mtsToPitch7_9(double mts);
+    static double pitch7_9ToMts(juce::uint16 pitch);
+
+    // Clipped to the range, which is the total bipolar range in semitones
+    static juce::uint32 semitonesToPitchbend(double semitones, int pitchbendRange);
+    static double pitchbendToSemitones(juce::uint32 pitchbend, int pitchbendRange);
+
+    // Min-center-max upscaling from the MIDI 2.0 specification
+    static juce::uint32 scaleUp(juce::uint32 value, int sourceBits, int destinationBits);
+
+    // The number of 32-bit words in a packet, read from its first word
+    static int packetSize(juce::uint32 firstWord);
+
+    static juce::uint8 getMessageType(juce::uint32 firstWord) { return (juce::uint8)(firstWord >> 28); }
+
+    // Big-endian byte stream, as written to MIDI 2.0 clip files and sent over transports without packets
+    static void writeByteStream(const juce::uint32* packets, int numWords, juce::MemoryBlock& bytes);
+
+    // Returns false if the size isn't whole words, or if the last packet is incomplete
+    static bool readByteStream(const void* data, size_t numBytes, juce::Array<juce::uint32>& packets);
+
+private:
+
+    NoteState& noteStateAt(int channelIndex, int midiNote) { return notes[channelIndex * 128 + midiNote]; }
+
+    juce::uint32 channelVoiceHeader(MessageType type, int status, int channelIndex) const;
+
+    bool addNoteOn(int channelIndex, int midiNote, int velocity, juce::Array<juce::uint32>& packets);
+    bool addNoteOff(int channelIndex, int midiNote, int velocity, juce::Array<juce::uint32>& packets);
+    void addPerNotePitchbend(int channelIndex, int midiNote, double semitones, juce::Array<juce::uint32>& packets);
+
+    void addSysEx(const juce::uint8* data, int size, juce::Array<juce::uint32>& packets);
+};
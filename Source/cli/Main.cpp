@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 20 Oct 2026 3:21:55am
+    Author:  Vincenzo
+
+    everytone-batch: retunes Standard MIDI Files offline with MidiFileRetuner.
+
+    everytone-batch --tuning <.scl|.tun|.msf> --output <folder> [options] <.mid files or folders>
+
+        --kbm <file>            Scala keyboard mapping of the tuning
+        --options <file>        Options saved from the plugin state, as XML
+        --pitchbend-range <n>   Total bipolar pitchbend range of the output in semitones
+        --mts                   Write MTS bulk dumps instead of allocating channels
+        --merge                 Tune all tracks of a file as one track
+        --threads <n>           Number of worker threads, all cores by default
+        --verbose               Print the log of every track
+
+    everytone-batch --bundle <output file> <.scl|.tun|.msf files or folders>
+
+        Writes the tunings into a TuningBundle, with each file's own mapping if it has one
+
+    everytone-batch --replay <capture> --output <capture> [--expected <capture>]
+
+        Replays a MIDI capture through a processor without an editor, and writes its output.
+        With --expected, the output is compared with one from another replay, such as of another build.
+
+    everytone-batch --compare <expected capture> <actual capture>
+
+        Compares the output of two replays, and fails if they differ
+
+  ==============================================================================
+*/
+
+#include "../io/MidiFileRetuner.h"
+#include "../io/TuningBundle.h"
+#include "../io/TuningFileParser.h"
+#include "../MidiCaptureReplay.h"
+
+#include <iostream>
+
+namespace
+{
+    class BatchLog : public juce::Logger
+    {
+        bool verbose;
+        juce::CriticalSection lock;
+
+    public:
+        BatchLog(bool verboseIn) : verbose(verboseIn) {}
+
+        void logMessage(const juce::String& msg) override
+        {
+            if (!verbose)
+                return;
+
+            const juce::ScopedLock sl(lock);
+            std::cerr << msg << std::endl;
+        }
+    };
+
+    juce::File fileForOption(const juce::ArgumentList& args, const juce::String& option)
+    {
+        auto path = args.getValueForOption(option).unquoted();
+        return path.isEmpty() ? juce::File() : juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    }
+
+    int fail(const juce::String& error)
+    {
+        std::cerr << "everytone-batch: " << error << std::endl;
+        return 1;
+    }
+
+    juce::Array<juce::File> findInputFiles(const juce::ArgumentList& args, const juce::StringArray& optionsWithValues, const juce::String& wildcard)
+    {
+        juce::Array<juce::File> files;
+
+        for (int i = 0; i < args.size(); i++)
+        {
+            auto& arg = args[i];
+            if (arg.isOption())
+            {
+                if (optionsWithValues.contains(arg.text))
+                    i++;
+                continue;
+            }
+
+            auto file = arg.resolveAsFile();
+            if (file.isDirectory())
+            {
+                auto found = file.findChildFiles(juce::File::findFiles, true, wildcard);
+                found.sort();
+                files.addArray(found);
+            }
+            else
+                files.add(file);
+        }
+
+        return files;
+    }
+
+    int writeBundle(const juce::ArgumentList& args)
+    {
+        auto files = findInputFiles(args, { "--bundle" }, "*.scl;*.tun;*.msf");
+        if (files.isEmpty())
+            return fail("No tuning files given");
+
+        TuningBundle::Builder builder;
+        int numFailed = 0;
+
+        for (auto file : files)
+        {
+            juce::String error;
+            if (!builder.addFile(file, error))
+            {
+                numFailed++;
+                std::cerr << file.getFullPathName() << ": " << error << std::endl;
+            }
+        }
+
+        auto bundleFile = fileForOption(args, "--bundle");
+        if (!builder.writeToFile(bundleFile))
+            return fail("Could not write " + bundleFile.getFullPathName());
+
+        std::cout << "Bundled " << builder.getNumTunings() << " of " << files.size() << " tunings into "
+                  << bundleFile.getFullPathName() << std::endl;
+
+        return numFailed > 0 ? 1 : 0;
+    }
+
+    int compareCaptures(const MidiCaptureLog::Capture& expected, const MidiCaptureLog::Capture& actual)
+    {
+        auto difference = MidiCaptureReplay::compare(expected, actual);
+        std::cout << difference.toString() << std::endl;
+        return difference.isIdentical() ? 0 : 1;
+    }
+
+    int compareCaptureFiles(const juce::ArgumentList& args)
+    {
+        auto files = findInputFiles(args, { "--compare" }, "*");
+        files.insert(0, fileForOption(args, "--compare"));
+        if (files.size() != 2)
+            return fail("Usage: everytone-batch --compare <expected capture> <actual capture>");
+
+        MidiCaptureLog::Capture expected, actual;
+        juce::String error;
+        if (!MidiCaptureLog::read(files[0], expected, error) || !MidiCaptureLog::read(files[1], actual, error))
+            return fail(error);
+
+        return compareCaptures(expected, actual);
+    }
+
+    int replayCapture(const juce::ArgumentList& args)
+    {
+        if (!args.containsOption("--output"))
+            return fail("Usage: everytone-batch --replay <capture> --output <capture> [--expected <capture>]");
+
+        BatchLog log(args.containsOption("--verbose"));
+        juce::Logger::setCurrentLogger(&log);
+
+        // The processor needs the message manager, as in a host
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+        MidiCaptureLog::Capture input, output;
+        juce::String error;
+        if (!MidiCaptureLog::read(fileForOption(args, "--replay"), input, error))
+            return fail(error);
+
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+        if (!MidiCaptureReplay::replay(input, output, error))
+            return fail(error);
+
+        auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        std::cout << "Replayed " << output.blocks.size() << " blocks in " << juce::String(seconds, 2) << " s" << std::endl;
+
+        auto outputFile = fileForOption(args, "--output");
+        if (!MidiCaptureLog::write(outputFile, output, error))
+            return fail(error);
+
+        int result = 0;
+        if (args.containsOption("--expected"))
+        {
+            MidiCaptureLog::Capture expected;
+            if (!MidiCaptureLog::read(fileForOption(args, "--expected"), expected, error))
+                return fail(error);
+
+            result = compareCaptures(expected, output);
+        }
+
+        juce::Logger::setCurrentLogger(nullptr);
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--bundle"))
+        return writeBundle(args);
+
+    if (args.containsOption("--replay"))
+        return replayCapture(args);
+
+    if (args.containsOption("--compare"))
+        return compareCaptureFiles(args);
+
+    const juce::StringArray optionsWithValues = { "--tuning", "--kbm", "--options", "--pitchbend-range", "--threads", "--output" };
+
+    if (!args.containsOption("--tuning") || !args.containsOption("--output"))
+        return fail("Usage: everytone-batch --tuning <.scl|.tun|.msf> --output <folder> [options] <.mid files or folders>");
+
+    BatchLog log(args.containsOption("--verbose"));
+    juce::Logger::setCurrentLogger(&log);
+
+    MidiFileRetuner::Settings settings;
+
+    auto tuningFile = fileForOption(args, "--tuning");
+    if (!tuningFile.existsAsFile())
+        return fail("Tuning file not found: " + tuningFile.getFullPathName());
+
+    auto parsed = TuningFileParser::parseFile(tuningFile);
+    if (!parsed.wasSuccessful())
+        return fail(parsed.error);
+
+    settings.targetTuning = parsed.tuning;
+    settings.targetMapping = parsed.mapping;
+
+    if (args.containsOption("--options"))
+    {
+        auto xml = juce::parseXML(fileForOption(args, "--options"));
+        auto tree = (xml != nullptr) ? juce::ValueTree::fromXml(*xml) : juce::ValueTree();
+
+        // Either a whole plugin state, or only its options
+        auto optionsTree = tree.hasType(Everytone::ID::Options) ? tree : tree.getChildWithName(Everytone::ID::Options);
+        if (!optionsTree.isValid())
+            return fail("No options found in " + args.getValueForOption("--options"));
+
+        settings.options = Everytone::Options::fromValueTree(optionsTree);
+    }
+
+    // As MultimapperAudioProcessor::loadTargetKeyboardMapping
+    if (args.containsOption("--kbm"))
+    {
+        ScalaBufferParser::KeyboardMapping keyboardMapping;
+        juce::String error;
+        if (!TuningFileParser::parseKeyboardMappingFile(fileForOption(args, "--kbm"), keyboardMapping, error))
+            return fail(error);
+
+        settings.targetMapping = TuningFileParser::applyKeyboardMapping(keyboardMapping, settings.targetTuning);
+        settings.options.mappingMode = Everytone::MappingMode::Manual;
+    }
+
+    if (args.containsOption("--pitchbend-range"))
+        settings.options.pitchbendRange = args.getValueForOption("--pitchbend-range").getIntValue();
+
+    if (args.containsOption("--mts"))
+        settings.format = MidiFileRetuner::OutputFormat::Mts;
+
+    settings.mergeTracks = args.containsOption("--merge");
+
+    settings.outputDirectory = fileForOption(args, "--output");
+    if (!settings.outputDirectory.createDirectory())
+        return fail("Could not create " + settings.outputDirectory.getFullPathName());
+
+    auto files = findInputFiles(args, optionsWithValues, "*.mid;*.midi");
+    if (files.isEmpty())
+        return fail("No MIDI files given");
+
+    auto numThreads = args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue()
+                                                       : juce::SystemStats::getNumCpus();
+
+    juce::CriticalSection printLock;
+    int numFailed = 0;
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    MidiFileRetuner retuner(settings, numThreads);
+    retuner.retuneFiles(files, [&](const MidiFileRetuner::Result& result, int numFinished, int numFiles)
+    {
+        const juce::ScopedLock sl(printLock);
+
+        auto progress = "[" + juce::String(numFinished) + "/" + juce::String(numFiles) + "] ";
+        if (result.wasSuccessful())
+        {
+            std::cout << progress << result.output.getFullPathName() << std::endl;
+        }
+        else
+        {
+            numFailed++;
+            std::cerr << progress << result.input.getFullPathName() << ": " << result.error << std::endl;
+        }
+    });
+
+    auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    std::cout << "Retuned " << (files.size() - numFailed) << " of " << files.size() << " files in "
+              << juce::String(seconds, 2) << " s" << std::endl;
+
+    juce::Logger::setCurrentLogger(nullptr);
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,476 @@
+/*
+  ==============================================================================
+
+    MidiCaptureLog.cpp
+    Created: 20 Oct 2026 1:26:44am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "MidiCaptureLog.h"
+
+namespace
+{
+    const juce::uint64 fnvOffsetBasis = 0xcbf29ce484222325ull;
+    const juce::uint64 fnvPrime = 0x100000001b3ull;
+
+    // Largest variable-length encoding of a 64-bit integer
+    const int maxVarIntSize = 10;
+
+    // Record type, tuner hash and sample rate, and the index, block size and number of events
+    const int blockRecordHeaderSize = 1 + 8 + 8 + maxVarIntSize * 3;
+
+    void hashBytes(juce::uint64& hash, const void* data, size_t numBytes)
+    {
+        auto bytes = static_cast<const juce::uint8*>(data);
+        for (size_t i = 0; i < numBytes; i++)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+    }
+
+    // Writes to a buffer that's known to be large enough
+    struct RecordWriter
+    {
+        juce::uint8* out;
+
+        void fixed(juce::uint64 value, int numBytes)
+        {
+            for (int i = 0; i < numBytes; i++)
+                *out++ = (juce::uint8)(value >> (i * 8));
+        }
+
+        void varInt(juce::uint64 value)
+        {
+            while (value >= 0x80)
+            {
+                *out++ = (juce::uint8)(value | 0x80);
+                value >>= 7;
+            }
+            *out++ = (juce::uint8)value;
+        }
+
+        void bytes(const juce::uint8* data, int numBytes)
+        {
+            memcpy(out, data, (size_t)numBytes);
+            out += numBytes;
+        }
+    };
+
+    struct RecordReader
+    {
+        const juce::uint8* in;
+        const juce::uint8* end;
+        bool failed = false;
+
+        bool isExhausted() const { return in >= end; }
+
+        juce::uint64 fixed(int numBytes)
+        {
+            if (end - in < numBytes)
+            {
+                failed = true;
+                return 0;
+            }
+
+            juce::uint64 value = 0;
+            for (int i = 0; i < numBytes; i++)
+                value |= (juce::uint64)(*in++) << (i * 8);
+            return value;
+        }
+
+        juce::uint64 varInt()
+        {
+            juce::uint64 value = 0;
+            for (int shift = 0; shift < maxVarIntSize * 7; shift += 7)
+            {
+                if (in >= end)
+                    break;
+
+                auto byte = *in++;
+                value |= (juce::uint64)(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    return value;
+            }
+
+            failed = true;
+            return 0;
+        }
+
+        const juce::uint8* bytes(juce::uint64 numBytes)
+        {
+            if ((juce::uint64)(end - in) < numBytes)
+            {
+                failed = true;
+                return nullptr;
+            }
+
+            auto data = in;
+            in += numBytes;
+            return data;
+        }
+    };
+
+    juce::uint64 doubleToBits(double value)
+    {
+        juce::uint64 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double bitsToDouble(juce::uint64 bits)
+    {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+const MidiCaptureLog::State* MidiCaptureLog::Capture::findState(juce::uint64 tunerHash) const
+{
+    for (auto& state : states)
+    {
+        if (state.tunerHash == tunerHash)
+            return &state;
+    }
+
+    return nullptr;
+}
+
+bool MidiCaptureLog::read(const juce::File& file, Capture& capture, juce::String& error)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+    {
+        error = "Could not read " + file.getFullPathName();
+        return false;
+    }
+
+    auto start = static_cast<const juce::uint8*>(data.getData());
+    RecordReader reader = { start, start + data.getSize() };
+
+    if (reader.fixed(4) != magic)
+    {
+        error = "Not a MIDI capture";
+        return false;
+    }
+
+    auto fileVersion = reader.fixed(4);
+    if (fileVersion != version)
+    {
+        error = "Unsupported MIDI capture version " + juce::String((int)fileVersion);
+        return false;
+    }
+
+    capture = Capture();
+
+    while (!reader.isExhausted() && !reader.failed)
+    {
+        auto type = reader.fixed(1);
+        if (type == stateRecord)
+        {
+            State state;
+            state.tunerHash = reader.fixed(8);
+            auto size = reader.fixed(4);
+            auto stateData = reader.bytes(size);
+            if (reader.failed)
+                break;
+
+            state.data.append(stateData, (size_t)size);
+            capture.states.add(state);
+        }
+        else if (type == blockRecord)
+        {
+            Block block;
+            block.tunerHash = reader.fixed(8);
+            block.sampleRate = bitsToDouble(reader.fixed(8));
+            block.index = (juce::int64)reader.varInt();
+            block.blockSize = (int)reader.varInt();
+
+            auto numEvents = reader.varInt();
+            int sample = 0;
+            for (juce::uint64 i = 0; i < numEvents && !reader.failed; i++)
+            {
+                sample += (int)reader.varInt();
+                auto size = reader.varInt();
+                auto eventData = reader.bytes(size);
+                if (!reader.failed)
+                    block.midi.addEvent(eventData, (int)size, sample);
+            }
+
+            if (reader.failed)
+                break;
+
+            capture.blocks.add(block);
+        }
+        else
+        {
+            error = "Unknown record type " + juce::String((int)type) + " in MIDI capture";
+            return false;
+        }
+    }
+
+    // A capture that was cut off, such as by a crash, keeps its complete records
+    if (reader.failed)
+        juce::Logger::writeToLog("MIDI capture " + file.getFileName() + " ends with an incomplete record");
+
+    return true;
+}
+
+bool MidiCaptureLog::write(const juce::File& file, const Capture& capture, juce::String& error)
+{
+    file.deleteFile();
+    auto stream = file.createOutputStream();
+    if (stream == nullptr || !stream->openedOk())
+    {
+        error = "Could not write " + file.getFullPathName();
+        return false;
+    }
+
+    writeHeader(*stream);
+
+    for (auto& state : capture.states)
+        writeStateRecord(*stream, state);
+
+    juce::HeapBlock<juce::uint8> record;
+    int capacity = 0;
+    for (auto& block : capture.blocks)
+    {
+        auto maxSize = maxBlockRecordSize(block.midi);
+        if (maxSize > capacity)
+        {
+            capacity = maxSize;
+            record.realloc((size_t)capacity);
+        }
+
+        auto size = writeBlockRecord(record.get(), capacity, block);
+        stream->write(record.get(), (size_t)size);
+    }
+
+    stream->flush();
+    if (!stream->getStatus().wasOk())
+    {
+        error = "Could not write " + file.getFullPathName();
+        return false;
+    }
+
+    return true;
+}
+
+juce::uint64 MidiCaptureLog::hashTuner(const MidiNoteTuner& tuner)
+{
+    auto hash = fnvOffsetBasis;
+
+    for (auto mapped : { tuner.mappedSource(), tuner.mappedTarget() })
+    {
+        for (int ch = 1; ch <= 16; ch++)
+        {
+            for (int note = 0; note < 128; note++)
+            {
+                auto bits = doubleToBits(mapped->mtsAt(note, ch));
+                hashBytes(hash, &bits, sizeof(bits));
+            }
+        }
+    }
+
+    auto pitchbendRange = (juce::int32)tuner.getPitchbendMax();
+    hashBytes(hash, &pitchbendRange, sizeof(pitchbendRange));
+
+    return hash;
+}
+
+int MidiCaptureLog::maxBlockRecordSize(const juce::MidiBuffer& midi)
+{
+    // Events are stored with a 4-byte sample and 2-byte size, which take at most twice that as variable-length integers
+    return blockRecordHeaderSize + (int)midi.data.size() * 2;
+}
+
+int MidiCaptureLog::writeBlockRecord(juce::uint8* dest, int capacity, const Block& block)
+{
+    return writeBlockRecord(dest, capacity, block.index, block.tunerHash, block.sampleRate, block.blockSize, block.midi);
+}
+
+int MidiCaptureLog::writeBlockRecord(juce::uint8* dest, int capacity, juce::int64 index, juce::uint64 tunerHash,
+                                     double sampleRate, int blockSize, const juce::MidiBuffer& midi)
+{
+    if (maxBlockRecordSize(midi) > capacity)
+        return 0;
+
+    RecordWriter writer = { dest };
+    writer.fixed(blockRecord, 1);
+    writer.fixed(tunerHash, 8);
+    writer.fixed(doubleToBits(sampleRate), 8);
+    writer.varInt((juce::uint64)index);
+    writer.varInt((juce::uint64)juce::jmax(0, blockSize));
+    writer.varInt((juce::uint64)midi.getNumEvents());
+
+    // Events are sorted by sample, so only the distance from the previous one is stored
+    int previousSample = 0;
+    for (auto metadata : midi)
+    {
+        writer.varInt((juce::uint64)juce::jmax(0, metadata.samplePosition - previousSample));
+        writer.varInt((juce::uint64)metadata.numBytes);
+        writer.bytes(metadata.data, metadata.numBytes);
+        previousSample = juce::jmax(previousSample, metadata.samplePosition);
+    }
+
+    return (int)(writer.out - dest);
+}
+
+void MidiCaptureLog::writeHeader(juce::OutputStream& stream)
+{
+    juce::uint8 header[8];
+    RecordWriter writer = { header };
+    writer.fixed(magic, 4);
+    writer.fixed(version, 4);
+    stream.write(header, sizeof(header));
+}
+
+void MidiCaptureLog::writeStateRecord(juce::OutputStream& stream, const State& state)
+{
+    juce::uint8 header[1 + 8 + 4];
+    RecordWriter writer = { header };
+    writer.fixed(stateRecord, 1);
+    writer.fixed(state.tunerHash, 8);
+    writer.fixed(state.data.getSize(), 4);
+    stream.write(header, sizeof(header));
+    stream.write(state.data.getData(), state.data.getSize());
+}
+
+//==============================================================================
+
+MidiCaptureWriter::MidiCaptureWriter(int fifoSize)
+    : juce::Thread("MidiCaptureWriter"),
+      fifo(fifoSize)
+{
+    buffer.allocate((size_t)fifoSize, true);
+    record.allocate((size_t)fifoSize / 4, true);
+}
+
+MidiCaptureWriter::~MidiCaptureWriter()
+{
+    stop();
+}
+
+bool MidiCaptureWriter::start(const juce::File& file, const MidiCaptureLog::State& initialState, juce::String& error)
+{
+    stop();
+
+    file.deleteFile();
+    stream = file.createOutputStream();
+    if (stream == nullptr || !stream->openedOk())
+    {
+        stream = nullptr;
+        error = "Could not write " + file.getFullPathName();
+        return false;
+    }
+
+    MidiCaptureLog::writeHeader(*stream);
+    MidiCaptureLog::writeStateRecord(*stream, initialState);
+
+    fifo.reset();
+    blockIndex = 0;
+    numDropped = 0;
+
+    active = true;
+    startThread();
+
+    juce::Logger::writeToLog("Capturing MIDI to " + file.getFullPathName());
+    return true;
+}
+
+void MidiCaptureWriter::stop()
+{
+    if (stream == nullptr)
+        return;
+
+    // Wait for a block that's being added, so that the FIFO can be drained and reset
+    active = false;
+    while (audioThreadWriting.load())
+        juce::Thread::yield();
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(drainIntervalMs * 20);
+
+    writePending();
+    stream->flush();
+
+    juce::Logger::writeToLog("Stopped capturing MIDI to " + stream->getFile().getFullPathName()
+                             + ", " + juce::String(blockIndex) + " blocks, " + juce::String(numDropped.load()) + " dropped");
+
+    stream = nullptr;
+}
+
+void MidiCaptureWriter::addBlock(const juce::MidiBuffer& midi, int blockSize, double sampleRate, juce::uint64 tunerHash)
+{
+    audioThreadWriting = true;
+
+    if (active.load())
+    {
+        auto capacity = fifo.getTotalSize() / 4;
+        auto size = MidiCaptureLog::writeBlockRecord(record.get(), capacity, blockIndex, tunerHash, sampleRate, blockSize, midi);
+
+        if (size == 0 || fifo.getFreeSpace() < size)
+        {
+            numDropped++;
+        }
+        else
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite(size, start1, size1, start2, size2);
+            memcpy(buffer.get() + start1, record.get(), (size_t)size1);
+            if (size2 > 0)
+                memcpy(buffer.get() + start2, record.get() + size1, (size_t)size2);
+            fifo.finishedWrite(size1 + size2);
+        }
+
+        blockIndex++;
+    }
+
+    audioThreadWriting = false;
+}
+
+void MidiCaptureWriter::addState(const MidiCaptureLog::State& state)
+{
+    if (!isActive())
+        return;
+
+    const juce::ScopedLock lock(stateLock);
+    pendingStates.add(state);
+}
+
+void MidiCaptureWriter::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(drainIntervalMs);
+        writePending();
+    }
+}
+
+void MidiCaptureWriter::writePending()
+{
+    juce::Array<MidiCaptureLog::State> states;
+    {
+        const juce::ScopedLock lock(stateLock);
+        states.swapWith(pendingStates);
+    }
+
+    // Replay looks states up by tuner hash, so they only need to be written before the end
+    for (auto& state : states)
+        MidiCaptureLog::writeStateRecord(*stream, state);
+
+    auto numReady = fifo.getNumReady();
+    if (numReady == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(numReady, start1, size1, start2, size2);
+    stream->write(buffer.get() + start1, (size_t)size1);
+    if (size2 > 0)
+        stream->write(buffer.get() + start2, (size_t)size2);
+    fifo.finishedRead(size1 + size2);
+}
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    MidiCaptureLog.h
+    Created: 20 Oct 2026 1:26:44am
+    Author:  Vincenzo
+
+    Records the MIDI input of every processed block, so that sessions can be
+    replayed offline and their output compared between builds.
+
+    A log starts with a magic number and version, followed by records:
+      State: the tuner hash, and the processor state that produces that tuner
+      Block: the block index, tuner hash, sample rate, block size and events
+
+    Block records use variable-length integers and delta sample offsets, and
+    blocks are numbered so that dropped ones show up as gaps on replay.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../MidiNoteTuner.h"
+
+class MidiCaptureLog
+{
+public:
+
+    // "ETMC", changed whenever the format changes
+    static const juce::uint32 magic = 0x434d5445;
+    static const juce::uint32 version = 1;
+
+    static const juce::uint8 stateRecord = 'S';
+    static const juce::uint8 blockRecord = 'B';
+
+    struct State
+    {
+        juce::uint64 tunerHash = 0;
+        juce::MemoryBlock data;     /* From AudioProcessor::getStateInformation */
+    };
+
+    struct Block
+    {
+        juce::int64 index = 0;
+        juce::uint64 tunerHash = 0;
+        double sampleRate = 0;
+        int blockSize = 0;
+        juce::MidiBuffer midi;
+    };
+
+    struct Capture
+    {
+        juce::Array<State> states;  /* The first one is the state when capturing started */
+        juce::Array<Block> blocks;
+
+        // Returns nullptr if no state produced the tuner
+        const State* findState(juce::uint64 tunerHash) const;
+    };
+
+    static bool read(const juce::File& file, Capture& capture, juce::String& error);
+    static bool write(const juce::File& file, const Capture& capture, juce::String& error);
+
+    // FNV-1a of every source and target pitch, and the pitchbend range
+    static juce::uint64 hashTuner(const MidiNoteTuner& tuner);
+
+    // Upper bound of the size of the block record of a buffer
+    static int maxBlockRecordSize(const juce::MidiBuffer& midi);
+
+    // Doesn't allocate. Returns the size of the record, or 0 if it doesn't fit.
+    static int writeBlockRecord(juce::uint8* dest, int capacity, const Block& block);
+    static int writeBlockRecord(juce::uint8* dest, int capacity, juce::int64 index, juce::uint64 tunerHash,
+                                double sampleRate, int blockSize, const juce::MidiBuffer& midi);
+
+    static void writeHeader(juce::OutputStream& stream);
+    static void writeStateRecord(juce::OutputStream& stream, const State& state);
+};
+
+// Writes a capture from the audio thread without locking or allocating.
+// Blocks go through a FIFO that a background thread drains to the file,
+// and blocks that don't fit in it are dropped and counted.
+class MidiCaptureWriter : private juce::Thread
+{
+    std::unique_ptr<juce::FileOutputStream> stream;
+
+    juce::AbstractFifo fifo;
+    juce::HeapBlock<juce::uint8> buffer;
+    juce::HeapBlock<juce::uint8> record;
+
+    std::atomic<bool> active { false };
+    std::atomic<bool> audioThreadWriting { false };
+    std::atomic<int> numDropped { 0 };
+    juce::int64 blockIndex = 0;
+
+    juce::CriticalSection stateLock;
+    juce::Array<MidiCaptureLog::State> pendingStates;
+
+    int drainIntervalMs = 50;
+
+public:
+
+    // Blocks with a record larger than a quarter of the FIFO are always dropped
+    MidiCaptureWriter(int fifoSize = 1 << 20);
+    ~MidiCaptureWriter() override;
+
+    // Message thread. Overwrites the file, and starts with the given processor state.
+    bool start(const juce::File& file, const MidiCaptureLog::State& initialState, juce::String& error);
+
+    // Message thread. Writes everything that's left and closes the file.
+    void stop();
+
+    bool isActive() const { return active.load(); }
+
+    juce::File getFile() const { return stream != nullptr ? stream->getFile() : juce::File(); }
+
+    int getNumDroppedBlocks() const { return numDropped.load(); }
+
+    // Audio thread
+    void addBlock(const juce::MidiBuffer& midi, int blockSize, double sampleRate, juce::uint64 tunerHash);
+
+    // Message thread. Written before any blocks that are still in the FIFO.
+    void addState(const MidiCaptureLog::State& state);
+
+private:
+
+    // juce::Thread implementation
+    void run() override;
+
+    void writePending();
+};
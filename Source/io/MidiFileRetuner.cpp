@@ -0,0 +1,389 @@
+/*
+  ==============================================================================
+
+    MidiFileRetuner.cpp
+    Created: 20 Oct 2026 2:47:30am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "MidiFileRetuner.h"
+
+namespace
+{
+    const juce::uint8 universalNonRealtime = 0x7e;
+    const juce::uint8 allDevices = 0x7f;
+    const juce::uint8 midiTuningStandard = 0x08;
+    const juce::uint8 bulkDump = 0x01;
+
+    const int tuningProgramRpn = 0x0003;
+
+    // Highest pitch of an MTS triplet, since 7F 7F 7F means no change
+    const double maxMts = 127.0 + 16382.0 / 16384.0;
+
+    // A file whose tracks are being tuned, shared by the jobs of its tracks
+    struct FileTask
+    {
+        int index = 0;
+        MidiFileRetuner::Result result;
+
+        juce::MidiFile input;
+        juce::Array<juce::MidiMessageSequence> tracks;
+        std::atomic<int> numTracksLeft { 0 };
+    };
+
+    bool writeMidiFile(const juce::MidiFile& input, const juce::Array<juce::MidiMessageSequence>& tracks, const juce::File& file, juce::String& error)
+    {
+        juce::MidiFile output;
+
+        auto timeFormat = input.getTimeFormat();
+        if (timeFormat > 0)
+            output.setTicksPerQuarterNote(timeFormat);
+        else
+            output.setSmpteTimeFormat(-(signed char)(timeFormat >> 8), timeFormat & 0xff);
+
+        for (auto& track : tracks)
+            output.addTrack(track);
+
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk() || !output.writeTo(stream))
+        {
+            error = "Could not write " + file.getFullPathName();
+            return false;
+        }
+
+        return true;
+    }
+}
+
+MidiFileRetuner::MidiFileRetuner(const Settings& settingsIn, int numThreadsIn)
+    : settings(settingsIn),
+      numThreads(juce::jmax(1, numThreadsIn)) {}
+
+juce::Array<MidiFileRetuner::Result> MidiFileRetuner::retuneFiles(const juce::Array<juce::File>& files, ProgressCallback progressCallback) const
+{
+    juce::Array<Result> results;
+    results.resize(files.size());
+
+    if (files.size() == 0)
+        return results;
+
+    juce::ThreadPool pool(numThreads);
+    juce::WaitableEvent allFinished;
+    std::atomic<int> numFinished { 0 };
+
+    // Each file has its own result, so they can be set from any thread
+    auto finish = [&](const FileTask& task)
+    {
+        results.getReference(task.index) = task.result;
+
+        auto finished = ++numFinished;
+        if (progressCallback)
+            progressCallback(task.result, finished, files.size());
+
+        if (finished == files.size())
+            allFinished.signal();
+    };
+
+    // Track jobs are added to the same pool as file jobs, so idle threads take the tracks of long files
+    auto startFile = [&](std::shared_ptr<FileTask> task)
+    {
+        auto& result = task->result;
+
+        if (result.output == result.input)
+        {
+            result.error = "Output would replace the input file";
+            finish(*task);
+            return;
+        }
+
+        juce::FileInputStream stream(result.input);
+        if (!stream.openedOk() || !task->input.readFrom(stream))
+        {
+            result.error = "Could not read " + result.input.getFullPathName();
+            finish(*task);
+            return;
+        }
+
+        if (settings.mergeTracks)
+        {
+            task->tracks.add(mergeTracks(task->input));
+        }
+        else
+        {
+            for (int i = 0; i < task->input.getNumTracks(); i++)
+                task->tracks.add(*task->input.getTrack(i));
+        }
+
+        result.numTracks = task->tracks.size();
+
+        // MTS output only needs the tuning added, so it's not worth more jobs
+        if (settings.format == OutputFormat::Mts || task->tracks.size() == 0)
+        {
+            if (task->tracks.size() > 0)
+            {
+                auto tunerController = createTunerController(settings);
+
+                juce::MidiMessageSequence firstTrack;
+                for (auto& message : createMtsMessages(*tunerController->readTuningTarget()))
+                    firstTrack.addEvent(message);
+
+                firstTrack.addSequence(task->tracks.getReference(0), 0);
+                task->tracks.getReference(0).swapWith(firstTrack);
+            }
+
+            writeMidiFile(task->input, task->tracks, result.output, result.error);
+            finish(*task);
+            return;
+        }
+
+        task->numTracksLeft = task->tracks.size();
+        for (int i = 0; i < task->tracks.size(); i++)
+        {
+            pool.addJob([&, task, i]()
+            {
+                auto& track = task->tracks.getReference(i);
+                auto retuned = retuneTrack(track, settings);
+                track.swapWith(retuned);
+
+                if (--task->numTracksLeft == 0)
+                {
+                    writeMidiFile(task->input, task->tracks, task->result.output, task->result.error);
+                    finish(*task);
+                }
+            });
+        }
+    };
+
+    for (int i = 0; i < files.size(); i++)
+    {
+        auto task = std::make_shared<FileTask>();
+        task->index = i;
+        task->result.input = files[i];
+        task->result.output = settings.outputDirectory.getChildFile(files[i].getFileName());
+
+        pool.addJob([&startFile, task]() { startFile(task); });
+    }
+
+    allFinished.wait();
+    return results;
+}
+
+juce::MidiMessageSequence MidiFileRetuner::retuneTrack(const juce::MidiMessageSequence& track, const Settings& settings)
+{
+    auto tunerController = createTunerController(settings);
+
+    MidiVoiceController voiceController(*tunerController, settings.options.channelMode, settings.options.mpeZone, settings.options.voiceLimit);
+    voiceController.setInputPitchbendRange(settings.options.inputPitchbendRange);
+    voiceController.setMidiMode(settings.options.midiMode);
+
+    // Offline, every chord can take as long as it needs
+    voiceController.setBendMode(settings.options.bendMode);
+    voiceController.setAdaptiveTimeBudget(0);
+
+    // Quantised pitch moves to each degree at once, and notes don't slide, since there are no audio blocks to glide over
+    voiceController.setInputPitchMode(settings.options.inputPitchMode);
+    voiceController.setQuantiseHysteresis(settings.options.quantiseHysteresis);
+    voiceController.setQuantiseGlide(0);
+    voiceController.setPortamentoTime(0);
+
+    MtsSysExReceiver::NoteTable mtsTable;
+
+    juce::MidiMessageSequence retuned;
+    juce::MidiBuffer tunedMessages;
+
+    // Note ons at the same time are tuned together, as in MultimapperAudioProcessor::tuneMidiBuffer
+    juce::Array<juce::MidiMessage> chordNoteOns;
+    double chordTime = 0;
+
+    auto tuneChord = [&]()
+    {
+        if (chordNoteOns.size() == 0)
+            return;
+
+        tunedMessages.clear();
+        int sample = 0;
+        voiceController.startAdaptiveBlock(tunedMessages, sample);
+        voiceController.tuneChord(chordNoteOns, tunedMessages, sample);
+
+        for (auto metadata : tunedMessages)
+            retuned.addEvent(metadata.getMessage().withTimeStamp(chordTime));
+
+        chordNoteOns.clearQuick();
+    };
+
+    for (int i = 0; i < track.getNumEvents(); i++)
+    {
+        auto& msg = track.getEventPointer(i)->message;
+        auto time = msg.getTimeStamp();
+
+        if (chordNoteOns.size() > 0 && !(msg.isNoteOn() && time == chordTime && chordNoteOns.size() < MULTIMAPPER_MAX_POLY_VOICES))
+            tuneChord();
+
+        if (msg.isNoteOn())
+        {
+            chordNoteOns.add(msg);
+            chordTime = time;
+            continue;
+        }
+
+        // The plugin never receives meta events, but they keep the tempo and names of the track
+        if (msg.isMetaEvent())
+        {
+            retuned.addEvent(msg);
+            continue;
+        }
+
+        // As MultimapperAudioProcessor::mtsTuningReceived, without waiting for the tuning to be built
+        if (msg.isSysEx() && MtsSysExReceiver::applySysEx(msg.getSysExData(), msg.getSysExDataSize(), mtsTable))
+        {
+            auto mapping = std::make_shared<TuningTableMap>(TuningTableMap::StandardMappingDefinition());
+            tunerController->setMappingMode(Everytone::MappingMode::Manual);
+            tunerController->setTargetTuning(MtsSysExReceiver::createTuning(mtsTable), mapping, MappedTuningTable::FrequencyReference());
+            voiceController.setMtsRetuning(true);
+
+            if (settings.options.bendMode == Everytone::BendMode::Dynamic || settings.options.bendMode == Everytone::BendMode::Adaptive)
+            {
+                tunedMessages.clear();
+                int sample = 0;
+                voiceController.retuneActiveVoices(tunedMessages, sample);
+
+                for (auto metadata : tunedMessages)
+                    retuned.addEvent(metadata.getMessage().withTimeStamp(time));
+            }
+            continue;
+        }
+
+        tunedMessages.clear();
+        int sample = 0;
+        voiceController.startAdaptiveBlock(tunedMessages, sample);
+        voiceController.tuneMessage(msg, tunedMessages, sample);
+
+        for (auto metadata : tunedMessages)
+            retuned.addEvent(metadata.getMessage().withTimeStamp(time));
+    }
+
+    tuneChord();
+    return retuned;
+}
+
+std::unique_ptr<TunerController> MidiFileRetuner::createTunerController(const Settings& settings)
+{
+    auto& options = settings.options;
+    auto tunerController = std::make_unique<TunerController>(options.mappingMode, options.mappingType);
+
+    // As in MultimapperAudioProcessor::setStateInformation
+    auto sourceTuning = FunctionalTuning::StandardTuning();
+    auto sourceMapping = std::make_shared<TuningTableMap>(TuningTableMap::StandardMappingDefinition());
+    MappedTuningTable::FrequencyReference sourceReference;
+
+    auto targetTuning = (settings.targetTuning != nullptr) ? settings.targetTuning
+                                                           : sourceTuning;
+
+    if (settings.targetMapping == nullptr)
+        tunerController->setTunings(sourceTuning, sourceReference, targetTuning, settings.targetReference);
+    else
+        tunerController->setTunings(sourceTuning, sourceMapping, sourceReference, targetTuning, settings.targetMapping, settings.targetReference);
+
+    tunerController->setPitchbendRange(options.pitchbendRange);
+    return tunerController;
+}
+
+juce::Array<juce::MidiMessage> MidiFileRetuner::createMtsMessages(const MappedTuningTable& tuning)
+{
+    juce::Array<std::array<double, 128>> tables;
+    std::array<int, 16> programOfChannel;
+
+    for (int ch = 0; ch < 16; ch++)
+    {
+        std::array<double, 128> table;
+        for (int note = 0; note < 128; note++)
+            table[note] = tuning.mtsAt(note, ch + 1);
+
+        programOfChannel[ch] = tables.indexOf(table);
+        if (programOfChannel[ch] < 0)
+        {
+            programOfChannel[ch] = tables.size();
+            tables.add(table);
+        }
+    }
+
+    juce::Array<juce::MidiMessage> messages;
+    auto name = tuning.getTuning()->getName();
+
+    for (int program = 0; program < tables.size(); program++)
+        messages.add(createBulkTuningDump(tables.getReference(program), program, name));
+
+    if (tables.size() > 1)
+    {
+        for (int ch = 1; ch <= 16; ch++)
+        {
+            messages.add(juce::MidiMessage::controllerEvent(ch, 101, tuningProgramRpn >> 7));
+            messages.add(juce::MidiMessage::controllerEvent(ch, 100, tuningProgramRpn & 0x7f));
+            messages.add(juce::MidiMessage::controllerEvent(ch, 6, programOfChannel[ch - 1]));
+
+            // Null RPN, so later data entry doesn't change the tuning program
+            messages.add(juce::MidiMessage::controllerEvent(ch, 101, 127));
+            messages.add(juce::MidiMessage::controllerEvent(ch, 100, 127));
+        }
+    }
+
+    return messages;
+}
+
+juce::MidiMessage MidiFileRetuner::createBulkTuningDump(const std::array<double, 128>& mts, int program, const juce::String& name)
+{
+    const int headerSize = 5;
+    const int size = headerSize + MtsSysExReceiver::nameLength + 128 * 3 + 1;
+
+    juce::uint8 data[size];
+    data[0] = universalNonRealtime;
+    data[1] = allDevices;
+    data[2] = midiTuningStandard;
+    data[3] = bulkDump;
+    data[4] = (juce::uint8)(program & 0x7f);
+
+    // Padded with spaces
+    auto nameData = name.toRawUTF8();
+    bool ended = false;
+    for (int i = 0; i < MtsSysExReceiver::nameLength; i++)
+    {
+        ended = ended || nameData[i] == '\0';
+        data[headerSize + i] = ended ? ' ' : (juce::uint8)(nameData[i] & 0x7f);
+    }
+
+    auto triplets = data + headerSize + MtsSysExReceiver::nameLength;
+    for (int note = 0; note < 128; note++)
+    {
+        auto triplet = (mts[note] < 0) ? MTSTriplet { 0x7f, 0x7f, 0x7f }
+                                       : mtsNoteToTriplet(juce::jlimit(0.0, maxMts, mts[note]));
+        triplets[note * 3] = triplet.coarse;
+        triplets[note * 3 + 1] = triplet.fineUpper;
+        triplets[note * 3 + 2] = triplet.fineLower;
+    }
+
+    juce::uint8 checksum = 0;
+    for (int i = 0; i < size - 1; i++)
+        checksum ^= data[i];
+    data[size - 1] = checksum & 0x7f;
+
+    return juce::MidiMessage::createSysExMessage(data, size);
+}
+
+juce::MidiMessageSequence MidiFileRetuner::mergeTracks(const juce::MidiFile& file)
+{
+    juce::MidiMessageSequence merged;
+    for (int i = 0; i < file.getNumTracks(); i++)
+        merged.addSequence(*file.getTrack(i), 0);
+
+    // Writing the file adds one at the end
+    for (int i = merged.getNumEvents() - 1; i >= 0; i--)
+    {
+        if (merged.getEventPointer(i)->message.isEndOfTrackMetaEvent())
+            merged.deleteEvent(i, false);
+    }
+
+    return merged;
+}
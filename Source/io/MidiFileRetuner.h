@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    MidiFileRetuner.h
+    Created: 20 Oct 2026 2:47:30am
+    Author:  Vincenzo
+
+    Retunes Standard MIDI Files offline, with the same TunerController,
+    MidiVoiceController and MidiNoteTuner pipeline as the plugin.
+
+    Every track is tuned as if it was played into its own plugin instance,
+    so each output track needs its own port or instrument, unless tracks are
+    merged first. Tracks are tuned in parallel, and files are written when
+    their last track is finished.
+
+    MTS output leaves notes unchanged, and starts the first track with bulk
+    tuning dumps of the target tuning. Channels with different tunings are
+    given their own tuning program.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "../MidiVoiceController.h"
+#include "../MtsSysExReceiver.h"
+
+class MidiFileRetuner
+{
+public:
+
+    enum class OutputFormat
+    {
+        Multichannel = 1,   /* Notes are allocated to channels and tuned with pitchbend */
+        Mts                 /* Notes are unchanged, and tuned with MIDI Tuning Standard SysEx */
+    };
+
+    struct Settings
+    {
+        std::shared_ptr<TuningTable> targetTuning;
+        std::shared_ptr<TuningTableMap> targetMapping;  /* nullptr to map the tuning with the mapping options */
+        MappedTuningTable::FrequencyReference targetReference;
+
+        Everytone::Options options;
+
+        OutputFormat format = OutputFormat::Multichannel;
+        bool mergeTracks = false;
+
+        juce::File outputDirectory;
+    };
+
+    struct Result
+    {
+        juce::File input;
+        juce::File output;
+        int numTracks = 0;
+        juce::String error;
+
+        bool wasSuccessful() const { return error.isEmpty(); }
+    };
+
+    using ProgressCallback = std::function<void(const Result& result, int numFinished, int numFiles)>;
+
+private:
+
+    Settings settings;
+    int numThreads;
+
+public:
+
+    MidiFileRetuner(const Settings& settings, int numThreads = juce::SystemStats::getNumCpus());
+
+    // Blocks until every file is written. Output files have the name of the input file, in the output directory.
+    // The callback is called on worker threads as each file is finished, and may be called by several at once.
+    juce::Array<Result> retuneFiles(const juce::Array<juce::File>& files, ProgressCallback progressCallback = nullptr) const;
+
+public:
+
+    // Tunes a track as the plugin would tune its messages in order. Meta events are passed through.
+    // MTS SysEx retunes the target tuning from the next event, instead of after the message thread builds it.
+    static juce::MidiMessageSequence retuneTrack(const juce::MidiMessageSequence& track, const Settings& settings);
+
+    // The target tuning with the same options as the plugin
+    static std::unique_ptr<TunerController> createTunerController(const Settings& settings);
+
+    // Bulk dumps of every distinct channel tuning, followed by tuning program changes if there is more than one
+    static juce::Array<juce::MidiMessage> createMtsMessages(const MappedTuningTable& tuning);
+
+    // Unmapped notes are left unchanged, and pitches are clipped to the MTS range
+    static juce::MidiMessage createBulkTuningDump(const std::array<double, 128>& mts, int program, const juce::String& name);
+
+    // One track with the events of every track, without their end of track events
+    static juce::MidiMessageSequence mergeTracks(const juce::MidiFile& file);
+};
@@ -0,0 +1,324 @@
+/*
+  ==============================================================================
+
+    ScalaBufferParser.cpp
+    Created: 19 Oct 2026 7:48:31pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "ScalaBufferParser.h"
+#include "TUN_V2/TUN_Scale.h"
+
+#include <charconv>
+
+namespace
+{
+    // Splits lines the same way as TUN::CStringParser::GetLineAndTrim, which ends a line at
+    // '\n', '\r' or '\0', and reads one more empty line at the end of the data.
+    // Only lines ending with the first kind of terminator found are counted.
+    class LineReader
+    {
+        std::string_view text;
+        size_t position = 0;
+        bool finished = false;
+
+        char countedTerminator = '@';
+        long lineCount = -1;
+
+    public:
+
+        LineReader(std::string_view textIn) : text(textIn) {}
+
+        long getLineCount() const { return lineCount; }
+
+        float getProgress() const { return text.empty() ? 1.0f : (float)std::min(position, text.size()) / (float)text.size(); }
+
+        bool next(std::string_view& line)
+        {
+            if (finished)
+                return false;
+
+            auto end = position;
+            while (end < text.size() && text[end] != '\n' && text[end] != '\r' && text[end] != '\0')
+                end++;
+
+            char terminator = '\0';
+            if (end < text.size())
+                terminator = text[end];
+            else
+                finished = true;
+
+            if (countedTerminator == '@')
+                countedTerminator = terminator;
+
+            if (terminator == countedTerminator)
+                lineCount++;
+
+            line = trim(text.substr(position, end - position));
+            position = end + 1;
+            return true;
+        }
+
+        // Empty lines and comments are skipped
+        bool nextData(std::string_view& line)
+        {
+            while (next(line))
+            {
+                if (!line.empty() && line[0] != '!')
+                    return true;
+            }
+            return false;
+        }
+
+        static bool isWhitespace(char c)
+        {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        static std::string_view trim(std::string_view str)
+        {
+            size_t start = 0;
+            while (start < str.size() && isWhitespace(str[start]))
+                start++;
+
+            size_t end = str.size();
+            while (end > start && isWhitespace(str[end - 1]))
+                end--;
+
+            return str.substr(start, end - start);
+        }
+    };
+
+    size_t readDoubleWithStrtod(std::string_view str, double& value)
+    {
+        std::string copy(str);
+        char* end = nullptr;
+        value = std::strtod(copy.c_str(), &end);
+        return (size_t)(end - copy.c_str());
+    }
+
+    // Reads a number like strtod, returns the number of characters read, or 0 if there is no number
+    size_t readDouble(std::string_view str, double& value)
+    {
+#ifndef __cpp_lib_to_chars
+        // Floating point from_chars is missing from some standard libraries, such as Apple's libc++
+        return readDoubleWithStrtod(str, value);
+#else
+        size_t start = 0;
+        while (start < str.size() && LineReader::isWhitespace(str[start]))
+            start++;
+
+        // from_chars doesn't accept a plus sign
+        size_t numberStart = start;
+        if (numberStart + 1 < str.size() && str[numberStart] == '+' && str[numberStart + 1] != '+' && str[numberStart + 1] != '-')
+            numberStart++;
+
+        auto first = str.data() + numberStart;
+        auto last = str.data() + str.size();
+        auto result = std::from_chars(first, last, value, std::chars_format::general);
+
+        // Hexadecimal, out of range and invalid numbers are rare, so these are left to strtod
+        bool isHex = result.ptr < last && (*result.ptr == 'x' || *result.ptr == 'X');
+        if (result.ec != std::errc() || isHex)
+            return readDoubleWithStrtod(str, value);
+
+        return (size_t)(result.ptr - str.data());
+#endif
+    }
+
+    // Reads a number like atol
+    long readLong(std::string_view str)
+    {
+        size_t start = 0;
+        while (start < str.size() && LineReader::isWhitespace(str[start]))
+            start++;
+
+        bool negative = false;
+        if (start < str.size() && (str[start] == '+' || str[start] == '-'))
+        {
+            negative = str[start] == '-';
+            start++;
+        }
+
+        if (start >= str.size() || str[start] < '0' || str[start] > '9')
+            return 0;
+
+        unsigned long magnitude = 0;
+        auto result = std::from_chars(str.data() + start, str.data() + str.size(), magnitude);
+        if (result.ec == std::errc::result_out_of_range || magnitude > (unsigned long)std::numeric_limits<long>::max())
+            return negative ? std::numeric_limits<long>::min() : std::numeric_limits<long>::max();
+
+        return negative ? -(long)magnitude : (long)magnitude;
+    }
+
+    template <typename T>
+    T restrictMinMax(T value, T min, T max)
+    {
+        return (value < min) ? min : ((value > max) ? max : value);
+    }
+
+    bool setError(juce::String& error, const juce::String& message, long lineNumber = -1)
+    {
+        error = (lineNumber >= 0)
+            ? "Line " + juce::String(lineNumber) + ": " + message
+            : message;
+        return false;
+    }
+}
+
+bool ScalaBufferParser::parseScale(std::string_view text, ScalaBufferParser::Scale& scale, juce::String& error, const ProgressCallback& progressCallback)
+{
+    LineReader reader(text);
+    std::string_view line;
+
+    // The first line is always the name
+    reader.next(line);
+    if (!line.empty() && line[0] == '!')
+        line = LineReader::trim(line.substr(1));
+    scale.name = juce::String::fromUTF8(line.data(), (int)line.size());
+    scale.description = juce::String();
+    scale.intervalCents.clearQuick();
+
+    bool descriptionRead = false;
+    long scaleSize = -1;
+    long currentNote = 0;
+
+    while (reader.nextData(line))
+    {
+        if (progressCallback && !progressCallback(reader.getProgress()))
+            return setError(error, "Cancelled.");
+
+        if (!descriptionRead)
+        {
+            descriptionRead = true;
+
+            // If the line only has digits, there is no description
+            if (line.find_first_not_of("0123456789") != std::string_view::npos)
+            {
+                scale.description = juce::String::fromUTF8(line.data(), (int)line.size());
+                continue;
+            }
+        }
+
+        if (scaleSize < 0)
+        {
+            scaleSize = readLong(line);
+            if (scaleSize < 1 || scaleSize > 127)
+                return setError(error, "Scale size not allowed. Must be within [1;127].", reader.getLineCount());
+
+            scale.intervalCents.ensureStorageAllocated((int)scaleSize);
+            continue;
+        }
+
+        if (++currentNote > scaleSize)
+            return setError(error, "End of file expected, but further data found.", reader.getLineCount());
+
+        // Cents values contain a period, anything else is a ratio
+        auto periodPosition = line.find_first_not_of("+-0123456789");
+        double cents = 0;
+
+        if (periodPosition == std::string_view::npos || line[periodPosition] != '.')
+        {
+            double numerator = 0;
+            auto position = readDouble(line, numerator);
+
+            while (position < line.size() && LineReader::isWhitespace(line[position]))
+                position++;
+
+            if (position >= line.size() || line[position] != '/')
+                return setError(error, "Unknown operator. '/' expected.", reader.getLineCount());
+
+            double denominator = 0;
+            readDouble(line.substr(position + 1), denominator);
+            if (denominator == 0)
+                return setError(error, "Division by zero.", reader.getLineCount());
+
+            cents = TUN::Factor2Cents(numerator / denominator);
+        }
+        else
+        {
+            readDouble(line, cents);
+        }
+
+        scale.intervalCents.add(cents);
+    }
+
+    if (!descriptionRead || scaleSize < 0)
+        return setError(error, "No data in file.", reader.getLineCount());
+
+    if (currentNote < scaleSize)
+        return setError(error, "Less tuning entries found than expected.", reader.getLineCount());
+
+    return true;
+}
+
+bool ScalaBufferParser::parseKeyboardMapping(std::string_view text, ScalaBufferParser::KeyboardMapping& mapping, juce::String& error)
+{
+    mapping = KeyboardMapping();
+
+    LineReader reader(text);
+    std::string_view line;
+
+    for (int setting = 0; setting < 7; setting++)
+    {
+        if (!reader.nextData(line))
+            return setError(error, "Premature end of file.", reader.getLineCount());
+
+        auto value = readLong(line);
+        bool valueIsValid = true;
+
+        switch (setting)
+        {
+        case 0:
+            mapping.patternSize = (int)restrictMinMax(value, 1L, 127L);
+            break;
+        case 1:
+            mapping.firstNote = (int)restrictMinMax(value, 0L, 127L);
+            break;
+        case 2:
+            mapping.lastNote = (int)restrictMinMax(value, 0L, 127L);
+            valueIsValid = mapping.firstNote < mapping.lastNote;
+            break;
+        case 3:
+            mapping.middleNote = (int)restrictMinMax(value, 0L, 127L);
+            valueIsValid = mapping.middleNote + mapping.patternSize <= 127;
+            break;
+        case 4:
+            mapping.referenceNote = (int)restrictMinMax(value, 0L, 127L);
+            break;
+        case 5:
+        {
+            double frequency = 0;
+            readDouble(line, frequency);
+            mapping.referenceFrequency = restrictMinMax(frequency, 0.001, 100000.0);
+            break;
+        }
+        case 6:
+            mapping.formalOctave = (int)restrictMinMax(value, 0L, 127L);
+            break;
+        }
+
+        if (!valueIsValid)
+            return setError(error, "Setting out of range.", reader.getLineCount());
+    }
+
+    // Missing entries at the end of the file are unmapped
+    mapping.keys.clearQuick();
+    mapping.keys.insertMultiple(0, -1, mapping.patternSize);
+
+    for (int key = 0; key < mapping.patternSize; key++)
+    {
+        if (!reader.nextData(line))
+            break;
+
+        if (line[0] != 'x' && line[0] != 'X')
+            mapping.keys.set(key, (int)restrictMinMax(readLong(line), 0L, 127L));
+    }
+
+    if (reader.nextData(line))
+        return setError(error, "End of file expected, but additional data found.", reader.getLineCount());
+
+    return true;
+}
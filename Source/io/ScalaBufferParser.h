@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    ScalaBufferParser.h
+    Created: 19 Oct 2026 7:48:31pm
+    Author:  Vincenzo
+
+    Reads Scala .scl and .kbm data from a memory buffer with std::string_view
+    and std::from_chars, without copying lines or tokens. Results and error
+    messages match TUN::CSCL_Import::ReadSCL and ReadKBM.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string_view>
+#include <functional>
+
+class ScalaBufferParser
+{
+public:
+
+    struct Scale
+    {
+        juce::String name;                  /* First line, without a leading '!' */
+        juce::String description;
+        juce::Array<double> intervalCents;  /* Excluding unison and ending with the period */
+    };
+
+    // Defaults are the same as an unmapped keyboard in CSCL_Import
+    struct KeyboardMapping
+    {
+        int patternSize = 12;               /* The pattern repeats every so many keys */
+        int firstNote = 0;                  /* First MIDI note to retune */
+        int lastNote = 127;                 /* Last MIDI note to retune */
+        int middleNote = 0;                 /* MIDI note that scale degree 0 is mapped to */
+        int referenceNote = 69;             /* MIDI note that the reference frequency is given for */
+        double referenceFrequency = 440.0;
+        int formalOctave = 12;              /* Scale degree that counts as the period of the pattern */
+
+        juce::Array<int> keys = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }; /* Scale degree of each key in the pattern, -1 if unmapped */
+    };
+
+    // Called with the fraction of the data that was read, return false to cancel
+    using ProgressCallback = std::function<bool(float progress)>;
+
+public:
+
+    // Returns false and sets the error if the data is not a valid scale, or if the progress callback cancelled it
+    static bool parseScale(std::string_view text, Scale& scale, juce::String& error, const ProgressCallback& progressCallback = nullptr);
+
+    // Returns false and sets the error if the data is not a valid keyboard mapping
+    static bool parseKeyboardMapping(std::string_view text, KeyboardMapping& mapping, juce::String& error);
+
+    static std::string_view viewOf(const juce::MemoryBlock& data)
+    {
+        return std::string_view(static_cast<const char*>(data.getData()), data.getSize());
+    }
+};
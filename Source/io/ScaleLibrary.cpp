@@ -0,0 +1,413 @@
+/*
+  ==============================================================================
+
+    ScaleLibrary.cpp
+    Created: 19 Oct 2026 4:05:52pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "ScaleLibrary.h"
+
+class ScaleLibrary::ParseJob : public juce::ThreadPoolJob
+{
+    const juce::Array<juce::File>& files;
+    int start;
+    int end;
+
+public:
+
+    juce::Array<Entry> parsed;
+    juce::Array<Entry> failed;  // Only the file path and modification time are set
+
+    ParseJob(const juce::Array<juce::File>& filesIn, int startIn, int endIn)
+        : juce::ThreadPoolJob("ScaleLibraryParse"),
+          files(filesIn),
+          start(startIn),
+          end(endIn) {}
+
+    JobStatus runJob() override
+    {
+        for (int i = start; i < end; i++)
+        {
+            if (shouldExit())
+                break;
+
+            Entry entry;
+            if (ScaleLibrary::parseEntry(files.getReference(i), entry))
+                parsed.add(entry);
+            else
+                failed.add(entry);
+        }
+
+        return JobStatus::jobHasFinished;
+    }
+};
+
+const ScaleLibrary::Entry* ScaleLibrary::findEntry(const juce::String& filePath) const
+{
+    auto indexed = entryIndices.find(filePath);
+    if (indexed == entryIndices.end())
+        return nullptr;
+
+    return &entries.getReference(indexed->second);
+}
+
+void ScaleLibrary::addEntry(ScaleLibrary::Entry entry)
+{
+    failedFiles.erase(entry.filePath);
+
+    auto indexed = entryIndices.find(entry.filePath);
+    if (indexed == entryIndices.end())
+    {
+        entryIndices[entry.filePath] = entries.size();
+        entryIndicesBySize[entry.size()].add(entries.size());
+        entries.add(entry);
+        return;
+    }
+
+    auto& existing = entries.getReference(indexed->second);
+    if (existing.size() != entry.size())
+    {
+        entryIndicesBySize[existing.size()].removeFirstMatchingValue(indexed->second);
+        entryIndicesBySize[entry.size()].add(indexed->second);
+    }
+
+    existing = entry;
+}
+
+void ScaleLibrary::clear()
+{
+    entries.clear();
+    failedFiles.clear();
+    rebuildIndices();
+}
+
+ScaleLibrary::ScanResult ScaleLibrary::scanDirectory(juce::File directory, int numThreads)
+{
+    ScanResult result;
+
+    auto files = directory.findChildFiles(juce::File::findFiles, true, "*.scl");
+
+    juce::Array<juce::File> filesToParse;
+    juce::Array<bool> keepEntry;
+    keepEntry.insertMultiple(0, false, entries.size());
+
+    // Failures of files that no longer exist are dropped
+    std::unordered_map<juce::String, juce::int64, StringHash> unchangedFailures;
+
+    for (auto& file : files)
+    {
+        auto filePath = file.getFullPathName();
+        auto modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        auto indexed = entryIndices.find(filePath);
+        if (indexed != entryIndices.end())
+        {
+            keepEntry.set(indexed->second, true);
+
+            if (modificationTime == entries.getReference(indexed->second).modificationTime)
+            {
+                result.unchanged++;
+                continue;
+            }
+        }
+        else
+        {
+            auto failure = failedFiles.find(filePath);
+            if (failure != failedFiles.end() && failure->second == modificationTime)
+            {
+                unchangedFailures.insert(*failure);
+                result.unchanged++;
+                continue;
+            }
+        }
+
+        filesToParse.add(file);
+    }
+
+    failedFiles.swap(unchangedFailures);
+
+    if (numThreads <= 0)
+        numThreads = juce::jmax(1, juce::SystemStats::getNumCpus());
+
+    int filesPerJob = juce::jmax(1, (filesToParse.size() + numThreads - 1) / numThreads);
+
+    juce::ThreadPool pool(numThreads);
+    juce::OwnedArray<ParseJob> jobs;
+
+    for (int start = 0; start < filesToParse.size(); start += filesPerJob)
+    {
+        auto end = juce::jmin(start + filesPerJob, filesToParse.size());
+        auto job = jobs.add(new ParseJob(filesToParse, start, end));
+        pool.addJob(job, false);
+    }
+
+    // Entries of changed files that no longer parse are counted as failed, not removed
+    int numFailedEntries = 0;
+
+    for (auto job : jobs)
+    {
+        pool.waitForJobToFinish(job, -1);
+
+        for (auto& entry : job->parsed)
+        {
+            auto indexed = entryIndices.find(entry.filePath);
+            if (indexed == entryIndices.end())
+            {
+                entryIndices[entry.filePath] = entries.size();
+                entries.add(entry);
+                keepEntry.add(true);
+                result.added++;
+            }
+            else
+            {
+                entries.set(indexed->second, entry);
+                result.updated++;
+            }
+        }
+
+        for (auto& entry : job->failed)
+        {
+            failedFiles[entry.filePath] = entry.modificationTime;
+            result.failed++;
+
+            auto indexed = entryIndices.find(entry.filePath);
+            if (indexed != entryIndices.end())
+            {
+                keepEntry.set(indexed->second, false);
+                numFailedEntries++;
+            }
+        }
+    }
+
+    // Remove entries of files that no longer exist
+    juce::Array<Entry> keptEntries;
+    keptEntries.ensureStorageAllocated(entries.size());
+
+    for (int i = 0; i < entries.size(); i++)
+    {
+        if (keepEntry[i])
+            keptEntries.add(entries.getReference(i));
+        else
+            result.removed++;
+    }
+
+    entries.swapWith(keptEntries);
+    rebuildIndices();
+
+    result.removed -= numFailedEntries;
+
+    juce::Logger::writeToLog("Scale library scan of " + directory.getFullPathName() + ": "
+                             + juce::String(result.added) + " added, "
+                             + juce::String(result.updated) + " updated, "
+                             + juce::String(result.removed) + " removed, "
+                             + juce::String(result.failed) + " failed");
+
+    return result;
+}
+
+juce::Array<int> ScaleLibrary::search(const ScaleLibrary::Query& query) const
+{
+    struct Match
+    {
+        int index;
+        double distance;
+    };
+
+    std::vector<Match> matches;
+
+    auto matchEntry = [&](int index)
+    {
+        const auto& entry = entries.getReference(index);
+
+        if (query.periodCents > 0 && std::abs(entry.periodCents() - query.periodCents) > query.periodTolerance)
+            return;
+
+        if (query.nameContains.isNotEmpty()
+            && !entry.name.containsIgnoreCase(query.nameContains)
+            && !juce::File(entry.filePath).getFileName().containsIgnoreCase(query.nameContains))
+            return;
+
+        double distance = (query.nearestIntervals.size() > 0)
+            ? intervalDistance(query.nearestIntervals, entry.intervalCents)
+            : 0.0;
+
+        matches.push_back({ index, distance });
+    };
+
+    // Only entries of the requested size are looked at
+    if (query.noteCount > 0)
+    {
+        auto sameSize = entryIndicesBySize.find(query.noteCount);
+        if (sameSize != entryIndicesBySize.end())
+        {
+            matches.reserve((size_t)sameSize->second.size());
+            for (auto index : sameSize->second)
+                matchEntry(index);
+        }
+    }
+    else
+    {
+        matches.reserve((size_t)entries.size());
+        for (int i = 0; i < entries.size(); i++)
+            matchEntry(i);
+    }
+
+    auto compare = [&](const Match& a, const Match& b)
+    {
+        if (a.distance != b.distance)
+            return a.distance < b.distance;
+
+        return entries.getReference(a.index).name.compareIgnoreCase(entries.getReference(b.index).name) < 0;
+    };
+
+    int numResults = (query.maxResults > 0) ? juce::jmin(query.maxResults, (int)matches.size())
+                                            : (int)matches.size();
+
+    std::partial_sort(matches.begin(), matches.begin() + numResults, matches.end(), compare);
+
+    juce::Array<int> results;
+    for (int i = 0; i < numResults; i++)
+        results.add(matches[i].index);
+
+    return results;
+}
+
+bool ScaleLibrary::saveIndex(juce::File indexFile) const
+{
+    indexFile.deleteFile();
+
+    juce::FileOutputStream stream(indexFile);
+    if (!stream.openedOk())
+    {
+        juce::Logger::writeToLog("Unable to write scale library index: " + indexFile.getFullPathName());
+        return false;
+    }
+
+    stream.writeInt(indexMagic);
+    stream.writeInt(indexVersion);
+    stream.writeCompressedInt(entries.size());
+
+    for (const auto& entry : entries)
+    {
+        stream.writeString(entry.filePath);
+        stream.writeInt64(entry.modificationTime);
+        stream.writeString(entry.name);
+        stream.writeString(entry.description);
+
+        stream.writeCompressedInt(entry.intervalCents.size());
+        for (auto cents : entry.intervalCents)
+            stream.writeDouble(cents);
+    }
+
+    stream.writeCompressedInt((int)failedFiles.size());
+    for (const auto& failure : failedFiles)
+    {
+        stream.writeString(failure.first);
+        stream.writeInt64(failure.second);
+    }
+
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+bool ScaleLibrary::loadIndex(juce::File indexFile)
+{
+    juce::FileInputStream stream(indexFile);
+    if (!stream.openedOk())
+        return false;
+
+    if (stream.readInt() != indexMagic || stream.readInt() != indexVersion)
+    {
+        juce::Logger::writeToLog("Scale library index is invalid or out of date: " + indexFile.getFullPathName());
+        return false;
+    }
+
+    int numEntries = stream.readCompressedInt();
+
+    juce::Array<Entry> loadedEntries;
+    loadedEntries.ensureStorageAllocated(numEntries);
+
+    for (int i = 0; i < numEntries; i++)
+    {
+        Entry entry;
+        entry.filePath = stream.readString();
+        entry.modificationTime = stream.readInt64();
+        entry.name = stream.readString();
+        entry.description = stream.readString();
+
+        int numIntervals = stream.readCompressedInt();
+        if (numIntervals <= 0 || stream.isExhausted())
+            return false;
+
+        entry.intervalCents.ensureStorageAllocated(numIntervals);
+        for (int n = 0; n < numIntervals; n++)
+            entry.intervalCents.add(stream.readDouble());
+
+        loadedEntries.add(entry);
+    }
+
+    std::unordered_map<juce::String, juce::int64, StringHash> loadedFailures;
+
+    int numFailures = stream.readCompressedInt();
+    for (int i = 0; i < numFailures; i++)
+    {
+        auto filePath = stream.readString();
+        loadedFailures[filePath] = stream.readInt64();
+    }
+
+    entries.swapWith(loadedEntries);
+    failedFiles.swap(loadedFailures);
+    rebuildIndices();
+    return true;
+}
+
+double ScaleLibrary::intervalDistance(const juce::Array<double>& queryCents, const juce::Array<double>& entryCents)
+{
+    if (queryCents.size() == 0 || entryCents.size() == 0)
+        return 0.0;
+
+    double total = 0.0;
+    for (auto query : queryCents)
+    {
+        double closest = std::abs(query);
+        for (auto cents : entryCents)
+            closest = juce::jmin(closest, std::abs(query - cents));
+
+        total += closest;
+    }
+
+    return total / queryCents.size();
+}
+
+bool ScaleLibrary::parseEntry(juce::File scalaFile, ScaleLibrary::Entry& entry)
+{
+    entry.filePath = scalaFile.getFullPathName();
+    entry.modificationTime = scalaFile.getLastModificationTime().toMilliseconds();
+
+    auto parsed = TuningFileParser::parseFile(scalaFile);
+    auto tuning = dynamic_cast<FunctionalTuning*>(parsed.tuning.get());
+    if (tuning == nullptr)
+        return false;
+
+    entry.name = tuning->getName();
+    entry.description = tuning->getDescription();
+    entry.intervalCents = tuning->getIntervalCentsList();
+
+    return entry.intervalCents.size() > 0;
+}
+
+void ScaleLibrary::rebuildIndices()
+{
+    entryIndices.clear();
+    entryIndicesBySize.clear();
+
+    for (int i = 0; i < entries.size(); i++)
+    {
+        const auto& entry = entries.getReference(i);
+        entryIndices[entry.filePath] = i;
+        entryIndicesBySize[entry.size()].add(i);
+    }
+}
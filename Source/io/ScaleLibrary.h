@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ScaleLibrary.h
+    Created: 19 Oct 2026 4:05:52pm
+    Author:  Vincenzo
+
+    An index of .scl files in a directory tree that can be searched without
+    reparsing the files. Scans are incremental by file modification time,
+    including for files that failed to parse.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "TuningFileParser.h"
+#include <unordered_map>
+
+class ScaleLibrary
+{
+public:
+
+    struct Entry
+    {
+        juce::String filePath;
+        juce::int64 modificationTime = 0;
+
+        juce::String name;
+        juce::String description;
+
+        // Interval list excluding unison and ending with the period
+        juce::Array<double> intervalCents;
+
+        int size() const { return intervalCents.size(); }
+        double periodCents() const { return intervalCents.getLast(); }
+    };
+
+    struct Query
+    {
+        juce::String nameContains;              /* Case-insensitive, matches name or file name */
+        int noteCount = 0;                      /* 0 for any size */
+        double periodCents = 0;                 /* 0 for any period */
+        double periodTolerance = 0.5;           /* In cents */
+        juce::Array<double> nearestIntervals;   /* Results are ranked by distance to these intervals */
+        int maxResults = 50;
+    };
+
+    struct ScanResult
+    {
+        int added = 0;
+        int updated = 0;
+        int unchanged = 0;      /* Includes files that failed before and didn't change */
+        int removed = 0;
+        int failed = 0;         /* Files that were parsed and failed in this scan */
+    };
+
+private:
+
+    class ParseJob;
+
+    struct StringHash
+    {
+        size_t operator()(const juce::String& str) const { return (size_t)str.hash(); }
+    };
+
+    juce::Array<Entry> entries;
+
+    // Built from entries by rebuildIndices()
+    std::unordered_map<juce::String, int, StringHash> entryIndices;     // By file path
+    std::unordered_map<int, juce::Array<int>> entryIndicesBySize;       // By note count
+
+    // Modification times of files that couldn't be parsed, so they're skipped until they change
+    std::unordered_map<juce::String, juce::int64, StringHash> failedFiles;
+
+    static const juce::int32 indexMagic = 0x4c535445; // "ETSL"
+    static const juce::int32 indexVersion = 2;
+
+public:
+
+    ScaleLibrary() {}
+
+    int getNumEntries() const { return entries.size(); }
+    const Entry& getEntry(int index) const { return entries.getReference(index); }
+
+    // Returns nullptr if the file isn't in the library
+    const Entry* findEntry(const juce::String& filePath) const;
+
+    int getNumFailedFiles() const { return (int)failedFiles.size(); }
+
+    // Replaces any entry with the same file path
+    void addEntry(Entry entry);
+
+    void clear();
+
+    // Parses new and modified .scl files with a thread pool, and removes entries for missing files.
+    // This blocks until the scan is finished, so call it from a background thread.
+    ScanResult scanDirectory(juce::File directory, int numThreads = 0);
+
+    // Returns indices of matching entries, sorted by interval distance if requested, otherwise by name
+    juce::Array<int> search(const Query& query) const;
+
+    bool saveIndex(juce::File indexFile) const;
+    bool loadIndex(juce::File indexFile);
+
+public:
+
+    // Average distance in cents from each query interval to the closest interval of the entry
+    static double intervalDistance(const juce::Array<double>& queryCents, const juce::Array<double>& entryCents);
+
+    // The file path and modification time are set even if parsing fails
+    static bool parseEntry(juce::File scalaFile, Entry& entry);
+
+private:
+
+    void rebuildIndices();
+};
@@ -97,9 +97,16 @@ struct SRVParam
 
 
 
+// Compiled form of a list of formulas, see TUN_FormulaProgram.h
+class CFormulaProgram;
+
+
+
 // Handling of formulas
 class CFormula
 {
+	friend class CFormulaProgram;
+
 public:
 	// At construction time, the note index, the formula refers to, must be given.
 	// ATTENTION: The calling source code is responsible that lMyIndex is valid!
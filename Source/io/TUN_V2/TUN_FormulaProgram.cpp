@@ -0,0 +1,311 @@
+// TUN_FormulaProgram.cpp: Implementation of the class CFormulaProgram.
+//
+// Read TUN_FormulaProgram.h for more informations about this class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdlib>
+
+#include "TUN_FormulaProgram.h"
+
+
+
+
+
+namespace TUN
+{
+
+
+
+
+
+void CFormulaProgram::Reset()
+{
+	m_bCompiled = false;
+	m_bEvaluated = false;
+	m_lBaseNote = 69;
+	m_vInstructions.clear();
+	m_vdblSlots.clear();
+	m_vlNoteSlots.clear();
+	m_vlBaseSlotsUsed.clear();
+	m_vlBaseDependent.clear();
+	m_vlNotesDependent.clear();
+	m_err.SetOK();
+}
+
+
+
+bool CFormulaProgram::ResolveParam(const SRVParam & rvp, long lScaleNoteIndex, SCompileState & state, long & lSlot, double & dblValue)
+{
+	long	lNote;
+	switch ( rvp.m_paramtype )
+	{
+	case SRVParam::t_AbsRef:	lNote = rvp.m_lRef; break;
+	case SRVParam::t_RelRef:	lNote = lScaleNoteIndex + rvp.m_lRef; break;
+	default:
+		lSlot = -1;
+		dblValue = rvp.m_dblValue;
+		return true;
+	}
+
+	if ( (lNote < 0) || (lNote >= MaxNumOfNotes) )
+		return false;
+
+	lSlot = ApplyPendingFactors(lNote, state);
+	dblValue = 0;
+	return true;
+}
+
+
+
+long CFormulaProgram::ApplyPendingFactors(long lNote, SCompileState & state)
+{
+	// Factors of "!" formulas are only applied to notes which are read afterwards
+	long	lNumOfFactors = (long) state.vlFactorSlots.size();
+	for ( long f = state.vlFirstPendingFactor[lNote] ; f < lNumOfFactors ; ++f )
+	{
+		SInstruction	instr;
+		instr.m_op = SInstruction::op_Scale;
+		instr.m_lRangeSlot = state.vlCurrentSlots[lNote];
+		instr.m_lShiftSlot = state.vlFactorSlots[f];
+		state.vInstructions.push_back(instr);
+		state.vlCurrentSlots[lNote] = MaxNumOfNotes + (long) state.vInstructions.size() - 1;
+	}
+	state.vlFirstPendingFactor[lNote] = lNumOfFactors;
+	return state.vlCurrentSlots[lNote];
+}
+
+
+
+bool CFormulaProgram::Compile(const std::list<CFormula> & lformulas, long lBaseNote)
+{
+	Reset();
+	m_lBaseNote = lBaseNote;
+
+	SCompileState	state;
+	state.vlCurrentSlots.resize(MaxNumOfNotes);
+	state.vlFirstPendingFactor.assign(MaxNumOfNotes, 0);
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+		state.vlCurrentSlots[i] = i;
+	state.vInstructions.reserve(lformulas.size() + MaxNumOfNotes);
+
+	std::list<CFormula>::const_iterator	it;
+	for ( it = lformulas.begin() ; it != lformulas.end() ; ++it )
+	{
+		const CFormula &	formula = *it;
+
+		// Same iteration as CFormula::Apply()
+		long lInc = ( formula.m_lLoop >= 0 ? +1 : -1 );
+		long l = 0;
+		do
+		{
+			long	scaleNoteIndex = formula.m_lMyIndex + l;
+			if ( (scaleNoteIndex < 0) || (scaleNoteIndex >= MaxNumOfNotes) )
+				break;
+
+			SInstruction	instr;
+			instr.m_dblMUL = 1;
+			instr.m_dblDIV = 1;
+			instr.m_dblCentsFactor = 1;
+			instr.m_lShiftSlot = -1;
+			instr.m_dblShiftHz = 0;
+
+			if ( formula.m_dblEnsureHz > 0 )
+			{
+				// Every note is scaled by this factor, see ApplyPendingFactors()
+				instr.m_op = SInstruction::op_EnsureFactor;
+				instr.m_lRangeSlot = ApplyPendingFactors(scaleNoteIndex, state);
+				instr.m_dblRangeHz = formula.m_dblEnsureHz;
+				state.vInstructions.push_back(instr);
+				state.vlFactorSlots.push_back(MaxNumOfNotes + (long) state.vInstructions.size() - 1);
+			}
+			else
+			{
+				instr.m_op = SInstruction::op_Set;
+				if ( !ResolveParam(formula.m_rvpRangeHz, scaleNoteIndex, state, instr.m_lRangeSlot, instr.m_dblRangeHz) ||
+					 !ResolveParam(formula.m_rvpShiftHz, scaleNoteIndex, state, instr.m_lShiftSlot, instr.m_dblShiftHz) )
+				{
+					Reset();
+					return m_err.SetError("Formula parameter refers to invalid note index!");
+				}
+				instr.m_dblMUL = formula.m_dblMUL;
+				instr.m_dblDIV = formula.m_dblDIV;
+				instr.m_dblCentsFactor = pow(2, formula.m_dblCENTS/1200);
+				state.vInstructions.push_back(instr);
+
+				// The new value replaces any factors which were not applied yet
+				state.vlCurrentSlots[scaleNoteIndex] = MaxNumOfNotes + (long) state.vInstructions.size() - 1;
+				state.vlFirstPendingFactor[scaleNoteIndex] = (long) state.vlFactorSlots.size();
+			}
+
+			l += lInc;
+		} while ( std::abs(l) < std::abs(formula.m_lLoop) );
+	}
+
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+		ApplyPendingFactors(i, state);
+
+	m_vlNoteSlots = state.vlCurrentSlots;
+	RemoveUnusedInstructions(state.vInstructions);
+
+	m_bCompiled = true;
+	return m_err.SetOK();
+}
+
+
+
+void CFormulaProgram::RemoveUnusedInstructions(std::vector<SInstruction> & vInstructions)
+{
+	long	lNumOfSlots = MaxNumOfNotes + (long) vInstructions.size();
+
+	// Walk backwards from the final note values to find the slots which are read
+	std::vector<char>	vbSlotUsed(lNumOfSlots, false);
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+		vbSlotUsed.at(m_vlNoteSlots.at(i)) = true;
+
+	for ( long i = (long) vInstructions.size() - 1 ; i >= 0 ; --i )
+	{
+		if ( !vbSlotUsed.at(MaxNumOfNotes + i) )
+			continue;
+
+		const SInstruction &	instr = vInstructions.at(i);
+		if ( instr.m_lRangeSlot >= 0 )
+			vbSlotUsed.at(instr.m_lRangeSlot) = true;
+		if ( instr.m_lShiftSlot >= 0 )
+			vbSlotUsed.at(instr.m_lShiftSlot) = true;
+	}
+
+	// Renumber the remaining slots and find what depends on the base frequency
+	std::vector<long>	vlNewSlot(lNumOfSlots, -1);
+	std::vector<char>	vbBaseDependent(lNumOfSlots, false);
+
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+	{
+		vlNewSlot.at(i) = i;
+		vbBaseDependent.at(i) = true;
+		if ( vbSlotUsed.at(i) )
+			m_vlBaseSlotsUsed.push_back(i);
+	}
+
+	m_vInstructions.reserve(vInstructions.size());
+	for ( long i = 0 ; i < (long) vInstructions.size() ; ++i )
+	{
+		long	lSlot = MaxNumOfNotes + i;
+		if ( !vbSlotUsed.at(lSlot) )
+			continue;
+
+		SInstruction	instr = vInstructions.at(i);
+		bool			bBaseDependent = false;
+
+		if ( instr.m_lRangeSlot >= 0 )
+		{
+			bBaseDependent |= vbBaseDependent.at(instr.m_lRangeSlot);
+			instr.m_lRangeSlot = vlNewSlot.at(instr.m_lRangeSlot);
+		}
+		if ( instr.m_lShiftSlot >= 0 )
+		{
+			bBaseDependent |= vbBaseDependent.at(instr.m_lShiftSlot);
+			instr.m_lShiftSlot = vlNewSlot.at(instr.m_lShiftSlot);
+		}
+
+		vbBaseDependent.at(lSlot) = bBaseDependent;
+		if ( bBaseDependent )
+			m_vlBaseDependent.push_back((long) m_vInstructions.size());
+
+		vlNewSlot.at(lSlot) = MaxNumOfNotes + (long) m_vInstructions.size();
+		m_vInstructions.push_back(instr);
+	}
+
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+	{
+		if ( vbBaseDependent.at(m_vlNoteSlots.at(i)) )
+			m_vlNotesDependent.push_back(i);
+		m_vlNoteSlots.at(i) = vlNewSlot.at(m_vlNoteSlots.at(i));
+	}
+
+	m_vdblSlots.assign(MaxNumOfNotes + m_vInstructions.size(), 0);
+}
+
+
+
+void CFormulaProgram::EvaluateBaseSlots(double dblBaseFreqHz)
+{
+	// Same as CSingleScale::InitEqual()
+	for ( size_t i = 0 ; i < m_vlBaseSlotsUsed.size() ; ++i )
+	{
+		long	lNote = m_vlBaseSlotsUsed[i];
+		m_vdblSlots[lNote] = dblBaseFreqHz * pow(2, (lNote - m_lBaseNote) / 12.);
+	}
+}
+
+
+
+inline void CFormulaProgram::Execute(long lInstruction)
+{
+	const SInstruction &	instr = m_vInstructions[lInstruction];
+	double *				pdblSlots = &m_vdblSlots[0];
+	double &				dblResult = pdblSlots[MaxNumOfNotes + lInstruction];
+
+	switch ( instr.m_op )
+	{
+	case SInstruction::op_Set:
+		{
+			double	dblRangeHz = ( instr.m_lRangeSlot >= 0 ? pdblSlots[instr.m_lRangeSlot] : instr.m_dblRangeHz );
+			double	dblShiftHz = ( instr.m_lShiftSlot >= 0 ? pdblSlots[instr.m_lShiftSlot] : instr.m_dblShiftHz );
+			dblResult = dblRangeHz * instr.m_dblMUL / instr.m_dblDIV * instr.m_dblCentsFactor + dblShiftHz;
+		}
+		break;
+	case SInstruction::op_EnsureFactor:
+		dblResult = instr.m_dblRangeHz / pdblSlots[instr.m_lRangeSlot];
+		break;
+	case SInstruction::op_Scale:
+		dblResult = pdblSlots[instr.m_lRangeSlot] * pdblSlots[instr.m_lShiftSlot];
+		break;
+	}
+}
+
+
+
+void CFormulaProgram::Evaluate(double dblBaseFreqHz, std::vector<double> & vdblNoteFrequenciesHz)
+{
+	EvaluateBaseSlots(dblBaseFreqHz);
+
+	long	lNumOfInstructions = (long) m_vInstructions.size();
+	for ( long i = 0 ; i < lNumOfInstructions ; ++i )
+		Execute(i);
+
+	vdblNoteFrequenciesHz.resize(MaxNumOfNotes);
+	for ( long i = 0 ; i < MaxNumOfNotes ; ++i )
+		vdblNoteFrequenciesHz[i] = m_vdblSlots[m_vlNoteSlots[i]];
+
+	m_bEvaluated = true;
+}
+
+
+
+void CFormulaProgram::UpdateBaseFreq(double dblBaseFreqHz, std::vector<double> & vdblNoteFrequenciesHz)
+{
+	if ( !m_bEvaluated || ((long) vdblNoteFrequenciesHz.size() != MaxNumOfNotes) )
+	{
+		Evaluate(dblBaseFreqHz, vdblNoteFrequenciesHz);
+		return;
+	}
+
+	EvaluateBaseSlots(dblBaseFreqHz);
+
+	for ( size_t i = 0 ; i < m_vlBaseDependent.size() ; ++i )
+		Execute(m_vlBaseDependent[i]);
+
+	for ( size_t i = 0 ; i < m_vlNotesDependent.size() ; ++i )
+	{
+		long	lNote = m_vlNotesDependent[i];
+		vdblNoteFrequenciesHz[lNote] = m_vdblSlots[m_vlNoteSlots[lNote]];
+	}
+}
+
+
+
+
+
+} // namespace TUN
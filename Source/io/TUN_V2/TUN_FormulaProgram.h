@@ -0,0 +1,127 @@
+// TUN_FormulaProgram.h: Interface of the class CFormulaProgram.
+//
+// Compiled evaluation of the formulas of a [Functional Tuning] section
+//
+// The formulas are applied in the order they were read, so a reference
+// always reads the most recent value of a note. Compile() resolves each
+// reference to the slot holding that value, which turns the formula list
+// into a linear instruction list over one contiguous buffer. File order is
+// already a topological order of this list, so there are no cycles to
+// detect. Writes which are overwritten before they are read are dropped.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(AFX_FORMULAPROGRAM_H__4B0A6E12_7C3D_4F8E_9A21_3E5D6C7B8A90__INCLUDED_)
+#define AFX_FORMULAPROGRAM_H__4B0A6E12_7C3D_4F8E_9A21_3E5D6C7B8A90__INCLUDED_
+
+
+
+
+
+#pragma warning( disable : 4786 )
+
+#include <list>
+#include <vector>
+
+#include "TUN_Error.h"
+#include "TUN_Formula.h"
+
+
+
+
+
+namespace TUN
+{
+
+
+
+
+
+class CFormulaProgram
+{
+public:
+	CFormulaProgram() { Reset(); }
+	virtual ~CFormulaProgram() {}
+
+	// Error handling
+	const CErr &	Err() const { return m_err; }
+private:
+	CErr	m_err;
+
+public:
+	void	Reset();
+
+	// Compiles the formulas, which are applied to an equal tempered scale
+	// with the given base note (see CSingleScale::InitEqual).
+	// returns false if a formula refers to an invalid note index
+	bool	Compile(const std::list<CFormula> & lformulas, long lBaseNote);
+
+	bool	IsCompiled() const { return m_bCompiled; }
+	long	GetNumOfInstructions() const { return (long) m_vInstructions.size(); }
+
+	// Evaluates all notes, starting from an equal tempered scale with the given base frequency
+	void	Evaluate(double dblBaseFreqHz, std::vector<double> & vdblNoteFrequenciesHz);
+
+	// Re-evaluates only the notes which depend on the base frequency.
+	// vdblNoteFrequenciesHz must hold the result of the previous evaluation.
+	void	UpdateBaseFreq(double dblBaseFreqHz, std::vector<double> & vdblNoteFrequenciesHz);
+
+private:
+	// Slots 0 to MaxNumOfNotes-1 hold the equal tempered start values,
+	// instruction i writes slot MaxNumOfNotes+i.
+	struct SInstruction
+	{
+		enum eOp
+		{
+			op_Set,				// #Range *MUL /DIV %CENTS +Shift
+			op_EnsureFactor,	// Ratio of the ensured frequency to the value in m_lRangeSlot
+			op_Scale			// Value in m_lRangeSlot scaled by the factor in m_lShiftSlot
+		}			m_op;
+		long		m_lRangeSlot;	// -1 = constant m_dblRangeHz
+		double		m_dblRangeHz;	// Also the ensured frequency of op_EnsureFactor
+		double		m_dblMUL;
+		double		m_dblDIV;
+		double		m_dblCentsFactor;
+		long		m_lShiftSlot;	// -1 = constant m_dblShiftHz
+		double		m_dblShiftHz;
+	};
+
+	struct SCompileState
+	{
+		std::vector<SInstruction>	vInstructions;
+		std::vector<long>			vlCurrentSlots;			// Slot of the current value of each note
+		std::vector<long>			vlFactorSlots;			// Slots of the factors of "!" formulas
+		std::vector<long>			vlFirstPendingFactor;	// First factor not yet applied to each note
+	};
+
+	bool	ResolveParam(const SRVParam & rvp, long lScaleNoteIndex, SCompileState & state, long & lSlot, double & dblValue);
+	long	ApplyPendingFactors(long lNote, SCompileState & state);
+	void	RemoveUnusedInstructions(std::vector<SInstruction> & vInstructions);
+	void	EvaluateBaseSlots(double dblBaseFreqHz);
+	void	Execute(long lInstruction);
+
+private:
+	bool						m_bCompiled;
+	bool						m_bEvaluated;
+	long						m_lBaseNote;
+
+	std::vector<SInstruction>	m_vInstructions;
+	std::vector<double>			m_vdblSlots;
+	std::vector<long>			m_vlNoteSlots;		// Slot of the final value of each note
+
+	std::vector<long>			m_vlBaseSlotsUsed;	// Equal tempered start values which are read
+	std::vector<long>			m_vlBaseDependent;	// Instructions depending on the base frequency, in order
+	std::vector<long>			m_vlNotesDependent;	// Notes depending on the base frequency
+};
+
+
+
+
+
+} // namespace TUN
+
+
+
+
+
+#endif // !defined(AFX_FORMULAPROGRAM_H__4B0A6E12_7C3D_4F8E_9A21_3E5D6C7B8A90__INCLUDED_)
@@ -269,6 +269,7 @@ void CSingleScale::InitEqual(long lBaseNote /* = 69 */,
 
 	// Clear formulas
 	m_lformulas.clear();
+	m_formulaprogram.Reset();
 }
 
 
@@ -287,6 +288,20 @@ void CSingleScale::AddFormula(CFormula formula)
 {
 	formula.Apply(m_vdblNoteFrequenciesHz);
 	m_lformulas.push_back(formula);
+	m_formulaprogram.Reset();
+}
+
+
+
+bool CSingleScale::ChangeBaseFreqHz(double dblBaseFreqHz)
+{
+	if ( !m_formulaprogram.IsCompiled() &&
+		 !m_formulaprogram.Compile(m_lformulas, m_lInitEqual_BaseNote) )
+		return m_err.SetError(m_formulaprogram.Err());
+
+	m_dblInitEqual_BaseFreqHz = dblBaseFreqHz;
+	m_formulaprogram.UpdateBaseFreq(m_dblInitEqual_BaseFreqHz, m_vdblNoteFrequenciesHz);
+	return true;
 }
 
 
@@ -977,7 +992,8 @@ long CSingleScale::Read(std::istream & istr, CStringParser & strparser)
 						m_err.SetError("Formula syntax error or parameter refers to invalid note index!", m_lReadLineCount);
 						return -1;
 					}
-					AddFormula(formula);
+					// Formulas are compiled and applied all at once at the end
+					m_lformulas.push_back(formula);
 				}
 				break;
 			}
@@ -1056,7 +1072,13 @@ long CSingleScale::Read(std::istream & istr, CStringParser & strparser)
 		break;
 
 	case SEC_FunctionalTuning:
-		// Nothing to do here, as values are already in-place
+		// Apply the formulas to the equal tempered scale of the last InitEqual
+		if ( !m_formulaprogram.Compile(m_lformulas, m_lInitEqual_BaseNote) )
+		{
+			m_err.SetError(m_formulaprogram.Err());
+			return -1;
+		}
+		m_formulaprogram.Evaluate(m_dblInitEqual_BaseFreqHz, m_vdblNoteFrequenciesHz);
 		break;
 
 	default:
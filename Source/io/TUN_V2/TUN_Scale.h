@@ -24,6 +24,7 @@
 #include "TUN_Error.h"
 #include "TUN_StringTools.h"
 #include "TUN_Formula.h"
+#include "TUN_FormulaProgram.h"
 #include "TUN_MIDIChannelRange.h"
 
 
@@ -164,6 +165,11 @@ public:
 	long	GetBaseNote() const { return m_lInitEqual_BaseNote; }
 	double	GetBaseFreqHz() const { return m_dblInitEqual_BaseFreqHz; }
 
+	// Change the base frequency of the equal tempered start of the scale.
+	// Only notes whose formulas depend on it are re-evaluated.
+	// returns false if the formulas refer to invalid note indices
+	bool	ChangeBaseFreqHz(double dblBaseFreqHz);
+
 	/**
 	 * Read-access of the note frequencies
 	 *
@@ -315,6 +321,7 @@ private:
 	double				m_dblInitEqual_BaseFreqHz;
 	std::vector<double>	m_vdblNoteFrequenciesHz; // index = Scale note number, see m_vlMapping
 	std::list<CFormula>	m_lformulas;
+	CFormulaProgram		m_formulaprogram; // Compiled m_lformulas, if IsCompiled()
 	// Keyboard mapping:
 	std::vector<long>	m_vlMapping; // index = MIDI note number, value = Scale note number
 	long				m_lMappingLoopSize;
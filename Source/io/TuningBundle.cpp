@@ -0,0 +1,425 @@
+/*
+  ==============================================================================
+
+    TuningBundle.cpp
+    Created: 19 Oct 2026 5:22:14pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "TuningBundle.h"
+
+void TuningBundle::Builder::addTuning(std::shared_ptr<TuningTable> tuning, std::shared_ptr<TuningTableMap> mapping)
+{
+    if (tuning == nullptr)
+        return;
+
+    items.add({ tuning, mapping });
+}
+
+bool TuningBundle::Builder::addFile(juce::File tuningFile, juce::String& error, std::shared_ptr<TuningTableMap> mapping)
+{
+    auto parsed = TuningFileParser::parseFile(tuningFile);
+    if (!parsed.wasSuccessful())
+    {
+        error = parsed.error;
+        return false;
+    }
+
+    addTuning(parsed.tuning, (mapping != nullptr) ? mapping : parsed.mapping);
+    return true;
+}
+
+bool TuningBundle::Builder::addFile(juce::File tuningFile, juce::File keyboardMappingFile, juce::String& error)
+{
+    auto parsed = TuningFileParser::parseFile(tuningFile);
+    if (!parsed.wasSuccessful())
+    {
+        error = parsed.error;
+        return false;
+    }
+
+    ScalaBufferParser::KeyboardMapping keyboardMapping;
+    if (!TuningFileParser::parseKeyboardMappingFile(keyboardMappingFile, keyboardMapping, error))
+        return false;
+
+    auto mapping = TuningFileParser::applyKeyboardMapping(keyboardMapping, parsed.tuning);
+    addTuning(parsed.tuning, mapping);
+    return true;
+}
+
+juce::MemoryBlock TuningBundle::Builder::build() const
+{
+    auto sortedItems = items;
+    std::stable_sort(sortedItems.begin(), sortedItems.end(), [](const Item& a, const Item& b)
+    {
+        return a.tuning->getName().compare(b.tuning->getName()) < 0;
+    });
+
+    auto numEntries = (size_t)sortedItems.size();
+    auto recordsOffset = (juce::uint64)sizeof(Header);
+    auto dataOffset = recordsOffset + numEntries * sizeof(Record);
+
+    std::vector<char> bytes((size_t)dataOffset, 0);
+    std::string strings;
+
+    auto append = [&](const void* source, size_t size, size_t alignment) -> juce::uint64
+    {
+        auto offset = (bytes.size() + alignment - 1) / alignment * alignment;
+        bytes.resize(offset + size, 0);
+        if (size > 0)
+            std::memcpy(bytes.data() + offset, source, size);
+        return (juce::uint64)offset;
+    };
+
+    auto appendString = [&](const juce::String& text, juce::uint64& offset, juce::uint32& length)
+    {
+        auto utf8 = text.toStdString();
+        offset = (juce::uint64)strings.size();
+        length = (juce::uint32)utf8.size();
+        strings += utf8;
+    };
+
+    std::vector<Record> records(numEntries);
+
+    for (size_t i = 0; i < numEntries; i++)
+    {
+        const auto& item = sortedItems.getReference((int)i);
+        auto& record = records[i];
+        std::memset(&record, 0, sizeof(Record));
+
+        appendString(item.tuning->getName(), record.nameOffset, record.nameLength);
+        appendString(item.tuning->getDescription(), record.descriptionOffset, record.descriptionLength);
+        appendString(item.tuning->getPeriodString(), record.periodStringOffset, record.periodStringLength);
+
+        record.rootIndex = item.tuning->getRootIndex();
+        record.rootFrequency = item.tuning->getRootFrequency();
+        record.virtualPeriod = item.tuning->getVirtualPeriod();
+        record.virtualSize = item.tuning->getVirtualSize();
+
+        if (auto functional = dynamic_cast<const FunctionalTuning*>(item.tuning.get()))
+        {
+            auto intervals = functional->getIntervalCentsList();
+            record.numIntervals = (juce::uint32)intervals.size();
+            record.intervalsOffset = append(intervals.data(), intervals.size() * sizeof(double), alignof(double));
+        }
+
+        auto frequencies = item.tuning->getFrequencyTable();
+        auto mts = item.tuning->getMtsTable();
+        jassert(frequencies.size() == mts.size());
+
+        record.numFrequencies = (juce::uint32)frequencies.size();
+        record.frequenciesOffset = append(frequencies.data(), frequencies.size() * sizeof(double), alignof(double));
+        record.mtsOffset = append(mts.data(), mts.size() * sizeof(double), alignof(double));
+
+        if (item.mapping != nullptr)
+        {
+            auto definition = item.mapping->getDefinition();
+            const auto& pattern = definition.map.pattern();
+
+            record.hasMapping = 1;
+            record.mappingRootChannel = definition.root.midiChannel;
+            record.mappingRootNote = definition.root.midiNote;
+            record.mappingTranspose = definition.transpose;
+            record.mapSize = definition.map.size();
+            record.mapBase = definition.map.base();
+            record.mapPatternRoot = definition.map.patternRoot();
+            record.mapRoot = definition.map.mapRoot();
+            record.mapTranspose = definition.map.transposition();
+
+            record.mapPatternOffset = append(pattern.data(), pattern.size() * sizeof(int), alignof(int));
+            record.mapTableOffset = append(item.mapping->getBaseTable()->table, sizeof(TuningTableMap::BaseTable), alignof(TuningTableMap::BaseTable));
+        }
+    }
+
+    auto stringsOffset = append(strings.data(), strings.size(), 1);
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    header.magic = bundleMagic;
+    header.version = bundleVersion;
+    header.numEntries = (juce::uint32)numEntries;
+    header.fileSize = (juce::uint64)bytes.size();
+    header.recordsOffset = recordsOffset;
+    header.stringsOffset = stringsOffset;
+
+    std::memcpy(bytes.data(), &header, sizeof(Header));
+    if (numEntries > 0)
+        std::memcpy(bytes.data() + (size_t)recordsOffset, records.data(), numEntries * sizeof(Record));
+
+    return juce::MemoryBlock(bytes.data(), bytes.size());
+}
+
+bool TuningBundle::Builder::writeToFile(juce::File bundleFile) const
+{
+    auto block = build();
+    if (!bundleFile.replaceWithData(block.getData(), block.getSize()))
+    {
+        juce::Logger::writeToLog("Unable to write tuning bundle: " + bundleFile.getFullPathName());
+        return false;
+    }
+
+    return true;
+}
+
+bool TuningBundle::open(juce::File bundleFile)
+{
+    close();
+
+    auto file = std::make_shared<juce::MemoryMappedFile>(bundleFile, juce::MemoryMappedFile::readOnly);
+    if (file->getData() == nullptr)
+    {
+        juce::Logger::writeToLog("Unable to map tuning bundle: " + bundleFile.getFullPathName());
+        return false;
+    }
+
+    if (!openFromMemory(file->getData(), file->getSize()))
+    {
+        juce::Logger::writeToLog("Invalid tuning bundle: " + bundleFile.getFullPathName());
+        return false;
+    }
+
+    // Tunings and maps loaded from the bundle keep the file mapped
+    mappedFile = file;
+    return true;
+}
+
+bool TuningBundle::openFromMemory(const void* bundleData, size_t size)
+{
+    close();
+
+    data = static_cast<const char*>(bundleData);
+    dataSize = (juce::uint64)size;
+
+    juce::String error;
+    if (!validate(error))
+    {
+        juce::Logger::writeToLog("Tuning bundle error: " + error);
+        close();
+        return false;
+    }
+
+    header = reinterpret_cast<const Header*>(data);
+    records = reinterpret_cast<const Record*>(data + header->recordsOffset);
+    return true;
+}
+
+void TuningBundle::close()
+{
+    header = nullptr;
+    records = nullptr;
+    data = nullptr;
+    dataSize = 0;
+    mappedFile = nullptr;
+}
+
+bool TuningBundle::validate(juce::String& error) const
+{
+    auto inRange = [&](juce::uint64 offset, juce::uint64 size, juce::uint64 alignment)
+    {
+        return offset <= dataSize && size <= dataSize - offset && offset % alignment == 0;
+    };
+
+    if (data == nullptr || dataSize < sizeof(Header) || (size_t)data % alignof(TuningTableMap::BaseTable) != 0)
+    {
+        error = "Bundle is too small or misaligned";
+        return false;
+    }
+
+    auto bundleHeader = reinterpret_cast<const Header*>(data);
+    if (bundleHeader->magic != bundleMagic)
+    {
+        error = "Not a tuning bundle";
+        return false;
+    }
+
+    if (bundleHeader->version != bundleVersion)
+    {
+        error = "Unsupported bundle version " + juce::String(bundleHeader->version);
+        return false;
+    }
+
+    if (bundleHeader->fileSize != dataSize
+        || !inRange(bundleHeader->recordsOffset, (juce::uint64)bundleHeader->numEntries * sizeof(Record), alignof(Record))
+        || !inRange(bundleHeader->stringsOffset, 0, 1))
+    {
+        error = "Bundle is truncated";
+        return false;
+    }
+
+    auto bundleRecords = reinterpret_cast<const Record*>(data + bundleHeader->recordsOffset);
+    auto stringsSize = dataSize - bundleHeader->stringsOffset;
+
+    for (juce::uint32 i = 0; i < bundleHeader->numEntries; i++)
+    {
+        const auto& record = bundleRecords[i];
+
+        auto stringInRange = [&](juce::uint64 offset, juce::uint32 length)
+        {
+            return offset <= stringsSize && length <= stringsSize - offset;
+        };
+
+        bool valid = stringInRange(record.nameOffset, record.nameLength)
+            && stringInRange(record.descriptionOffset, record.descriptionLength)
+            && stringInRange(record.periodStringOffset, record.periodStringLength)
+            && inRange(record.intervalsOffset, (juce::uint64)record.numIntervals * sizeof(double), alignof(double))
+            && inRange(record.frequenciesOffset, (juce::uint64)record.numFrequencies * sizeof(double), alignof(double))
+            && inRange(record.mtsOffset, (juce::uint64)record.numFrequencies * sizeof(double), alignof(double))
+            && (record.numIntervals > 0 || (record.rootIndex >= 0 && (juce::uint32)record.rootIndex < record.numFrequencies));
+
+        if (valid && record.hasMapping)
+        {
+            valid = record.mapSize > 0
+                && inRange(record.mapPatternOffset, (juce::uint64)record.mapSize * sizeof(int), alignof(int))
+                && inRange(record.mapTableOffset, sizeof(TuningTableMap::BaseTable), alignof(TuningTableMap::BaseTable));
+        }
+
+        if (!valid)
+        {
+            error = "Entry " + juce::String(i) + " is out of bounds";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+juce::String TuningBundle::readString(juce::uint64 offset, juce::uint32 length) const
+{
+    auto start = data + header->stringsOffset + offset;
+    return juce::String::fromUTF8(start, (int)length);
+}
+
+juce::String TuningBundle::getName(int index) const
+{
+    const auto& record = getRecord(index);
+    return readString(record.nameOffset, record.nameLength);
+}
+
+juce::String TuningBundle::getDescription(int index) const
+{
+    const auto& record = getRecord(index);
+    return readString(record.descriptionOffset, record.descriptionLength);
+}
+
+int TuningBundle::indexOf(const juce::String& name) const
+{
+    int low = 0;
+    int high = getNumTunings() - 1;
+
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        auto comparison = getName(middle).compare(name);
+
+        if (comparison == 0)
+            return middle;
+
+        if (comparison < 0)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+
+    return -1;
+}
+
+TableView<double> TuningBundle::getIntervalCentsView(int index) const
+{
+    const auto& record = getRecord(index);
+    return viewAt<double>(record.intervalsOffset, record.numIntervals);
+}
+
+TableView<double> TuningBundle::getFrequencyTableView(int index) const
+{
+    const auto& record = getRecord(index);
+    return viewAt<double>(record.frequenciesOffset, record.numFrequencies);
+}
+
+TableView<double> TuningBundle::getMtsTableView(int index) const
+{
+    const auto& record = getRecord(index);
+    return viewAt<double>(record.mtsOffset, record.numFrequencies);
+}
+
+TableView<int> TuningBundle::getMapTableView(int index) const
+{
+    const auto& record = getRecord(index);
+    if (!record.hasMapping)
+        return TableView<int>();
+
+    return viewAt<int>(record.mapTableOffset, 2048);
+}
+
+CentsDefinition TuningBundle::getCentsDefinition(int index) const
+{
+    const auto& record = getRecord(index);
+    auto intervals = getIntervalCentsView(index);
+
+    CentsDefinition definition;
+    definition.intervalCents = juce::Array<double>(intervals.data(), intervals.size());
+    definition.rootFrequency = record.rootFrequency;
+    definition.name = getName(index);
+    definition.description = getDescription(index);
+    definition.virtualPeriod = record.virtualPeriod;
+    definition.virtualSize = record.virtualSize;
+    return definition;
+}
+
+std::shared_ptr<TuningTable> TuningBundle::createTuning(int index) const
+{
+    const auto& record = getRecord(index);
+    auto frequencies = getFrequencyTableView(index);
+    auto mts = getMtsTableView(index);
+
+    if (record.numIntervals > 0)
+        return std::make_shared<FunctionalTuning>(getCentsDefinition(index), frequencies, mts, shareData(record.frequenciesOffset));
+
+    TuningTable::Definition definition;
+    definition.rootIndex = record.rootIndex;
+    definition.name = getName(index);
+    definition.description = getDescription(index);
+    definition.periodString = readString(record.periodStringOffset, record.periodStringLength);
+    definition.virtualPeriod = record.virtualPeriod;
+    definition.virtualSize = record.virtualSize;
+
+    return std::make_shared<TuningTable>(definition, frequencies, mts, shareData(record.frequenciesOffset));
+}
+
+std::shared_ptr<TuningTableMap> TuningBundle::createMapping(int index) const
+{
+    const auto& record = getRecord(index);
+    if (!record.hasMapping)
+        return nullptr;
+
+    auto pattern = viewAt<int>(record.mapPatternOffset, (juce::uint32)record.mapSize);
+
+    Map<int>::Definition mapDefinition =
+    {
+        record.mapSize,
+        Map<int>::Pattern(pattern.begin(), pattern.end()),
+        record.mapBase,
+        record.mapPatternRoot,
+        record.mapRoot,
+        record.mapTranspose
+    };
+
+    TuningTableMap::Definition definition =
+    {
+        TuningTableMap::Root { record.mappingRootChannel, record.mappingRootNote },
+        Map<int>(std::move(mapDefinition)),
+        record.mappingTranspose
+    };
+
+    // Aliases the mapped file, so the table stays valid as long as the map uses it
+    auto table = reinterpret_cast<const TuningTableMap::BaseTable*>(data + record.mapTableOffset);
+    auto sharedTable = std::shared_ptr<const TuningTableMap::BaseTable>(shareData(record.mapTableOffset), table);
+
+    return std::make_shared<TuningTableMap>(std::move(definition), sharedTable);
+}
+
+TuningBundle::Preset TuningBundle::loadPreset(int index) const
+{
+    return Preset { createTuning(index), createMapping(index) };
+}
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    TuningBundle.h
+    Created: 19 Oct 2026 5:22:14pm
+    Author:  Vincenzo
+
+    A read-only file of many tunings and mappings, opened with memory mapping.
+    Tunings and maps read their tables in place from the mapped file, so recalling
+    a tuning does not parse or copy anything. Bundles are built from tuning files
+    with Builder, or with everytone-batch --bundle.
+
+    Layout, in native byte order, with 64-bit sizes and offsets:
+        Header
+        Record[numEntries], sorted by name
+        Data: interval lists, frequency and MTS tables, map patterns and 64-byte aligned map tables
+        Strings: UTF-8 names and descriptions
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "TuningFileParser.h"
+#include "../mapping/TuningTableMap.h"
+
+class TuningBundle
+{
+public:
+
+    struct Header
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 numEntries;
+        juce::uint32 reserved;
+        juce::uint64 fileSize;
+        juce::uint64 recordsOffset;
+        juce::uint64 stringsOffset;
+    };
+
+    struct Record
+    {
+        juce::uint64 nameOffset;            /* Relative to stringsOffset */
+        juce::uint64 descriptionOffset;
+        juce::uint64 periodStringOffset;
+        juce::uint32 nameLength;
+        juce::uint32 descriptionLength;
+        juce::uint32 periodStringLength;
+
+        juce::int32 rootIndex;              /* Tuning table index of the root frequency */
+        juce::uint32 numIntervals;          /* 0 for tunings defined by a frequency table */
+        juce::uint32 numFrequencies;
+        juce::uint32 hasMapping;
+        juce::uint32 reserved;
+
+        double rootFrequency;
+        double virtualPeriod;
+        double virtualSize;
+
+        juce::uint64 intervalsOffset;       /* double[numIntervals] */
+        juce::uint64 frequenciesOffset;     /* double[numFrequencies] */
+        juce::uint64 mtsOffset;             /* double[numFrequencies] */
+
+        juce::int32 mappingRootChannel;
+        juce::int32 mappingRootNote;
+        juce::int32 mappingTranspose;
+        juce::int32 mapSize;
+        juce::int32 mapBase;
+        juce::int32 mapPatternRoot;
+        juce::int32 mapRoot;
+        juce::int32 mapTranspose;
+
+        juce::uint64 mapPatternOffset;      /* int32[mapSize] */
+        juce::uint64 mapTableOffset;        /* TuningTableMap::BaseTable */
+    };
+
+    static_assert(sizeof(Header) == 40, "The header is packed without padding");
+    static_assert(sizeof(Record) == 152, "Records are packed without padding");
+    static_assert(sizeof(TuningTableMap::BaseTable) == 2048 * sizeof(juce::int32), "Map tables are stored as 2048 int32s");
+
+    struct Preset
+    {
+        std::shared_ptr<TuningTable> tuning;
+        std::shared_ptr<TuningTableMap> mapping;    // nullptr if the entry has no mapping
+    };
+
+    class Builder
+    {
+        struct Item
+        {
+            std::shared_ptr<TuningTable> tuning;
+            std::shared_ptr<TuningTableMap> mapping;
+        };
+
+        juce::Array<Item> items;
+
+    public:
+
+        Builder() {}
+
+        int getNumTunings() const { return items.size(); }
+
+        // The tuning's name is used for lookup, and a mapping is optional
+        void addTuning(std::shared_ptr<TuningTable> tuning, std::shared_ptr<TuningTableMap> mapping = nullptr);
+
+        // Parses a .scl, .tun or .msf file, returns false and sets the error if the file could not be read.
+        // Multiple scale files use their own mapping if none is given.
+        bool addFile(juce::File tuningFile, juce::String& error, std::shared_ptr<TuningTableMap> mapping = nullptr);
+
+        // Parses a tuning file and a Scala keyboard mapping for it
+        bool addFile(juce::File tuningFile, juce::File keyboardMappingFile, juce::String& error);
+
+        juce::MemoryBlock build() const;
+
+        bool writeToFile(juce::File bundleFile) const;
+    };
+
+private:
+
+    // Shared with loaded maps so their tables can point into the mapped file
+    std::shared_ptr<juce::MemoryMappedFile> mappedFile;
+
+    const char* data = nullptr;
+    juce::uint64 dataSize = 0;
+
+    const Header* header = nullptr;
+    const Record* records = nullptr;
+
+private:
+
+    bool validate(juce::String& error) const;
+
+    const Record& getRecord(int index) const { return records[index]; }
+
+    juce::String readString(juce::uint64 offset, juce::uint32 length) const;
+
+    // Owns nothing when the bundle was opened from memory
+    std::shared_ptr<const void> shareData(juce::uint64 offset) const
+    {
+        return std::shared_ptr<const void>(mappedFile, data + offset);
+    }
+
+    template <typename T>
+    TableView<T> viewAt(juce::uint64 offset, juce::uint32 size) const
+    {
+        return TableView<T>((size == 0) ? nullptr : reinterpret_cast<const T*>(data + offset), (int)size);
+    }
+
+public:
+
+    TuningBundle() {}
+
+    // Returns false and logs the error if the file is not a valid bundle
+    bool open(juce::File bundleFile);
+
+    // Reads a bundle from 64-byte aligned memory that must outlive this object and its presets
+    bool openFromMemory(const void* bundleData, size_t size);
+
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+
+    int getNumTunings() const { return isOpen() ? (int)header->numEntries : 0; }
+
+    juce::String getName(int index) const;
+    juce::String getDescription(int index) const;
+
+    // Binary search by exact name, returns -1 if not found
+    int indexOf(const juce::String& name) const;
+
+    bool hasMapping(int index) const { return getRecord(index).hasMapping != 0; }
+
+    // Views into the bundle, valid while it is open
+
+    TableView<double> getIntervalCentsView(int index) const;
+    TableView<double> getFrequencyTableView(int index) const;
+    TableView<double> getMtsTableView(int index) const;
+    TableView<int> getMapTableView(int index) const;
+
+    CentsDefinition getCentsDefinition(int index) const;
+
+    // Tables are read from the bundle without being copied, and keep the bundle mapped while in use.
+    // Cents-based entries become FunctionalTuning, which copies only the interval list.
+    std::shared_ptr<TuningTable> createTuning(int index) const;
+
+    // The map table is read from the bundle without being rebuilt, and keeps the bundle mapped while in use
+    std::shared_ptr<TuningTableMap> createMapping(int index) const;
+
+    Preset loadPreset(int index) const;
+
+public:
+
+    static const juce::uint32 bundleMagic = 0x42545645; // "EVTB"
+    static const juce::uint32 bundleVersion = 2;
+};
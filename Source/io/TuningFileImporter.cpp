@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    TuningFileImporter.cpp
+    Created: 19 Oct 2026 2:41:07pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "TuningFileImporter.h"
+
+class TuningFileImporter::ImportJob : public juce::ThreadPoolJob
+{
+    juce::WeakReference<TuningFileImporter> importer;
+    int importId;
+    Request request;
+
+    float lastPostedProgress = -1.0f;
+
+public:
+
+    ImportJob(TuningFileImporter* importerIn, int importIdIn, Request requestIn)
+        : juce::ThreadPoolJob("TuningFileImport"),
+          importer(importerIn),
+          importId(importIdIn),
+          request(requestIn) {}
+
+    JobStatus runJob() override
+    {
+        auto result = TuningFileImporter::import(request, [&](float progress)
+        {
+            if (shouldExit())
+                return false;
+
+            // Progress is reported for every line, so only post whole percents
+            if (progress < 1.0f && progress - lastPostedProgress < 0.01f)
+                return true;
+
+            lastPostedProgress = progress;
+            if (auto owner = importer.get())
+                owner->postProgress(importId, request.file, progress);
+
+            return true;
+        });
+
+        if (auto owner = importer.get())
+            owner->postResult(importId, result);
+
+        return JobStatus::jobHasFinished;
+    }
+};
+
+TuningFileImporter::TuningFileImporter() {}
+
+TuningFileImporter::~TuningFileImporter()
+{
+    listeners.clear();
+
+    // The job stops at its next line, so wait for it however long a read takes,
+    // since a running job would post to this importer while it is destroyed
+    pool.removeAllJobs(true, -1);
+    masterReference.clear();
+}
+
+void TuningFileImporter::importFile(TuningFileImporter::Request request)
+{
+    auto importId = ++currentImportId;
+    currentRequest = request;
+    pool.removeAllJobs(true, 0);
+    pool.addJob(new ImportJob(this, importId, request), true);
+    juce::Logger::writeToLog("Importing tuning file: " + request.file.getFullPathName());
+}
+
+void TuningFileImporter::cancel()
+{
+    bool wasImporting = isImporting();
+
+    ++currentImportId;
+    pool.removeAllJobs(true, 0);
+
+    if (!wasImporting)
+        return;
+
+    Result result;
+    result.request = currentRequest;
+    result.parsed.filePath = currentRequest.file.getFullPathName();
+    result.wasCancelled = true;
+
+    juce::Logger::writeToLog("Cancelled importing tuning file: " + result.parsed.filePath);
+    listeners.call(&Listener::tuningImportFinished, this, result);
+}
+
+bool TuningFileImporter::isImporting() const
+{
+    return pool.getNumJobs() > 0;
+}
+
+TuningFileImporter::Result TuningFileImporter::import(const TuningFileImporter::Request& request, TuningFileImporter::ProgressCallback progressCallback)
+{
+    Result result;
+    result.request = request;
+
+    if (!progressCallback(0.0f))
+    {
+        result.wasCancelled = true;
+        return result;
+    }
+
+    // Parsing is the first half of the import
+    result.parsed = TuningFileParser::parseFile(request.file, [&](float progress) { return progressCallback(progress * 0.5f); });
+    if (result.parsed.wasCancelled)
+    {
+        result.wasCancelled = true;
+        return result;
+    }
+
+    if (!result.parsed.wasSuccessful())
+        return result;
+
+    if (!progressCallback(0.5f))
+    {
+        result.wasCancelled = true;
+        return result;
+    }
+
+    // Multiple scale files map each channel to its own scale, so keyboard mappings don't apply to them
+    if (result.parsed.mapping != nullptr)
+    {
+        result.mapping = result.parsed.mapping;
+    }
+
+    // The keyboard mapping can retune the tuning, so it's applied before the tables are built
+    else if (request.hasKeyboardMapping())
+    {
+        ScalaBufferParser::KeyboardMapping keyboardMapping;
+        juce::String error;
+
+        if (!TuningFileParser::parseKeyboardMappingFile(request.keyboardMappingFile, keyboardMapping, error))
+        {
+            result.parsed.tuning = nullptr;
+            result.parsed.error = request.keyboardMappingFile.getFileName() + ": " + error;
+            return result;
+        }
+
+        result.mapping = TuningFileParser::applyKeyboardMapping(keyboardMapping, result.parsed.tuning);
+    }
+
+    // Build tables, mapping and tuner here so that the message thread only has to swap them in
+    auto functionalTuning = dynamic_cast<FunctionalTuning*>(result.parsed.tuning.get());
+    if (functionalTuning != nullptr)
+        functionalTuning->cacheTables();
+
+    if (request.buildMapping && result.mapping == nullptr)
+    {
+        if (!progressCallback(0.8f))
+        {
+            result.wasCancelled = true;
+            return result;
+        }
+
+        result.mapping = TunerController::NewMappingFromTuning(result.parsed.tuning.get(), request.mappingRoot, request.mappingType);
+    }
+
+    if (request.source != nullptr && result.mapping != nullptr)
+    {
+        if (!progressCallback(0.9f))
+        {
+            result.wasCancelled = true;
+            return result;
+        }
+
+        // File mappings set their own reference, like in MultimapperAudioProcessor::tuningImportFinished
+        auto reference = result.hasFileMapping() ? MappedTuningTable::FrequencyReference()
+                                                 : request.targetReference;
+
+        result.target = std::make_shared<MappedTuningTable>(result.parsed.tuning, result.mapping, reference);
+        result.tuner = std::make_shared<MidiNoteTuner>(request.source, result.target, request.pitchbendRange);
+    }
+
+    progressCallback(1.0f);
+    return result;
+}
+
+void TuningFileImporter::postProgress(int importId, juce::File file, float progress)
+{
+    juce::WeakReference<TuningFileImporter> importer(this);
+    juce::MessageManager::callAsync([importer, importId, file, progress]()
+    {
+        auto owner = importer.get();
+        if (owner != nullptr && owner->currentImportId == importId)
+            owner->listeners.call(&Listener::tuningImportProgressed, owner, file, progress);
+    });
+}
+
+void TuningFileImporter::postResult(int importId, TuningFileImporter::Result result)
+{
+    juce::WeakReference<TuningFileImporter> importer(this);
+    juce::MessageManager::callAsync([importer, importId, result]()
+    {
+        auto owner = importer.get();
+        if (owner == nullptr || owner->currentImportId != importId)
+            return;
+
+        if (!result.wasSuccessful() && !result.wasCancelled)
+            juce::Logger::writeToLog("Error importing " + result.parsed.filePath + ": " + result.parsed.error);
+
+        owner->listeners.call(&Listener::tuningImportFinished, owner, result);
+    });
+}
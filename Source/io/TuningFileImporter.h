@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    TuningFileImporter.h
+    Created: 19 Oct 2026 2:41:07pm
+    Author:  Vincenzo
+
+    Reads tuning files on a background thread, and builds the tuning tables,
+    mapping and tuner before handing the result back on the message thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "TuningFileParser.h"
+#include "../TunerController.h"
+
+class TuningFileImporter
+{
+public:
+
+    struct Request
+    {
+        juce::File file;
+
+        // Used to build the mapping ahead of time, as TunerController would in Auto mapping mode
+        bool buildMapping = true;
+        TuningTableMap::Root mappingRoot;
+        Everytone::MappingType mappingType = Everytone::MappingType::Linear;
+
+        // Optional Scala keyboard mapping, used instead of building a mapping
+        juce::File keyboardMappingFile;
+
+        // Used to build the tuner ahead of time, which is skipped if there's no source
+        std::shared_ptr<MappedTuningTable> source;
+        int pitchbendRange = 4;
+        MappedTuningTable::FrequencyReference targetReference;
+
+        bool hasKeyboardMapping() const { return keyboardMappingFile != juce::File(); }
+    };
+
+    struct Result
+    {
+        Request request;
+        TuningFileParser::ParseResult parsed;
+        std::shared_ptr<TuningTableMap> mapping;    // nullptr if not requested or parsing failed
+        std::shared_ptr<MappedTuningTable> target;  // Set with the tuner
+        std::shared_ptr<MidiNoteTuner> tuner;       // nullptr if there's no source or mapping
+        bool wasCancelled = false;
+
+        bool wasSuccessful() const { return !wasCancelled && parsed.wasSuccessful(); }
+
+        // The mapping came from a keyboard mapping or the tuning file, and shouldn't be rebuilt from the mapping settings
+        bool hasFileMapping() const { return mapping != nullptr && (request.hasKeyboardMapping() || parsed.mapping != nullptr); }
+    };
+
+    // Return false to cancel the import
+    using ProgressCallback = std::function<bool(float progress)>;
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        // These are called on the message thread
+        virtual void tuningImportProgressed(TuningFileImporter* importer, const juce::File& file, float progress) {}
+        virtual void tuningImportFinished(TuningFileImporter* importer, const Result& result) {}
+    };
+
+private:
+
+    class ImportJob;
+
+    juce::ThreadPool pool { 1 };
+    juce::ListenerList<Listener> listeners;
+
+    // Results from jobs that were replaced or cancelled are not delivered
+    std::atomic<int> currentImportId { 0 };
+
+    Request currentRequest;
+
+public:
+
+    TuningFileImporter();
+    ~TuningFileImporter();
+
+    // Cancels an import that is in progress
+    void importFile(Request request);
+
+    // Listeners are told right away with a cancelled result
+    void cancel();
+
+    bool isImporting() const;
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    // Runs the whole import on the calling thread
+    static Result import(const Request& request, ProgressCallback progressCallback = [](float) { return true; });
+
+private:
+
+    void postProgress(int importId, juce::File file, float progress);
+    void postResult(int importId, Result result);
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(TuningFileImporter)
+};
@@ -10,6 +10,65 @@
 
 #include "TuningFileParser.h"
 
+namespace
+{
+    // Read-only stream over a buffer that is already in memory
+    struct MemoryStreamBuffer : public std::streambuf
+    {
+        MemoryStreamBuffer(std::string_view data)
+        {
+            auto begin = const_cast<char*>(data.data());
+            setg(begin, begin, begin + data.size());
+        }
+    };
+
+    // Same as MemoryStreamBuffer, but hands the buffer to the stream one line at a time,
+    // so that progress can be reported and parsing can be stopped between lines
+    class LineStreamBuffer : public std::streambuf
+    {
+        std::string_view data;
+        const TuningFileParser::ProgressCallback& progressCallback;
+        bool cancelled = false;
+
+    public:
+
+        LineStreamBuffer(std::string_view dataIn, const TuningFileParser::ProgressCallback& callback)
+            : data(dataIn), progressCallback(callback)
+        {
+            auto begin = const_cast<char*>(data.data());
+            setg(begin, begin, begin);
+        }
+
+        bool wasCancelled() const { return cancelled; }
+
+    protected:
+
+        int_type underflow() override
+        {
+            if (gptr() < egptr())
+                return traits_type::to_int_type(*gptr());
+
+            auto position = (size_t)(egptr() - data.data());
+            if (cancelled || position >= data.size())
+                return traits_type::eof();
+
+            if (progressCallback && !progressCallback((float)position / (float)data.size()))
+            {
+                cancelled = true;
+                return traits_type::eof();
+            }
+
+            auto end = data.find('\n', position);
+            end = (end == std::string_view::npos) ? data.size() : end + 1;
+
+            // Keep the start of the buffer so that characters can still be put back
+            auto begin = const_cast<char*>(data.data());
+            setg(begin, begin + position, begin + end);
+            return traits_type::to_int_type(*gptr());
+        }
+    };
+}
+
 TuningFileParser::TuningFileParser(juce::File file)
 {
     readFile(file);
@@ -50,59 +109,54 @@ int TuningFileParser::determineTuningType(juce::File tuningFileIn)
     else if (fileType == ".tun")
         type = TuningType::TUN;
 
+    else if (fileType == ".msf")
+        type = TuningType::MSF;
+
     return type;
 }
 
 std::shared_ptr<FunctionalTuning> TuningFileParser::parseScalaFileDefinition(juce::File scalaFile)
 {
-    std::string path = scalaFile.getFullPathName().toStdString();
+    juce::String error;
+    auto tuning = parseScalaFileDefinition(scalaFile, error);
 
-    TUN::CSCL_Import sclImport;
+    if (tuning == nullptr)
+        showError(scalaFile.getFullPathName(), error);
 
-    auto ok = sclImport.ReadSCL(path.c_str());
+    return tuning;
+}
 
-    if (!ok)
+std::shared_ptr<FunctionalTuning> TuningFileParser::parseScalaFileDefinition(juce::File scalaFile, juce::String& error, const ProgressCallback& progressCallback)
+{
+    juce::MemoryBlock data;
+    if (!scalaFile.loadFileAsData(data))
     {
-        showError(path, sclImport.Err());
+        error = "Error opening the file.";
         return nullptr;
     }
-    
-    TUN::CSingleScale tunSingleScale;
-    sclImport.SetSingleScale(tunSingleScale);
 
-    ok = sclImport.Err().IsOK();
-    if (!ok)
-    {
-        showError(path, tunSingleScale.Err());
+    ScalaBufferParser::Scale scale;
+    if (!ScalaBufferParser::parseScale(ScalaBufferParser::viewOf(data), scale, error, progressCallback))
         return nullptr;
-    }
 
-    int baseNote = tunSingleScale.GetBaseNote();
-    double baseFreq = tunSingleScale.GetBaseFreqHz();
-
-    juce::Array<double> centsTable;
-    for (int i = 1; i <= sclImport.GetScaleSize(); i++)
-    {
-        auto line = sclImport.GetLineInCents(i);
-        centsTable.add(line);
-    }
+    // Without a keyboard mapping, the scale is tuned from the default reference
+    double baseFreq = ScalaBufferParser::KeyboardMapping().referenceFrequency;
 
-    auto name = juce::String(sclImport.GetTuningName());
+    auto name = scale.name;
     if (juce::File::isAbsolutePath(name))
     {
         auto temp = juce::File(name);
         name = temp.getFileNameWithoutExtension();
     }
-    auto description = juce::String(sclImport.GetScaleDescription());
 
-    auto vSize = (double)centsTable.size();
+    auto vSize = (double)scale.intervalCents.size();
     CentsDefinition definition =
     {
-        centsTable,
+        scale.intervalCents,
         baseFreq,
         name,
-        description,
-        centsTable.getLast(),
+        scale.description,
+        scale.intervalCents.getLast(),
         vSize
     };
 
@@ -111,14 +165,42 @@ std::shared_ptr<FunctionalTuning> TuningFileParser::parseScalaFileDefinition(juc
 
 std::shared_ptr<TuningTable> TuningFileParser::parseTunFileDefinition(juce::File tunFile)
 {
-    TUN::CSingleScale tunSingleScale;
+    juce::String error;
+    auto tuning = parseTunFileDefinition(tunFile, error);
+
+    if (tuning == nullptr)
+        showError(tunFile.getFullPathName(), error);
+
+    return tuning;
+}
+
+std::shared_ptr<TuningTable> TuningFileParser::parseTunFileDefinition(juce::File tunFile, juce::String& error, const ProgressCallback& progressCallback)
+{
+    juce::MemoryBlock data;
+    if (!tunFile.loadFileAsData(data))
+    {
+        error = "Error opening the file.";
+        return nullptr;
+    }
 
-    std::string path = tunFile.getFullPathName().toStdString();
+    // Read from memory instead of through a file stream
+    LineStreamBuffer buffer(ScalaBufferParser::viewOf(data), progressCallback);
+    std::istream stream(&buffer);
+
+    TUN::CStringParser stringParser;
+    stringParser.InitStreamReading();
+
+    TUN::CSingleScale tunSingleScale;
+    auto code = tunSingleScale.Read(stream, stringParser);
+    if (buffer.wasCancelled())
+    {
+        error = "Cancelled.";
+        return nullptr;
+    }
 
-    auto code = tunSingleScale.Read(path.c_str());
     if (code < 1)
     {
-        showError(path, tunSingleScale.Err());
+        error = juce::String(tunSingleScale.Err().GetLastError());
         return nullptr;
     }
 
@@ -138,27 +220,247 @@ std::shared_ptr<TuningTable> TuningFileParser::parseTunFileDefinition(juce::File
     }
     auto description = tunInfoToString(tunSingleScale);
 
-    // Try to find interval pattern to return FunctionalTuning if possible
-    //auto extractedDefinition = CentsDefinition::ExtractFromFrequencyTable(frequencies, baseNote);
-    //if (extractedDefinition.intervalCents.size() > 0)
-    //{
-    //    extractedDefinition.name = name;
-    //    extractedDefinition.description = description;
-    //    return std::make_shared<FunctionalTuning>(extractedDefinition);
-    //}
+    // Tables with a repeating interval pattern are imported as a FunctionalTuning.
+    // Its root index comes from the MTS range instead of the base note, but indices stay relative
+    // to the root, so mappings rooted at the base note play the same frequencies as the table.
+    // That only holds if every note of the file is inside of the functional tuning's table.
+    CentsDefinition extractedDefinition;
+    if (CentsDefinition::ExtractFromFrequencyTable(frequencies, baseNote, extractedDefinition))
+    {
+        int rootIndex, tableSize;
+        extractedDefinition.calculateMtsRootAndTableSize(rootIndex, tableSize);
+
+        int firstNoteIndex = rootIndex - baseNote;
+        int lastNoteIndex = firstNoteIndex + frequencies.size() - 1;
+        if (firstNoteIndex >= 0 && lastNoteIndex < tableSize)
+        {
+            extractedDefinition.name = name;
+            extractedDefinition.description = description;
+            return std::make_shared<FunctionalTuning>(extractedDefinition);
+        }
+    }
 
-    // Fallback to a frequency table tuning
+    // Fallback to a frequency table tuning, indexed by MIDI note
     TuningTable::Definition definition =
     {
         frequencies,
         baseNote,
         name,
-        description
+        description,
+        juce::String(),
+        0,
+        0
     };
 
     return std::make_shared<TuningTable>(definition);
 }
 
+std::shared_ptr<TuningTable> TuningFileParser::parseMultiScaleFileDefinition(juce::File msfFile, std::shared_ptr<TuningTableMap>& mapping, juce::String& error,
+                                                                           const ProgressCallback& progressCallback)
+{
+    juce::MemoryBlock data;
+    if (!msfFile.loadFileAsData(data))
+    {
+        error = "Error opening the file.";
+        return nullptr;
+    }
+
+    LineStreamBuffer buffer(ScalaBufferParser::viewOf(data), progressCallback);
+    std::istream stream(&buffer);
+
+    TUN::CStringParser stringParser;
+    stringParser.InitStreamReading();
+
+    // Same as CMultiScaleFile::Add, but keeps the error of the scale that failed
+    TUN::CMultiScaleFile multiScaleFile;
+    while (true)
+    {
+        TUN::CSingleScale scale;
+        auto code = scale.Read(stream, stringParser);
+        if (buffer.wasCancelled())
+        {
+            error = "Cancelled.";
+            return nullptr;
+        }
+
+        if (code == 0)
+            break;
+
+        if (code < 0)
+        {
+            error = "Scale " + juce::String((int)multiScaleFile.m_lssScales.size() + 1) + ": " + juce::String(scale.Err().GetLastError());
+            return nullptr;
+        }
+
+        multiScaleFile.m_lssScales.push_back(scale);
+    }
+
+    if (multiScaleFile.m_lssScales.empty())
+    {
+        error = "No scales found in file.";
+        return nullptr;
+    }
+
+    // Each scale used by a channel gets one slice, and channels without a scale play 12EDO
+    TUN::CSingleScale defaultScale;
+    std::vector<const TUN::CSingleScale*> sliceScales;
+    std::array<int, 16> channelSlices;
+
+    for (int channel = 1; channel <= 16; channel++)
+    {
+        const TUN::CSingleScale* scale = multiScaleFile.Find(channel);
+        if (scale == nullptr)
+            scale = &defaultScale;
+
+        auto slice = std::find(sliceScales.begin(), sliceScales.end(), scale);
+        channelSlices[channel - 1] = (int)(slice - sliceScales.begin());
+
+        if (slice == sliceScales.end())
+            sliceScales.push_back(scale);
+    }
+
+    juce::Array<double> frequencies;
+    frequencies.ensureStorageAllocated((int)sliceScales.size() * 128);
+
+    juce::String description;
+    for (int s = 0; s < (int)sliceScales.size(); s++)
+    {
+        auto scaleFrequencies = sliceScales[s]->GetNoteFrequenciesHz();
+        for (int note = 0; note < 128; note++)
+            frequencies.add(scaleFrequencies[note]);
+
+        juce::StringArray channels;
+        for (int channel = 1; channel <= 16; channel++)
+            if (channelSlices[channel - 1] == s)
+                channels.add(juce::String(channel));
+
+        auto scaleName = (sliceScales[s] == &defaultScale) ? juce::String("12EDO")
+                                                           : juce::String(sliceScales[s]->m_strName);
+
+        description += "Channels " + channels.joinIntoString(", ") + ": " + scaleName + juce::newLine;
+    }
+
+    auto rootScale = sliceScales[channelSlices[0]];
+    int rootNote = (int)rootScale->GetBaseNote();
+
+    TuningTable::Definition definition =
+    {
+        frequencies,
+        channelSlices[0] * 128 + rootNote,
+        msfFile.getFileNameWithoutExtension(),
+        description,
+        juce::String(),
+        0,
+        0
+    };
+
+    mapping = std::make_shared<TuningTableMap>(TuningTableMap::ChannelSlicesDefinition(channelSlices, rootNote));
+    return std::make_shared<TuningTable>(definition);
+}
+
+TuningFileParser::ParseResult TuningFileParser::parseFile(juce::File file, const ProgressCallback& progressCallback)
+{
+    ParseResult result;
+    result.type = TuningType(determineTuningType(file));
+    result.filePath = file.getFullPathName();
+
+    // Remember if the caller cancelled, since the parsers only report it as an error
+    ProgressCallback lineCallback;
+    if (progressCallback)
+    {
+        lineCallback = [&](float progress)
+        {
+            result.wasCancelled = !progressCallback(progress);
+            return !result.wasCancelled;
+        };
+    }
+
+    switch (result.type)
+    {
+    case TuningType::SCL:
+        result.tuning = parseScalaFileDefinition(file, result.error, lineCallback);
+        break;
+
+    case TuningType::TUN:
+        result.tuning = parseTunFileDefinition(file, result.error, lineCallback);
+        break;
+
+    case TuningType::MSF:
+        result.tuning = parseMultiScaleFileDefinition(file, result.mapping, result.error, lineCallback);
+        break;
+
+    default:
+        result.error = "Unsupported file type: " + file.getFileExtension();
+        break;
+    }
+
+    if (result.tuning == nullptr && result.error.isEmpty())
+        result.error = "Unable to read tuning from file.";
+
+    return result;
+}
+
+bool TuningFileParser::parseKeyboardMappingFile(juce::File kbmFile, ScalaBufferParser::KeyboardMapping& keyboardMapping, juce::String& error)
+{
+    juce::MemoryBlock data;
+    if (!kbmFile.loadFileAsData(data))
+    {
+        error = "Error opening the file.";
+        return false;
+    }
+
+    return ScalaBufferParser::parseKeyboardMapping(ScalaBufferParser::viewOf(data), keyboardMapping, error);
+}
+
+TuningTableMap::Definition TuningFileParser::keyboardMappingDefinition(const ScalaBufferParser::KeyboardMapping& keyboardMapping, const TuningTable& tuning)
+{
+    std::vector<int> keys(keyboardMapping.keys.begin(), keyboardMapping.keys.end());
+
+    return TuningTableMap::KeyboardMappingDefinition(keys,
+                                                     keyboardMapping.firstNote,
+                                                     keyboardMapping.lastNote,
+                                                     keyboardMapping.middleNote,
+                                                     keyboardMapping.formalOctave,
+                                                     tuning.getRootIndex());
+}
+
+double TuningFileParser::keyboardMappingRootFrequency(const ScalaBufferParser::KeyboardMapping& keyboardMapping, const TuningTable& tuning)
+{
+    auto definition = keyboardMappingDefinition(keyboardMapping, tuning);
+    auto referenceIndex = definition.map.at(keyboardMapping.referenceNote);
+
+    if (referenceIndex == TuningTableMap::UnmappedIndex)
+        return tuning.getRootFrequency();
+
+    // Cents from the root don't depend on the root frequency
+    auto referenceCents = tuning.centsAt(referenceIndex);
+    return keyboardMapping.referenceFrequency / centsToRatio(referenceCents);
+}
+
+std::shared_ptr<TuningTableMap> TuningFileParser::applyKeyboardMapping(const ScalaBufferParser::KeyboardMapping& keyboardMapping, std::shared_ptr<TuningTable>& tuning)
+{
+    auto rootFrequency = keyboardMappingRootFrequency(keyboardMapping, *tuning);
+
+    if (rootFrequency != tuning->getRootFrequency())
+    {
+        auto functional = dynamic_cast<FunctionalTuning*>(tuning.get());
+        if (functional != nullptr)
+        {
+            auto definition = functional->getDefinition();
+            definition.rootFrequency = rootFrequency;
+            tuning = std::make_shared<FunctionalTuning>(definition);
+        }
+        else
+        {
+            auto copy = std::make_shared<TuningTable>(*tuning);
+            copy->setRootFrequency(rootFrequency);
+            tuning = copy;
+        }
+    }
+
+    return std::make_shared<TuningTableMap>(keyboardMappingDefinition(keyboardMapping, *tuning));
+}
+
 void TuningFileParser::parseTuning(juce::File fileLoaded)
 {
     switch (type)
@@ -170,6 +472,16 @@ void TuningFileParser::parseTuning(juce::File fileLoaded)
     case TuningType::TUN:
         parsedTuning = parseTunFileDefinition(fileLoaded);
         break;
+
+    case TuningType::MSF:
+    {
+        juce::String error;
+        std::shared_ptr<TuningTableMap> mapping;
+        parsedTuning = parseMultiScaleFileDefinition(fileLoaded, mapping, error);
+        if (parsedTuning == nullptr)
+            showError(fileLoaded.getFullPathName(), error);
+        break;
+    }
     }
 }
 
@@ -238,11 +550,11 @@ juce::String TuningFileParser::tunInfoToString(const TUN::CSingleScale& tunScale
     return info;
 }
 
-void TuningFileParser::showError(juce::String fileName, TUN::CErr err)
+void TuningFileParser::showError(juce::String fileName, juce::String error)
 {
     juce::AlertWindow::showMessageBoxAsync(
         juce::MessageBoxIconType::WarningIcon, 
         juce::String("Error loading ") + fileName,
-        juce::String(err.GetLastError()), 
+        error, 
         juce::String("OK"));
 }
@@ -15,6 +15,8 @@
 #include <JuceHeader.h>
 
 #include "../tuning/FunctionalTuning.h"
+#include "ScalaBufferParser.h"
+#include "../mapping/TuningTableMap.h"
 
 #include "TUN_V2/SCL_Import.h"
 #include "TUN_V2/TUN_Scale.h"
@@ -35,6 +37,23 @@ public:
         INV = 0,    // Invalid
         SCL,        // Scala
         TUN,        // Anamark Tun 2.0
+        MSF,        // Anamark multiple scale file
+    };
+
+    // Called for every line read with the fraction of the file read, return false to cancel
+    using ProgressCallback = ScalaBufferParser::ProgressCallback;
+
+    // Parsing outcome that can be passed between threads, instead of showing an error dialog
+    struct ParseResult
+    {
+        std::shared_ptr<TuningTable> tuning;    // nullptr if parsing failed
+        std::shared_ptr<TuningTableMap> mapping; // Set if the file defines its own mapping, like .msf
+        TuningType type = TuningType::INV;
+        juce::String filePath;
+        juce::String error;                     // Empty if parsing succeeded
+        bool wasCancelled = false;              // The progress callback stopped parsing
+
+        bool wasSuccessful() const { return tuning != nullptr; }
     };
 
 public:
@@ -56,13 +75,39 @@ public:
 
     static std::shared_ptr<TuningTable> parseTunFileDefinition(juce::File tunFile);
 
+    // Reads every scale of a multiple scale file into one table of 128-note slices,
+    // and sets the mapping that plays each MIDI channel's slice
+    static std::shared_ptr<TuningTable> parseMultiScaleFileDefinition(juce::File msfFile, std::shared_ptr<TuningTableMap>& mapping, juce::String& error,
+                                                                      const ProgressCallback& progressCallback = nullptr);
+
+    // Does not show any dialogs, so it is safe to call from a background thread
+    static ParseResult parseFile(juce::File file, const ProgressCallback& progressCallback = nullptr);
+
+    // Reads a Scala keyboard mapping (.kbm), without showing any dialogs
+    static bool parseKeyboardMappingFile(juce::File kbmFile, ScalaBufferParser::KeyboardMapping& keyboardMapping, juce::String& error);
+
+    // Converts a Scala keyboard mapping to a TuningTableMap, where scale degree 0 is the tuning's root index
+    static TuningTableMap::Definition keyboardMappingDefinition(const ScalaBufferParser::KeyboardMapping& keyboardMapping, const TuningTable& tuning);
+
+    // The root frequency that tunes the reference note of the keyboard mapping to its reference frequency,
+    // or the current root frequency if the reference note is unmapped
+    static double keyboardMappingRootFrequency(const ScalaBufferParser::KeyboardMapping& keyboardMapping, const TuningTable& tuning);
+
+    // Replaces the tuning with a copy at the keyboard mapping's root frequency if it needs to be retuned,
+    // and returns the keyboard mapping for it
+    static std::shared_ptr<TuningTableMap> applyKeyboardMapping(const ScalaBufferParser::KeyboardMapping& keyboardMapping, std::shared_ptr<TuningTable>& tuning);
+
 private:
 
     void parseTuning(juce::File file);
 
+    static std::shared_ptr<FunctionalTuning> parseScalaFileDefinition(juce::File scalaFile, juce::String& error, const ProgressCallback& progressCallback = nullptr);
+
+    static std::shared_ptr<TuningTable> parseTunFileDefinition(juce::File tunFile, juce::String& error, const ProgressCallback& progressCallback = nullptr);
+
     static juce::String tunInfoToString(const TUN::CSingleScale& tunScale);
 
-    static void showError(juce::String filename, TUN::CErr err);
+    static void showError(juce::String filename, juce::String error);
 
 private:
 
@@ -0,0 +1,499 @@
+/*
+  ==============================================================================
+
+    TuningFileWriter.cpp
+    Created: 19 Oct 2026 9:12:40pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include "TuningFileWriter.h"
+#include "TUN_V2/TUN_Scale.h"
+
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    const int unknownKey = std::numeric_limits<int>::min();
+
+    // Fits the degrees of each MIDI note to a pattern of keys starting at the middle note,
+    // where each repetition of the pattern is offset by the formal octave
+    bool fitKeyboardPattern(const std::array<int, 128>& degrees,
+                            const std::array<bool, 128>& isMapped,
+                            int firstNote, int lastNote,
+                            int middleNote, int patternSize, int defaultOctave,
+                            ScalaBufferParser::KeyboardMapping& keyboardMapping)
+    {
+        std::vector<int> keys((size_t)patternSize, unknownKey);
+
+        auto repetitionOf = [&](int note) { return floorDiv(note - middleNote, patternSize); };
+        auto keyOf = [&](int note) { return note - middleNote - repetitionOf(note) * patternSize; };
+
+        for (int note = firstNote; note <= lastNote; note++)
+        {
+            if (isMapped[note] && repetitionOf(note) == 0)
+                keys[keyOf(note)] = degrees[note];
+        }
+
+        int formalOctave = unknownKey;
+        for (int note = firstNote; note <= lastNote && formalOctave == unknownKey; note++)
+        {
+            int repetition = repetitionOf(note);
+            int key = keys[keyOf(note)];
+            if (!isMapped[note] || repetition == 0 || key == unknownKey)
+                continue;
+
+            int difference = degrees[note] - key;
+            if (difference % repetition != 0)
+                return false;
+
+            formalOctave = difference / repetition;
+        }
+
+        if (formalOctave == unknownKey)
+            formalOctave = defaultOctave;
+
+        // Keys that are only played outside of the first repetition
+        for (int note = firstNote; note <= lastNote; note++)
+        {
+            if (isMapped[note] && keys[keyOf(note)] == unknownKey)
+                keys[keyOf(note)] = degrees[note] - repetitionOf(note) * formalOctave;
+        }
+
+        for (int note = firstNote; note <= lastNote; note++)
+        {
+            int key = keys[keyOf(note)];
+            if (isMapped[note] != (key != unknownKey))
+                return false;
+
+            if (isMapped[note] && degrees[note] != key + repetitionOf(note) * formalOctave)
+                return false;
+        }
+
+        // Values the .kbm reader accepts
+        if (formalOctave < 0 || formalOctave > 127)
+            return false;
+
+        for (auto key : keys)
+        {
+            if (key != unknownKey && (key < 0 || key > 127))
+                return false;
+        }
+
+        keyboardMapping.patternSize = patternSize;
+        keyboardMapping.firstNote = firstNote;
+        keyboardMapping.lastNote = lastNote;
+        keyboardMapping.middleNote = middleNote;
+        keyboardMapping.formalOctave = formalOctave;
+
+        keyboardMapping.keys.clearQuick();
+        for (auto key : keys)
+            keyboardMapping.keys.add((key == unknownKey) ? -1 : key);
+
+        return true;
+    }
+
+    // Scala and TUN files are single lines of text
+    juce::String singleLine(const juce::String& text)
+    {
+        return text.replaceCharacters("\r\n", "  ").trim();
+    }
+}
+
+class TuningFileWriter::ExportJob : public juce::ThreadPoolJob
+{
+    const juce::Array<ExportItem>& items;
+    int start;
+    int end;
+
+public:
+
+    int written = 0;
+    juce::StringArray errors;
+
+    ExportJob(const juce::Array<ExportItem>& itemsIn, int startIn, int endIn)
+        : juce::ThreadPoolJob("TuningFileExport"),
+          items(itemsIn),
+          start(startIn),
+          end(endIn) {}
+
+    JobStatus runJob() override
+    {
+        // One buffer for every file of this job
+        TuningFileWriter writer;
+
+        for (int i = start; i < end; i++)
+        {
+            if (shouldExit())
+                break;
+
+            const auto& item = items.getReference(i);
+
+            juce::String error;
+            if (writer.exportFile(item, error))
+                written++;
+            else
+                errors.add(item.file.getFullPathName() + ": " + error);
+        }
+
+        return JobStatus::jobHasFinished;
+    }
+};
+
+const std::string& TuningFileWriter::formatScala(const TuningTable& tuning)
+{
+    auto cents = scaleCents(tuning);
+
+    buffer.clear();
+    appendLine("! " + singleLine(tuning.getName()));
+    appendLine("!");
+    appendLine(singleLine(tuning.getDescription()));
+    appendInt(cents.size());
+    buffer += '\n';
+    appendLine("!");
+
+    for (auto value : cents)
+    {
+        appendCents(value);
+        buffer += '\n';
+    }
+
+    return buffer;
+}
+
+bool TuningFileWriter::formatKeyboardMapping(const MappedTuningTable& mappedTuning, int midiChannel, juce::String& error)
+{
+    ScalaBufferParser::KeyboardMapping keyboardMapping;
+    if (!findKeyboardMapping(mappedTuning, midiChannel, keyboardMapping))
+    {
+        error = "The mapping of channel " + juce::String(midiChannel) + " can't be written as a Scala keyboard mapping.";
+        return false;
+    }
+
+    auto writeSetting = [&](const char* comment, int value)
+    {
+        appendLine(comment);
+        appendInt(value);
+        buffer += '\n';
+    };
+
+    buffer.clear();
+    appendLine("! Keyboard mapping for " + singleLine(mappedTuning.getTuning()->getName())
+               + ", MIDI channel " + juce::String(midiChannel));
+    appendLine("!");
+    writeSetting("! Size of map:", keyboardMapping.patternSize);
+    writeSetting("! First MIDI note number to retune:", keyboardMapping.firstNote);
+    writeSetting("! Last MIDI note number to retune:", keyboardMapping.lastNote);
+    writeSetting("! Middle note where the first entry of the mapping is mapped to:", keyboardMapping.middleNote);
+    writeSetting("! Reference note for which frequency is given:", keyboardMapping.referenceNote);
+
+    appendLine("! Frequency to tune the above note to:");
+    appendDouble(keyboardMapping.referenceFrequency);
+    buffer += '\n';
+
+    writeSetting("! Scale degree to consider as formal octave:", keyboardMapping.formalOctave);
+
+    appendLine("! Mapping.");
+    for (auto key : keyboardMapping.keys)
+    {
+        if (key < 0)
+            buffer += 'x';
+        else
+            appendInt(key);
+        buffer += '\n';
+    }
+
+    return true;
+}
+
+const std::string& TuningFileWriter::formatTun(const MappedTuningTable& mappedTuning, int midiChannel)
+{
+    std::array<double, 128> cents;
+    for (int note = 0; note < 128; note++)
+    {
+        auto frequency = mappedTuning.frequencyAt(note, midiChannel);
+        cents[note] = (frequency > 0) ? TUN::Hz2Cents(frequency, TUN::DefaultBaseFreqHz)
+                                      : TUN::MIDINote_DefaultCents(note);
+    }
+
+    auto tuning = mappedTuning.getTuning();
+    auto quoted = [](const juce::String& text) { return juce::String(TUN::strx::GetAsString(text.toStdString())); };
+
+    buffer.clear();
+    appendLine(";");
+    appendLine("; AnaMark tuning map file V2.00");
+    appendLine(";");
+    appendLine("[Scale Begin]");
+    appendLine("Format = \"AnaMark-TUN\"");
+    appendLine("FormatVersion = 200");
+    appendLine("FormatSpecs = " + quoted(TUN::CSingleScale::FormatSpecs()));
+    buffer += '\n';
+
+    appendLine("[Info]");
+    appendLine("Name = " + quoted(singleLine(tuning->getName())));
+    if (tuning->getDescription().isNotEmpty())
+        appendLine("Description = " + quoted(singleLine(tuning->getDescription())));
+    buffer += '\n';
+
+    // Version 1 section with exact tunings
+    appendLine("[Exact Tuning]");
+    buffer += "BaseFreq = ";
+    appendDouble(TUN::DefaultBaseFreqHz);
+    buffer += '\n';
+    for (int note = 0; note < 128; note++)
+    {
+        buffer += "note ";
+        appendInt(note);
+        buffer += " = ";
+        appendCents(cents[note]);
+        buffer += '\n';
+    }
+    buffer += '\n';
+
+    // Version 0 section with whole cents
+    appendLine("[Tuning]");
+    for (int note = 0; note < 128; note++)
+    {
+        buffer += "note ";
+        appendInt(note);
+        buffer += " = ";
+        appendInt((int)std::floor(cents[note] + 0.5));
+        buffer += '\n';
+    }
+    buffer += '\n';
+
+    appendLine("[Scale End]");
+    return buffer;
+}
+
+bool TuningFileWriter::writeBufferToFile(juce::File file, juce::String& error) const
+{
+    if (!file.replaceWithData(buffer.data(), buffer.size()))
+    {
+        error = "Error writing the file.";
+        return false;
+    }
+
+    return true;
+}
+
+bool TuningFileWriter::exportFile(const TuningFileWriter::ExportItem& item, juce::String& error)
+{
+    if (item.tuning == nullptr)
+    {
+        error = "No tuning to export.";
+        return false;
+    }
+
+    if (item.file.hasFileExtension("scl"))
+    {
+        if (scaleCents(*item.tuning->getTuning()).isEmpty())
+        {
+            error = "The tuning has no degrees above its root.";
+            return false;
+        }
+
+        formatScala(*item.tuning->getTuning());
+    }
+
+    else if (item.file.hasFileExtension("kbm"))
+    {
+        if (!formatKeyboardMapping(*item.tuning, item.midiChannel, error))
+            return false;
+    }
+
+    else if (item.file.hasFileExtension("tun"))
+        formatTun(*item.tuning, item.midiChannel);
+
+    else
+    {
+        error = "Unsupported file type: " + item.file.getFileExtension();
+        return false;
+    }
+
+    return writeBufferToFile(item.file, error);
+}
+
+TuningFileWriter::BatchResult TuningFileWriter::exportBank(const juce::Array<TuningFileWriter::ExportItem>& items, int numThreads)
+{
+    BatchResult result;
+
+    if (numThreads <= 0)
+        numThreads = juce::jmax(1, juce::SystemStats::getNumCpus());
+
+    int itemsPerJob = juce::jmax(1, (items.size() + numThreads - 1) / numThreads);
+
+    juce::ThreadPool pool(numThreads);
+    juce::OwnedArray<ExportJob> jobs;
+
+    for (int start = 0; start < items.size(); start += itemsPerJob)
+    {
+        auto end = juce::jmin(start + itemsPerJob, items.size());
+        auto job = jobs.add(new ExportJob(items, start, end));
+        pool.addJob(job, false);
+    }
+
+    for (auto job : jobs)
+    {
+        pool.waitForJobToFinish(job, -1);
+        result.written += job->written;
+        result.errors.addArray(job->errors);
+    }
+
+    juce::Logger::writeToLog("Exported " + juce::String(result.written) + " of " + juce::String(items.size()) + " tuning files");
+    for (auto error : result.errors)
+        juce::Logger::writeToLog("Error exporting " + error);
+
+    return result;
+}
+
+juce::Array<double> TuningFileWriter::scaleCents(const TuningTable& tuning)
+{
+    auto functionalTuning = dynamic_cast<const FunctionalTuning*>(&tuning);
+    if (functionalTuning != nullptr)
+        return functionalTuning->getIntervalCentsList();
+
+    // Use the virtual size as the period if it's known, otherwise the whole table above the root
+    int rootIndex = tuning.getRootIndex();
+    int sizeAbove = tuning.getTableSize() - 1 - rootIndex;
+    int size = (int)tuning.getVirtualSize();
+    if (size <= 0 || size != tuning.getVirtualSize())
+        size = sizeAbove;
+
+    // Degrees past the end of the table are a period above the degree one period lower,
+    // which needs a whole period below the root. Otherwise only the table above the root is written.
+    bool wrapsAroundPeriod = size > sizeAbove && size <= rootIndex;
+    if (size > sizeAbove && !wrapsAroundPeriod)
+        size = sizeAbove;
+
+    // Same limit as the .scl reader
+    size = juce::jmin(size, 127);
+
+    juce::Array<double> cents;
+    if (size < 1)
+        return cents;
+
+    double periodCents = wrapsAroundPeriod ? -tuning.centsAt(rootIndex - size) : 0.0;
+
+    cents.ensureStorageAllocated(size);
+    for (int i = 1; i <= size; i++)
+    {
+        if (i <= sizeAbove)
+            cents.add(tuning.centsAt(rootIndex + i));
+        else
+            cents.add(tuning.centsAt(rootIndex + i - size) + periodCents);
+    }
+
+    return cents;
+}
+
+bool TuningFileWriter::findKeyboardMapping(const MappedTuningTable& mappedTuning, int midiChannel, ScalaBufferParser::KeyboardMapping& keyboardMapping)
+{
+    auto tuning = mappedTuning.getTuning();
+    auto mapping = mappedTuning.getMapping();
+    int rootIndex = tuning->getRootIndex();
+
+    std::array<int, 128> degrees;
+    std::array<bool, 128> isMapped;
+    int firstNote = -1;
+    int lastNote = -1;
+
+    for (int note = 0; note < 128; note++)
+    {
+        auto mapped = mapping->getMappedNote(midiChannel, note);
+        isMapped[note] = mapped.mapped;
+        degrees[note] = mapped.index - rootIndex;
+
+        if (mapped.mapped)
+        {
+            if (firstNote < 0)
+                firstNote = note;
+            lastNote = note;
+        }
+    }
+
+    if (firstNote < 0)
+        return false;
+
+    int middleNote = mapping->getRootMidiNote();
+    int scaleSize = scaleCents(*tuning).size();
+
+    // Prefer the mapping's own period and the scale size, otherwise the smallest pattern that fits
+    juce::Array<int> patternSizes = { mapping->period(), scaleSize };
+    for (int size = 1; middleNote + size <= 127; size++)
+        patternSizes.addIfNotAlreadyThere(size);
+
+    for (auto patternSize : patternSizes)
+    {
+        if (patternSize < 1 || middleNote + patternSize > 127)
+            continue;
+
+        if (fitKeyboardPattern(degrees, isMapped, firstNote, lastNote, middleNote, patternSize, scaleSize, keyboardMapping))
+        {
+            keyboardMapping.referenceNote = isMapped[middleNote] ? middleNote : firstNote;
+            keyboardMapping.referenceFrequency = mappedTuning.frequencyAt(keyboardMapping.referenceNote, midiChannel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TuningFileWriter::appendLine(const juce::String& text)
+{
+    buffer += text.toRawUTF8();
+    buffer += '\n';
+}
+
+void TuningFileWriter::appendInt(int value)
+{
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+void TuningFileWriter::appendDouble(double value)
+{
+    // Shortest representation that reads back to the same value
+    char digits[64];
+#ifndef __cpp_lib_to_chars
+    // Floating point to_chars is missing from some standard libraries, such as Apple's libc++,
+    // so the fewest decimals that read back to the value are found with snprintf instead
+    for (int decimals = 0; decimals <= 17; decimals++)
+    {
+        auto length = std::snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+        if (length > 0 && length < (int)sizeof(digits) && std::strtod(digits, nullptr) == value)
+        {
+            buffer.append(digits, (size_t)length);
+            return;
+        }
+    }
+
+    auto length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+    buffer.append(digits, (size_t)juce::jlimit(0, (int)sizeof(digits) - 1, length));
+#else
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed);
+    if (result.ec != std::errc())
+        result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general);
+
+    buffer.append(digits, result.ptr);
+#endif
+}
+
+void TuningFileWriter::appendCents(double cents)
+{
+    // Avoid values like 1e-13 from rounding errors, like CSingleScale::WriteKey
+    if (std::abs(cents) < 1e-8)
+        cents = 0;
+
+    auto start = buffer.size();
+    appendDouble(cents);
+
+    // Scala reads values without a period as ratios
+    if (buffer.find('.', start) == std::string::npos)
+        buffer += ".0";
+}
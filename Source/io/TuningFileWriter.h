@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    TuningFileWriter.h
+    Created: 19 Oct 2026 9:12:40pm
+    Author:  Vincenzo
+
+    Exports tunings to Scala .scl and .kbm files and AnaMark .tun files.
+    Each file is formatted with std::to_chars into a buffer that is reused
+    between files, and written to disk in one call.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ScalaBufferParser.h"
+#include "../tuning/MappedTuning.h"
+
+#include <string>
+
+class TuningFileWriter
+{
+public:
+
+    struct ExportItem
+    {
+        std::shared_ptr<MappedTuningTable> tuning;
+        juce::File file;            /* The format is chosen by the extension: .scl, .kbm or .tun */
+        int midiChannel = 1;        /* Channel of the mapping that is written to .kbm and .tun files */
+    };
+
+    struct BatchResult
+    {
+        int written = 0;
+        juce::StringArray errors;   /* One line per file that failed */
+    };
+
+private:
+
+    class ExportJob;
+
+    std::string buffer;
+
+public:
+
+    TuningFileWriter() {}
+
+    // Each of these replaces the buffer with a complete file
+
+    // Interval list of a FunctionalTuning, or the table above the root of other tunings
+    const std::string& formatScala(const TuningTable& tuning);
+
+    // Returns false and sets the error if the mapping of the channel doesn't fit a Scala keyboard mapping
+    bool formatKeyboardMapping(const MappedTuningTable& mappedTuning, int midiChannel, juce::String& error);
+
+    // The frequency of each MIDI note of the channel, unmapped notes keep their standard tuning
+    const std::string& formatTun(const MappedTuningTable& mappedTuning, int midiChannel = 1);
+
+    const std::string& getBuffer() const { return buffer; }
+
+    bool writeBufferToFile(juce::File file, juce::String& error) const;
+
+    bool exportFile(const ExportItem& item, juce::String& error);
+
+    // Exports the items with a thread pool, and blocks until all files are written
+    static BatchResult exportBank(const juce::Array<ExportItem>& items, int numThreads = 0);
+
+public:
+
+    // Degrees above the root in cents, ending with the period, as written to .scl files.
+    // Only reads inside the tuning's table, and is empty if nothing is above the root.
+    static juce::Array<double> scaleCents(const TuningTable& tuning);
+
+    // Finds a Scala keyboard mapping that reproduces the mapping of one channel
+    static bool findKeyboardMapping(const MappedTuningTable& mappedTuning, int midiChannel, ScalaBufferParser::KeyboardMapping& keyboardMapping);
+
+private:
+
+    void appendLine(const juce::String& text);
+    void appendInt(int value);
+    void appendDouble(double value);
+    void appendCents(double cents);
+};
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <cmath>
+#include <algorithm>
 #include <functional>
 #include <vector>
 #include <string>
@@ -24,6 +25,70 @@ static int mod(int num, int mod)
     return ((num % mod) + mod) % mod;
 }
 
+// Integer equivalent of floor((double)num / (double)den)
+static int floorDiv(int num, int den)
+{
+    int quotient = num / den;
+    return (num % den != 0 && (num < 0) != (den < 0)) ? quotient - 1 : quotient;
+}
+
+// Returns log2(size) if size is a power of two, otherwise -1
+static int powerOfTwoShift(int size)
+{
+    if (size <= 0 || (size & (size - 1)) != 0)
+        return -1;
+
+    int shift = 0;
+    while ((1 << shift) < size)
+        shift++;
+
+    return shift;
+}
+
+// Period arithmetic of a pattern size known at compile time, a shift and mask for powers of two
+template <int Size>
+struct FixedSizePeriod
+{
+    static constexpr bool isPowerOfTwo = (Size & (Size - 1)) == 0;
+
+    static constexpr int shiftOf(int size) { return (size > 1) ? 1 + shiftOf(size >> 1) : 0; }
+    static constexpr int shift = shiftOf(Size);
+
+    int index(int normalizedIndex) const
+    {
+        if constexpr (isPowerOfTwo)
+            return normalizedIndex & (Size - 1);
+        else
+            return mod(normalizedIndex, Size);
+    }
+
+    int periods(int normalizedIndex) const
+    {
+        if constexpr (isPowerOfTwo)
+            return normalizedIndex >> shift;
+        else
+            return floorDiv(normalizedIndex, Size);
+    }
+};
+
+// Period arithmetic of any power of two size
+struct PowerOfTwoPeriod
+{
+    int shift = 0;
+
+    int index(int normalizedIndex) const { return normalizedIndex & ((1 << shift) - 1); }
+    int periods(int normalizedIndex) const { return normalizedIndex >> shift; }
+};
+
+// Period arithmetic of any size
+struct AnyPeriod
+{
+    int size = 1;
+
+    int index(int normalizedIndex) const { return mod(normalizedIndex, size); }
+    int periods(int normalizedIndex) const { return floorDiv(normalizedIndex, size); }
+};
+
 template <typename T>
 class Map
 {
@@ -97,13 +162,24 @@ private:
     // Added to mapped number
     T transpose = 0;
 
+    // Used for shift & mask period arithmetic if the size is a power of two, otherwise -1
+    int sizeShift = -1;
+
 private:
         
     int normalizedIndex(const int& index) const { return index - mapRootIndex + (int)patternRootIndex; }
         
-    int mapIndex(const int& normalizedIndex) const { return mod(normalizedIndex, mapSize); }
+    int mapIndex(const int& normalizedIndex) const 
+    { 
+        return (sizeShift >= 0) ? normalizedIndex & (mapSize - 1)
+                                : mod(normalizedIndex, mapSize); 
+    }
 
-    int periods(const int& normalizedIndex) const { return floor((double)normalizedIndex / (double)mapSize); }
+    int periods(const int& normalizedIndex) const 
+    { 
+        return (sizeShift >= 0) ? normalizedIndex >> sizeShift
+                                : floorDiv(normalizedIndex, mapSize); 
+    }
 
 public:
 
@@ -125,20 +201,77 @@ private:
     //    return newPatternCopy(definition.mapSize, definition.pattern);
     //}
 
-    Pattern initializePattern(FunctionDefinition definition)
+    template <typename Period>
+    T atWith(const Period& period, int index) const
     {
-        Pattern pattern;
-        for (int i = 0; i < definition.mapSize; i++)
+        auto normIndex = normalizedIndex(index);
+        return mapPattern[period.index(normIndex)] + period.periods(normIndex) * patternBase + transpose;
+    }
+
+    template <typename Period>
+    void fillWith(const Period& period, T* output, int start, int count) const
+    {
+        auto normIndex = normalizedIndex(start);
+        auto p = period.periods(normIndex);
+        auto i = period.index(normIndex);
+
+        int n = 0;
+        while (n < count)
         {
-            int x = definition.start + i;
-            pattern.push_back(definition.function(x));
+            int segmentLength = std::min(mapSize - i, count - n);
+            const T* patternSegment = mapPattern.data() + i;
+            T* outputSegment = output + n;
+
+            T offset = p * patternBase + transpose;
+            if (offset == 0)
+                std::copy(patternSegment, patternSegment + segmentLength, outputSegment);
+            else
+                for (int s = 0; s < segmentLength; s++)
+                    outputSegment[s] = patternSegment[s] + offset;
+
+            n += segmentLength;
+            i = 0;
+            p++;
         }
-
-        return pattern;
     }
 
 public:
 
+    // Evaluates any callable with an integer input for each pattern index, writing into existing storage
+    template <typename Generator>
+    static void generatePattern(T* output, int size, int start, const Generator& generator)
+    {
+        for (int i = 0; i < size; i++)
+            output[i] = generator(start + i);
+    }
+
+    // Same as constructing with a FunctionDefinition, without wrapping the generator in a std::function.
+    // The pattern is generated in the map's own storage.
+    template <typename Generator>
+    static Map FromGenerator(int mapSize, int start, const Generator& generator, T base = 0, T transpose = 0)
+    {
+        Definition d =
+        {
+            mapSize,
+            Pattern(mapSize),
+            base,
+            0,
+            0,
+            transpose
+        };
+
+        Map map(std::move(d));
+        generatePattern(map.mapPattern.data(), mapSize, start, generator);
+        return map;
+    }
+
+    // Evaluates a generator again over the pattern, in place and without allocating
+    template <typename Generator>
+    void regenerate(int start, const Generator& generator)
+    {
+        generatePattern(mapPattern.data(), mapSize, start, generator);
+    }
+
     // 1:1 mapping
     Map()
         : mapSize(1),
@@ -146,23 +279,29 @@ public:
           patternBase(1),
           patternRootIndex(0),
           mapRootIndex(0),
-          transpose(0) {}
+          transpose(0),
+          sizeShift(0) {}
 
     Map(Definition definition)
         : mapSize(definition.mapSize), 
-          mapPattern(definition.pattern),
+          mapPattern(std::move(definition.pattern)),
           patternBase(definition.patternBase),
           patternRootIndex(mod(definition.patternRootIndex, definition.mapSize)),
           mapRootIndex(definition.mapRootIndex),
-          transpose(definition.transpose) {}
+          transpose(definition.transpose),
+          sizeShift(powerOfTwoShift(definition.mapSize)) {}
 
-    Map(FunctionDefinition definition)
+    Map(const FunctionDefinition& definition)
         : mapSize(definition.mapSize), 
-          mapPattern(initializePattern(definition)),
+          mapPattern(definition.mapSize),
           patternBase(definition.base),
           patternRootIndex(0),
           mapRootIndex(0),
-          transpose(definition.transpose) {}
+          transpose(definition.transpose),
+          sizeShift(powerOfTwoShift(definition.mapSize))
+    {
+        generatePattern(mapPattern.data(), mapSize, definition.start, definition.function);
+    }
 
     Map(const Map& map)
         : mapSize(map.mapSize),
@@ -170,10 +309,14 @@ public:
           patternBase(map.patternBase),
           patternRootIndex(map.patternRootIndex),
           mapRootIndex(map.mapRootIndex),
-          transpose(map.transpose) {}
+          transpose(map.transpose),
+          sizeShift(map.sizeShift) {}
+
+    Map(Map&& map) = default;
 
     ~Map() {}
 
+    // Reuses the pattern storage if it is large enough
     void operator=(const Map& map)
     {
         mapSize = map.mapSize;
@@ -182,6 +325,7 @@ public:
         patternRootIndex  = map.patternRootIndex;
         mapRootIndex = map.mapRootIndex;
         transpose = map.transpose;
+        sizeShift = map.sizeShift;
     }
 
     bool operator==(const Map& map)
@@ -213,7 +357,7 @@ public:
 
     T base() const { return patternBase; }
 
-    Pattern pattern() const { return mapPattern; }
+    const Pattern& pattern() const { return mapPattern; }
 
     int patternRoot() const { return patternRootIndex; }
 
@@ -223,10 +367,34 @@ public:
 
     T at(int index) const
     {
-        auto normIndex = normalizedIndex(index);
-        auto p = periods(normIndex);
-        auto i = mapIndex(normIndex);
-        return mapPattern[i] + p * patternBase + transpose;
+        if (sizeShift >= 0)
+            return atWith(PowerOfTwoPeriod { sizeShift }, index);
+
+        return atWith(AnyPeriod { mapSize }, index);
+    }
+
+    // Writes the values of at(start) through at(start + count - 1) into output.
+    // Only the first index is divided, the rest step through the pattern one period at a time,
+    // and periods with no offset are copied straight from the pattern.
+    // The 128 and 2048 note sizes of MIDI mappings use their compile-time period arithmetic.
+    void fill(T* output, int start, int count) const
+    {
+        switch (mapSize)
+        {
+        case 128:
+            fillWith(FixedSizePeriod<128>(), output, start, count);
+            break;
+
+        case 2048:
+            fillWith(FixedSizePeriod<2048>(), output, start, count);
+            break;
+
+        default:
+            if (sizeShift >= 0)
+                fillWith(PowerOfTwoPeriod { sizeShift }, output, start, count);
+            else
+                fillWith(AnyPeriod { mapSize }, output, start, count);
+        }
     }
 
     int periodsAt(int index) const
@@ -289,14 +457,12 @@ public:
 template <typename T>
 static Map<T> LinearMap(int mapRootIndex = 0, T base = 1, T transpose = 0)
 {
-    typename Map<T>::FunctionDefinition d =
-    { 
+    auto map = Map<T>::FromGenerator(
         1,             /* size */
         0,             /* start */
         [=](int x) -> int { return x - mapRootIndex; }, 
         base,
         transpose 
-    };
-    auto map = Map<T>(d);
+    );
     return map;
 }
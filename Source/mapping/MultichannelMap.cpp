@@ -11,45 +11,69 @@
 #include "MultichannelMap.h"
 
 MultichannelMap::MultichannelMap(MultichannelMap::Definition definition)
-    : TuningTableMap(DefineTuningTableMap(definition)),
-      maps(definition.maps) {}
+    : MultichannelMap(definition, buildTable(definition.maps)) {}
+
+MultichannelMap::MultichannelMap(MultichannelMap::Definition definition, std::shared_ptr<TuningTableMap::BaseTable> table)
+    : TuningTableMap(TuningTableMap::Definition 
+                     { 
+                        definition.root, 
+                        buildMultimap(*table, definition.maps.at(definition.root.midiChannel - 1).base()) 
+                     }, table),
+      maps(std::move(definition.maps)) {}
+
+MultichannelMap::MultichannelMap(TuningTableMap::Root root, const int* channelTables, int period)
+    : MultichannelMap(root, copyTable(channelTables), period) {}
+
+MultichannelMap::MultichannelMap(TuningTableMap::Root root, std::shared_ptr<TuningTableMap::BaseTable> table, int period)
+    : TuningTableMap(TuningTableMap::Definition { root, buildMultimap(*table, period) }, table) {}
 
 MultichannelMap::MultichannelMap(const MultichannelMap& mapToCopy)
-    : maps(mapToCopy.maps),
-      TuningTableMap(DefineTuningTableMap(mapToCopy.getDefinition())) {}
+    : TuningTableMap(mapToCopy),
+      maps(mapToCopy.maps) {}
 
 MultichannelMap::~MultichannelMap() {}
 
-Map<int> MultichannelMap::buildMultimap(MultichannelMap::Definition definition)
+std::shared_ptr<TuningTableMap::BaseTable> MultichannelMap::buildTable(const std::vector<Map<int>>& maps)
 {
-    // Create multimap from maps
-    std::vector<int> multipattern;
-    for (int m = 0; m < definition.maps.size(); m++)
-    {
-        auto channelOffset = m * 128;
-        auto map = &(definition.maps[m]);
-        for (int i = 0; i < 128; i++)
-        {
-            auto index = channelOffset + i;
-            multipattern.push_back(map->at(i));
-        }
-    }
+    auto table = std::make_shared<TuningTableMap::BaseTable>();
 
-    // Probably should be reworked
-    int period = definition.maps.at(definition.root.midiChannel - 1).base();
+    int numChannels = std::min((int)maps.size(), 16);
+    for (int m = 0; m < numChannels; m++)
+        maps[m].fill(table->table + m * 128, 0, 128);
+
+    std::fill(table->table + numChannels * 128, table->table + 2048, 0);
+
+    return table;
+}
+
+std::shared_ptr<TuningTableMap::BaseTable> MultichannelMap::copyTable(const int* channelTables)
+{
+    auto table = std::make_shared<TuningTableMap::BaseTable>();
+    std::copy(channelTables, channelTables + 2048, table->table);
+    return table;
+}
 
+Map<int> MultichannelMap::buildMultimap(const TuningTableMap::BaseTable& table, int period)
+{
     Map<int>::Definition d =
     {
-        2048,           /* mapSize */
-        multipattern,   /* pattern */
-        period,         /* base */
-        0,              /* pattern root */
-        0,              /* map root*/
+        2048,                                                   /* mapSize */
+        Map<int>::Pattern(table.table, table.table + 2048),     /* pattern */
+        period,                                                 /* base */
+        0,                                                      /* pattern root */
+        0,                                                      /* map root*/
     };
 
     return Map<int>(d);
 }
 
+Map<int> MultichannelMap::buildMultimap(const MultichannelMap::Definition& definition)
+{
+    // Probably should be reworked
+    int period = definition.maps.at(definition.root.midiChannel - 1).base();
+    return buildMultimap(*buildTable(definition.maps), period);
+}
+
 MultichannelMap::Definition MultichannelMap::getDefinition() const
 {
     MultichannelMap::Definition definition = 
@@ -58,5 +82,16 @@ MultichannelMap::Definition MultichannelMap::getDefinition() const
         maps,
     };
 
+    // Maps loaded from a channel table are only kept as the table
+    if (definition.maps.empty())
+    {
+        definition.maps.reserve(16);
+        for (int m = 0; m < 16; m++)
+        {
+            auto channelTable = baseTable->table + m * 128;
+            definition.maps.push_back(Map<int>(Map<int>::Definition { 128, Map<int>::Pattern(channelTable, channelTable + 128), period() }));
+        }
+    }
+
     return definition;
 }
\ No newline at end of file
@@ -14,15 +14,12 @@
 // Multichannel map
 class MultichannelMap : public TuningTableMap
 {
-    // Maps per channel of MultichannelMap
+    // Maps per channel of MultichannelMap, empty if loaded from a channel table
     std::vector<Map<int>> maps;
 
     // The multimap index that considered the root map
     int multimapRootIndex = 0;
 
-    // A lookup table by [midiChannel][midiNote]
-    int** lookup;
-
 public:
 
     struct Definition
@@ -33,12 +30,28 @@ public:
 
 private:
 
-    static Map<int> buildMultimap(Definition definition);
+    // Fills all 16 channels of the table in one pass, channels without a map are left at 0
+    static std::shared_ptr<TuningTableMap::BaseTable> buildTable(const std::vector<Map<int>>& maps);
+
+    // Wraps a built table in a 2048-note map, the period is taken from the root channel map
+    static Map<int> buildMultimap(const TuningTableMap::BaseTable& table, int period);
+
+    static Map<int> buildMultimap(const Definition& definition);
+
+    // Copies channel tables straight into the table that the map reads from
+    static std::shared_ptr<TuningTableMap::BaseTable> copyTable(const int* channelTables);
+
+    MultichannelMap(Definition definition, std::shared_ptr<TuningTableMap::BaseTable> table);
+
+    MultichannelMap(TuningTableMap::Root root, std::shared_ptr<TuningTableMap::BaseTable> table, int period);
 
 public:
 
     MultichannelMap(Definition definition);
 
+    // Loads 16 channels of 128 tuning indices, ordered by channel then note
+    MultichannelMap(TuningTableMap::Root root, const int* channelTables, int period);
+
     MultichannelMap(const MultichannelMap&);
 
     virtual ~MultichannelMap();
@@ -49,7 +62,7 @@ public:
 
 public:
 
-    static TuningTableMap::Definition DefineTuningTableMap(Definition definition)
+    static TuningTableMap::Definition DefineTuningTableMap(const Definition& definition)
     {
         return TuningTableMap::Definition
         {
@@ -58,42 +71,47 @@ public:
         };
     }
 
-    static std::unique_ptr<TuningTableMap> CreateTuningTableMap(Definition definition)
-    {
-        auto d = DefineTuningTableMap(definition);
-        return std::make_unique<TuningTableMap>(d);
-    }
-
     /*
         Creates a MultichannelMap that have linear maps that are offset by a period from each other.
         The root MIDI Channel & Note marks 0 periods, and will output the tuningRootIndex parameter.
     */
-    static TuningTableMap::Definition PeriodicMappingDefinition(int period, int rootMidiChannel, int rootMidiNote, int tuningRootIndex, int tuningTableSize)
+    static MultichannelMap::Definition PeriodicMultichannelDefinition(int period, int rootMidiChannel, int rootMidiNote, int tuningRootIndex, int tuningTableSize)
     {
         int channelPeriodOffset = -(rootMidiChannel - 1) * period;
         int currentTuningIndex = mod(channelPeriodOffset + tuningRootIndex - rootMidiNote, tuningTableSize);
 
         std::vector<Map<int>> maps;
+        maps.reserve(16);
         for (int m = 0; m < 16; m++)
         {
-            Map<int>::FunctionDefinition fd =
-            {
-                128,
-                currentTuningIndex,
-                [=](int x) { return mod(x, tuningTableSize); }
-            };
-
-            maps.push_back(Map<int>(fd));
+            maps.push_back(Map<int>::FromGenerator(128, currentTuningIndex, [=](int x) { return mod(x, tuningTableSize); }));
 
             currentTuningIndex = mod(currentTuningIndex + period, tuningTableSize);
         }
 
-        MultichannelMap::Definition d =
+        return MultichannelMap::Definition
         {
             TuningTableMap::Root { rootMidiChannel, rootMidiNote },
             maps
         };
+    }
 
-        return DefineTuningTableMap(d);
+    static std::unique_ptr<TuningTableMap> CreateTuningTableMap(const Definition& definition)
+    {
+        auto table = buildTable(definition.maps);
+        auto d = TuningTableMap::Definition
+        {
+            TuningTableMap::Root { definition.root.midiChannel, definition.root.midiNote },
+            buildMultimap(*table, definition.maps.at(definition.root.midiChannel - 1).base())
+        };
+        return std::make_unique<TuningTableMap>(d, table);
+    }
+
+    /*
+        Creates a TuningTableMap with the layout of PeriodicMultichannelDefinition
+    */
+    static TuningTableMap::Definition PeriodicMappingDefinition(int period, int rootMidiChannel, int rootMidiNote, int tuningRootIndex, int tuningTableSize)
+    {
+        return DefineTuningTableMap(PeriodicMultichannelDefinition(period, rootMidiChannel, rootMidiNote, tuningRootIndex, tuningTableSize));
     }
 };
@@ -13,37 +13,86 @@
 TuningTableMap::TuningTableMap(TuningTableMap::Definition definition)
     : rootMidiChannel(definition.root.midiChannel),
       rootMidiNote(definition.root.midiNote),
-      map(std::make_unique<Map<int>>(definition.map)),
-      transpose(definition.transpose)
+      map(std::make_shared<Map<int>>(std::move(definition.map))),
+      transpose(definition.transpose),
+      tableOffset(mod(definition.transpose, 2048))
 {
     rebuildTable();
 }
 
+TuningTableMap::TuningTableMap(TuningTableMap::Definition definition, std::shared_ptr<const BaseTable> prebuiltTable)
+    : rootMidiChannel(definition.root.midiChannel),
+      rootMidiNote(definition.root.midiNote),
+      map(std::make_shared<Map<int>>(std::move(definition.map))),
+      transpose(definition.transpose),
+      baseTable(prebuiltTable),
+      tableOffset(mod(definition.transpose, 2048))
+{
+    if (baseTable == nullptr)
+        rebuildTable();
+}
+
 TuningTableMap::TuningTableMap(const TuningTableMap& mapToCopy)
     : rootMidiChannel(mapToCopy.rootMidiChannel),
       rootMidiNote(mapToCopy.rootMidiNote),
-      map(new Map<int>(*mapToCopy.map.get())),
-      transpose(mapToCopy.transpose)
-{
-    rebuildTable();
-}
+      map(mapToCopy.map),
+      transpose(mapToCopy.transpose),
+      baseTable(mapToCopy.baseTable),
+      tableOffset(mapToCopy.tableOffset),
+      tableIsBuilt(mapToCopy.tableIsBuilt) {}
 
 void TuningTableMap::operator=(const TuningTableMap& mapToCopy)
 {
     rootMidiChannel = mapToCopy.rootMidiChannel;
     rootMidiNote = mapToCopy.rootMidiNote;
-    map.reset(new Map<int>(mapToCopy.getDefinition().map));
+    map = mapToCopy.map;
     transpose = mapToCopy.transpose;
+    baseTable = mapToCopy.baseTable;
+    tableOffset = mapToCopy.tableOffset;
+    tableIsBuilt = mapToCopy.tableIsBuilt;
+}
+
+void TuningTableMap::rebuild(const Definition& definition)
+{
+    rootMidiChannel = definition.root.midiChannel;
+    rootMidiNote = definition.root.midiNote;
+    transpose = definition.transpose;
+    tableOffset = mod(definition.transpose, 2048);
+
+    if (map.use_count() == 1)
+        *map = definition.map;
+    else
+        map = std::make_shared<Map<int>>(definition.map);
+
     rebuildTable();
 }
 
 void TuningTableMap::rebuildTable()
 {
+    // Tables built by maps are never const, only shared as const
+    BaseTable* table = nullptr;
+    if (tableIsBuilt && baseTable.use_count() == 1)
+    {
+        table = const_cast<BaseTable*>(baseTable.get());
+    }
+    else
+    {
+        auto newTable = std::make_shared<BaseTable>();
+        table = newTable.get();
+        baseTable = newTable;
+        tableIsBuilt = true;
+    }
 
-    for (int i = 0; i < 2048; i++)
+    const auto& pattern = map->pattern();
+    if (std::find(pattern.begin(), pattern.end(), UnmappedIndex) == pattern.end())
     {
-        int index = mod(i + transpose, 2048);
-        table[i] = map->at(index);
+        map->fill(table->table, 0, 2048);
+    }
+    else
+    {
+        // Unmapped keys stay unmapped in every period
+        for (int i = 0; i < 2048; i++)
+            table->table[i] = (pattern[map->mapIndexAt(i)] == UnmappedIndex) ? UnmappedIndex : map->at(i);
     }
 }
 
@@ -64,7 +113,13 @@ MappedNote TuningTableMap::getMappedNote(int midiNoteIndex) const
 
     bool mapped = midiNoteIndex >= 0 && midiNoteIndex < 2048;
    
-    int fullIndex = (mapped) ? table[midiNoteIndex] : 0;
+    int fullIndex = (mapped) ? baseTable->table[rotatedIndex(midiNoteIndex)] : 0;
+    if (fullIndex == UnmappedIndex)
+    {
+        mapped = false;
+        fullIndex = 0;
+    }
+
     int table = fullIndex / 128;
     int index = fullIndex % 128;
 
@@ -98,7 +153,7 @@ int TuningTableMap::getPatternIndex(int channel, int note)
 
 int TuningTableMap::tableAt(int midiNoteIndex) const
 {
-    return table[midiNoteIndex];
+    return baseTable->table[rotatedIndex(midiNoteIndex)];
 }
 
 TuningTableMap::Root TuningTableMap::getRoot() const
@@ -114,14 +169,14 @@ int TuningTableMap::getTransposition() const
 void TuningTableMap::setTransposition(int transposeIn)
 {
     transpose = transposeIn;
-    rebuildTable();
+    tableOffset = mod(transpose, 2048);
 }
 
-std::shared_ptr<TuningTableMap> TuningTableMap::withTransposition(int transposeIn)
+std::shared_ptr<TuningTableMap> TuningTableMap::withTransposition(int transposeIn) const
 {
-    auto definition = getDefinition();
-    definition.transpose = transposeIn;
-    return std::make_shared<TuningTableMap>(definition);
+    auto transposedMap = std::make_shared<TuningTableMap>(*this);
+    transposedMap->setTransposition(transposeIn);
+    return transposedMap;
 }
 
 TuningTableMap::Definition TuningTableMap::getDefinition() const
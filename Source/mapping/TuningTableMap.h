@@ -11,6 +11,8 @@
 #pragma once
 
 #include "./Map.h"
+#include <array>
+#include <limits>
 
 static int midiIndex(int midiChannel, int midiNote)
 {
@@ -66,6 +68,16 @@ public:
         int transpose = 0;
     };
 
+    // Table value for keys that should be ignored. Map patterns can use it for keys that are
+    // unmapped in every period, but Map::at() is only meaningful for the other keys.
+    static constexpr int UnmappedIndex = std::numeric_limits<int>::min();
+
+    // Untransposed map for Multichannel MIDI range, laid out as 16 channels of 128 notes
+    struct alignas(64) BaseTable
+    {
+        int table[2048];
+    };
+
 protected:
 
     // MIDI Channel and Note combine to set the mapping root
@@ -74,29 +86,48 @@ protected:
     int rootMidiNote;
 
     // MIDI Note to Tuning Table index map
-    std::unique_ptr<Map<int>> map;
+    std::shared_ptr<Map<int>> map;
 
     // Number of steps to offset the output by, 
     // best used when Tuning Reference and Mapping Root aren't the same
     int transpose = 0;
 
-    // Cached map for Multichannel MIDI range
-    int table[2048];
+    // Cached map, shared between maps that only differ by transposition
+    std::shared_ptr<const BaseTable> baseTable;
+
+    // Transposition applied as a rotation of the base table, 0 through 2047
+    int tableOffset = 0;
+
+    // The table was allocated by a map rather than given, such as read in place from a bundle
+    bool tableIsBuilt = false;
 
 private:
 
+    // Writes over the table if it was built by a map and no other map shares it, otherwise allocates
+    // a new one, which is shared with copies and transpositions of the map.
+    // Maps are only built on the message thread, when a mapping is created or loaded;
+    // the audio thread only reads tables that were already built.
     void rebuildTable();
 
+    int rotatedIndex(int midiNoteIndex) const { return (midiNoteIndex + tableOffset) & 2047; }
+
 public:
 
     TuningTableMap(Definition definition);
 
+    // Uses a table that was already built from the definition's map
+    TuningTableMap(Definition definition, std::shared_ptr<const BaseTable> prebuiltTable);
+
     TuningTableMap(const TuningTableMap& mapToCopy);
 
     virtual ~TuningTableMap() {}
 
     void operator=(const TuningTableMap& mapToCopy);
 
+    // Replaces the definition, writing over the pattern and table while no other map shares them,
+    // so rebuilding a map of the same size allocates nothing. Not for maps the audio thread is reading.
+    void rebuild(const Definition& definition);
+
     int getRootMidiChannel() const { return rootMidiChannel; }
     int getRootMidiNote() const { return rootMidiNote; }
     int getRootMidiIndex() const { return midiIndex(rootMidiChannel, rootMidiNote); }
@@ -115,8 +146,16 @@ public:
 
 
     int getTransposition() const;
+
+    // Transposition only rotates the cached table, so these don't rebuild it
     void setTransposition(int transposeIn);
-    std::shared_ptr<TuningTableMap> withTransposition(int transposeIn);
+    std::shared_ptr<TuningTableMap> withTransposition(int transposeIn) const;
+
+    // True if both maps read from the same cached table
+    bool sharesTableWith(const TuningTableMap& otherMap) const { return baseTable == otherMap.baseTable; }
+
+    // Untransposed table, the transposition is applied when reading
+    std::shared_ptr<const BaseTable> getBaseTable() const { return baseTable; }
 
     Definition getDefinition() const;
 
@@ -134,19 +173,10 @@ public:
     /// <returns></returns>
     static TuningTableMap::Definition StandardMappingDefinition()
     {
-        Map<int>::FunctionDefinition mapDefinition =
-        {
-            128,
-            0,
-            [&](int x) { return x % 128; },
-            0,
-            0
-        };
-
         return TuningTableMap::Definition
         {
             TuningTableMap::Root { 1, 69 },
-            Map<int>(mapDefinition)
+            Map<int>::FromGenerator(128, 0, [](int x) { return x % 128; })
         };
     }
 
@@ -159,18 +189,68 @@ public:
     {
         int midiIndex = mod((rootMidiChannel - 1) * 128 + rootMidiNote, 2048);
 
-        auto mapFunction = Map<int>::FunctionDefinition
+        auto mapFunction = [=](int x) { return mod(x - midiIndex + tuningRootIndex, tuningTableSize); };
+
+        return TuningTableMap::Definition
+        {
+            TuningTableMap::Root { rootMidiChannel, rootMidiNote },
+            Map<int>::FromGenerator(2048, 0, mapFunction)
+        };
+    }
+
+    /*
+    Creates a mapping from a Scala keyboard mapping, repeated on every MIDI channel.
+    Keys holds the scale degree for each key of the pattern starting at the middle note, or -1 if unmapped.
+    Each repetition of the pattern is offset by formalOctave degrees, and notes outside of
+    firstNote and lastNote are unmapped. Scale degree 0 outputs tuningRootIndex.
+    */
+    static TuningTableMap::Definition KeyboardMappingDefinition(const std::vector<int>& keys, int firstNote, int lastNote, int middleNote, int formalOctave, int tuningRootIndex)
+    {
+        int patternSize = (int)keys.size();
+
+        auto mapFunction = [=](int note)
         {
-            2048,
-            0,
-            [&](int x) { return mod(x - midiIndex + tuningRootIndex, tuningTableSize); },
-            0
+            if (patternSize == 0 || note < firstNote || note > lastNote)
+                return UnmappedIndex;
+
+            int offset = note - middleNote;
+            int octave = floorDiv(offset, patternSize);
+            int degree = keys[offset - octave * patternSize];
+
+            if (degree < 0)
+                return UnmappedIndex;
+
+            return tuningRootIndex + degree + octave * formalOctave;
         };
 
         return TuningTableMap::Definition
         {
-            TuningTableMap::Root { rootMidiChannel, rootMidiNote },
-            Map<int>(mapFunction)
+            TuningTableMap::Root { 1, middleNote },
+            Map<int>::FromGenerator(128, 0, mapFunction)
+        };
+    }
+
+    /*
+    Creates a mapping where each MIDI channel plays its own 128-note slice of the tuning table,
+    as used by multi-scale files. channelSlices holds the slice for channels 1 through 16,
+    and the channels with a negative slice are unmapped. Notes are not transposed within a slice.
+    */
+    static TuningTableMap::Definition ChannelSlicesDefinition(const std::array<int, 16>& channelSlices, int rootMidiNote)
+    {
+        auto mapFunction = [=](int x)
+        {
+            int slice = channelSlices[x / 128];
+            return (slice < 0) ? UnmappedIndex : slice * 128 + x % 128;
+        };
+
+        int rootChannel = 1;
+        while (rootChannel < 16 && channelSlices[rootChannel - 1] < 0)
+            rootChannel++;
+
+        return TuningTableMap::Definition
+        {
+            TuningTableMap::Root { rootChannel, rootMidiNote },
+            Map<int>::FromGenerator(2048, 0, mapFunction)
         };
     }
 };
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    AdaptiveJustTuner_tests.h
+    Created: 20 Oct 2026 4:48:19am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../AdaptiveJustTuner.h"
+
+class AdaptiveJustTuner_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    juce::Array<AdaptiveJustTuner::Note> chord(std::initializer_list<double> mts)
+    {
+        juce::Array<AdaptiveJustTuner::Note> notes;
+        for (auto pitch : mts)
+            notes.add({ pitch, 0, false });
+        return notes;
+    }
+
+    double tunedInterval(const juce::Array<AdaptiveJustTuner::Note>& notes, int from, int to)
+    {
+        return (notes[to].mts + notes[to].offset) - (notes[from].mts + notes[from].offset);
+    }
+
+    double ratioSemitones(double ratio)
+    {
+        return std::log2(ratio) * 12.0;
+    }
+
+public:
+
+    AdaptiveJustTuner_Test() : EverytoneTunerUnitTest("AdaptiveJustTuner") {};
+
+    void runTest() override
+    {
+        triadTest();
+        shapeCacheTest();
+        heldNotesTest();
+        addedNotesTest();
+        driftTest();
+        budgetTest();
+    }
+
+private:
+
+    void triadTest()
+    {
+        beginTest("Just triads");
+
+        AdaptiveJustTuner tuner;
+
+        auto major = chord({ 60, 64, 67 });
+        expect(tuner.tune(major), "Major triad tuned");
+        expect_equals(ratioSemitones(5.0 / 4.0), tunedInterval(major, 0, 1), "Major third");
+        expect_equals(ratioSemitones(3.0 / 2.0), tunedInterval(major, 0, 2), "Perfect fifth");
+        expect_equals(0.0, major[0].offset + major[1].offset + major[2].offset, "New chord centered on the static tuning");
+
+        // Notes in any order
+        auto minor = chord({ 67, 60, 63 });
+        expect(tuner.tune(minor), "Minor triad tuned");
+        expect_equals(ratioSemitones(6.0 / 5.0), tunedInterval(minor, 1, 2), "Minor third");
+        expect_equals(ratioSemitones(3.0 / 2.0), tunedInterval(minor, 1, 0), "Perfect fifth");
+
+        auto single = chord({ 61 });
+        expect(tuner.tune(single), "Single note tuned");
+        expect_equals(0.0, single[0].offset, "Single note on the static tuning");
+    }
+
+    void shapeCacheTest()
+    {
+        beginTest("Chord shapes are cached");
+
+        AdaptiveJustTuner tuner;
+
+        auto major = chord({ 60, 64, 67 });
+        tuner.tune(major);
+        expect_exact(1, tuner.getNumCachedShapes(), "First shape");
+
+        auto transposed = chord({ 66, 62, 69 });
+        tuner.tune(transposed);
+        expect_exact(1, tuner.getNumCachedShapes(), "Transposed shape");
+        expect_equals(ratioSemitones(5.0 / 4.0), tunedInterval(transposed, 1, 0), "Transposed major third");
+
+        auto minor = chord({ 60, 63, 67 });
+        tuner.tune(minor);
+        expect_exact(2, tuner.getNumCachedShapes(), "Second shape");
+
+        tuner.clearCache();
+        expect_exact(0, tuner.getNumCachedShapes(), "Cleared");
+    }
+
+    void heldNotesTest()
+    {
+        beginTest("Held notes stay in place");
+
+        AdaptiveJustTuner tuner;
+
+        auto notes = chord({ 60, 64, 67 });
+        tuner.tune(notes);
+
+        juce::Array<double> heldOffsets;
+        for (auto& note : notes)
+        {
+            note.isHeld = true;
+            heldOffsets.add(note.offset);
+        }
+
+        notes.add({ 71, 0, false });
+        expect(tuner.tune(notes), "Major seventh added");
+
+        for (int i = 0; i < heldOffsets.size(); i++)
+            expect_equals(heldOffsets[i], notes[i].offset, "Held note " + juce::String(i));
+
+        expect_equals(ratioSemitones(15.0 / 8.0), tunedInterval(notes, 0, 3), "Major seventh");
+
+        // Releasing a note leaves the rest of the chord
+        notes.getReference(3).isHeld = true;
+        notes.remove(1);
+        expect(tuner.tune(notes), "Third released");
+        expect_equals(heldOffsets[0], notes[0].offset, "Root after release");
+        expect_equals(heldOffsets[2], notes[1].offset, "Fifth after release");
+    }
+
+    void addedNotesTest()
+    {
+        beginTest("New notes are tuned against the held chord");
+
+        AdaptiveJustTuner tuner;
+
+        auto notes = chord({ 60, 64, 67 });
+        notes.getReference(0).isHeld = true;
+        notes.getReference(0).offset = 0.2;
+
+        expect(tuner.tune(notes), "Third and fifth added");
+        expect_equals(0.2, notes[0].offset, "Held root in place");
+        expect_equals(ratioSemitones(5.0 / 4.0), tunedInterval(notes, 0, 1), "Major third");
+        expect_equals(ratioSemitones(3.0 / 2.0), tunedInterval(notes, 0, 2), "Perfect fifth");
+        expect_equals(ratioSemitones(6.0 / 5.0), tunedInterval(notes, 1, 2), "Minor third between the new notes");
+        expect_exact(0, tuner.getNumCachedShapes(), "Added notes aren't cached as a shape");
+
+        // Cached shapes are kept in a fixed number of slots
+        for (int i = 1; i < 1000; i++)
+        {
+            auto cluster = chord({ 60, 60 + i * 0.01, 72 });
+            tuner.tune(cluster);
+        }
+        expect(tuner.getNumCachedShapes() <= 512, "Cache is bounded");
+    }
+
+    void driftTest()
+    {
+        beginTest("Drift is limited");
+
+        AdaptiveJustTuner tuner;
+
+        auto notes = chord({ 60, 67 });
+        notes.getReference(0).isHeld = true;
+        notes.getReference(0).offset = 0.49;
+
+        expect(tuner.tune(notes), "Fifth added");
+        expect_equals(ratioSemitones(3.0 / 2.0), tunedInterval(notes, 0, 1), "Perfect fifth");
+        expect(notes[0].offset < 0.1, "Held note recentered");
+        expect_equals(0.0, notes[0].offset + notes[1].offset, "Chord centered on the static tuning");
+    }
+
+    void budgetTest()
+    {
+        beginTest("Time budget");
+
+        AdaptiveJustTuner tuner;
+        tuner.setTimeBudget(0);
+
+        auto cached = chord({ 60, 64, 67, 70 });
+        expect(tuner.tune(cached), "Solved without a budget");
+
+        // Any solve uses up a budget this small
+        tuner.setTimeBudget(1e-9);
+        tuner.startBlock();
+
+        auto first = chord({ 60, 63, 66, 69, 72 });
+        tuner.tune(first);
+
+        auto notes = chord({ 60, 62 });
+        notes.getReference(0).isHeld = true;
+        notes.getReference(0).offset = 0.1;
+
+        expect(!tuner.tune(notes), "Over budget");
+        expect_equals(0.1, notes[0].offset, "Held note unchanged");
+        expect_equals(0.0, notes[1].offset, "New note on the static tuning");
+
+        auto transposed = chord({ 62, 66, 69, 72 });
+        expect(tuner.tune(transposed), "Cached shape tuned over budget");
+        expect_equals(ratioSemitones(5.0 / 4.0), tunedInterval(transposed, 0, 1), "Cached major third");
+
+        tuner.setTimeBudget(0);
+        tuner.startBlock();
+        expect(tuner.tune(notes), "Solved in the next block");
+        expect_equals(0.1, notes[0].offset, "Held note kept");
+        expect_equals(ratioSemitones(9.0 / 8.0), tunedInterval(notes, 0, 1), "Major second");
+    }
+};
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    FormulaProgram_tests.h
+    Created: 21 Oct 2026 12:41:18pm
+    Author:  Vincenzo
+
+    Compares TUN::CFormulaProgram with applying each formula in turn, as
+    CSingleScale::AddFormula does, on randomly generated formula lists.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/TUN_V2/TUN_Scale.h"
+
+class FormulaProgram_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    static constexpr int numPrograms = 300;
+    static constexpr int maxNumFormulas = 200;
+
+    juce::Random random { 7 };
+
+    int randomInt(int min, int max) { return min + random.nextInt(max - min + 1); }
+
+    // References stay inside the scale for the notes a looping formula visits,
+    // unless invalid references are wanted
+    juce::String randomFormula(int noteIndex, bool allowInvalidReferences)
+    {
+        if (randomInt(0, 9) == 0)
+            return "!" + juce::String(randomInt(100, 900));
+
+        juce::String loop;
+        int lowestNote = noteIndex;
+        int highestNote = noteIndex;
+
+        if (randomInt(0, 4) == 0)
+        {
+            auto loopLength = randomInt(-20, 20);
+            loop = "~" + juce::String(loopLength);
+
+            if (loopLength > 1)
+                highestNote = juce::jmin(127, noteIndex + loopLength - 1);
+            else if (loopLength < -1)
+                lowestNote = juce::jmax(0, noteIndex + loopLength + 1);
+        }
+
+        auto relativeReference = [&]()
+        {
+            if (allowInvalidReferences)
+                return ">" + juce::String(randomInt(-140, 140));
+            return ">" + juce::String(randomInt(-lowestNote, 127 - highestNote));
+        };
+
+        juce::String formula;
+
+        switch (randomInt(0, 2))
+        {
+        case 0:
+            formula += "#=" + juce::String(randomInt(0, 127));
+            break;
+        case 1:
+            formula += "#" + relativeReference();
+            break;
+        default:
+            formula += "#" + juce::String(randomInt(10, 2000)) + ".5";
+            break;
+        }
+
+        if (random.nextBool())
+            formula += "*" + juce::String(randomInt(1, 7));
+        if (random.nextBool())
+            formula += "/" + juce::String(randomInt(1, 7));
+        if (random.nextBool())
+            formula += "%" + juce::String(randomInt(-1200, 1200)) + ".25";
+
+        switch (randomInt(0, 5))
+        {
+        case 0:
+            formula += "+=" + juce::String(randomInt(0, 127));
+            break;
+        case 1:
+            formula += "+" + relativeReference();
+            break;
+        case 2:
+            formula += "+" + juce::String(randomInt(0, 20));
+            break;
+        }
+
+        return formula + loop;
+    }
+
+    std::list<TUN::CFormula> randomFormulas(bool allowInvalidReferences)
+    {
+        std::list<TUN::CFormula> formulas;
+
+        auto numFormulas = randomInt(1, maxNumFormulas);
+        for (int i = 0; i < numFormulas; i++)
+        {
+            auto noteIndex = randomInt(0, 127);
+            auto text = randomFormula(noteIndex, allowInvalidReferences);
+
+            TUN::CFormula formula(noteIndex);
+            expect(formula.SetFromStr(text.toStdString()), "Formula parsed: " + text);
+            formulas.push_back(formula);
+        }
+
+        return formulas;
+    }
+
+    // Applies each formula in turn, returns false if a formula read outside of the scale
+    bool interpret(const std::list<TUN::CFormula>& formulas, long baseNote, double baseFrequency, std::vector<double>& frequencies)
+    {
+        TUN::CSingleScale scale;
+        scale.InitEqual(baseNote, baseFrequency);
+
+        try
+        {
+            for (const auto& formula : formulas)
+                scale.AddFormula(formula);
+        }
+        catch (const std::out_of_range&)
+        {
+            return false;
+        }
+
+        frequencies = scale.GetNoteFrequenciesHz();
+        return true;
+    }
+
+    // The program must give exactly the same doubles, not just close ones
+    int firstDifference(const std::vector<double>& expected, const std::vector<double>& actual)
+    {
+        if (expected.size() != actual.size())
+            return 0;
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            if (std::memcmp(&expected[i], &actual[i], sizeof(double)) != 0)
+                return (int)i;
+        }
+
+        return -1;
+    }
+
+public:
+
+    FormulaProgram_Test() : EverytoneTunerUnitTest("FormulaProgram") {};
+
+    void runTest() override
+    {
+        randomProgramTest();
+        invalidReferenceTest();
+    }
+
+private:
+
+    void randomProgramTest()
+    {
+        beginTest("Random programs match the interpreted formulas");
+
+        for (int program = 0; program < numPrograms; program++)
+        {
+            auto formulas = randomFormulas(false);
+            auto baseNote = (long)randomInt(0, 127);
+            auto baseFrequency = (double)randomInt(100, 500);
+            auto programName = "Program " + juce::String(program);
+
+            std::vector<double> expected;
+            expect(interpret(formulas, baseNote, baseFrequency, expected), programName + " interpreted");
+
+            TUN::CFormulaProgram compiled;
+            expect(compiled.Compile(formulas, baseNote), programName + " compiled: " + juce::String(compiled.Err().GetLastError()));
+
+            std::vector<double> frequencies;
+            compiled.Evaluate(baseFrequency, frequencies);
+
+            auto difference = firstDifference(expected, frequencies);
+            expect_exact(-1, difference, programName + " evaluated, first different note");
+
+            // Only the notes depending on the base frequency are updated
+            auto newBaseFrequency = (double)randomInt(100, 500);
+            interpret(formulas, baseNote, newBaseFrequency, expected);
+            compiled.UpdateBaseFreq(newBaseFrequency, frequencies);
+
+            difference = firstDifference(expected, frequencies);
+            expect_exact(-1, difference, programName + " base frequency updated, first different note");
+        }
+    }
+
+    void invalidReferenceTest()
+    {
+        beginTest("Invalid references fail in both");
+
+        int numInvalid = 0;
+
+        for (int program = 0; program < numPrograms; program++)
+        {
+            auto formulas = randomFormulas(true);
+            auto baseNote = (long)randomInt(0, 127);
+            auto programName = "Program " + juce::String(program);
+
+            std::vector<double> expected;
+            bool interpreted = interpret(formulas, baseNote, 440.0, expected);
+
+            TUN::CFormulaProgram compiled;
+            bool isCompiled = compiled.Compile(formulas, baseNote);
+            expect(interpreted == isCompiled, programName + " fails in both or neither");
+
+            if (!interpreted)
+            {
+                numInvalid++;
+                continue;
+            }
+
+            std::vector<double> frequencies;
+            compiled.Evaluate(440.0, frequencies);
+            expect_exact(-1, firstDifference(expected, frequencies), programName + " first different note");
+        }
+
+        expect(numInvalid > 0, "Some programs had invalid references");
+    }
+};
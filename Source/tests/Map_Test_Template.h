@@ -25,6 +25,11 @@ private:
             T e = expected[i - start];
             expect_exact<T>(e, map->at(i), name + " map at " + String(i));
         }
+
+        std::vector<T> filled(size);
+        map->fill(filled.data(), start, size);
+        for (int i = 0; i < size; i++)
+            expect_exact<T>(expected[i], filled[i], name + " fill at " + String(start + i));
     };
 
     String MapDefToString(typename Map<T>::Definition def)
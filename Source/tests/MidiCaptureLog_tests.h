@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+    MidiCaptureLog_tests.h
+    Created: 21 Oct 2026 7:30:05pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/MidiCaptureLog.h"
+#include "../MidiCaptureReplay.h"
+
+class MidiCaptureLog_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Deleted when the test goes out of scope
+    struct TestFile
+    {
+        juce::File file;
+
+        TestFile() : file(juce::File::createTempFile(".etmc")) {}
+
+        ~TestFile() { file.deleteFile(); }
+    };
+
+    MidiCaptureLog::State testState(juce::uint64 tunerHash, int size)
+    {
+        MidiCaptureLog::State state;
+        state.tunerHash = tunerHash;
+        for (int i = 0; i < size; i++)
+        {
+            auto byte = (juce::uint8)(i * 7 + tunerHash);
+            state.data.append(&byte, 1);
+        }
+        return state;
+    }
+
+    MidiCaptureLog::Block testBlock(juce::int64 index, juce::uint64 tunerHash, int numNotes)
+    {
+        MidiCaptureLog::Block block;
+        block.index = index;
+        block.tunerHash = tunerHash;
+        block.sampleRate = 44100;
+        block.blockSize = 512;
+
+        for (int i = 0; i < numNotes; i++)
+        {
+            auto sample = (i * 97) % block.blockSize;
+            block.midi.addEvent(juce::MidiMessage::noteOn(1 + i % 16, 60 + i % 12, (juce::uint8)100), sample);
+            block.midi.addEvent(juce::MidiMessage::pitchWheel(1 + i % 16, 8192 + i * 64), sample);
+        }
+
+        return block;
+    }
+
+    juce::Array<juce::MidiMessage> messagesOf(const juce::MidiBuffer& midi, juce::Array<int>& samples)
+    {
+        juce::Array<juce::MidiMessage> messages;
+        samples.clearQuick();
+        for (auto metadata : midi)
+        {
+            messages.add(metadata.getMessage());
+            samples.add(metadata.samplePosition);
+        }
+        return messages;
+    }
+
+    void expectSameBlock(const MidiCaptureLog::Block& expected, const MidiCaptureLog::Block& actual, juce::String name)
+    {
+        expect(expected.index == actual.index, name + " index");
+        expect(expected.tunerHash == actual.tunerHash, name + " tuner hash");
+        expect_equals(expected.sampleRate, actual.sampleRate, name + " sample rate");
+        expect_exact(expected.blockSize, actual.blockSize, name + " block size");
+
+        juce::Array<int> expectedSamples, actualSamples;
+        auto expectedMessages = messagesOf(expected.midi, expectedSamples);
+        auto actualMessages = messagesOf(actual.midi, actualSamples);
+
+        expect_exact(expectedMessages.size(), actualMessages.size(), name + " number of events");
+        if (expectedMessages.size() != actualMessages.size())
+            return;
+
+        for (int i = 0; i < expectedMessages.size(); i++)
+        {
+            auto& expectedMessage = expectedMessages.getReference(i);
+            auto& actualMessage = actualMessages.getReference(i);
+            expect(expectedMessage.getRawDataSize() == actualMessage.getRawDataSize()
+                   && memcmp(expectedMessage.getRawData(), actualMessage.getRawData(), (size_t)expectedMessage.getRawDataSize()) == 0,
+                   name + " event " + juce::String(i) + " data");
+            expect_exact(expectedSamples[i], actualSamples[i], name + " event " + juce::String(i) + " sample");
+        }
+    }
+
+public:
+
+    MidiCaptureLog_Test() : EverytoneTunerUnitTest("MidiCaptureLog") {};
+
+    void runTest() override
+    {
+        writeAndReadTest();
+        truncatedCaptureTest();
+        captureWriterTest();
+        compareTest();
+    }
+
+private:
+
+    void writeAndReadTest()
+    {
+        beginTest("Captures read back as written");
+
+        MidiCaptureLog::Capture capture;
+        capture.states.add(testState(11, 300));
+        capture.states.add(testState(22, 0));
+
+        capture.blocks.add(testBlock(0, 11, 5));
+        capture.blocks.add(testBlock(1, 11, 0));
+
+        // Gaps are kept, and events larger than a byte of size or far apart in samples
+        auto block = testBlock(5, 22, 40);
+        juce::uint8 sysEx[300] = {};
+        block.midi.addEvent(juce::MidiMessage::createSysExMessage(sysEx, (int)sizeof(sysEx)), 200);
+        block.blockSize = 100000;
+        block.midi.addEvent(juce::MidiMessage::noteOff(3, 64), 99999);
+        block.sampleRate = 96000;
+        capture.blocks.add(block);
+
+        TestFile file;
+        juce::String error;
+        expect(MidiCaptureLog::write(file.file, capture, error), "Written: " + error);
+
+        MidiCaptureLog::Capture read;
+        expect(MidiCaptureLog::read(file.file, read, error), "Read: " + error);
+
+        expect_exact(capture.states.size(), read.states.size(), "Number of states");
+        for (int i = 0; i < juce::jmin(capture.states.size(), read.states.size()); i++)
+        {
+            expect(capture.states[i].tunerHash == read.states[i].tunerHash, "State " + juce::String(i) + " tuner hash");
+            expect(capture.states[i].data == read.states[i].data, "State " + juce::String(i) + " data");
+        }
+
+        expect(read.findState(22) == &read.states.getReference(1), "State found by tuner hash");
+        expect(read.findState(33) == nullptr, "No state for an unknown tuner");
+
+        expect_exact(capture.blocks.size(), read.blocks.size(), "Number of blocks");
+        for (int i = 0; i < juce::jmin(capture.blocks.size(), read.blocks.size()); i++)
+            expectSameBlock(capture.blocks.getReference(i), read.blocks.getReference(i), "Block " + juce::String(i));
+
+        // Other files are rejected
+        file.file.replaceWithText("Not a capture");
+        expect(!MidiCaptureLog::read(file.file, read, error), "Other file rejected");
+    }
+
+    void truncatedCaptureTest()
+    {
+        beginTest("Captures that were cut off keep their complete records");
+
+        MidiCaptureLog::Capture capture;
+        capture.states.add(testState(11, 20));
+        for (int i = 0; i < 4; i++)
+            capture.blocks.add(testBlock(i, 11, 3));
+
+        TestFile file;
+        juce::String error;
+        MidiCaptureLog::write(file.file, capture, error);
+
+        juce::MemoryBlock data;
+        file.file.loadFileAsData(data);
+        data.setSize(data.getSize() - 5);
+        file.file.replaceWithData(data.getData(), data.getSize());
+
+        MidiCaptureLog::Capture read;
+        expect(MidiCaptureLog::read(file.file, read, error), "Read: " + error);
+        expect_exact(3, read.blocks.size(), "Last block dropped");
+        for (int i = 0; i < read.blocks.size(); i++)
+            expectSameBlock(capture.blocks.getReference(i), read.blocks.getReference(i), "Block " + juce::String(i));
+    }
+
+    void captureWriterTest()
+    {
+        beginTest("Capture writer");
+
+        TestFile file;
+        juce::String error;
+
+        MidiCaptureWriter writer(1 << 12);
+        expect(writer.start(file.file, testState(11, 50), error), "Started: " + error);
+
+        juce::Array<MidiCaptureLog::Block> blocks;
+        for (int i = 0; i < 8; i++)
+        {
+            auto block = testBlock(i, i < 4 ? 11 : 22, i);
+            writer.addBlock(block.midi, block.blockSize, block.sampleRate, block.tunerHash);
+            blocks.add(block);
+
+            if (i == 3)
+                writer.addState(testState(22, 10));
+        }
+
+        // Larger than a quarter of the FIFO
+        auto tooLarge = testBlock(8, 22, 200);
+        writer.addBlock(tooLarge.midi, tooLarge.blockSize, tooLarge.sampleRate, tooLarge.tunerHash);
+        expect_exact(1, writer.getNumDroppedBlocks(), "Large block dropped");
+
+        auto last = testBlock(9, 22, 2);
+        writer.addBlock(last.midi, last.blockSize, last.sampleRate, last.tunerHash);
+        blocks.add(last);
+
+        writer.stop();
+        expect(!writer.isActive(), "Stopped");
+
+        MidiCaptureLog::Capture read;
+        expect(MidiCaptureLog::read(file.file, read, error), "Read: " + error);
+
+        expect_exact(2, read.states.size(), "Initial and added state");
+        expect(read.findState(22) != nullptr, "Added state");
+
+        expect_exact(blocks.size(), read.blocks.size(), "Number of blocks");
+        for (int i = 0; i < juce::jmin(blocks.size(), read.blocks.size()); i++)
+            expectSameBlock(blocks.getReference(i), read.blocks.getReference(i), "Block " + juce::String(i));
+
+        // The dropped block shows up as a gap
+        if (read.blocks.size() == blocks.size())
+            expect(read.blocks.getLast().index == 9, "Gap after the dropped block");
+    }
+
+    void compareTest()
+    {
+        beginTest("Compare captures");
+
+        MidiCaptureLog::Capture expected;
+        for (int i = 0; i < 6; i++)
+            expected.blocks.add(testBlock(i, 11, 4));
+
+        auto difference = MidiCaptureReplay::compare(expected, expected);
+        expect(difference.isIdentical(), "Identical: " + difference.toString());
+        expect_exact(6, difference.blocksCompared, "Blocks compared");
+
+        // Changed data
+        auto actual = expected;
+        actual.blocks.getReference(1).midi.clear();
+        actual.blocks.getReference(1).midi.addEvent(juce::MidiMessage::noteOn(2, 61, (juce::uint8)100), 0);
+        difference = MidiCaptureReplay::compare(expected, actual);
+        expect(!difference.isIdentical(), "Changed data found");
+        expect(difference.byteMismatches > 0, "Byte mismatches");
+        expect_exact(0, difference.timingMismatches, "No timing mismatches");
+        expect_exact(0, difference.missingBlocks, "No missing blocks");
+
+        // Same events at other samples
+        actual = expected;
+        juce::MidiBuffer moved;
+        for (auto metadata : expected.blocks.getReference(2).midi)
+            moved.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition + 1);
+        actual.blocks.getReference(2).midi = moved;
+        difference = MidiCaptureReplay::compare(expected, actual);
+        expect_exact(0, difference.byteMismatches, "No byte mismatches when moved");
+        expect_exact(expected.blocks.getReference(2).midi.getNumEvents(), difference.timingMismatches, "Timing mismatches");
+
+        // A different tuner
+        actual = expected;
+        actual.blocks.getReference(3).tunerHash = 12;
+        difference = MidiCaptureReplay::compare(expected, actual);
+        expect_exact(1, difference.tunerMismatches, "Tuner mismatch");
+        expect_exact(0, difference.byteMismatches, "No byte mismatches with another tuner");
+
+        // Missing events and blocks
+        actual = expected;
+        actual.blocks.getReference(0).midi.clear();
+        actual.blocks.remove(4);
+        actual.blocks.add(testBlock(9, 11, 1));
+        difference = MidiCaptureReplay::compare(expected, actual);
+        expect_exact(expected.blocks.getReference(0).midi.getNumEvents(), difference.byteMismatches, "Missing events");
+        expect_exact(2, difference.missingBlocks, "Missing blocks in both");
+        expect_exact(5, difference.blocksCompared, "Matching blocks compared");
+
+        difference = MidiCaptureReplay::compare(expected, actual, 2);
+        expect_exact(2, difference.details.size(), "Details are limited");
+    }
+};
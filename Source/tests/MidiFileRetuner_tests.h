@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+    MidiFileRetuner_tests.h
+    Created: 22 Oct 2026 10:14:52am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/MidiFileRetuner.h"
+
+class MidiFileRetuner_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Smallest step of an MTS triplet, in semitones
+    const double mtsResolution = 1.0 / 16384.0;
+
+    MidiFileRetuner::Settings quarterToneSettings()
+    {
+        MidiFileRetuner::Settings settings;
+        settings.targetTuning = std::make_shared<FunctionalTuning>(CentsDefinition::CentsDivisions(24));
+        settings.targetTuning->setName("Quarter tones");
+        return settings;
+    }
+
+    juce::MidiMessage tempo()
+    {
+        const juce::uint8 data[] = { 0xff, 0x51, 0x03, 0x07, 0xa1, 0x20 };
+        return juce::MidiMessage(data, (int)sizeof(data));
+    }
+
+    juce::MidiMessage endOfTrack()
+    {
+        const juce::uint8 data[] = { 0xff, 0x2f, 0x00 };
+        return juce::MidiMessage(data, (int)sizeof(data));
+    }
+
+    juce::MidiMessage at(const juce::MidiMessage& msg, double time) { return msg.withTimeStamp(time); }
+
+    // The output channel of the last note on of a note, and the pitchbend sent before it on that channel
+    bool findNoteOn(const juce::MidiMessageSequence& track, int outputNote, juce::MidiMessage& noteOn, juce::MidiMessage& pitchbend)
+    {
+        bool found = false;
+        for (int i = 0; i < track.getNumEvents(); i++)
+        {
+            auto& msg = track.getEventPointer(i)->message;
+            if (!msg.isNoteOn() || msg.getNoteNumber() != outputNote)
+                continue;
+
+            noteOn = msg;
+            found = true;
+
+            pitchbend = juce::MidiMessage::pitchWheel(msg.getChannel(), 8192);
+            for (int j = i - 1; j >= 0; j--)
+            {
+                auto& previous = track.getEventPointer(j)->message;
+                if (previous.isPitchWheel() && previous.getChannel() == msg.getChannel())
+                {
+                    pitchbend = previous;
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+
+    int countEvents(const juce::MidiMessageSequence& track, std::function<bool(const juce::MidiMessage&)> predicate)
+    {
+        int count = 0;
+        for (int i = 0; i < track.getNumEvents(); i++)
+            count += predicate(track.getEventPointer(i)->message) ? 1 : 0;
+        return count;
+    }
+
+public:
+
+    MidiFileRetuner_Test() : EverytoneTunerUnitTest("MidiFileRetuner") {};
+
+    void runTest() override
+    {
+        multichannelTest();
+        mtsInputTest();
+        mtsOutputTest();
+        mergeTracksTest();
+    }
+
+private:
+
+    void multichannelTest()
+    {
+        beginTest("Tracks are retuned with pitchbend");
+
+        auto settings = quarterToneSettings();
+        auto reference = MidiFileRetuner::createTunerController(settings);
+
+        juce::MidiFile file;
+        juce::MidiMessageSequence track;
+        track.addEvent(at(tempo(), 0));
+        track.addEvent(at(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100), 0));
+        track.addEvent(at(juce::MidiMessage::noteOn(1, 61, (juce::uint8)100), 0));
+        track.addEvent(at(juce::MidiMessage::noteOff(1, 60), 480));
+        track.addEvent(at(juce::MidiMessage::noteOff(1, 61), 480));
+        track.addEvent(at(juce::MidiMessage::noteOn(1, 67, (juce::uint8)100), 960));
+        track.addEvent(at(juce::MidiMessage::noteOff(1, 67), 1440));
+        file.addTrack(track);
+
+        auto retuned = MidiFileRetuner::retuneTrack(*file.getTrack(0), settings);
+
+        expect_exact(1, countEvents(retuned, [](const juce::MidiMessage& msg) { return msg.isTempoMetaEvent(); }), "Tempo passed through");
+        expect_exact(3, countEvents(retuned, [](const juce::MidiMessage& msg) { return msg.isNoteOn(); }), "Every note on");
+        expect_exact(3, countEvents(retuned, [](const juce::MidiMessage& msg) { return msg.isNoteOff(); }), "Every note off");
+
+        juce::Array<int> chordChannels;
+        for (auto note : { 60, 61, 67 })
+        {
+            auto name = "Note " + juce::String(note);
+            auto expected = reference->getTuner()->getMidiPitch(1, note);
+
+            juce::MidiMessage noteOn, pitchbend;
+            expect(findNoteOn(retuned, expected.coarse, noteOn, pitchbend), name + " on");
+            expect_exact(expected.pitchbend, pitchbend.getPitchWheelValue(), name + " pitchbend");
+            expect_equals(note == 67 ? 960.0 : 0.0, noteOn.getTimeStamp(), name + " time");
+
+            if (note != 67)
+                chordChannels.add(noteOn.getChannel());
+        }
+
+        expect(chordChannels[0] != chordChannels[1], "Chord notes on separate channels");
+
+        // Note offs keep their time, on the channel of their note on
+        for (int i = 0; i < retuned.getNumEvents(); i++)
+        {
+            auto& msg = retuned.getEventPointer(i)->message;
+            if (msg.isNoteOff() && msg.getTimeStamp() == 480)
+                expect(chordChannels.contains(msg.getChannel()), "Chord note off on a chord channel");
+        }
+    }
+
+    void mtsInputTest()
+    {
+        beginTest("MTS in a track retunes the notes after it");
+
+        auto settings = quarterToneSettings();
+
+        std::array<double, 128> mts;
+        for (int note = 0; note < 128; note++)
+            mts[note] = note + 0.25;
+
+        juce::MidiMessageSequence track;
+        track.addEvent(at(MidiFileRetuner::createBulkTuningDump(mts, 0, "Quarter sharp"), 0));
+        track.addEvent(at(juce::MidiMessage::noteOn(1, 62, (juce::uint8)100), 10));
+        track.addEvent(at(juce::MidiMessage::noteOff(1, 62), 20));
+
+        auto retuned = MidiFileRetuner::retuneTrack(track, settings);
+        expect_exact(0, countEvents(retuned, [](const juce::MidiMessage& msg) { return msg.isSysEx(); }), "Received MTS is not passed through");
+
+        // As the tuner from the received tuning would tune it
+        MtsSysExReceiver::NoteTable table;
+        expect(MtsSysExReceiver::applySysEx(track.getEventPointer(0)->message.getSysExData(), track.getEventPointer(0)->message.getSysExDataSize(), table), "Dump read");
+        expect(std::abs(table.mts[62] - 62.25) < mtsResolution, "Dump pitch");
+
+        auto reference = MidiFileRetuner::createTunerController(settings);
+        reference->setMappingMode(Everytone::MappingMode::Manual);
+        reference->setTargetTuning(MtsSysExReceiver::createTuning(table), std::make_shared<TuningTableMap>(TuningTableMap::StandardMappingDefinition()), MappedTuningTable::FrequencyReference());
+        auto expected = reference->getTuner()->getMidiPitch(1, 62);
+
+        juce::MidiMessage noteOn, pitchbend;
+        expect(findNoteOn(retuned, expected.coarse, noteOn, pitchbend), "Note on");
+        expect_exact(expected.pitchbend, pitchbend.getPitchWheelValue(), "Pitchbend of the received tuning");
+        expect_equals(10.0, noteOn.getTimeStamp(), "Note on time");
+    }
+
+    void mtsOutputTest()
+    {
+        beginTest("MTS output dumps the target tuning");
+
+        auto settings = quarterToneSettings();
+        settings.format = MidiFileRetuner::OutputFormat::Mts;
+
+        auto tunerController = MidiFileRetuner::createTunerController(settings);
+        auto tuning = tunerController->readTuningTarget();
+        auto messages = MidiFileRetuner::createMtsMessages(*tuning);
+
+        int numDumps = 0;
+        juce::Array<MtsSysExReceiver::NoteTable> programs;
+        for (auto& msg : messages)
+        {
+            if (!msg.isSysEx())
+                continue;
+
+            numDumps++;
+            MtsSysExReceiver::NoteTable table;
+            expect(MtsSysExReceiver::applySysEx(msg.getSysExData(), msg.getSysExDataSize(), table), "Dump " + juce::String(numDumps) + " read");
+            expect_exact(juce::String("Quarter tones"), juce::String(table.name.data()).trim(), "Dump name");
+            programs.add(table);
+        }
+
+        expect(numDumps > 0, "Dumps sent");
+
+        // Channels select their program with RPN 3, when there is more than one
+        std::array<int, 16> programOfChannel;
+        programOfChannel.fill(0);
+        for (int i = 0; i + 2 < messages.size(); i++)
+        {
+            auto& msg = messages.getReference(i);
+            if (msg.isControllerOfType(101) && msg.getControllerValue() == 0
+                && messages[i + 1].isControllerOfType(100) && messages[i + 1].getControllerValue() == 3)
+                programOfChannel[msg.getChannel() - 1] = messages[i + 2].getControllerValue();
+        }
+
+        expect_exact(numDumps > 1 ? 16 * 5 : 0, messages.size() - numDumps, "Program changes only with several tables");
+
+        for (int ch = 1; ch <= 16; ch++)
+        {
+            auto program = programOfChannel[ch - 1];
+            expect(program < programs.size(), "Channel " + juce::String(ch) + " program sent");
+            if (program >= programs.size())
+                continue;
+
+            for (int note = 0; note < 128; note += 5)
+            {
+                auto expected = tuning->mtsAt(note, ch);
+                if (expected < 0)
+                    continue;
+
+                auto actual = programs.getReference(program).mts[note];
+                expect(std::abs(juce::jlimit(0.0, 127.0 + 16382.0 / 16384.0, expected) - actual) < mtsResolution,
+                       "Channel " + juce::String(ch) + " note " + juce::String(note) + " pitch");
+            }
+        }
+    }
+
+    void mergeTracksTest()
+    {
+        beginTest("Merged tracks");
+
+        juce::MidiFile file;
+        for (int i = 0; i < 3; i++)
+        {
+            juce::MidiMessageSequence track;
+            track.addEvent(at(juce::MidiMessage::noteOn(1 + i, 60 + i, (juce::uint8)100), i * 100));
+            track.addEvent(at(juce::MidiMessage::noteOff(1 + i, 60 + i), i * 100 + 50));
+            track.addEvent(at(endOfTrack(), i * 100 + 60));
+            file.addTrack(track);
+        }
+
+        auto merged = MidiFileRetuner::mergeTracks(file);
+        expect_exact(6, merged.getNumEvents(), "Events of every track");
+        expect_exact(0, countEvents(merged, [](const juce::MidiMessage& msg) { return msg.isEndOfTrackMetaEvent(); }), "No end of track events");
+
+        for (int i = 1; i < merged.getNumEvents(); i++)
+            expect(merged.getEventPointer(i - 1)->message.getTimeStamp() <= merged.getEventPointer(i)->message.getTimeStamp(), "Event " + juce::String(i) + " in order");
+    }
+};
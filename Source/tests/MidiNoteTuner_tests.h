@@ -67,6 +67,7 @@ public:
         defaultTuningTest();
         ode22Test();
         ode31Test();
+        pitchbendRescaleTest();
     }
 
 private:
@@ -202,4 +203,29 @@ public:
         doTesting("std -> 31edo", params);
     }
 
-};
\ No newline at end of file
+    void pitchbendRescaleTest()
+    {
+        beginTest("Pitchbend rescaling");
+
+        // Same range, and center
+        expect_exact(1000, MidiNoteTuner::rescalePitchbendOffset(9192, 96, 96), "Same range");
+        expect_exact(0, MidiNoteTuner::rescalePitchbendOffset(8192, 96, 4), "Center");
+
+        // MPE +/-48 to +/-2 semitones: one and a half semitones up and down
+        expect_exact(6144, MidiNoteTuner::rescalePitchbendOffset(8192 + 256, 96, 4), "1.5 semitones up");
+        expect_exact(-6144, MidiNoteTuner::rescalePitchbendOffset(8192 - 256, 96, 4), "1.5 semitones down");
+
+        // Rounds half away from zero
+        expect_exact(1, MidiNoteTuner::rescalePitchbendOffset(8193, 1, 2), "Half step up");
+        expect_exact(-1, MidiNoteTuner::rescalePitchbendOffset(8191, 1, 2), "Half step down");
+
+        // Full range into a larger range
+        expect_exact(-2048, MidiNoteTuner::rescalePitchbendOffset(0, 4, 16), "Full down into larger range");
+        expect_exact(2048, MidiNoteTuner::rescalePitchbendOffset(16384, 4, 16), "Full up into larger range");
+
+        expect_exact(16383, MidiNoteTuner::addPitchbendOffset(16000, 1000), "Clipped up");
+        expect_exact(0, MidiNoteTuner::addPitchbendOffset(500, -1000), "Clipped down");
+        expect_exact(9000, MidiNoteTuner::addPitchbendOffset(8192, 808), "Added");
+    }
+
+};
@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+    MidiOutputScheduler_tests.h
+    Created: 20 Oct 2026 8:04:37am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../MidiOutputScheduler.h"
+
+class MidiOutputScheduler_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+
+    // Runs blocks until the scheduler has sent everything, returning the messages in the order sent
+    juce::Array<MidiOutputScheduler::ScheduledEvent> runBlocks(MidiOutputScheduler& scheduler, juce::MidiBuffer firstBlock, int maxBlocks = 100)
+    {
+        juce::Array<MidiOutputScheduler::ScheduledEvent> sent;
+        for (int block = 0; block < maxBlocks; block++)
+        {
+            juce::MidiBuffer buffer;
+            if (block == 0)
+                buffer.swapWith(firstBlock);
+
+            scheduler.schedule(buffer, blockSize);
+            sent.addArray(scheduler.getLastBlock());
+
+            if (scheduler.getNumQueued() == 0 && block > 0)
+                break;
+        }
+        return sent;
+    }
+
+    // As sent by MidiVoiceController for a new voice on each channel
+    juce::MidiBuffer chord(int numNotes)
+    {
+        juce::MidiBuffer buffer;
+        int sample = 0;
+        for (int i = 0; i < numNotes; i++)
+        {
+            buffer.addEvent(juce::MidiMessage::pitchWheel(i + 2, 8000 + i), sample++);
+            buffer.addEvent(juce::MidiMessage::noteOn(i + 2, 60 + i, (juce::uint8)100), sample++);
+        }
+        return buffer;
+    }
+
+public:
+
+    MidiOutputScheduler_Test() : EverytoneTunerUnitTest("MidiOutputScheduler") {};
+
+    void runTest() override
+    {
+        unlimitedTest();
+        bandwidthTest();
+        priorityTest();
+        channelOrderTest();
+        refreshTest();
+        overflowTest();
+    }
+
+private:
+
+    void unlimitedTest()
+    {
+        beginTest("Unlimited link");
+
+        MidiOutputScheduler scheduler;
+        scheduler.reset(sampleRate);
+
+        auto buffer = chord(10);
+        scheduler.schedule(buffer, blockSize);
+
+        expect_exact(20, buffer.getNumEvents(), "All messages sent");
+        expect_exact(0, scheduler.getNumQueued(), "Nothing queued");
+        expect_equals(0.0, scheduler.getMaxDelayMs(), "No delay");
+
+        int sample = 0;
+        for (auto metadata : buffer)
+        {
+            expect_exact(sample, metadata.samplePosition, "Message " + juce::String(sample) + " at its own sample");
+            sample++;
+        }
+
+        // Messages left from a limited link are sent first when it becomes unlimited
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        auto limited = chord(10);
+        scheduler.schedule(limited, blockSize);
+        expect(scheduler.getNumQueued() > 0, "Messages left on the limited link");
+
+        scheduler.setBaudRate(0);
+        auto next = chord(1);
+        scheduler.schedule(next, blockSize);
+        expect_exact(20 - limited.getNumEvents() + 2, next.getNumEvents(), "Messages left sent with the block");
+        expect_exact(0, scheduler.getNumQueued(), "Nothing queued after");
+        expect(next.getNumEvents() == scheduler.getLastBlock().size(), "Messages left reported");
+    }
+
+    void bandwidthTest()
+    {
+        beginTest("DIN bandwidth");
+
+        MidiOutputScheduler scheduler;
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        scheduler.reset(sampleRate);
+
+        auto sent = runBlocks(scheduler, chord(10));
+        expect_exact(20, sent.size(), "All messages sent");
+
+        // Three bytes of ten bits at 31250 baud
+        auto messageSamples = 30.0 * sampleRate / MidiOutputScheduler::dinBaudRate;
+        for (int i = 1; i < sent.size(); i++)
+        {
+            auto gap = (double)(sent[i].sent - sent[i - 1].sent);
+            expect(gap >= messageSamples - 1.0, "Message " + juce::String(i) + " waits for the link");
+        }
+
+        auto lastDelayMs = sent.getLast().delayMs;
+        expect(lastDelayMs > 17.0 && lastDelayMs < 20.0, "Last note of the chord delayed by the link, was " + juce::String(lastDelayMs) + " ms");
+
+        for (int i = 0; i < sent.size(); i += 2)
+        {
+            expect(sent[i].message.isPitchWheel(), "Pitchbend first");
+            expect(sent[i + 1].message.isNoteOn(), "Then its note on");
+            expect_exact(sent[i].message.getChannel(), sent[i + 1].message.getChannel(), "On the same channel");
+        }
+    }
+
+    void priorityTest()
+    {
+        beginTest("Note ons, then note offs, then controllers");
+
+        MidiOutputScheduler scheduler;
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        scheduler.reset(sampleRate);
+
+        juce::MidiBuffer buffer;
+        int sample = 0;
+        buffer.addEvent(juce::MidiMessage::controllerEvent(5, 1, 64), sample++);
+        buffer.addEvent(juce::MidiMessage::noteOff(4, 62), sample++);
+        buffer.addEvent(juce::MidiMessage::pitchWheel(3, 9000), sample++);
+        buffer.addEvent(juce::MidiMessage::noteOn(3, 61, (juce::uint8)100), sample++);
+
+        // The link is busy with the first message until the rest are due
+        auto sent = runBlocks(scheduler, buffer);
+        expect_exact(4, sent.size(), "All messages sent");
+
+        expect(sent[0].message.isController(), "First message was free to go");
+        expect(sent[1].message.isPitchWheel(), "Pitchbend of the note on");
+        expect(sent[2].message.isNoteOn(), "Note on");
+        expect(sent[3].message.isNoteOff(), "Note off");
+
+        for (auto& event : sent)
+            expect(event.delayMs >= 0, "Delay is never negative");
+    }
+
+    void channelOrderTest()
+    {
+        beginTest("Messages of a channel stay in order");
+
+        MidiOutputScheduler scheduler;
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        scheduler.reset(sampleRate);
+
+        juce::MidiBuffer buffer;
+        int sample = 0;
+        buffer.addEvent(juce::MidiMessage::controllerEvent(2, 1, 10), sample++);
+        buffer.addEvent(juce::MidiMessage::noteOff(2, 60), sample++);
+        buffer.addEvent(juce::MidiMessage::pitchWheel(2, 7000), sample++);
+        buffer.addEvent(juce::MidiMessage::noteOn(2, 60, (juce::uint8)100), sample++);
+
+        auto sent = runBlocks(scheduler, buffer);
+        expect_exact(4, sent.size(), "All messages sent");
+        expect(sent[0].message.isController(), "Controller");
+        expect(sent[1].message.isNoteOff(), "Note off of the previous voice");
+        expect(sent[2].message.isPitchWheel(), "Pitchbend of the new voice");
+        expect(sent[3].message.isNoteOn(), "Note on of the new voice");
+    }
+
+    void refreshTest()
+    {
+        beginTest("Refreshes use the time left");
+
+        MidiOutputScheduler scheduler;
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        scheduler.reset(sampleRate);
+
+        for (int ch = 1; ch <= 16; ch++)
+            scheduler.addRefresh(juce::MidiMessage::pitchWheel(ch, 8192 + ch));
+
+        // Replaced by a newer pitchbend
+        juce::MidiBuffer buffer;
+        buffer.addEvent(juce::MidiMessage::pitchWheel(1, 100), 0);
+
+        scheduler.schedule(buffer, blockSize);
+
+        // A 256 sample block fits less than nine messages
+        expect(buffer.getNumEvents() > 1 && buffer.getNumEvents() < 16, "Some refreshes deferred");
+
+        int numRefreshes = 0;
+        for (auto metadata : buffer)
+        {
+            auto msg = metadata.getMessage();
+            if (msg.getChannel() == 1)
+                expect_exact(100, msg.getPitchWheelValue(), "Newer pitchbend sent instead of refresh");
+            else
+                numRefreshes++;
+        }
+
+        for (int block = 0; block < 10; block++)
+        {
+            juce::MidiBuffer empty;
+            scheduler.schedule(empty, blockSize);
+            numRefreshes += empty.getNumEvents();
+        }
+
+        expect_exact(15, numRefreshes, "Every other channel refreshed once");
+    }
+
+    void overflowTest()
+    {
+        beginTest("Full queues send their oldest message");
+
+        MidiOutputScheduler scheduler;
+        scheduler.setBaudRate(MidiOutputScheduler::dinBaudRate);
+        scheduler.reset(sampleRate);
+
+        // Far more than a block of the link carries, all on one channel
+        const int numNotes = MidiOutputScheduler::queueCapacity;
+        juce::MidiBuffer buffer;
+        for (int i = 0; i < numNotes; i++)
+        {
+            buffer.addEvent(juce::MidiMessage::noteOn(1, i, (juce::uint8)100), i);
+            buffer.addEvent(juce::MidiMessage::noteOff(1, i), i);
+        }
+
+        auto sent = runBlocks(scheduler, buffer, 1000);
+        expect(scheduler.getNumOverflowed() > 0, "Queue overflowed");
+        expect(scheduler.getNumQueued() <= MidiOutputScheduler::queueCapacity, "Queue within its capacity");
+        expect_exact(numNotes * 2, sent.size(), "Every message sent");
+
+        for (int i = 0; i < juce::jmin(sent.size(), numNotes * 2); i++)
+        {
+            auto& msg = sent.getReference(i).message;
+            expect_exact(i / 2, msg.getNoteNumber(), "Message " + juce::String(i) + " in order");
+            expect((i % 2 == 0) ? msg.isNoteOn() : msg.isNoteOff(), "Message " + juce::String(i) + " type");
+        }
+
+        scheduler.reset(sampleRate);
+        expect_exact(0, scheduler.getNumOverflowed(), "Reset");
+    }
+};
@@ -0,0 +1,322 @@
+/*
+  ==============================================================================
+
+    MidiVoiceController_tests.h
+    Created: 21 Oct 2026 4:48:30pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../MidiVoiceController.h"
+
+class MidiVoiceController_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    std::unique_ptr<TunerController> tunerController;
+    std::unique_ptr<MidiVoiceController> voiceController;
+
+    void setupController(Everytone::ChannelMode channelMode = Everytone::ChannelMode::FirstAvailable)
+    {
+        tunerController = std::make_unique<TunerController>();
+        voiceController = std::make_unique<MidiVoiceController>(*tunerController, channelMode, Everytone::MpeZone::Lower);
+    }
+
+    juce::Array<juce::MidiMessage> tune(const juce::MidiMessage& msg)
+    {
+        juce::MidiBuffer output;
+        int sample = 0;
+        voiceController->tuneMessage(msg, output, sample);
+
+        juce::Array<juce::MidiMessage> messages;
+        for (auto metadata : output)
+            messages.add(metadata.getMessage());
+        return messages;
+    }
+
+    void tuneChord(int midiChannel, juce::Array<int> notes)
+    {
+        juce::Array<juce::MidiMessage> noteOns;
+        for (auto note : notes)
+            noteOns.add(juce::MidiMessage::noteOn(midiChannel, note, (juce::uint8)100));
+
+        juce::MidiBuffer output;
+        int sample = 0;
+        voiceController->tuneChord(noteOns, output, sample);
+    }
+
+    int numChannelsOf(int midiChannel, juce::Array<int> notes)
+    {
+        juce::Array<int> channels;
+        for (auto note : notes)
+            channels.addIfNotAlreadyThere(voiceController->channelOfVoice(midiChannel, note));
+        return channels.size();
+    }
+
+    // Input pitchbend for a number of semitones, with the default input range of +/-48 semitones
+    int inputPitchbend(double semitones)
+    {
+        return juce::roundToInt(8192 + semitones / 48.0 * 8192);
+    }
+
+    double outputSemitones(const juce::MidiMessage& pitchbend)
+    {
+        return (pitchbend.getPitchWheelValue() - 8192) / 8192.0 * tunerController->getPitchbendRange() * 0.5;
+    }
+
+public:
+
+    MidiVoiceController_Test() : EverytoneTunerUnitTest("MidiVoiceController") {};
+
+    void runTest() override
+    {
+        pitchbendRoutingTest();
+        pressureAndTimbreRoutingTest();
+        expressionBeforeNoteOnTest();
+        chordSharingTest();
+        bendConflictTest();
+        channelOrderTest();
+    }
+
+private:
+
+    void pitchbendRoutingTest()
+    {
+        beginTest("Pitchbend follows the voices of its input channel");
+
+        setupController();
+        tune(juce::MidiMessage::noteOn(2, 60, (juce::uint8)100));
+        tune(juce::MidiMessage::noteOn(3, 64, (juce::uint8)100));
+
+        auto channel2 = voiceController->channelOfVoice(2, 60);
+        auto channel3 = voiceController->channelOfVoice(3, 64);
+        expect(channel2 > 0 && channel3 > 0 && channel2 != channel3, "Voices on separate channels");
+
+        auto output = tune(juce::MidiMessage::pitchWheel(3, inputPitchbend(1.0)));
+        expect_exact(1, output.size(), "One pitchbend sent");
+        expect(output[0].isPitchWheel(), "Pitchbend sent");
+        expect_exact(channel3, output[0].getChannel(), "Sent on the voice's output channel");
+        expect(std::abs(outputSemitones(output[0]) - 1.0) < 0.01, "Input bend rescaled to the output range");
+
+        expect_exact(8192, voiceController->getVoice(2, 60)->getPitchbend().getPitchWheelValue(), "Voice of another channel unchanged");
+
+        // Input bend is added to the tuning pitchbend
+        tune(juce::MidiMessage::pitchWheel(3, 8192));
+        tunerController->setTargetTuning(std::make_shared<FunctionalTuning>(CentsDefinition::CentsDivisions(24)));
+        juce::MidiBuffer retuned;
+        int sample = 0;
+        voiceController->retuneActiveVoices(retuned, sample);
+        expect_exact(sample, retuned.getNumEvents(), "A pitchbend for each retuned voice");
+        for (auto metadata : retuned)
+            expect(metadata.getMessage().isPitchWheel(), "Retuned voices send pitchbend");
+
+        auto tuningSemitones = outputSemitones(voiceController->getVoice(3, 64)->getPitchbend());
+
+        output = tune(juce::MidiMessage::pitchWheel(3, inputPitchbend(-0.5)));
+        expect_exact(1, output.size(), "One pitchbend sent with a tuning pitchbend");
+        expect(std::abs(outputSemitones(output[0]) - (tuningSemitones - 0.5)) < 0.01, "Input bend added to the tuning pitchbend");
+
+        // Every voice of a non-MPE input channel bends, each on its own output channel
+        setupController();
+        tune(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100));
+        tune(juce::MidiMessage::noteOn(1, 67, (juce::uint8)100));
+
+        output = tune(juce::MidiMessage::pitchWheel(1, inputPitchbend(2.0)));
+        expect_exact(2, output.size(), "A pitchbend for each voice");
+        expect(output[0].getChannel() != output[1].getChannel(), "Pitchbends on both output channels");
+
+        // Stopped voices no longer receive expression
+        tune(juce::MidiMessage::noteOff(1, 60));
+        tune(juce::MidiMessage::noteOff(1, 67));
+        expect(tune(juce::MidiMessage::pitchWheel(1, 8192)).isEmpty(), "No voices to bend");
+    }
+
+    void pressureAndTimbreRoutingTest()
+    {
+        beginTest("Pressure and timbre follow the voices of their input channel");
+
+        setupController();
+        tune(juce::MidiMessage::noteOn(2, 60, (juce::uint8)100));
+        tune(juce::MidiMessage::noteOn(3, 64, (juce::uint8)100));
+
+        auto channel2 = voiceController->channelOfVoice(2, 60);
+        auto channel3 = voiceController->channelOfVoice(3, 64);
+
+        auto output = tune(juce::MidiMessage::channelPressureChange(2, 90));
+        expect_exact(1, output.size(), "One pressure message");
+        expect(output[0].isChannelPressure(), "Pressure sent");
+        expect_exact(channel2, output[0].getChannel(), "Pressure on the voice's output channel");
+        expect_exact(90, output[0].getChannelPressureValue(), "Pressure value");
+
+        output = tune(juce::MidiMessage::controllerEvent(3, MULTIMAPPER_MPE_TIMBRE_CC, 20));
+        expect_exact(1, output.size(), "One timbre message");
+        expect(output[0].isControllerOfType(MULTIMAPPER_MPE_TIMBRE_CC), "Timbre sent");
+        expect_exact(channel3, output[0].getChannel(), "Timbre on the voice's output channel");
+        expect_exact(20, output[0].getControllerValue(), "Timbre value");
+
+        // Other controllers are not expression, and keep their channel
+        output = tune(juce::MidiMessage::controllerEvent(3, 1, 50));
+        expect_exact(1, output.size(), "Other controller passed through");
+        expect_exact(3, output[0].getChannel(), "Other controller keeps its channel");
+
+        // Expression for a channel without voices is kept for the next voice
+        expect(tune(juce::MidiMessage::channelPressureChange(5, 30)).isEmpty(), "Pressure without voices not sent");
+    }
+
+    void expressionBeforeNoteOnTest()
+    {
+        beginTest("Expression received before a note on");
+
+        setupController();
+        tune(juce::MidiMessage::controllerEvent(4, MULTIMAPPER_MPE_TIMBRE_CC, 100));
+        tune(juce::MidiMessage::channelPressureChange(4, 40));
+        tune(juce::MidiMessage::pitchWheel(4, inputPitchbend(0.25)));
+
+        auto output = tune(juce::MidiMessage::noteOn(4, 62, (juce::uint8)100));
+        expect_exact(4, output.size(), "Pitchbend, timbre, pressure and note on");
+
+        auto channel = voiceController->channelOfVoice(4, 62);
+        for (auto msg : output)
+            expect_exact(channel, msg.getChannel(), "All on the voice's output channel");
+
+        expect(output[0].isPitchWheel(), "Pitchbend first");
+        expect(std::abs(outputSemitones(output[0]) - 0.25) < 0.01, "Initial bend");
+        expect(output[1].isControllerOfType(MULTIMAPPER_MPE_TIMBRE_CC), "Then timbre");
+        expect_exact(100, output[1].getControllerValue(), "Initial timbre");
+        expect(output[2].isChannelPressure(), "Then pressure");
+        expect_exact(40, output[2].getChannelPressureValue(), "Initial pressure");
+        expect(output[3].isNoteOn(), "Note on last");
+    }
+
+    void chordSharingTest()
+    {
+        beginTest("Chords share channels in Poly mode");
+
+        juce::Array<int> chord = { 60, 64, 67 };
+
+        setupController();
+        tuneChord(1, chord);
+        expect_exact(3, voiceController->numVoices(), "Every note started");
+        expect_exact(3, numChannelsOf(1, chord), "Separate channels in Mono mode");
+
+        setupController();
+        voiceController->setMidiMode(Everytone::MidiMode::Poly);
+        tuneChord(1, chord);
+        expect_exact(3, voiceController->numVoices(), "Every note started in Poly mode");
+        expect_exact(1, numChannelsOf(1, chord), "One channel in Poly mode");
+
+        // Notes played later join the channel too
+        tune(juce::MidiMessage::noteOn(1, 72, (juce::uint8)100));
+        expect_exact(voiceController->channelOfVoice(1, 60), voiceController->channelOfVoice(1, 72), "Later note joins the chord");
+
+        // Voices of another input channel have their own input bend
+        tuneChord(2, { 62, 65 });
+        expect(voiceController->channelOfVoice(2, 62) != voiceController->channelOfVoice(1, 60), "Other input channel not shared");
+        expect_exact(1, numChannelsOf(2, { 62, 65 }), "Other input channel shares its own channel");
+    }
+
+    void bendConflictTest()
+    {
+        beginTest("Notes only share channels with the same pitchbend");
+
+        juce::Array<int> chord = { 60, 61, 62, 63 };
+
+        setupController();
+        voiceController->setMidiMode(Everytone::MidiMode::Poly);
+        tunerController->setTargetTuning(std::make_shared<FunctionalTuning>(CentsDefinition::CentsDivisions(24)));
+        tuneChord(1, chord);
+
+        // Voices that can't share are on separate channels
+        for (auto note : chord)
+        {
+            auto voice = voiceController->getVoice(1, note);
+            expect(voice != nullptr, "Note " + juce::String(note) + " started");
+            if (voice == nullptr)
+                return;
+
+            for (auto otherNote : chord)
+            {
+                auto other = voiceController->getVoice(1, otherNote);
+                if (other == nullptr || other == voice || voice->getAssignedChannel() != other->getAssignedChannel())
+                    continue;
+
+                auto name = "Notes " + juce::String(note) + " and " + juce::String(otherNote);
+                expect_exact(voice->getPitchbend().getPitchWheelValue(), other->getPitchbend().getPitchWheelValue(), name + " share with the same pitchbend");
+                expect(voice->getOutputNote() != other->getOutputNote(), name + " share with other output notes");
+            }
+        }
+
+        // Held voices keep their pitchbend in Static mode, so notes of a new tuning only join them with the same one
+        tunerController->setTargetTuning(std::make_shared<FunctionalTuning>(CentsDefinition::CentsDivisions(12)));
+        tune(juce::MidiMessage::noteOn(1, 72, (juce::uint8)100));
+        auto added = voiceController->getVoice(1, 72);
+        expect(added != nullptr, "Note of the new tuning started");
+        for (auto note : chord)
+        {
+            auto held = voiceController->getVoice(1, note);
+            if (added != nullptr && held != nullptr && held->getAssignedChannel() == added->getAssignedChannel())
+                expect_exact(held->getPitchbend().getPitchWheelValue(), added->getPitchbend().getPitchWheelValue(), "Joined note " + juce::String(note) + " with the same pitchbend");
+        }
+
+        // Held voices that can be retuned don't share, even with the same pitchbend
+        juce::Array<int> major = { 60, 64, 67 };
+        for (auto mode : { Everytone::BendMode::Dynamic, Everytone::BendMode::Adaptive })
+        {
+            setupController();
+            voiceController->setMidiMode(Everytone::MidiMode::Poly);
+            voiceController->setBendMode(mode);
+            tuneChord(1, major);
+            expect_exact(3, numChannelsOf(1, major), "Not shared in bend mode " + juce::String((int)mode));
+        }
+
+        setupController();
+        voiceController->setMidiMode(Everytone::MidiMode::Poly);
+        voiceController->setBendMode(Everytone::BendMode::Persistent);
+        tuneChord(1, major);
+        expect_exact(1, numChannelsOf(1, major), "Shared in Persistent mode");
+
+        setupController();
+        voiceController->setMidiMode(Everytone::MidiMode::Poly);
+        voiceController->setMtsRetuning(true);
+        tuneChord(1, major);
+        expect_exact(3, numChannelsOf(1, major), "Not shared with MTS retuning");
+    }
+
+    void channelOrderTest()
+    {
+        beginTest("Single notes keep the order of the channel mode");
+
+        // Round robin continues past a released channel
+        setupController(Everytone::ChannelMode::RoundRobin);
+        tune(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100));
+        auto first = voiceController->channelOfVoice(1, 60);
+        tune(juce::MidiMessage::noteOn(1, 61, (juce::uint8)100));
+        tune(juce::MidiMessage::noteOn(1, 62, (juce::uint8)100));
+        expect_exact(first + 1, voiceController->channelOfVoice(1, 61), "Second note on the next channel");
+        expect_exact(first + 2, voiceController->channelOfVoice(1, 62), "Third note on the next channel");
+
+        tune(juce::MidiMessage::noteOff(1, 61));
+        tune(juce::MidiMessage::noteOn(1, 63, (juce::uint8)100));
+        expect_exact(first + 3, voiceController->channelOfVoice(1, 63), "Released channel skipped");
+
+        voiceController->addVoice(1, 64, 100);
+        expect_exact(first + 4, voiceController->channelOfVoice(1, 64), "Added voice on the next channel");
+
+        // First available takes the first free channel, not the one last used by the note
+        setupController();
+        tune(juce::MidiMessage::noteOn(1, 60, (juce::uint8)100));
+        tune(juce::MidiMessage::noteOn(1, 64, (juce::uint8)100));
+        auto channel60 = voiceController->channelOfVoice(1, 60);
+        tune(juce::MidiMessage::noteOff(1, 60));
+        tune(juce::MidiMessage::noteOff(1, 64));
+
+        tune(juce::MidiMessage::noteOn(1, 64, (juce::uint8)100));
+        expect_exact(channel60, voiceController->channelOfVoice(1, 64), "First free channel");
+
+        voiceController->addVoice(1, 67, 100);
+        expect_exact(channel60 + 1, voiceController->channelOfVoice(1, 67), "Added voice on the first free channel");
+    }
+};
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    MtsSysExReceiver_tests.h
+    Created: 21 Oct 2026 4:02:16pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../MtsSysExReceiver.h"
+
+class MtsSysExReceiver_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    using Bytes = std::vector<juce::uint8>;
+
+    // Multiples of 1/128 semitone are sent exactly
+    static double testMts(int note) { return note + (note % 7) / 8.0 + 0.0078125; }
+
+    void appendTriplet(Bytes& bytes, double mts)
+    {
+        auto triplet = mtsNoteToTriplet(mts);
+        bytes.push_back(triplet.coarse);
+        bytes.push_back(triplet.fineUpper);
+        bytes.push_back(triplet.fineLower);
+    }
+
+    // SysEx data without the F0 and F7 bytes
+    Bytes bulkDump(juce::uint8 deviceId, juce::String name, bool withBank = false)
+    {
+        Bytes bytes = { 0x7e, deviceId, 0x08, (juce::uint8)(withBank ? 0x04 : 0x01) };
+        if (withBank)
+            bytes.push_back(2);
+        bytes.push_back(5);
+
+        for (int i = 0; i < MtsSysExReceiver::nameLength; i++)
+            bytes.push_back((juce::uint8)(i < name.length() ? name[i] : ' '));
+
+        for (int note = 0; note < 128; note++)
+            appendTriplet(bytes, testMts(note));
+
+        juce::uint8 checksum = 0;
+        for (auto byte : bytes)
+            checksum ^= byte;
+        bytes.push_back(checksum & 0x7f);
+
+        return bytes;
+    }
+
+    Bytes singleNoteChange(juce::uint8 deviceId, const std::vector<std::pair<int, double>>& changes, bool withBank = false)
+    {
+        Bytes bytes = { 0x7f, deviceId, 0x08, (juce::uint8)(withBank ? 0x07 : 0x02) };
+        if (withBank)
+            bytes.push_back(2);
+        bytes.push_back(5);
+
+        bytes.push_back((juce::uint8)changes.size());
+        for (auto change : changes)
+        {
+            bytes.push_back((juce::uint8)change.first);
+            appendTriplet(bytes, change.second);
+        }
+
+        return bytes;
+    }
+
+    bool apply(const Bytes& bytes, MtsSysExReceiver::NoteTable& table, int deviceId = MtsSysExReceiver::allDevices)
+    {
+        return MtsSysExReceiver::applySysEx(bytes.data(), (int)bytes.size(), table, deviceId);
+    }
+
+public:
+
+    MtsSysExReceiver_Test() : EverytoneTunerUnitTest("MtsSysExReceiver") {};
+
+    void runTest() override
+    {
+        bulkDumpTest();
+        singleNoteChangeTest();
+        checksumTest();
+        deviceIdTest();
+    }
+
+private:
+
+    void bulkDumpTest()
+    {
+        beginTest("Bulk tuning dump");
+
+        for (auto withBank : { false, true })
+        {
+            auto message = juce::String(withBank ? "With bank: " : "");
+
+            MtsSysExReceiver::NoteTable table;
+            expect(apply(bulkDump(0x00, "Bulk test", withBank), table), message + "Dump applied");
+            expect_exact(juce::String("Bulk test"), juce::String(table.name.data()).trim(), message + "Name");
+
+            for (int note = 0; note < 128; note++)
+                expect_equals(testMts(note), table.mts[note], message + "Note " + juce::String(note));
+
+            auto tuning = MtsSysExReceiver::createTuning(table);
+            expect_exact(juce::String("Bulk test"), tuning->getName(), message + "Tuning name");
+            expect_equals(mtsToFrequency(testMts(60)), tuning->frequencyAt(60), message + "Tuning frequency");
+        }
+
+        // Notes sent as 7F 7F 7F keep their tuning
+        auto bytes = bulkDump(0x00, "Unchanged");
+        const int firstNote = 4 + 1 + MtsSysExReceiver::nameLength;
+        bytes[firstNote + 60 * 3] = bytes[firstNote + 60 * 3 + 1] = bytes[firstNote + 60 * 3 + 2] = 0x7f;
+
+        juce::uint8 checksum = 0;
+        for (size_t i = 0; i + 1 < bytes.size(); i++)
+            checksum ^= bytes[i];
+        bytes.back() = checksum & 0x7f;
+
+        MtsSysExReceiver::NoteTable table;
+        expect(apply(bytes, table), "Dump with an unchanged note applied");
+        expect_equals(60.0, table.mts[60], "Unchanged note");
+        expect_equals(testMts(61), table.mts[61], "Next note");
+
+        bytes.resize(bytes.size() - 10);
+        expect(!apply(bytes, table), "Truncated dump rejected");
+    }
+
+    void singleNoteChangeTest()
+    {
+        beginTest("Single note tuning change");
+
+        for (auto withBank : { false, true })
+        {
+            auto message = juce::String(withBank ? "With bank: " : "");
+
+            MtsSysExReceiver::NoteTable table;
+            expect(apply(singleNoteChange(0x00, { { 60, 60.5 }, { 64, 63.859375 } }, withBank), table), message + "Change applied");
+            expect_equals(60.5, table.mts[60], message + "First change");
+            expect_equals(63.859375, table.mts[64], message + "Second change");
+            expect_equals(62.0, table.mts[62], message + "Other notes unchanged");
+        }
+
+        MtsSysExReceiver::NoteTable table;
+        auto bytes = singleNoteChange(0x00, { { 60, 60.5 }, { 64, 63.859375 } });
+        bytes.pop_back();
+        expect(!apply(bytes, table), "Truncated change rejected");
+        expect_equals(60.0, table.mts[60], "Truncated change not applied");
+    }
+
+    void checksumTest()
+    {
+        beginTest("Bulk dump checksum");
+
+        MtsSysExReceiver::NoteTable table;
+        auto before = table;
+
+        auto bytes = bulkDump(0x00, "Bad checksum");
+        bytes.back() ^= 0x01;
+        expect(!apply(bytes, table), "Wrong checksum rejected");
+        expect(table.mts == before.mts, "Tuning unchanged");
+        expect(table.name == before.name, "Name unchanged");
+
+        bytes = bulkDump(0x00, "Bad data");
+        bytes[100] ^= 0x01;
+        expect(!apply(bytes, table), "Changed data rejected");
+        expect(table.mts == before.mts, "Tuning unchanged by changed data");
+
+        expect(apply(bulkDump(0x00, "Good checksum"), table), "Right checksum applied");
+    }
+
+    void deviceIdTest()
+    {
+        beginTest("Device ID");
+
+        MtsSysExReceiver::NoteTable table;
+        auto before = table;
+
+        expect(!apply(bulkDump(0x05, "Other device"), table, 0x03), "Dump for another device ignored");
+        expect(!apply(singleNoteChange(0x05, { { 60, 60.5 } }), table, 0x03), "Change for another device ignored");
+        expect(table.mts == before.mts, "Tuning unchanged");
+
+        expect(apply(singleNoteChange(0x03, { { 60, 60.5 } }), table, 0x03), "Change for this device applied");
+        expect(apply(singleNoteChange(MtsSysExReceiver::allDevices, { { 61, 61.5 } }), table, 0x03), "Change for all devices applied");
+        expect(apply(bulkDump(0x05, "Any device"), table), "Receiving for all devices");
+
+        // Through the receiver, with the F0 and F7 bytes
+        MtsSysExReceiver receiver;
+        receiver.setDeviceId(0x03);
+
+        auto bytes = singleNoteChange(0x05, { { 60, 60.5 } });
+        bytes.insert(bytes.begin(), 0xf0);
+        bytes.push_back(0xf7);
+        expect(!receiver.readSysEx(bytes.data(), (int)bytes.size()), "Receiver ignores another device");
+
+        bytes[2] = 0x03;
+        expect(receiver.readSysEx(bytes.data(), (int)bytes.size()), "Receiver reads its device");
+    }
+};
@@ -26,6 +26,20 @@ static bool testTable(const MultichannelMap& multimap, int* expectedIndices)
     return true;
 }
 
+    // Fastest of several runs, in high resolution ticks
+    template <typename Function>
+    static juce::int64 fastestTicks(Function function)
+    {
+        juce::int64 fastest = std::numeric_limits<juce::int64>::max();
+        for (int run = 0; run < 5; run++)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            function();
+            fastest = juce::jmin(fastest, juce::Time::getHighResolutionTicks() - start);
+        }
+        return fastest;
+    }
+
     MultichannelMap_Test() : EverytoneTunerUnitTest("MultichannelMap") {}
 
     void runTest() override
@@ -33,6 +47,12 @@ static bool testTable(const MultichannelMap& multimap, int* expectedIndices)
         //pre_test();
         standardMapping();
         period31OnChannel5();
+        transposition();
+        multichannelLayout();
+        keyboardMapping();
+        channelSlices();
+        rebuildInPlace();
+        fillSpeed();
     }
 
     void standardMapping()
@@ -175,4 +195,196 @@ static bool testTable(const MultichannelMap& multimap, int* expectedIndices)
 
         //DBG(multichannelMapToString(periodMapping));
     }
-};
\ No newline at end of file
+
+    void transposition()
+    {
+        beginTest("Transposed mappings rotate a shared table");
+
+        auto mapDefinition = MultichannelMap::PeriodicMappingDefinition(31, 5, 0, 178, 329);
+        auto baseMapping = TuningTableMap(mapDefinition);
+
+        for (auto transposeTest : { 1, -1, 12, -31, 2047, -2049, 5000 })
+        {
+            auto transposedMapping = baseMapping.withTransposition(transposeTest);
+            auto detail = " transposed by " + juce::String(transposeTest);
+
+            expect_exact(transposeTest, transposedMapping->getTransposition(), "getTransposition()" + detail);
+            expect(transposedMapping->sharesTableWith(baseMapping), "withTransposition() did not share the base table" + detail);
+
+            for (int i = 0; i < 2048; i++)
+                expect_exact(mapDefinition.map.at(mod(i + transposeTest, 2048)), transposedMapping->tableAt(i), "tableAt(" + juce::String(i) + ")" + detail);
+        }
+
+        auto setterMapping = TuningTableMap(baseMapping);
+        setterMapping.setTransposition(-7);
+        setterMapping.setTransposition(0);
+        expect(setterMapping.sharesTableWith(baseMapping), "setTransposition() rebuilt the base table");
+
+        for (int i = 0; i < 2048; i++)
+            expect_exact(baseMapping.tableAt(i), setterMapping.tableAt(i), "tableAt(" + juce::String(i) + ") after transposing back to 0");
+    }
+
+    void multichannelLayout()
+    {
+        beginTest("MultichannelMap built from per-channel maps and from a channel table");
+
+        auto expectedMapping = TuningTableMap(MultichannelMap::PeriodicMappingDefinition(31, 5, 0, 178, 329));
+
+        auto multimapDefinition = MultichannelMap::PeriodicMultichannelDefinition(31, 5, 0, 178, 329);
+        auto multimap = MultichannelMap(multimapDefinition);
+
+        int channelTables[2048];
+        for (int i = 0; i < 2048; i++)
+        {
+            expect_exact(expectedMapping.tableAt(i), multimap.tableAt(i), "Multimap tableAt(" + juce::String(i) + ")");
+            channelTables[i] = expectedMapping.tableAt(i);
+        }
+
+        auto tableMultimap = MultichannelMap(TuningTableMap::Root { 5, 0 }, channelTables, 31);
+        for (int i = 0; i < 2048; i++)
+            expect_exact(channelTables[i], tableMultimap.tableAt(i), "Channel table multimap tableAt(" + juce::String(i) + ")");
+
+        auto tableDefinition = tableMultimap.getDefinition();
+        expect_exact(16, (int)tableDefinition.maps.size(), "Channel table multimap number of maps");
+        expect_exact(channelTables[128 * 4], tableDefinition.maps[4].at(0), "Channel table multimap channel 5 map");
+
+        auto multimapCopy = MultichannelMap(multimap);
+        expect(multimapCopy.sharesTableWith(multimap), "MultichannelMap copy did not share the table");
+    }
+
+    void keyboardMapping()
+    {
+        beginTest("Scala keyboard mapping with unmapped keys, repeated on every channel");
+
+        // Pattern of 3 keys from note 60, the second key unmapped, and 2 degrees per pattern
+        auto definition = TuningTableMap::KeyboardMappingDefinition({ 0, -1, 1 }, 10, 100, 60, 2, 50);
+        auto mapping = TuningTableMap(definition);
+
+        expect_exact(60, mapping.getRootMidiNote(), "Root MIDI note");
+
+        for (int channel = 1; channel <= 16; channel++)
+        {
+            auto channelLabel = " on channel " + juce::String(channel);
+
+            expect_exact(50, mapping.getMappedNote(channel, 60).index, "Note 60" + channelLabel);
+            expect_exact(51, mapping.getMappedNote(channel, 62).index, "Note 62" + channelLabel);
+            expect_exact(52, mapping.getMappedNote(channel, 63).index, "Note 63" + channelLabel);
+            expect_exact(48, mapping.getMappedNote(channel, 57).index, "Note 57" + channelLabel);
+            expect_exact(49, mapping.getMappedNote(channel, 59).index, "Note 59" + channelLabel);
+
+            for (auto note : { 61, 64, 58, 13, 9, 101, 127 })
+                expect(!mapping.getMappedNote(channel, note).mapped, "Note " + juce::String(note) + " should be unmapped" + channelLabel);
+
+            expect_exact(TuningTableMap::UnmappedIndex, mapping.tableAt(midiIndex(channel, 61)), "tableAt() of unmapped note" + channelLabel);
+        }
+
+        auto transposed = mapping.withTransposition(1);
+        expect(!transposed->getMappedNote(1, 60).mapped, "Unmapped key should stay unmapped after transposition");
+        expect_exact(51, transposed->getMappedNote(1, 61).index, "Transposed mapped key");
+    }
+
+    void channelSlices()
+    {
+        beginTest("Multi-scale mapping with a tuning table slice per channel");
+
+        // Channels 1-4 use slice 0, channels 5-15 use slice 1, and channel 16 is unmapped
+        std::array<int, 16> slices;
+        for (int i = 0; i < 16; i++)
+            slices[i] = (i < 4) ? 0 : 1;
+        slices[15] = -1;
+
+        auto mapping = TuningTableMap(TuningTableMap::ChannelSlicesDefinition(slices, 60));
+
+        expect_exact(1, mapping.getRootMidiChannel(), "Root MIDI channel");
+        expect_exact(60, mapping.getRootMidiNote(), "Root MIDI note");
+
+        for (int channel = 1; channel <= 16; channel++)
+        {
+            auto channelLabel = " on channel " + juce::String(channel);
+
+            for (int note = 0; note < 128; note++)
+            {
+                auto mapped = mapping.getMappedNote(channel, note);
+                if (channel == 16)
+                {
+                    expect(!mapped.mapped, "Note " + juce::String(note) + " should be unmapped" + channelLabel);
+                    continue;
+                }
+
+                int slice = (channel <= 4) ? 0 : 1;
+                expect(mapped.mapped, "Note " + juce::String(note) + " should be mapped" + channelLabel);
+                expect_exact(slice, mapped.tableIndex, "Table of note " + juce::String(note) + channelLabel);
+                expect_exact(note, mapped.noteIndex, "Index of note " + juce::String(note) + channelLabel);
+            }
+        }
+    }
+
+    void rebuildInPlace()
+    {
+        beginTest("Rebuilt maps write over a table they don't share");
+
+        auto mapping = TuningTableMap(TuningTableMap::LinearMappingDefinition(1, 60, 0, 31));
+        auto table = mapping.getBaseTable().get();
+        auto pattern = mapping.midiIndexMap()->pattern().data();
+
+        auto definition = TuningTableMap::LinearMappingDefinition(3, 64, 5, 41);
+        definition.transpose = 7;
+        mapping.rebuild(definition);
+
+        expect(mapping.getBaseTable().get() == table, "Table written over");
+        expect(mapping.midiIndexMap()->pattern().data() == pattern, "Pattern written over");
+
+        auto expected = TuningTableMap(definition);
+        expect(expected.getRoot() == mapping.getRoot(), "Root of the new definition");
+        expect_exact(7, mapping.getTransposition(), "Transposition of the new definition");
+        for (int i = 0; i < 2048; i++)
+            expect_exact(expected.tableAt(i), mapping.tableAt(i), "tableAt(" + juce::String(i) + ") after rebuilding");
+
+        // Shared tables are left to the maps that share them
+        auto copy = mapping;
+        mapping.rebuild(TuningTableMap::StandardMappingDefinition());
+        expect(!mapping.sharesTableWith(copy), "Shared table not written over");
+        for (int i = 0; i < 2048; i++)
+            expect_exact(expected.tableAt(i), copy.tableAt(i), "tableAt(" + juce::String(i) + ") of the copy");
+
+        // Tables that weren't built by a map, such as bundle tables, are never written
+        auto given = std::make_shared<const TuningTableMap::BaseTable>(*expected.getBaseTable());
+        auto givenMapping = TuningTableMap(TuningTableMap::LinearMappingDefinition(3, 64, 5, 41), given);
+        given = nullptr;
+        auto givenTable = givenMapping.getBaseTable();
+        givenMapping.rebuild(TuningTableMap::StandardMappingDefinition());
+        expect(givenMapping.getBaseTable() != givenTable, "Given table not written over");
+    }
+
+    void fillSpeed()
+    {
+        beginTest("Filling a table is faster than indexing each key");
+
+        for (auto definition : { TuningTableMap::StandardMappingDefinition(),
+                                 TuningTableMap::LinearMappingDefinition(1, 60, 0, 31),
+                                 MultichannelMap::PeriodicMappingDefinition(31, 5, 0, 178, 329) })
+        {
+            const auto& map = definition.map;
+            auto name = " of size " + juce::String(map.size());
+
+            TuningTableMap::BaseTable filled, indexed;
+            const int numFills = 200;
+
+            auto fillTicks = fastestTicks([&]()
+            {
+                for (int n = 0; n < numFills; n++)
+                    map.fill(filled.table, n, 2048);
+            });
+
+            auto indexTicks = fastestTicks([&]()
+            {
+                for (int n = 0; n < numFills; n++)
+                    for (int i = 0; i < 2048; i++)
+                        indexed.table[i] = map.at(n + i);
+            });
+
+            expect(std::equal(filled.table, filled.table + 2048, indexed.table), "Same table" + name);
+            expect(fillTicks < indexTicks, "Fill" + name + " took " + juce::String(fillTicks) + " ticks, indexing took " + juce::String(indexTicks));
+        }
+    }
+};
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    PitchQuantiser_tests.h
+    Created: 20 Oct 2026 6:10:44am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../PitchQuantiser.h"
+
+class PitchQuantiser_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    int bruteForceNearest(const PitchQuantiser& quantiser, double mts)
+    {
+        int nearest = 0;
+        for (int degree = 1; degree < quantiser.getNumDegrees(); degree++)
+        {
+            if (std::abs(quantiser.mtsOfDegree(degree) - mts) < std::abs(quantiser.mtsOfDegree(nearest) - mts))
+                nearest = degree;
+        }
+        return nearest;
+    }
+
+public:
+
+    PitchQuantiser_Test() : EverytoneTunerUnitTest("PitchQuantiser") {};
+
+    void runTest() override
+    {
+        standardTuningTest();
+        hysteresisTest();
+        ode31Test();
+    }
+
+private:
+
+    void standardTuningTest()
+    {
+        beginTest("Standard tuning");
+
+        auto tuning = MappedTuningTable::StandardTuning();
+        PitchQuantiser quantiser(*tuning);
+
+        expect(!quantiser.isEmpty(), "Has degrees");
+
+        auto degree = quantiser.nearestDegreeTo(60.3);
+        expect_equals(60.0, quantiser.mtsOfDegree(degree), "Rounds down");
+
+        degree = quantiser.nearestDegreeTo(60.6);
+        expect_equals(61.0, quantiser.mtsOfDegree(degree), "Rounds up");
+
+        degree = quantiser.nearestDegreeTo(-5.0);
+        expect_exact(0, degree, "Below the range");
+
+        degree = quantiser.nearestDegreeTo(200.0);
+        expect_exact(quantiser.getNumDegrees() - 1, degree, "Above the range");
+
+        expect_exact(-1, PitchQuantiser().nearestDegreeTo(60.0), "Empty quantiser");
+    }
+
+    void hysteresisTest()
+    {
+        beginTest("Hysteresis");
+
+        auto tuning = MappedTuningTable::StandardTuning();
+        PitchQuantiser quantiser(*tuning);
+
+        auto degree = quantiser.nearestDegreeTo(60.0);
+
+        expect_exact(degree, quantiser.quantise(60.6, degree, 0.15), "Kept past the boundary");
+        expect_exact(degree, quantiser.quantise(59.4, degree, 0.15), "Kept below the boundary");
+        expect_exact(degree + 1, quantiser.quantise(60.7, degree, 0.15), "Changed past the hysteresis");
+        expect_exact(degree + 1, quantiser.quantise(60.6, degree, 0), "Changed without hysteresis");
+        expect_exact(degree + 2, quantiser.quantise(62.1, degree, 0.15), "Jumped degrees");
+        expect_exact(degree + 1, quantiser.quantise(60.6, -1, 0.15), "Nearest without a current degree");
+    }
+
+    void ode31Test()
+    {
+        beginTest("31-EDO matches nearest degree");
+
+        auto ode31def = CentsDefinition::CentsDivisions(31.0, 1200.0, 440);
+        auto ode31at440 = std::make_shared<FunctionalTuning>(ode31def);
+
+        auto root = TuningTableMap::Root{ 5, 0 };
+        auto mapping = MappedTuningTable::PeriodicMappingFromTuning(ode31at440.get(), root);
+        auto ode31MappedTuning = std::make_unique<MappedTuningTable>(ode31at440, mapping);
+
+        PitchQuantiser quantiser(*ode31MappedTuning);
+        expect(quantiser.getNumDegrees() > 128, "More degrees than standard tuning");
+
+        // Steps that don't line up with the table
+        int mismatches = 0;
+        for (double mts = 0.0; mts <= 128.0; mts += 0.0071)
+        {
+            if (quantiser.nearestDegreeTo(mts) != bruteForceNearest(quantiser, mts))
+                mismatches++;
+        }
+
+        expect_exact(0, mismatches, "Degrees that were not the nearest");
+    }
+};
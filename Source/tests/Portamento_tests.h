@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    Portamento_tests.h
+    Created: 20 Oct 2026 7:02:16am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../Portamento.h"
+
+class Portamento_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    struct Bend
+    {
+        int channelIndex;
+        int position;   // Samples from the start of the ramp
+        double offset;
+    };
+
+    juce::Array<Bend> runRamp(Portamento& portamento, int blockSize, int numBlocks)
+    {
+        juce::Array<Bend> bends;
+        for (int block = 0; block < numBlocks; block++)
+        {
+            portamento.advance(blockSize, [&](int channelIndex, int sample, double offset)
+            {
+                bends.add({ channelIndex, block * blockSize + sample, offset });
+            });
+        }
+        return bends;
+    }
+
+public:
+
+    Portamento_Test() : EverytoneTunerUnitTest("Portamento") {};
+
+    void runTest() override
+    {
+        rampTest();
+        thresholdTest();
+        blockSizeTest();
+    }
+
+private:
+
+    void rampTest()
+    {
+        beginTest("Ramp to the target");
+
+        Portamento portamento;
+        portamento.setThreshold(5);
+        portamento.start(3, 2.0, 4410);
+
+        expect(portamento.isActive(3), "Started");
+        expect_equals(2.0, portamento.getOffset(3), "Starts at the previous pitch");
+
+        auto bends = runRamp(portamento, 512, 10);
+
+        expect(bends.size() > 0, "Has pitchbends");
+        expect_exact(3, bends.getLast().channelIndex, "Channel");
+        expect_exact(4410, bends.getLast().position, "Ends at the length of the ramp");
+        expect_equals(0.0, bends.getLast().offset, "Ends at the target");
+        expect(!portamento.isActive(3), "Finished");
+
+        // A pitchbend every 5 cents down to 5 cents, then the target
+        expect_exact(40, bends.size(), "Pitchbends for the threshold");
+
+        Portamento down;
+        down.start(0, -1.0, 1000);
+        bends = runRamp(down, 256, 4);
+        expect(bends[0].offset > -1.0 && bends[0].offset < 0, "Ramps up from below");
+        expect_equals(0.0, bends.getLast().offset, "Ends at the target from below");
+
+        Portamento none;
+        none.start(0, 0.0, 1000);
+        expect(!none.isActive(0), "No ramp without a distance");
+        none.start(0, 1.0, 0);
+        expect(!none.isActive(0), "No ramp without a length");
+    }
+
+    void thresholdTest()
+    {
+        beginTest("Sent pitch stays within the threshold");
+
+        Portamento portamento;
+        portamento.setThreshold(10);
+
+        double from = 3.7;
+        int length = 9000;
+        portamento.start(0, from, length);
+
+        auto bends = runRamp(portamento, 64, 200);
+
+        double sent = from;
+        int bendIndex = 0;
+        double maxError = 0;
+        for (int position = 0; position <= length; position++)
+        {
+            if (bendIndex < bends.size() && bends[bendIndex].position == position)
+                sent = bends[bendIndex++].offset;
+
+            auto ramp = from * (1.0 - (double)position / length);
+            maxError = juce::jmax(maxError, std::abs(sent - ramp));
+        }
+
+        expect(maxError < 0.1, "Error under the threshold, was " + juce::String(maxError * 100.0) + " cents");
+
+        for (int i = 1; i < bends.size(); i++)
+            expect(bends[i].position > bends[i - 1].position, "One pitchbend per sample");
+    }
+
+    void blockSizeTest()
+    {
+        beginTest("Same pitchbends for any block size");
+
+        Portamento small;
+        small.start(5, -4.0, 3000);
+        auto smallBends = runRamp(small, 32, 100);
+
+        Portamento large;
+        large.start(5, -4.0, 3000);
+        auto largeBends = runRamp(large, 4096, 1);
+
+        expect_exact(largeBends.size(), smallBends.size(), "Number of pitchbends");
+        for (int i = 0; i < smallBends.size() && i < largeBends.size(); i++)
+        {
+            expect_exact(largeBends[i].position, smallBends[i].position, "Position of pitchbend " + juce::String(i));
+            expect_equals(largeBends[i].offset, smallBends[i].offset, "Offset of pitchbend " + juce::String(i));
+        }
+    }
+};
@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    ScalaBufferParser_tests.h
+    Created: 21 Oct 2026 11:26:52am
+    Author:  Vincenzo
+
+    Checks ScalaBufferParser against TUN::CSCL_Import, which it replaces.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/ScalaBufferParser.h"
+#include "../io/TUN_V2/SCL_Import.h"
+
+class ScalaBufferParser_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Deleted when the test goes out of scope
+    struct TestFile
+    {
+        juce::File file;
+
+        TestFile(juce::String extension, juce::String text)
+            : file(juce::File::createTempFile(extension))
+        {
+            file.replaceWithText(text);
+        }
+
+        ~TestFile() { file.deleteFile(); }
+    };
+
+    // Scale degree n is n * 100 cents, so keyboard mappings can be compared through mapped frequencies
+    juce::String semitoneScaleText()
+    {
+        juce::String text = "! semitones.scl\n127 semitones\n127\n";
+        for (int degree = 1; degree <= 127; degree++)
+            text += juce::String(degree * 100) + ".0\n";
+        return text;
+    }
+
+public:
+
+    ScalaBufferParser_Test() : EverytoneTunerUnitTest("ScalaBufferParser") {};
+
+    void runTest() override
+    {
+        scaleTest();
+        malformedScaleTest();
+        keyboardMappingTest();
+        malformedKeyboardMappingTest();
+    }
+
+private:
+
+    void compareScale(juce::String text, juce::String message)
+    {
+        TestFile scl(".scl", text);
+
+        TUN::CSCL_Import importer;
+        bool imported = importer.ReadSCL(scl.file.getFullPathName().toRawUTF8());
+
+        ScalaBufferParser::Scale scale;
+        juce::String error;
+        auto utf8 = text.toStdString();
+        bool parsed = ScalaBufferParser::parseScale(utf8, scale, error);
+
+        expect(imported == parsed, message + ": both succeed or both fail");
+        expect_exact(juce::String(importer.Err().GetLastError()), error, message + ": error");
+
+        if (!imported || !parsed)
+            return;
+
+        expect_exact(juce::String(importer.GetTuningName()), scale.name, message + ": name");
+        expect_exact(juce::String(importer.GetScaleDescription()), scale.description, message + ": description");
+        expect_exact(importer.GetScaleSize(), scale.intervalCents.size(), message + ": size");
+
+        for (int i = 0; i < scale.intervalCents.size(); i++)
+            expect_equals(importer.GetLineInCents(i + 1), scale.intervalCents[i], message + ": interval " + juce::String(i + 1));
+    }
+
+    // CSCL_Import only exposes a keyboard mapping through the frequencies it maps,
+    // so the parsed settings are applied the same way with a scale of semitones
+    void compareKeyboardMapping(juce::String text, juce::String message)
+    {
+        TestFile scl(".scl", semitoneScaleText());
+        TestFile kbm(".kbm", text);
+
+        TUN::CSCL_Import importer;
+        importer.ReadSCL(scl.file.getFullPathName().toRawUTF8());
+        bool imported = importer.ReadKBM(kbm.file.getFullPathName().toRawUTF8());
+
+        ScalaBufferParser::KeyboardMapping mapping;
+        juce::String error;
+        auto utf8 = text.toStdString();
+        bool parsed = ScalaBufferParser::parseKeyboardMapping(utf8, mapping, error);
+
+        expect(imported == parsed, message + ": both succeed or both fail");
+        expect_exact(juce::String(importer.Err().GetLastError()), error, message + ": error");
+
+        if (!imported || !parsed)
+            return;
+
+        TUN::CSingleScale singleScale;
+        importer.SetSingleScale(singleScale);
+
+        auto mappedCents = [&](int note) -> double
+        {
+            if (note < mapping.firstNote || note > mapping.lastNote)
+                return note * 100.0;
+
+            auto offset = note - mapping.middleNote;
+            auto repetition = (int)std::floor((double)offset / mapping.patternSize);
+            auto degree = mapping.keys[offset - repetition * mapping.patternSize];
+            if (degree < 0 || degree >= 127)
+                return note * 100.0;
+
+            return (degree + mapping.middleNote + repetition * mapping.formalOctave) * 100.0;
+        };
+
+        auto referenceCents = mappedCents(mapping.referenceNote);
+        for (int note = 0; note < 128; note++)
+        {
+            auto frequency = mapping.referenceFrequency * std::pow(2.0, (mappedCents(note) - referenceCents) / 1200.0);
+            expect_equals(singleScale.GetMIDINoteFreqHz(note), frequency, message + ": note " + juce::String(note));
+        }
+    }
+
+    void scaleTest()
+    {
+        beginTest("Scales match CSCL_Import");
+
+        compareScale("! test.scl\n"
+                     "!\n"
+                     "Five note scale\n"
+                     " 5\n"
+                     "!\n"
+                     " 9/8\n"
+                     " 5/4\n"
+                     " 701.955\n"
+                     " 5/3\n"
+                     " 2/1\n",
+                     "Ratios and cents");
+
+        compareScale("! comments.scl\n"
+                     "! A comment before the description\n"
+                     "\n"
+                     "Comments and blank lines\n"
+                     "\n"
+                     "! Another comment\n"
+                     "3\n"
+                     "\n"
+                     "! Between intervals\n"
+                     "386.3137\n"
+                     "\n"
+                     "3/2\n"
+                     "! Before the period\n"
+                     "2/1\n"
+                     "\n",
+                     "Comments and blank lines");
+
+        compareScale("Name without an exclamation mark\r\n"
+                     "CRLF line endings\r\n"
+                     "2\r\n"
+                     "600.0 cents with text after\r\n"
+                     "1200.\r\n",
+                     "CRLF and trailing text");
+
+        compareScale("! no_description.scl\n"
+                     "3\n"
+                     "  3 / 2  \n"
+                     "+5/4\n"
+                     "-100.5\n",
+                     "Digits only line is the size, spaces in ratios and signs");
+
+        compareScale("! last.scl\n"
+                     "No newline at the end\n"
+                     "2\n"
+                     "3/2\n"
+                     "2/1",
+                     "No newline at the end");
+
+        compareScale("! exponent.scl\n"
+                     "Exponents and fractions\n"
+                     "3\n"
+                     "1.5e2\n"
+                     "0.5/0.25\n"
+                     "7/4 septimal seventh\n",
+                     "Exponents and fractional ratios");
+    }
+
+    void malformedScaleTest()
+    {
+        beginTest("Malformed scales match CSCL_Import");
+
+        compareScale("! empty.scl\n", "No data");
+        compareScale("! description.scl\nOnly a description\n", "No size");
+        compareScale("! zero.scl\nZero notes\n0\n", "Size zero");
+        compareScale("! large.scl\nToo many notes\n128\n", "Size too large");
+        compareScale("! negative.scl\nNegative size\n-3\n100.0\n", "Negative size");
+        compareScale("! few.scl\nToo few\n3\n100.0\n200.0\n", "Too few intervals");
+        compareScale("! many.scl\nToo many\n2\n100.0\n200.0\n300.0\n", "Too many intervals");
+        compareScale("! operator.scl\nNo slash\n2\n5\n2/1\n", "Integer without a slash");
+        compareScale("! text.scl\nText\n2\nthird\n2/1\n", "Text interval");
+        compareScale("! zero.scl\nDivision\n2\n3/0\n2/1\n", "Division by zero");
+        compareScale("! star.scl\nOperator\n1\n3*2\n", "Unknown operator");
+    }
+
+    void keyboardMappingTest()
+    {
+        beginTest("Keyboard mappings match CSCL_Import");
+
+        compareKeyboardMapping("! whole.kbm\n"
+                               "! Size of map\n"
+                               "12\n"
+                               "! First and last notes\n"
+                               "0\n"
+                               "127\n"
+                               "! Middle note\n"
+                               "60\n"
+                               "! Reference note and frequency\n"
+                               "69\n"
+                               "440.0\n"
+                               "! Formal octave\n"
+                               "12\n"
+                               "! Mapping\n"
+                               "0\n1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n11\n",
+                               "Standard mapping with comments");
+
+        compareKeyboardMapping("! gaps.kbm\n"
+                               "7\n"
+                               "\n"
+                               "10\n"
+                               "110\n"
+                               "62\n"
+                               "\n"
+                               "64\n"
+                               "330.5Hz\n"
+                               "5\n"
+                               "0\n"
+                               "x\n"
+                               "1\n"
+                               "X\n"
+                               "! comment between keys\n"
+                               "2\n"
+                               "3\n"
+                               "4\n",
+                               "Unmapped keys, blank lines and a partial range");
+
+        compareKeyboardMapping("! short.kbm\n"
+                               "5\n0\n127\n48\n60\n261.6255653\n3\n"
+                               "0\n2\n",
+                               "Missing keys at the end are unmapped");
+
+        compareKeyboardMapping("! clamped.kbm\r\n"
+                               "200\r\n-4\r\n300\r\n0\r\n-1\r\n1e9\r\n200\r\n",
+                               "Settings clamped, CRLF and no keys");
+
+        compareKeyboardMapping("! empty.kbm\n0\n0\n127\n60\n69\n440\n0\n", "Empty pattern is clamped to one key");
+    }
+
+    void malformedKeyboardMappingTest()
+    {
+        beginTest("Malformed keyboard mappings match CSCL_Import");
+
+        compareKeyboardMapping("12\n0\n127\n60\n", "Premature end");
+        compareKeyboardMapping("12\n100\n20\n60\n69\n440\n12\n", "First note after last note");
+        compareKeyboardMapping("12\n0\n127\n120\n69\n440\n12\n", "Middle note too high");
+        compareKeyboardMapping("2\n0\n127\n60\n69\n440\n2\n0\n1\n5\n", "Additional data");
+    }
+};
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    ScaleLibrary_tests.h
+    Created: 20 Oct 2026 5:21:09pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/ScaleLibrary.h"
+
+class ScaleLibrary_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    juce::File directory;
+
+    // Each write gets a later modification time, so that rescans see the change
+    juce::int64 modificationTime = 1600000000000;
+
+    juce::File writeScale(juce::String fileName, juce::String text)
+    {
+        auto file = directory.getChildFile(fileName);
+        file.replaceWithText(text);
+
+        modificationTime += 2000;
+        file.setLastModificationTime(juce::Time(modificationTime));
+        return file;
+    }
+
+    juce::String scalaText(juce::String name, juce::StringArray intervals)
+    {
+        return "! " + name + ".scl\n"
+               "!\n"
+               + name + "\n"
+               + juce::String(intervals.size()) + "\n"
+               "!\n"
+               + intervals.joinIntoString("\n") + "\n";
+    }
+
+    juce::String pentatonicText() { return scalaText("Pentatonic", { "9/8", "5/4", "3/2", "5/3", "2/1" }); }
+    juce::String heptatonicText() { return scalaText("Heptatonic", { "9/8", "5/4", "4/3", "3/2", "5/3", "15/8", "2/1" }); }
+    juce::String tritaveText() { return scalaText("Bohlen-Pierce", { "146.3", "292.6", "438.9", "585.2", "731.5", "877.8", "1024.1",
+                                                                     "1170.4", "1316.7", "1463.0", "1609.3", "1755.6", "1901.955" }); }
+
+    // Says there are three notes but only has two
+    juce::String malformedText() { return "! bad.scl\nBad\n3\n100.0\n200.0\n"; }
+
+public:
+
+    ScaleLibrary_Test() : EverytoneTunerUnitTest("ScaleLibrary") {};
+
+    void runTest() override
+    {
+        directory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("EverytoneScaleLibraryTest");
+        directory.deleteRecursively();
+        directory.createDirectory();
+
+        scanTest();
+        searchTest();
+
+        directory.deleteRecursively();
+    }
+
+private:
+
+    void scanTest()
+    {
+        beginTest("Scan and rescan");
+
+        auto pentatonic = writeScale("pentatonic.scl", pentatonicText());
+        auto tritave = writeScale("tritave.scl", tritaveText());
+        auto bad = writeScale("bad.scl", malformedText());
+
+        ScaleLibrary library;
+        auto result = library.scanDirectory(directory, 2);
+        expect_exact(2, result.added, "Scales added");
+        expect_exact(1, result.failed, "Malformed scale failed");
+        expect_exact(2, library.getNumEntries(), "Entries");
+        expect_exact(1, library.getNumFailedFiles(), "Failure recorded");
+
+        auto entry = library.findEntry(pentatonic.getFullPathName());
+        expect(entry != nullptr, "Entry found by file path");
+        expect_exact(5, entry->size(), "Entry size");
+        expect_exact(juce::String("Pentatonic"), entry->description, "Entry description");
+
+        result = library.scanDirectory(directory, 2);
+        expect_exact(3, result.unchanged, "Nothing reparsed, including the failure");
+        expect_exact(0, result.added + result.updated + result.failed + result.removed, "Nothing changed");
+
+        writeScale("pentatonic.scl", heptatonicText());
+        result = library.scanDirectory(directory, 2);
+        expect_exact(1, result.updated, "Modified scale updated");
+        expect_exact(7, library.findEntry(pentatonic.getFullPathName())->size(), "Updated entry size");
+
+        writeScale("bad.scl", pentatonicText());
+        result = library.scanDirectory(directory, 2);
+        expect_exact(1, result.added, "Fixed scale added");
+        expect_exact(0, library.getNumFailedFiles(), "Failure cleared");
+
+        tritave.deleteFile();
+        result = library.scanDirectory(directory, 2);
+        expect_exact(1, result.removed, "Deleted scale removed");
+        expect(library.findEntry(tritave.getFullPathName()) == nullptr, "Deleted scale not found");
+
+        writeScale("pentatonic.scl", malformedText());
+        result = library.scanDirectory(directory, 2);
+        expect_exact(1, result.failed, "Broken scale failed");
+        expect_exact(0, result.removed, "Broken scale counted as failed, not removed");
+        expect_exact(1, library.getNumEntries(), "Broken scale's entry removed");
+        expect(library.findEntry(bad.getFullPathName()) != nullptr, "Other entry kept");
+
+        pentatonic.deleteFile();
+        bad.deleteFile();
+        library.scanDirectory(directory, 2);
+        expect_exact(0, library.getNumEntries(), "All entries removed");
+        expect_exact(0, library.getNumFailedFiles(), "Failures of deleted files dropped");
+    }
+
+    void searchTest()
+    {
+        beginTest("Search");
+
+        auto pentatonic = writeScale("pentatonic.scl", pentatonicText());
+        auto heptatonic = writeScale("heptatonic.scl", heptatonicText());
+        auto tritave = writeScale("tritave.scl", tritaveText());
+
+        ScaleLibrary library;
+        library.scanDirectory(directory, 1);
+
+        ScaleLibrary::Query query;
+        auto results = library.search(query);
+        expect_exact(3, results.size(), "Everything matches an empty query");
+
+        query.noteCount = 7;
+        results = library.search(query);
+        expect_exact(1, results.size(), "One scale with seven notes");
+        expect_exact(heptatonic.getFullPathName(), library.getEntry(results[0]).filePath, "Seven note scale");
+
+        query.noteCount = 6;
+        expect_exact(0, library.search(query).size(), "No scale with six notes");
+
+        query = ScaleLibrary::Query();
+        query.nameContains = "TRITAVE";
+        results = library.search(query);
+        expect_exact(1, results.size(), "Found by file name, ignoring case");
+        expect_exact(tritave.getFullPathName(), library.getEntry(results[0]).filePath, "Tritave scale");
+
+        query = ScaleLibrary::Query();
+        query.periodCents = 1200.0;
+        expect_exact(2, library.search(query).size(), "Octave scales");
+
+        query = ScaleLibrary::Query();
+        query.nearestIntervals = { 386.3, 1088.3 };
+        results = library.search(query);
+        expect_exact(heptatonic.getFullPathName(), library.getEntry(results[0]).filePath, "Closest to a just major third and seventh");
+
+        query.maxResults = 2;
+        expect_exact(2, library.search(query).size(), "Results limited");
+
+        // Entries added by hand are found the same way
+        ScaleLibrary::Entry entry;
+        entry.filePath = directory.getChildFile("added.scl").getFullPathName();
+        entry.name = "Added";
+        entry.intervalCents = { 600.0, 1200.0 };
+        library.addEntry(entry);
+
+        query = ScaleLibrary::Query();
+        query.noteCount = 2;
+        results = library.search(query);
+        expect_exact(1, results.size(), "Added entry found by size");
+
+        entry.intervalCents = { 400.0, 800.0, 1200.0 };
+        library.addEntry(entry);
+        expect_exact(4, library.getNumEntries(), "Entry replaced, not added");
+        expect_exact(0, library.search(query).size(), "Replaced entry no longer found by old size");
+
+        query.noteCount = 3;
+        expect_exact(1, library.search(query).size(), "Replaced entry found by new size");
+
+        pentatonic.deleteFile();
+        heptatonic.deleteFile();
+        tritave.deleteFile();
+    }
+};
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    SharedTuning_tests.h
+    Created: 21 Oct 2026 6:12:40pm
+    Author:  Vincenzo
+
+    A master and its readers in one process, through a segment only used by the tests.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../SharedTuning.h"
+#include "../MidiNoteTuner.h"
+
+#include <thread>
+
+class SharedTuning_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Unique to each run, so runs never share a segment or find one left by a crashed run
+    const juce::String segmentName = "everytone-tuning-test-" + juce::String::toHexString(juce::Random::getSystemRandom().nextInt64());
+
+    struct ClientListener : public SharedTuningClient::Listener
+    {
+        std::shared_ptr<MappedTuningTable> tuning;
+        int numChanges = 0;
+
+        void sharedTuningConnected(SharedTuningClient* client, std::shared_ptr<MappedTuningTable> tuningIn) override { tuning = tuningIn; }
+        void sharedTuningChanged(SharedTuningClient* client) override { numChanges++; }
+    };
+
+    std::shared_ptr<MappedTuningTable> equalTuning(double divisions, juce::String name)
+    {
+        auto tuning = std::make_shared<FunctionalTuning>(CentsDefinition::CentsDivisions(divisions));
+        tuning->setName(name);
+        auto mapping = MappedTuningTable::LinearMappingFromTuning(tuning.get(), TuningTableMap::Root { 1, 69 });
+        return std::make_shared<MappedTuningTable>(tuning, mapping);
+    }
+
+public:
+
+    SharedTuning_Test() : EverytoneTunerUnitTest("SharedTuning") {};
+
+    void runTest() override
+    {
+        publishAndReadTest();
+        masterClaimTest();
+        clientTest();
+        tornReadTest();
+
+        SharedTuningSegment::remove(segmentName);
+    }
+
+private:
+
+    void publishAndReadTest()
+    {
+        beginTest("Published tuning is read through the seqlock");
+
+        auto tuning = equalTuning(24, "Quarter tones");
+
+        SharedTuningSegment master(segmentName, SharedTuningSegment::Access::Publish);
+        expect(master.isOpen() && master.isMaster(), "Master opened");
+        expect(master.publish(*tuning), "Published");
+
+        SharedTuningSegment reader(segmentName, SharedTuningSegment::Access::Read);
+        expect(reader.isOpen(), "Reader opened");
+        expect(!reader.isMaster(), "Reader isn't the master");
+        expect(!reader.publish(*tuning), "Reader can't publish");
+
+        juce::String name;
+        juce::uint32 sequence = 0;
+        expect(reader.readName(name, sequence), "Name read");
+        expect_exact(juce::String("Quarter tones"), name, "Name");
+        expect(sequence != 0 && (sequence & 1) == 0, "Sequence of a finished publish");
+
+        juce::Array<double> mtsTable, frequencyTable;
+        expect(reader.readMtsTable(mtsTable), "MTS table read");
+        expect(reader.readFrequencyTable(frequencyTable), "Frequency table read");
+        expect_exact(SharedTuningSegment::tableSize, mtsTable.size(), "Every channel and note");
+
+        for (int ch = 1; ch <= 16; ch += 5)
+        {
+            for (int note = 0; note < 128; note += 7)
+            {
+                auto expected = tuning->mtsAt(note, ch);
+                auto noteName = "Channel " + juce::String(ch) + " note " + juce::String(note);
+
+                double mts = 0, frequency = 0;
+                expect(reader.readMts(note, ch, mts), noteName + " read");
+                expect(reader.readFrequency(note, ch, frequency), noteName + " frequency read");
+                expect_equals(expected, mts, noteName + " pitch");
+                expect_equals(mtsToFrequency(expected), frequency, noteName + " frequency");
+                expect_equals(expected, mtsTable[(ch - 1) * 128 + note], noteName + " pitch in table");
+                expect_equals(mtsToFrequency(expected), frequencyTable[(ch - 1) * 128 + note], noteName + " frequency in table");
+            }
+        }
+    }
+
+    void masterClaimTest()
+    {
+        beginTest("One master at a time");
+
+        auto tuning = equalTuning(12, "Twelve");
+
+        auto first = std::make_unique<SharedTuningSegment>(segmentName, SharedTuningSegment::Access::Publish);
+        expect(first->isMaster(), "First master claimed the segment");
+
+        SharedTuningSegment second(segmentName, SharedTuningSegment::Access::Publish);
+        expect(!second.isOpen(), "Second master refused");
+        expect(!second.publish(*tuning), "Second master can't publish");
+
+        // Released when the master closes
+        first = nullptr;
+        SharedTuningSegment third(segmentName, SharedTuningSegment::Access::Publish);
+        expect(third.isMaster(), "Next master claimed the released segment");
+        expect(third.publish(*tuning), "Next master published");
+    }
+
+    void clientTest()
+    {
+        beginTest("Client follows the master without rebuilding");
+
+        SharedTuningSegment master(segmentName, SharedTuningSegment::Access::Publish);
+        auto twelve = equalTuning(12, "Twelve");
+        master.publish(*twelve);
+
+        SharedTuningClient client(segmentName);
+        ClientListener listener;
+        client.addListener(&listener);
+
+        client.poll();
+        expect(client.isConnected(), "Connected");
+        expect(listener.tuning != nullptr, "Tuning received");
+        if (listener.tuning == nullptr)
+            return;
+
+        auto shared = listener.tuning;
+        expect_exact(juce::String("Twelve"), shared->getTuning()->getName(), "Name");
+        expect_equals(twelve->mtsAt(61, 1), shared->mtsAt(61, 1), "Pitch of the master");
+        expect(shared->getTuning()->getMtsTableView().isEmpty(), "Segment isn't read around the seqlock");
+
+        client.poll();
+        expect_exact(0, listener.numChanges, "Nothing new");
+
+        auto quarterTones = equalTuning(24, "Quarter tones");
+        master.publish(*quarterTones);
+        client.poll();
+
+        expect_exact(1, listener.numChanges, "Change received");
+        expect(listener.tuning == shared, "Same tuning");
+        expect_exact(juce::String("Quarter tones"), shared->getTuning()->getName(), "New name");
+
+        for (int ch = 1; ch <= 16; ch += 3)
+        {
+            for (int note = 0; note < 128; note += 11)
+            {
+                auto noteName = "Channel " + juce::String(ch) + " note " + juce::String(note);
+                expect_equals(quarterTones->mtsAt(note, ch), shared->mtsAt(note, ch), noteName);
+                expect_equals(quarterTones->frequencyAt(note, ch), shared->frequencyAt(note, ch), noteName + " frequency");
+            }
+        }
+
+        // Copied out of the segment when leaving client mode
+        auto copy = TuningTable(shared->getTuning()->getDefinition());
+        expect_equals(quarterTones->mtsAt(64, 3), copy.mtsAt(2 * 128 + 64), "Copied pitch");
+
+        // A tuner reads the new pitches through the same tables
+        auto standard = std::shared_ptr<MappedTuningTable>(MappedTuningTable::StandardTuning());
+        MidiNoteTuner sharedTuner(standard, shared);
+        MidiNoteTuner tuner(standard, quarterTones);
+        for (int note = 60; note < 72; note++)
+        {
+            auto pitch = sharedTuner.getMidiPitch(1, note);
+            auto expected = tuner.getMidiPitch(1, note);
+            expect_exact(expected.coarse, pitch.coarse, "Tuner note " + juce::String(note));
+            expect_exact(expected.pitchbend, pitch.pitchbend, "Tuner pitchbend " + juce::String(note));
+        }
+
+        client.removeListener(&listener);
+    }
+
+    void tornReadTest()
+    {
+        beginTest("Reads retry while the master writes");
+
+        auto lower = equalTuning(12, "Lower tuning with a long name to write");
+        auto upper = equalTuning(24, "Upper");
+
+        SharedTuningSegment master(segmentName, SharedTuningSegment::Access::Publish);
+        master.publish(*lower);
+
+        SharedTuningSegment reader(segmentName, SharedTuningSegment::Access::Read);
+
+        std::atomic<bool> writing { true };
+        std::thread writer([&]()
+        {
+            for (int i = 0; i < 20000; i++)
+                master.publish((i & 1) ? *upper : *lower);
+            writing = false;
+        });
+
+        int numReads = 0;
+        int numTorn = 0;
+        while (writing)
+        {
+            juce::String name;
+            juce::uint32 sequence;
+            if (reader.readName(name, sequence))
+            {
+                numReads++;
+                if ((sequence & 1) || (name != lower->getTuning()->getName() && name != upper->getTuning()->getName()))
+                    numTorn++;
+            }
+
+            double mts;
+            if (reader.readMts(70, 1, mts))
+            {
+                numReads++;
+                if (mts != lower->mtsAt(70, 1) && mts != upper->mtsAt(70, 1))
+                    numTorn++;
+            }
+        }
+
+        writer.join();
+
+        expect(numReads > 0, "Read while writing");
+        expect_exact(0, numTorn, "Torn reads");
+
+        juce::String name;
+        juce::uint32 sequence;
+        expect(reader.readName(name, sequence), "Read after writing");
+        expect_exact(upper->getTuning()->getName(), name, "Last published name");
+    }
+};
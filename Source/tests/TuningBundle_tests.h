@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    TuningBundle_tests.h
+    Created: 21 Oct 2026 10:04:37am
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/TuningBundle.h"
+
+class TuningBundle_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    std::shared_ptr<TuningTable> tableTuning;
+    std::shared_ptr<FunctionalTuning> functionalTuning;
+    std::shared_ptr<TuningTableMap> mapping;
+
+    // Bundles opened from memory need 64-byte aligned storage
+    std::unique_ptr<TuningTableMap::BaseTable[]> alignedCopy(const juce::MemoryBlock& block)
+    {
+        auto numTables = (block.getSize() + sizeof(TuningTableMap::BaseTable) - 1) / sizeof(TuningTableMap::BaseTable);
+        std::unique_ptr<TuningTableMap::BaseTable[]> storage(new TuningTableMap::BaseTable[numTables]);
+        std::memcpy(storage.get(), block.getData(), block.getSize());
+        return storage;
+    }
+
+    bool pointsInto(const void* pointer, const void* start, size_t size)
+    {
+        auto address = static_cast<const char*>(pointer);
+        auto begin = static_cast<const char*>(start);
+        return address >= begin && address < begin + size;
+    }
+
+    TuningBundle::Builder makeBuilder()
+    {
+        TuningBundle::Builder builder;
+        builder.addTuning(tableTuning, mapping);
+        builder.addTuning(functionalTuning);
+        return builder;
+    }
+
+public:
+
+    TuningBundle_Test() : EverytoneTunerUnitTest("TuningBundle") {};
+
+    void runTest() override
+    {
+        setupTunings();
+
+        memoryTest();
+        fileTest();
+        invalidTest();
+    }
+
+private:
+
+    void setupTunings()
+    {
+        juce::Array<double> frequencies;
+        for (int i = 0; i < 128; i++)
+            frequencies.add(440.0 * std::pow(2.0, (i - 69) / 17.0));
+
+        TuningTable::Definition definition;
+        definition.frequencies = frequencies;
+        definition.rootIndex = 69;
+        definition.name = "Table";
+        definition.description = "17-edo as a frequency table";
+        definition.periodString = "2/1";
+        definition.virtualPeriod = 1200.0;
+        definition.virtualSize = 17;
+        tableTuning = std::make_shared<TuningTable>(definition);
+
+        CentsDefinition centsDefinition;
+        centsDefinition.intervalCents = { 203.91, 386.31, 701.955, 884.36, 1200.0 };
+        centsDefinition.rootFrequency = 261.6255653;
+        centsDefinition.name = "Functional";
+        centsDefinition.description = "5-note just scale";
+        functionalTuning = std::make_shared<FunctionalTuning>(centsDefinition);
+
+        mapping = std::make_shared<TuningTableMap>(TuningTableMap::StandardMappingDefinition());
+    }
+
+    void expectSameTuning(const TuningTable* expected, const TuningTable* loaded, juce::String message)
+    {
+        expect_exact(expected->getName(), loaded->getName(), message + " name");
+        expect_exact(expected->getDescription(), loaded->getDescription(), message + " description");
+        expect_exact(expected->getRootIndex(), loaded->getRootIndex(), message + " root index");
+        expect_exact(expected->getTableSize(), loaded->getTableSize(), message + " table size");
+        expect_equals(expected->getRootFrequency(), loaded->getRootFrequency(), message + " root frequency");
+
+        for (int i = 0; i < expected->getTableSize(); i++)
+        {
+            expect_equals(expected->frequencyAt(i), loaded->frequencyAt(i), message + " frequency " + juce::String(i));
+            expect_equals(expected->mtsAt(i), loaded->mtsAt(i), message + " MTS " + juce::String(i));
+        }
+    }
+
+    void memoryTest()
+    {
+        beginTest("Build and read from memory");
+
+        auto block = makeBuilder().build();
+        auto storage = alignedCopy(block);
+
+        TuningBundle bundle;
+        expect(bundle.openFromMemory(storage.get(), block.getSize()), "Bundle opened");
+        expect_exact(2, bundle.getNumTunings(), "Number of tunings");
+
+        // Sorted by name
+        expect_exact(juce::String("Functional"), bundle.getName(0), "First name");
+        expect_exact(juce::String("Table"), bundle.getName(1), "Second name");
+        expect_exact(1, bundle.indexOf("Table"), "Found by name");
+        expect_exact(-1, bundle.indexOf("Missing"), "Missing name");
+
+        auto table = bundle.loadPreset(bundle.indexOf("Table"));
+        expectSameTuning(tableTuning.get(), table.tuning.get(), "Table");
+        expect_exact(juce::String("2/1"), table.tuning->getPeriodString(), "Period string");
+
+        // Zero-copy: tables are read in place
+        expect(pointsInto(table.tuning->getFrequencyTableView().data(), storage.get(), block.getSize()), "Frequencies read in place");
+        expect(pointsInto(table.tuning->getMtsTableView().data(), storage.get(), block.getSize()), "MTS read in place");
+        expect(pointsInto(table.mapping->getBaseTable().get(), storage.get(), block.getSize()), "Map table read in place");
+
+        for (int index = 0; index < 2048; index++)
+            expect_exact(mapping->tableAt(index), table.mapping->tableAt(index), "Map entry " + juce::String(index));
+
+        auto functional = bundle.loadPreset(bundle.indexOf("Functional"));
+        expect(functional.mapping == nullptr, "No mapping");
+        expect(dynamic_cast<FunctionalTuning*>(functional.tuning.get()) != nullptr, "Cents-based entry is functional");
+        expectSameTuning(functionalTuning.get(), functional.tuning.get(), "Functional");
+        expect(pointsInto(functional.tuning->getFrequencyTableView().data(), storage.get(), block.getSize()), "Functional tables read in place");
+
+        // Changing a loaded tuning copies its tables out of the bundle
+        auto copy = std::make_shared<TuningTable>(*table.tuning);
+        copy->setRootFrequency(450.0);
+        expect(!pointsInto(copy->getFrequencyTableView().data(), storage.get(), block.getSize()), "Changed tuning owns its tables");
+        expect_equals(tableTuning->frequencyAt(0), bundle.getFrequencyTableView(1)[0], "Bundle unchanged");
+    }
+
+    void fileTest()
+    {
+        beginTest("Write and map a file");
+
+        auto file = juce::File::createTempFile(".evtb");
+        expect(makeBuilder().writeToFile(file), "Bundle written");
+
+        TuningBundle::Preset preset;
+        {
+            TuningBundle bundle;
+            expect(bundle.open(file), "Bundle mapped");
+            expect_exact(2, bundle.getNumTunings(), "Number of tunings");
+            preset = bundle.loadPreset(bundle.indexOf("Table"));
+        }
+
+        // The preset keeps the file mapped after the bundle is closed
+        expectSameTuning(tableTuning.get(), preset.tuning.get(), "Mapped table");
+        expect_exact(mapping->tableAt(midiIndex(0, 60)), preset.mapping->tableAt(midiIndex(0, 60)), "Mapped map table");
+
+        preset = TuningBundle::Preset();
+        file.deleteFile();
+    }
+
+    void invalidTest()
+    {
+        beginTest("Invalid bundles");
+
+        auto block = makeBuilder().build();
+
+        TuningBundle bundle;
+
+        auto truncated = alignedCopy(block);
+        expect(!bundle.openFromMemory(truncated.get(), block.getSize() - 8), "Truncated bundle rejected");
+        expect(!bundle.isOpen(), "Not open");
+
+        auto badMagic = alignedCopy(block);
+        reinterpret_cast<TuningBundle::Header*>(badMagic.get())->magic = 0;
+        expect(!bundle.openFromMemory(badMagic.get(), block.getSize()), "Wrong magic rejected");
+
+        auto badRecord = alignedCopy(block);
+        auto header = reinterpret_cast<TuningBundle::Header*>(badRecord.get());
+        auto records = reinterpret_cast<TuningBundle::Record*>(reinterpret_cast<char*>(badRecord.get()) + header->recordsOffset);
+        records[1].frequenciesOffset = header->fileSize;
+        expect(!bundle.openFromMemory(badRecord.get(), block.getSize()), "Out of bounds table rejected");
+
+        auto valid = alignedCopy(block);
+        expect(bundle.openFromMemory(valid.get(), block.getSize()), "Valid bundle opened");
+    }
+};
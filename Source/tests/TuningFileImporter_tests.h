@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    TuningFileImporter_tests.h
+    Created: 20 Oct 2026 3:12:48pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/TuningFileImporter.h"
+
+class TuningFileImporter_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Deleted when the test goes out of scope
+    struct TestFile
+    {
+        juce::File file;
+
+        TestFile(juce::String extension, juce::String text)
+            : file(juce::File::createTempFile(extension))
+        {
+            file.replaceWithText(text);
+        }
+
+        ~TestFile() { file.deleteFile(); }
+    };
+
+    juce::String scalaText()
+    {
+        return "! test.scl\n"
+               "!\n"
+               "Five note just scale\n"
+               " 5\n"
+               "!\n"
+               " 9/8\n"
+               " 5/4\n"
+               " 701.955\n"
+               " 5/3\n"
+               " 2/1\n";
+    }
+
+    // One line per note, so there are plenty of lines to cancel between
+    juce::String tunText()
+    {
+        juce::String text = "[Scale Begin]\n"
+                            "Format = \"AnaMark-TUN\"\n"
+                            "FormatVersion = 200\n"
+                            "\n"
+                            "[Info]\n"
+                            "Name = \"Test\"\n"
+                            "\n"
+                            "[Exact Tuning]\n"
+                            "BaseFreq = 8.1757989156437073336\n";
+
+        for (int note = 0; note < 128; note++)
+            text += "note " + juce::String(note) + " = " + juce::String(note * 100.0 + 10.0) + "\n";
+
+        return text + "\n[Scale End]\n";
+    }
+
+    TuningFileImporter::Request request(juce::File file)
+    {
+        TuningFileImporter::Request request;
+        request.file = file;
+        request.source = MappedTuningTable::StandardTuning();
+        return request;
+    }
+
+public:
+
+    TuningFileImporter_Test() : EverytoneTunerUnitTest("TuningFileImporter") {};
+
+    void runTest() override
+    {
+        successTest();
+        failureTest();
+        cancelTest();
+    }
+
+private:
+
+    void successTest()
+    {
+        beginTest("Import succeeds");
+
+        TestFile scala(".scl", scalaText());
+
+        juce::Array<float> progress;
+        auto result = TuningFileImporter::import(request(scala.file), [&](float value)
+        {
+            progress.add(value);
+            return true;
+        });
+
+        expect(result.wasSuccessful(), "Scale imported: " + result.parsed.error);
+        expect(!result.wasCancelled, "Not cancelled");
+        expect_equals(5.0, result.parsed.tuning->getVirtualSize(), "Scale size");
+        expect(result.mapping != nullptr, "Mapping built");
+        expect(result.tuner != nullptr, "Tuner built");
+        expect(result.tuner->mappedTarget() == result.target.get(), "Tuner plays the target");
+
+        expect(progress.size() > 3, "Progress reported while parsing");
+        expect_equals(1.0f, progress.getLast(), "Progress finished");
+        for (int i = 1; i < progress.size(); i++)
+            expect(progress[i] >= progress[i - 1], "Progress never goes back");
+
+        TestFile tun(".tun", tunText());
+        result = TuningFileImporter::import(request(tun.file));
+        expect(result.wasSuccessful(), "Tun file imported: " + result.parsed.error);
+        expect(result.tuner != nullptr, "Tuner built");
+
+        auto noRequestSource = request(tun.file);
+        noRequestSource.source = nullptr;
+        result = TuningFileImporter::import(noRequestSource);
+        expect(result.wasSuccessful(), "Imported without a source");
+        expect(result.tuner == nullptr, "Tuner needs a source");
+    }
+
+    void failureTest()
+    {
+        beginTest("Import fails");
+
+        TestFile malformed(".scl", "! bad.scl\nDescription\n3\n100.0\n200.0\n");
+        auto result = TuningFileImporter::import(request(malformed.file));
+        expect(!result.wasSuccessful(), "Malformed scale not imported");
+        expect(!result.wasCancelled, "Failed, not cancelled");
+        expect(result.parsed.error.isNotEmpty(), "Error reported");
+        expect(result.tuner == nullptr, "No tuner");
+
+        TestFile unsupported(".txt", scalaText());
+        result = TuningFileImporter::import(request(unsupported.file));
+        expect(!result.wasSuccessful(), "Unsupported file type not imported");
+        expect(result.parsed.error.startsWith("Unsupported"), "Unsupported file type reported");
+
+        TestFile scala(".scl", scalaText());
+        TestFile keyboardMapping(".kbm", "12\n0\n127\n");
+        auto mappingRequest = request(scala.file);
+        mappingRequest.keyboardMappingFile = keyboardMapping.file;
+        result = TuningFileImporter::import(mappingRequest);
+        expect(!result.wasSuccessful(), "Malformed keyboard mapping fails the import");
+        expect(result.parsed.error.isNotEmpty(), "Keyboard mapping error reported");
+    }
+
+    void cancelTest()
+    {
+        beginTest("Import cancelled");
+
+        TestFile tun(".tun", tunText());
+
+        // Cancel part way through parsing
+        int numCalls = 0;
+        auto result = TuningFileImporter::import(request(tun.file), [&](float progress)
+        {
+            numCalls++;
+            return progress < 0.25f;
+        });
+
+        expect(result.wasCancelled, "Cancelled while parsing");
+        expect(!result.wasSuccessful(), "Cancelled import is not successful");
+        expect(result.parsed.tuning == nullptr, "No tuning");
+        expect(result.tuner == nullptr, "No tuner");
+        expect(numCalls > 2, "Parsing stopped between lines");
+
+        // Cancel once the file is parsed
+        TestFile scala(".scl", scalaText());
+        result = TuningFileImporter::import(request(scala.file), [&](float progress)
+        {
+            return progress < 0.5f;
+        });
+
+        expect(result.wasCancelled, "Cancelled after parsing");
+        expect(result.tuner == nullptr, "No tuner");
+
+        // Cancel before starting
+        result = TuningFileImporter::import(request(scala.file), [&](float progress) { return false; });
+        expect(result.wasCancelled, "Cancelled before parsing");
+        expect(result.parsed.tuning == nullptr, "Nothing parsed");
+    }
+};
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    TuningFileParser_tests.h
+    Created: 21 Oct 2026 3:17:45pm
+    Author:  Vincenzo
+
+    Imports .tun files laid out as Scala and AnaMark export them, and checks
+    that every MIDI note plays the frequency TUN::CSingleScale reads from the file.
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/TuningFileParser.h"
+
+class TuningFileParser_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Deleted when the test goes out of scope
+    struct TestFile
+    {
+        juce::File file;
+
+        TestFile(juce::String extension, juce::String text)
+            : file(juce::File::createTempFile(extension))
+        {
+            file.replaceWithText(text);
+        }
+
+        ~TestFile() { file.deleteFile(); }
+    };
+
+    struct TunFile
+    {
+        juce::String name;
+        juce::String text;
+        int patternSize;        /* Expected size of the FunctionalTuning, or 0 if imported as a table */
+    };
+
+    static constexpr double scalaBaseFrequency = 8.1757989156;
+
+    juce::String scalaHeader(juce::String name)
+    {
+        return ";\n"
+               "; AnaMark tuning map file\n"
+               "; Created by Scala\n"
+               ";\n"
+               "[Scale Begin]\n"
+               "Format= \"AnaMark-TUN\"\n"
+               "FormatVersion= 200\n"
+               "FormatSpecs= \"http://www.mark-henning.de/eternity/tuningspecs.html\"\n"
+               "\n"
+               "[Info]\n"
+               "Name= \"" + name + "\"\n"
+               "Filename= \"" + name + "\"\n"
+               "Date= \"2026-10-21\"\n"
+               "\n";
+    }
+
+    // As written by Scala, with cents of each note above the base frequency
+    juce::String scalaExport(juce::String name, std::function<double(int)> centsOfNote, bool exactTuning = true)
+    {
+        auto text = scalaHeader(name);
+
+        text += "[Tuning]\n";
+        for (int note = 0; note < 128; note++)
+            text += "note " + juce::String(note) + "= " + juce::String(juce::roundToInt(centsOfNote(note))) + "\n";
+
+        if (exactTuning)
+        {
+            text += "\n[Exact Tuning]\n"
+                    "BaseFreq= " + juce::String(scalaBaseFrequency, 10) + "\n";
+            for (int note = 0; note < 128; note++)
+                text += "note " + juce::String(note) + "= " + juce::String(centsOfNote(note), 6) + "\n";
+        }
+
+        return text + "\n[Scale End]\n";
+    }
+
+    // Cents above the base frequency of a pattern repeated from a root note
+    std::function<double(int)> patternCents(juce::Array<double> stepCents, int rootNote, double rootCents)
+    {
+        return [=](int note)
+        {
+            int size = stepCents.size();
+            int offset = note - rootNote;
+            int repetitions = (int)std::floor((double)offset / size);
+            int degree = offset - repetitions * size;
+
+            double cents = rootCents;
+            for (int i = 0; i < degree; i++)
+                cents += stepCents[i];
+
+            double period = 0;
+            for (auto step : stepCents)
+                period += step;
+
+            return cents + repetitions * period;
+        };
+    }
+
+    juce::Array<TunFile> corpus()
+    {
+        juce::Array<TunFile> files;
+
+        files.add({ "12-edo", scalaExport("12-edo", [](int note) { return note * 100.0; }), 1 });
+
+        auto nineteen = juce::Array<double> { 1200.0 / 19 };
+        files.add({ "19-edo", scalaExport("19-edo", patternCents(nineteen, 69, 6900.0)), 1 });
+
+        auto thirtyOne = juce::Array<double> { 1200.0 / 31 };
+        files.add({ "31-edo", scalaExport("31-edo", patternCents(thirtyOne, 60, 6000.0)), 1 });
+
+        // Quarter-comma meantone from Eb to G#
+        double fifth = 696.578428;
+        double chromatic = 7 * fifth - 4 * 1200.0;
+        double diatonic = 3 * 1200.0 - 5 * fifth;
+        auto meantone = juce::Array<double> { chromatic, diatonic, diatonic, chromatic, diatonic, chromatic,
+                                              diatonic, chromatic, diatonic, diatonic, chromatic, diatonic };
+        files.add({ "meantone-12", scalaExport("meantone-12", patternCents(meantone, 60, 6000.0)), 12 });
+
+        // Porcupine[15] in 22-edo, seven large and eight small steps
+        double small = 1200.0 / 22, large = 2 * small;
+        auto porcupine = juce::Array<double> { small, large, small, large, small, large, small, large,
+                                               small, large, small, large, small, large, small };
+        files.add({ "porcupine-15", scalaExport("porcupine-15", patternCents(porcupine, 60, 6000.0)), 15 });
+
+        // Thirteen steps of the tritave reach past the MTS range, so the notes stay in a table
+        auto bohlenPierce = juce::Array<double> { ratioToCents(3.0) / 13 };
+        files.add({ "bohlen-pierce", scalaExport("bohlen-pierce", patternCents(bohlenPierce, 69, 6900.0)), 0 });
+
+        files.add({ "harmonics", scalaExport("harmonics", [](int note) { return ratioToCents(note + 1.0); }), 0 });
+
+        // Version 0 files only have whole cents, so the rounded steps are the pattern
+        files.add({ "19-edo whole cents", scalaExport("19-edo whole cents", patternCents(nineteen, 69, 6900.0), false), 19 });
+
+        // AnaMark version 2 formulas, based on middle C instead of A
+        juce::String functional = "[Scale Begin]\n"
+                                  "Format = \"AnaMark-TUN\"\n"
+                                  "FormatVersion = 200\n"
+                                  "\n"
+                                  "[Info]\n"
+                                  "Name = \"17-edo formulas\"\n"
+                                  "\n"
+                                  "[Functional Tuning]\n"
+                                  "InitEqual = (60, 261.6255653)\n"
+                                  "note 61 = \"#>-1%70.588235294~999\"\n"
+                                  "note 59 = \"#>1%-70.588235294~-999\"\n"
+                                  "\n"
+                                  "[Scale End]\n";
+        files.add({ "17-edo formulas", functional, 1 });
+
+        return files;
+    }
+
+public:
+
+    TuningFileParser_Test() : EverytoneTunerUnitTest("TuningFileParser") {};
+
+    void runTest() override
+    {
+        tunCorpusTest();
+    }
+
+private:
+
+    void tunCorpusTest()
+    {
+        beginTest("TUN corpus");
+
+        for (auto tunFile : corpus())
+        {
+            auto name = tunFile.name;
+            TestFile tun(".tun", tunFile.text);
+
+            TUN::CSingleScale scale;
+            expect(scale.Read(tun.file.getFullPathName().toRawUTF8()) > 0, name + " read: " + juce::String(scale.Err().GetLastError()));
+            int baseNote = (int)scale.GetBaseNote();
+
+            auto parsed = TuningFileParser::parseFile(tun.file);
+            expect(parsed.wasSuccessful(), name + " imported: " + parsed.error);
+            if (!parsed.wasSuccessful())
+                continue;
+
+            auto tuning = parsed.tuning;
+            expect_exact(name, tuning->getName(), name + " name");
+
+            auto functional = std::dynamic_pointer_cast<FunctionalTuning>(tuning);
+            if (tunFile.patternSize == 0)
+            {
+                expect(functional == nullptr, name + " imported as a table");
+                expect_exact(baseNote, tuning->getRootIndex(), name + " table root is the base note");
+            }
+            else
+            {
+                expect(functional != nullptr, name + " imported as a functional tuning");
+                if (functional != nullptr)
+                    expect_exact(tunFile.patternSize, functional->getTuningSize(), name + " pattern size");
+            }
+
+            // Indices are relative to the root, and mappings rooted at the base note play the file's notes
+            auto mapping = MappedTuningTable::LinearMappingFromTuning(tuning.get(), TuningTableMap::Root { 1, baseNote });
+            MappedTuningTable mappedTuning(tuning, mapping);
+
+            for (int note = 0; note < 128; note++)
+            {
+                auto expected = scale.GetMIDINoteFreqHz(note);
+                auto noteName = name + " note " + juce::String(note);
+
+                auto index = tuning->getRootIndex() + note - baseNote;
+                expect(index >= 0 && index < tuning->getTableSize(), noteName + " inside of the table");
+                expect(std::abs(ratioToCents(tuning->frequencyAt(index) / expected)) < 0.01, noteName + " frequency by index");
+                expect(std::abs(ratioToCents(mappedTuning.frequencyAt(note, 1) / expected)) < 0.01, noteName + " mapped frequency");
+            }
+        }
+    }
+};
@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+
+    TuningFileWriter_tests.h
+    Created: 21 Oct 2026 2:08:33pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../io/TuningFileWriter.h"
+#include "../io/TuningFileParser.h"
+
+class TuningFileWriter_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    // Deleted when the test goes out of scope
+    struct TestFile
+    {
+        juce::File file;
+
+        TestFile(juce::String extension) : file(juce::File::createTempFile(extension)) {}
+
+        ~TestFile() { file.deleteFile(); }
+    };
+
+    std::shared_ptr<FunctionalTuning> justTuning()
+    {
+        CentsDefinition definition;
+        definition.intervalCents = { 203.91000173, 386.31371386, 498.04499913, 701.95500087, 884.35871299, 1088.26871473, 1200.0 };
+        definition.rootFrequency = 261.6255653;
+        definition.name = "Just major";
+        definition.description = "Ptolemy's intense diatonic";
+        return std::make_shared<FunctionalTuning>(definition);
+    }
+
+    // An equal division as a plain frequency table, with its size known
+    std::shared_ptr<TuningTable> equalTable(int divisions, int tableSize, int rootIndex)
+    {
+        TuningTable::Definition definition;
+        for (int i = 0; i < tableSize; i++)
+            definition.frequencies.add(440.0 * std::pow(2.0, (double)(i - rootIndex) / divisions));
+
+        definition.rootIndex = rootIndex;
+        definition.name = juce::String(divisions) + "-edo table";
+        definition.virtualPeriod = 1200.0;
+        definition.virtualSize = divisions;
+        return std::make_shared<TuningTable>(definition);
+    }
+
+    std::shared_ptr<MappedTuningTable> standardMapped(std::shared_ptr<TuningTable> tuning)
+    {
+        auto mapping = MappedTuningTable::LinearMappingFromTuning(tuning.get(), TuningTableMap::Root { 1, 60 });
+        return std::make_shared<MappedTuningTable>(tuning, mapping);
+    }
+
+public:
+
+    TuningFileWriter_Test() : EverytoneTunerUnitTest("TuningFileWriter") {};
+
+    void runTest() override
+    {
+        scaleCentsTest();
+        scalaRoundTripTest();
+        tunRoundTripTest();
+    }
+
+private:
+
+    void scaleCentsTest()
+    {
+        beginTest("Scale cents stay inside the table");
+
+        // The root is near the top, so most of the period is above the end of the table
+        auto nearTop = equalTable(17, 128, 120);
+        auto cents = TuningFileWriter::scaleCents(*nearTop);
+        expect_exact(17, cents.size(), "Whole period written");
+        for (int i = 0; i < cents.size(); i++)
+            expect_equals((i + 1) * 1200.0 / 17, cents[i], "Degree " + juce::String(i + 1) + " above the end of the table");
+
+        // Not enough below the root to reach a period lower either
+        auto shortTable = equalTable(12, 10, 2);
+        cents = TuningFileWriter::scaleCents(*shortTable);
+        expect_exact(7, cents.size(), "Clamped to the table above the root");
+        expect_equals(700.0, cents.getLast(), "Last degree of the table");
+
+        expect(TuningFileWriter::scaleCents(*equalTable(31, 3, 2)).isEmpty(), "Nothing above the root");
+
+        TestFile scl(".scl");
+        TuningFileWriter writer;
+        juce::String error;
+        expect(!writer.exportFile({ standardMapped(equalTable(31, 3, 2)), scl.file }, error), "Empty scale not exported");
+        expect(error.isNotEmpty(), "Empty scale error");
+    }
+
+    void scalaRoundTripTest()
+    {
+        beginTest("Scala round trip");
+
+        TuningFileWriter writer;
+
+        auto tuning = justTuning();
+        auto text = writer.formatScala(*tuning);
+
+        ScalaBufferParser::Scale scale;
+        juce::String error;
+        expect(ScalaBufferParser::parseScale(text, scale, error), "Written scale parsed: " + error);
+        expect_exact(tuning->getDescription(), scale.description, "Description");
+
+        auto intervals = tuning->getIntervalCentsList();
+        expect_exact(intervals.size(), scale.intervalCents.size(), "Size");
+        for (int i = 0; i < intervals.size(); i++)
+            expect(intervals[i] == scale.intervalCents[i], "Interval " + juce::String(i) + " reads back exactly");
+
+        // Through a file and the importer
+        TestFile scl(".scl");
+        expect(writer.exportFile({ standardMapped(tuning), scl.file }, error), "Exported: " + error);
+
+        auto parsed = TuningFileParser::parseFile(scl.file);
+        expect(parsed.wasSuccessful(), "Exported scale imported: " + parsed.error);
+
+        auto functional = std::dynamic_pointer_cast<FunctionalTuning>(parsed.tuning);
+        expect(functional != nullptr, "Imported as a functional tuning");
+        expect(functional->getIntervalCentsList() == intervals, "Imported intervals");
+
+        // A table written a period past its end reads back as the equal division
+        auto table = equalTable(17, 128, 120);
+        text = writer.formatScala(*table);
+        expect(ScalaBufferParser::parseScale(text, scale, error), "Written table parsed: " + error);
+        expect_exact(17, scale.intervalCents.size(), "Table size");
+        for (int i = 0; i < scale.intervalCents.size(); i++)
+            expect_equals((i + 1) * 1200.0 / 17, scale.intervalCents[i], "Table degree " + juce::String(i + 1));
+    }
+
+    void tunRoundTripTest()
+    {
+        beginTest("TUN round trip");
+
+        TuningFileWriter writer;
+
+        juce::Array<std::shared_ptr<MappedTuningTable>> tunings =
+        {
+            standardMapped(justTuning()),
+            standardMapped(equalTable(17, 128, 69)),
+            std::shared_ptr<MappedTuningTable>(MappedTuningTable::StandardTuning())
+        };
+
+        for (auto mappedTuning : tunings)
+        {
+            auto name = mappedTuning->getTuning()->getName();
+
+            TestFile tun(".tun");
+            juce::String error;
+            expect(writer.exportFile({ mappedTuning, tun.file }, error), name + " exported: " + error);
+
+            TUN::CSingleScale scale;
+            expect(scale.Read(tun.file.getFullPathName().toRawUTF8()) > 0, name + " read: " + juce::String(scale.Err().GetLastError()));
+            expect_exact(name, juce::String(scale.m_strName), name + " name");
+
+            for (int note = 0; note < 128; note++)
+            {
+                auto expected = mappedTuning->frequencyAt(note, 1);
+                auto actual = scale.GetMIDINoteFreqHz(note);
+                expect_equals(0.0, ratioToCents(actual / expected), name + " note " + juce::String(note) + " in cents");
+            }
+
+            auto parsed = TuningFileParser::parseFile(tun.file);
+            expect(parsed.wasSuccessful(), name + " imported: " + parsed.error);
+        }
+    }
+};
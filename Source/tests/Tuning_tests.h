@@ -11,6 +11,7 @@
 #pragma once
 #include "TestsCommon.h"
 #include "../tuning/FunctionalTuning.h"
+#include <thread>
 
 class FunctionalTuning_Test : public EverytoneTunerUnitTest
 {
@@ -49,6 +50,40 @@ private:
         }
     }
 
+    void test_table_view(const FunctionalTuning* tuning, int expectedTuningSize, const double* expectedCents, int expectedTableSize)
+    {
+        auto centsView = tuning->getIntervalCentsView();
+        expect_exact(expectedTuningSize, centsView.size(), "getIntervalCentsView().size()");
+        for (int i = 0; i < centsView.size(); i++)
+            expect_equals(expectedCents[i], centsView[i], "getIntervalCentsView() at " + juce::String(i));
+
+        auto tail = centsView.subview(1, centsView.size());
+        expect_exact(juce::jmax(0, centsView.size() - 1), tail.size(), "subview() is clamped to the table");
+        if (tail.size() > 0)
+            expect_equals(centsView[1], tail[0], "subview() starts at its offset");
+
+        auto frequencyView = tuning->getFrequencyTableView();
+        auto mtsView = tuning->getMtsTableView();
+
+        if (!tuning->hasCachedTables())
+        {
+            expect(frequencyView.isEmpty(), "getFrequencyTableView() should be empty without cached tables");
+            expect(mtsView.isEmpty(), "getMtsTableView() should be empty without cached tables");
+            return;
+        }
+
+        expect_exact(expectedTableSize, frequencyView.size(), "getFrequencyTableView().size()");
+        expect_exact(expectedTableSize, mtsView.size(), "getMtsTableView().size()");
+
+        auto frequencies = tuning->getFrequencyTable();
+        auto mts = tuning->getMtsTable();
+        for (int i = 0; i < expectedTableSize; i++)
+        {
+            expect_exact(frequencies[i], frequencyView[i], "getFrequencyTableView() at " + juce::String(i));
+            expect_exact(mts[i], mtsView[i], "getMtsTableView() at " + juce::String(i));
+        }
+    }
+
 public:
 
     struct GetAndSetParams
@@ -88,6 +123,8 @@ public:
         defaultTuningTest();
         test31edo();
         test34edoR1();
+        testLazyTables();
+        testExtractFromFrequencyTable();
     }
 
 private:
@@ -124,6 +161,8 @@ private:
         test_table(params.expectedTableSize, params.expectedFrequencyTable, tuning->getFrequencyTable(), "getFrequencyTable");
         test_table(params.expectedTableSize, params.expectedMtsTable, tuning->getMtsTable(), "getMtsTable()");
 
+        test_table_view(tuning, params.expectedTuningSize, params.expectedIntervalCentsTable, params.expectedTableSize);
+
         auto copied = FunctionalTuning(*tuning);
         expect(copied == *tuning, "Copied tuning failed with == operator");
 
@@ -400,4 +439,134 @@ private:
         tuning.cacheTables();
         doTests("34-edo with tables", params);
     }
+
+    void testLazyTables()
+    {
+        beginTest("Lazy tables for large tunings");
+
+        auto lazyTuning = FunctionalTuning(CentsDefinition::CentsDivisions(1000));
+        auto cachedTuning = FunctionalTuning(CentsDefinition::CentsDivisions(1000), true);
+
+        expect(!lazyTuning.hasCachedTables(), "Tuning without buildTables should not have cached tables");
+        expect_exact(cachedTuning.getTableSize(), lazyTuning.getTableSize(), "getTableSize()");
+
+        int tableSize = lazyTuning.getTableSize();
+        for (int i = 0; i < tableSize; i += 997)
+        {
+            auto frequency = lazyTuning.frequencyAt(i);
+            expect_equals(cachedTuning.frequencyAt(i), frequency, "frequencyAt(" + juce::String(i) + ")");
+            expect_exact(frequency, lazyTuning.frequencyAt(i), "frequencyAt(" + juce::String(i) + ") second read");
+
+            auto mts = lazyTuning.mtsAt(i);
+            expect_equals(cachedTuning.mtsAt(i), mts, "mtsAt(" + juce::String(i) + ")");
+            expect_exact(mts, lazyTuning.mtsAt(i), "mtsAt(" + juce::String(i) + ") second read");
+        }
+
+        auto copiedTuning = FunctionalTuning(lazyTuning);
+        expect_exact(lazyTuning.frequencyAt(997), copiedTuning.frequencyAt(997), "Copied frequencyAt(997)");
+
+        lazyTuning.setRootFrequency(256.0);
+        auto rerootedTuning = FunctionalTuning(CentsDefinition::CentsDivisions(1000, 1200.0, 256.0), true);
+        expect_exact(rerootedTuning.getRootIndex(), lazyTuning.getRootIndex(), "getRootIndex() after setRootFrequency()");
+        expect_equals(rerootedTuning.frequencyAt(997), lazyTuning.frequencyAt(997), "frequencyAt(997) after setRootFrequency()");
+        expect_equals(rerootedTuning.mtsAt(997), lazyTuning.mtsAt(997), "mtsAt(997) after setRootFrequency()");
+
+        // The audio thread keeps reading while the root changes, and then reads the last root
+        std::atomic<bool> reading { true };
+        std::thread reader([&]()
+        {
+            while (reading.load())
+                for (int i = 0; i < tableSize; i += 7)
+                    lazyTuning.mtsAt(i);
+        });
+
+        for (int change = 0; change < 200; change++)
+            lazyTuning.setRootFrequency((change % 2 == 0) ? 440.0 : 256.0);
+
+        reading = false;
+        reader.join();
+
+        for (int i = 0; i < tableSize; i += 97)
+            expect_equals(rerootedTuning.mtsAt(i), lazyTuning.mtsAt(i), "mtsAt(" + juce::String(i) + ") after concurrent reads");
+    }
+
+    // 128 note frequency table of a tuning, with the root at rootNote
+    juce::Array<double> frequencyTableOf(const CentsDefinition& definition, int rootNote)
+    {
+        auto tuning = FunctionalTuning(definition);
+        juce::Array<double> frequencies;
+        for (int note = 0; note < 128; note++)
+            frequencies.add(tuning.frequencyAt(tuning.getRootIndex() + note - rootNote));
+        return frequencies;
+    }
+
+    void test_extraction(juce::String name, const CentsDefinition& expected, int rootNote)
+    {
+        auto frequencies = frequencyTableOf(expected, rootNote);
+
+        CentsDefinition extracted;
+        auto found = CentsDefinition::ExtractFromFrequencyTable(frequencies, rootNote, extracted);
+        expect(found, name + " pattern was not found");
+        if (!found)
+            return;
+
+        expect_exact(expected.intervalCents.size(), extracted.intervalCents.size(), name + " size");
+        for (int i = 0; i < expected.intervalCents.size() && i < extracted.intervalCents.size(); i++)
+            expect_equals(expected.intervalCents[i], extracted.intervalCents[i], name + " interval " + juce::String(i));
+
+        expect_equals(expected.rootFrequency, extracted.rootFrequency, name + " root frequency");
+        // Only equal divisions of the octave can be recognized as such
+        if (expected.virtualPeriod == 1200.0)
+            expect_equals(expected.virtualSize, extracted.virtualSize, name + " virtual size");
+
+        auto extractedFrequencies = frequencyTableOf(extracted, rootNote);
+        for (int note = 0; note < 128; note++)
+            expect_equals(frequencies[note], extractedFrequencies[note], name + " frequency at " + juce::String(note));
+    }
+
+    void testExtractFromFrequencyTable()
+    {
+        beginTest("Extract tunings from frequency tables");
+
+        test_extraction("12-edo", CentsDefinition::CentsDivisions(12), 69);
+        test_extraction("31-edo", CentsDefinition::CentsDivisions(31, 1200.0, 261.6255653), 60);
+        test_extraction("13-ed3", CentsDefinition::RatioDivisions(13, 3.0), 0);
+        test_extraction("113-edo", CentsDefinition::CentsDivisions(113, 1200.0, 300.0), 127);
+
+        // Meantone 5L 2s and Pythagorean 5L 7s
+        CentsDefinition meantone = { { 193.157, 386.314, 503.422, 696.578, 889.735, 1082.892, 1200.0 }, 264.0 };
+        test_extraction("Meantone major", meantone, 60);
+
+        CentsDefinition pythagorean = { { 90.225, 203.91, 294.135, 407.82, 498.045, 611.73, 701.955, 792.18, 905.865, 996.09, 1109.775, 1200.0 } };
+        test_extraction("Pythagorean", pythagorean, 62);
+
+        // Tables from integer cents, as in the [Tuning] section of .tun files
+        juce::Array<double> roundedCents;
+        for (int note = 0; note < 128; note++)
+            roundedCents.add(440.0 * centsToRatio(std::round((note - 69) * 1200.0 / 31)));
+
+        // The rounded steps repeat exactly every period, and only a larger tolerance recovers the equal division
+        CentsDefinition extracted;
+        expect(CentsDefinition::ExtractFromFrequencyTable(roundedCents, 69, extracted), "Rounded 31-edo was not matched");
+        expect_exact(31, extracted.intervalCents.size(), "Rounded 31-edo size");
+        expect_equals(1200.0, extracted.intervalCents.getLast(), "Rounded 31-edo period");
+
+        expect(CentsDefinition::ExtractFromFrequencyTable(roundedCents, 69, extracted, 1.0), "Rounded 31-edo was not matched within a cent");
+        expect_exact(1, extracted.intervalCents.size(), "Rounded 31-edo size within a cent");
+        expect_equals(31.0, extracted.virtualSize, "Rounded 31-edo divisions within a cent");
+
+        // Tables without a pattern fall back to frequency tables
+        auto detuned = frequencyTableOf(CentsDefinition::CentsDivisions(12), 69);
+        detuned.set(100, detuned[100] * 1.01);
+        expect(!CentsDefinition::ExtractFromFrequencyTable(detuned, 69, extracted), "Detuned 12-edo matched");
+
+        juce::Array<double> harmonics;
+        for (int note = 0; note < 128; note++)
+            harmonics.add(55.0 * (note + 1));
+        expect(!CentsDefinition::ExtractFromFrequencyTable(harmonics, 0, extracted), "Harmonic series matched");
+
+        expect(!CentsDefinition::ExtractFromFrequencyTable({ 440.0 }, 0, extracted), "Single frequency matched");
+        expect(!CentsDefinition::ExtractFromFrequencyTable({ 220.0, 0.0, 440.0, 0.0 }, 0, extracted), "Table with zero frequencies matched");
+        expect(!CentsDefinition::ExtractFromFrequencyTable(harmonics, 128, extracted), "Root outside of the table matched");
+    }
 };
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    UmpEncoder_tests.h
+    Created: 19 Oct 2026 11:52:06pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "TestsCommon.h"
+#include "../UmpEncoder.h"
+
+class UmpEncoder_Test : public EverytoneTunerUnitTest
+{
+private:
+
+    void expect_packets(const juce::Array<juce::uint32>& expected, const juce::Array<juce::uint32>& packets, juce::String testName)
+    {
+        expect_exact(expected.size(), packets.size(), testName + " number of words");
+
+        for (int i = 0; i < juce::jmin(expected.size(), packets.size()); i++)
+            expect_exact((juce::int64)expected[i], (juce::int64)packets[i], testName + " word " + juce::String(i));
+    }
+
+    std::shared_ptr<MappedTuningTable> ode31Tuning()
+    {
+        auto ode31def = CentsDefinition::CentsDivisions(31.0, 1200.0, 440);
+        auto ode31at440 = std::make_shared<FunctionalTuning>(ode31def);
+
+        auto root = TuningTableMap::Root{ 1, 69 };
+        auto mapping = MappedTuningTable::PeriodicMappingFromTuning(ode31at440.get(), root);
+        return std::make_shared<MappedTuningTable>(ode31at440, mapping);
+    }
+
+public:
+
+    UmpEncoder_Test() : EverytoneTunerUnitTest("UmpEncoder") {};
+
+    void runTest() override
+    {
+        conversionTest();
+        noteAttributeTest();
+        perNotePitchbendTest();
+        retuneTest();
+        passThroughTest();
+        byteStreamTest();
+    }
+
+private:
+
+    void conversionTest()
+    {
+        beginTest("Conversions");
+
+        expect_exact(0, (int)UmpEncoder::scaleUp(0, 7, 16), "Velocity 0");
+        expect_exact(0x8000, (int)UmpEncoder::scaleUp(64, 7, 16), "Velocity 64");
+        expect_exact(0xffff, (int)UmpEncoder::scaleUp(127, 7, 16), "Velocity 127");
+        expect_exact(0x0200, (int)UmpEncoder::scaleUp(1, 7, 16), "Velocity 1");
+
+        expect_exact(60 * 512 + 256, (int)UmpEncoder::mtsToPitch7_9(60.5), "Pitch 60.5");
+        expect_exact(0, (int)UmpEncoder::mtsToPitch7_9(-3.0), "Pitch clipped down");
+        expect_exact(0xffff, (int)UmpEncoder::mtsToPitch7_9(130.0), "Pitch clipped up");
+        expect_equals(69.25, UmpEncoder::pitch7_9ToMts(UmpEncoder::mtsToPitch7_9(69.25)), "Pitch round trip");
+
+        expect_exact((juce::int64)0x80000000, (juce::int64)UmpEncoder::semitonesToPitchbend(0, 96), "Pitchbend center");
+        expect_exact((juce::int64)0xffffffff, (juce::int64)UmpEncoder::semitonesToPitchbend(48, 96), "Pitchbend max");
+        expect_exact((juce::int64)0, (juce::int64)UmpEncoder::semitonesToPitchbend(-60, 96), "Pitchbend clipped down");
+        expect_equals(0.387096, UmpEncoder::pitchbendToSemitones(UmpEncoder::semitonesToPitchbend(0.387096, 96), 96), "Pitchbend round trip");
+    }
+
+    void noteAttributeTest()
+    {
+        beginTest("Note-on with pitch attribute");
+
+        auto tuning = ode31Tuning();
+        UmpEncoder encoder(tuning);
+
+        juce::Array<juce::uint32> packets;
+        const juce::uint8 noteOn[] = { 0x90, 70, 100 };
+        expect(encoder.addMessage(noteOn, 3, packets), "Note-on added");
+
+        auto pitch = UmpEncoder::mtsToPitch7_9(69.0 + 12.0 / 31.0);
+        expect_packets({ 0x40904603, (UmpEncoder::scaleUp(100, 7, 16) << 16) | pitch }, packets, "Note-on");
+        expect(encoder.isSounding(1, 70), "Note is sounding");
+
+        // Velocity 0 is a release with the default velocity
+        packets.clearQuick();
+        const juce::uint8 noteOff[] = { 0x90, 70, 0 };
+        expect(encoder.addMessage(noteOff, 3, packets), "Note-off added");
+        expect_packets({ 0x40804600, 0x80000000 }, packets, "Note-off");
+        expect(!encoder.isSounding(1, 70), "Note is released");
+
+        // Releases of notes that aren't sounding are dropped
+        packets.clearQuick();
+        expect(!encoder.addMessage(noteOff, 3, packets), "Repeated note-off dropped");
+        expect_exact(0, packets.size(), "Repeated note-off");
+    }
+
+    void perNotePitchbendTest()
+    {
+        beginTest("Note-on with per-note pitchbend");
+
+        auto tuning = ode31Tuning();
+        UmpEncoder encoder(tuning, UmpEncoder::PitchMode::PerNotePitchbend);
+
+        juce::Array<juce::uint32> packets;
+        const juce::uint8 noteOn[] = { 0x90, 72, 127 };
+        expect(encoder.addMessage(noteOn, 3, packets), "Note-on added");
+
+        // Bent from the note number, three steps above the root are about three semitones below
+        auto bend = UmpEncoder::semitonesToPitchbend(tuning->mtsAt(72, 1) - 72.0, 96);
+        expect_equals(69.0 + 36.0 / 31.0 - 72.0, UmpEncoder::pitchbendToSemitones(bend, 96), "Per-note pitchbend");
+        expect_packets({ 0x40604800, bend, 0x40904800, 0xffff0000 }, packets, "Note-on");
+    }
+
+    void retuneTest()
+    {
+        beginTest("Retuning held notes");
+
+        std::shared_ptr<MappedTuningTable> standard = MappedTuningTable::StandardTuning();
+        UmpEncoder encoder(standard);
+
+        juce::Array<juce::uint32> packets;
+        const juce::uint8 noteOn[] = { 0x90, 70, 100 };
+        encoder.addMessage(noteOn, 3, packets);
+
+        packets.clearQuick();
+        auto ode31 = ode31Tuning();
+        encoder.setTuning(ode31, packets);
+
+        // Bent from the pitch it started with
+        auto bend = UmpEncoder::semitonesToPitchbend(ode31->mtsAt(70, 1) - 70.0, 96);
+        expect_packets({ 0x40604600, bend }, packets, "Retuned note");
+
+        // The next note-on of the same note clears its bend
+        const juce::uint8 noteOff[] = { 0x80, 70, 64 };
+        encoder.addMessage(noteOff, 3, packets);
+
+        packets.clearQuick();
+        encoder.addMessage(noteOn, 3, packets);
+        expect_exact(4, packets.size(), "Note-on after retune number of words");
+        expect_exact((juce::int64)UmpEncoder::pitchbendCenter, (juce::int64)packets[1], "Cleared bend");
+    }
+
+    void passThroughTest()
+    {
+        beginTest("Pass through");
+
+        UmpEncoder encoder(ode31Tuning(), UmpEncoder::PitchMode::NoteAttribute, 2);
+
+        juce::Array<juce::uint32> packets;
+        const juce::uint8 controller[] = { 0xb1, 74, 10 };
+        const juce::uint8 pressure[] = { 0xd1, 90 };
+        const juce::uint8 clock[] = { 0xf8 };
+        encoder.addMessage(controller, 3, packets);
+        encoder.addMessage(pressure, 2, packets);
+        encoder.addMessage(clock, 1, packets);
+        expect_packets({ 0x22b14a0a, 0x22d15a00, 0x12f80000 }, packets, "Channel and system messages");
+
+        packets.clearQuick();
+        const juce::uint8 sysEx[] = { 0xf0, 0x7e, 0x7f, 0x08, 0x02, 0x00, 0x01, 0x45, 0xf7 };
+        encoder.addMessage(sysEx, 9, packets);
+        expect_packets({ 0x32167e7f, 0x08020001, 0x32314500, 0x00000000 }, packets, "SysEx");
+
+        packets.clearQuick();
+        const juce::uint8 runningStatus[] = { 70, 100 };
+        expect(!encoder.addMessage(runningStatus, 2, packets), "Running status dropped");
+    }
+
+    void byteStreamTest()
+    {
+        beginTest("Byte stream");
+
+        const juce::Array<juce::uint32> packets = { 0x40904603, 0x12345678, 0x22b14a0a, 0x12f80000 };
+
+        juce::MemoryBlock bytes;
+        UmpEncoder::writeByteStream(packets.getRawDataPointer(), packets.size(), bytes);
+        expect_exact(16, (int)bytes.getSize(), "Stream size");
+
+        auto data = static_cast<const juce::uint8*>(bytes.getData());
+        expect_exact(0x40, (int)data[0], "Big endian first byte");
+        expect_exact(0x03, (int)data[3], "Big endian last byte");
+
+        juce::Array<juce::uint32> read;
+        expect(UmpEncoder::readByteStream(bytes.getData(), bytes.getSize(), read), "Stream read");
+        expect_packets(packets, read, "Round trip");
+
+        // A 64-bit packet without its second word
+        read.clearQuick();
+        expect(!UmpEncoder::readByteStream(bytes.getData(), 4, read), "Incomplete packet rejected");
+        expect(!UmpEncoder::readByteStream(bytes.getData(), 6, read), "Partial word rejected");
+        expect_exact(0, read.size(), "Nothing read from invalid streams");
+    }
+};
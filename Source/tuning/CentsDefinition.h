@@ -157,96 +157,105 @@ struct CentsDefinition
     }
 
 
-    // I think this should work alright when given a frequency table with an accurate root, but I'm having
-    // trouble getting this using an unmodified TUN library, so this is shelved for the moment.
-    //static CentsDefinition ExtractFromFrequencyTable(juce::Array<double> frequencyTable, int rootIndex)
-    //{
-    //    int maxSize = frequencyTable.size() - rootIndex;
-
-    //    if (maxSize <= 0)
-    //        return CentsDefinition({ 0 });
-
-
-    //    // I suspect there might be a better way to do this
-
-    //    juce::Array<double> centsSteps;
-    //    for (int i = 1; i < maxSize; i++)
-    //    {
-    //        int index = i + rootIndex;
-    //        auto ratio = frequencyTable[index] / frequencyTable[index - 1];
-    //        auto cents = roundN(6, ratioToCents(ratio));
-    //        centsSteps.add(cents);
-    //    }
-
-    //    // Test chunks of the cents steps pattern, with incrementing sizes
-    //    // And figure out at what size the pattern repeats
-
-    //    int successfulSize = 0;
-    //    for (int size = 1; size < centsSteps.size(); size++)
-    //    {
-    //        bool sizeFailed = false;
-    //        int numChunks = (centsSteps.size() / size);
-
-    //        juce::String chunkString;
-    //        for (int i = 0; i < size; i++)
-    //            chunkString += juce::String(centsSteps[i]) + ", ";
-    //        DBG("Testing chunk: " + chunkString);
-
-    //        for (int chunk = 0; chunk < numChunks; chunk++)
-    //        {
-    //            int chunkOffset = (size + 1) * chunk;
-
-    //            for (int index = 0; index < size; index++)
-    //            {
-    //                int testIndex = chunkOffset + index;
-    //                if (testIndex > centsSteps.size())
-    //                    break;
-
-    //                double chunkPattern = centsSteps[index];
-    //                double chunkTest = centsSteps[testIndex];
-    //                if (chunkPattern != chunkTest)
-    //                {
-    //                    sizeFailed = true;
-    //                    break;
-    //                }
-    //            }
-
-    //            if (sizeFailed)
-    //                break;
-    //        }
-
-    //        if (!sizeFailed)
-    //        {
-    //            successfulSize = size;
-    //            break;
-    //        }
-    //    }
-
-    //    if (successfulSize == 0)
-    //        return CentsDefinition({ 0 });
-
-    //    centsSteps.resize(successfulSize);
-    //    DBG("Selected: " + arrayToString(centsSteps.data(), centsSteps.size()));
-
-    //    juce::Array<double> centsScale(0);
-    //    for (int i = 0; i < successfulSize; i++)
-    //    {
-    //        auto interval = centsSteps[i] + centsScale[i - 1];
-    //        centsScale.add(interval);
-    //    }
-    //    centsScale.remove(0);
-
-    //    DBG("Scale: " + arrayToString(centsScale.data(), centsScale.size()));
-
-    //    CentsDefinition definition =
-    //    {
-    //        centsScale,
-    //        frequencyTable[rootIndex]
-    //    };
-
-    //    definition.virtualPeriod = centsSteps.getLast();
-    //    definition.virtualSize = successfulSize;
-
-    //    return definition;
-    //}
+    // Finds the smallest pattern of intervals that repeats over the whole frequency table, measured from the root.
+    // Each interval is averaged over every repetition of the pattern, and the result must reproduce every
+    // frequency in the table within the tolerance. Returns false if the table has no repeating pattern.
+    static bool ExtractFromFrequencyTable(const juce::Array<double>& frequencyTable, int rootIndex, CentsDefinition& definition, double toleranceCents = 0.01)
+    {
+        int tableSize = frequencyTable.size();
+        if (tableSize < 2 || rootIndex < 0 || rootIndex >= tableSize)
+            return false;
+
+        auto rootFrequency = frequencyTable[rootIndex];
+        if (rootFrequency <= 0)
+            return false;
+
+        juce::Array<double> cents;
+        for (auto frequency : frequencyTable)
+        {
+            if (frequency <= 0)
+                return false;
+
+            cents.add(ratioToCents(frequency / rootFrequency));
+        }
+
+        // A pattern needs to repeat at least once to be found
+        for (int size = 1; size * 2 <= tableSize; size++)
+        {
+            double periodSum = 0;
+            bool sizeFailed = false;
+
+            auto firstPeriod = cents[size] - cents[0];
+            for (int i = 0; i + size < tableSize; i++)
+            {
+                auto period = cents[i + size] - cents[i];
+                if (std::abs(period - firstPeriod) > toleranceCents * 2)
+                {
+                    sizeFailed = true;
+                    break;
+                }
+
+                periodSum += period;
+            }
+
+            if (sizeFailed)
+                continue;
+
+            auto period = periodSum / (tableSize - size);
+            if (period <= 0)
+                continue;
+
+            // Degree of the pattern and repetition of each index, relative to the root
+            auto degreeOf = [&](int index) { return modulo(index - rootIndex, size); };
+            auto repetitionOf = [&](int index) { return (index - rootIndex - degreeOf(index)) / size; };
+
+            juce::Array<double> degreeSums;
+            juce::Array<int> degreeCounts;
+            degreeSums.insertMultiple(0, 0.0, size);
+            degreeCounts.insertMultiple(0, 0, size);
+
+            for (int i = 0; i < tableSize; i++)
+            {
+                auto degree = degreeOf(i);
+                degreeSums.getReference(degree) += cents[i] - repetitionOf(i) * period;
+                degreeCounts.getReference(degree)++;
+            }
+
+            juce::Array<double> degreeCents;
+            for (int degree = 0; degree < size; degree++)
+                degreeCents.add(degreeSums[degree] / degreeCounts[degree]);
+
+            // The root is the unison, so its average only measures the offset of the other degrees
+            auto offset = degreeCents[0];
+
+            for (int i = 0; i < tableSize && !sizeFailed; i++)
+            {
+                auto expected = degreeCents[degreeOf(i)] - offset + repetitionOf(i) * period;
+                sizeFailed = std::abs(expected - cents[i]) > toleranceCents;
+            }
+
+            if (sizeFailed)
+                continue;
+
+            juce::Array<double> intervalCents;
+            for (int degree = 1; degree < size; degree++)
+                intervalCents.add(degreeCents[degree] - offset);
+            intervalCents.add(period);
+
+            definition.intervalCents = intervalCents;
+            definition.rootFrequency = rootFrequency;
+
+            // Equal divisions of the octave get the same period and size as CentsDivisions
+            auto divisions = std::round(1200.0 / period);
+            if (size == 1 && std::abs(divisions * period - 1200.0) <= toleranceCents)
+            {
+                definition.virtualPeriod = 1200.0;
+                definition.virtualSize = divisions;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
 };
@@ -11,7 +11,10 @@
 #include "FunctionalTuning.h"
 
 FunctionalTuning::FunctionalTuning(CentsDefinition definition, bool buildTables)
-    : TuningTable(setupEmptyTableDefinition(definition)) /* initialize without table size */
+    : TuningTable(setupEmptyTableDefinition(definition)), /* initialize without table size */
+      lazyTableSize(lazyTableSizeOf(definition, buildTables)),
+      lazyFrequencies(new LazyEntry[lazyTableSize]),
+      lazyMts(new LazyEntry[lazyTableSize])
 {
     setupCentsMap(definition.intervalCents);
     TuningTable::setRootFrequency(definition.rootFrequency);
@@ -19,26 +22,71 @@ FunctionalTuning::FunctionalTuning(CentsDefinition definition, bool buildTables)
     int tableSize;
     definition.calculateMtsRootAndTableSize(rootIndex, tableSize);
     setTableSize(tableSize);
+    publishLazyRoot();
 
     if (buildTables)
-    {
         cacheTables();
+}
+
+FunctionalTuning::FunctionalTuning(CentsDefinition definition, TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage)
+    : TuningTable(setupEmptyTableDefinition(definition)),
+      lazyTableSize(0),
+      lazyFrequencies(new LazyEntry[0]),
+      lazyMts(new LazyEntry[0])
+{
+    setupCentsMap(definition.intervalCents);
+    TuningTable::setRootFrequency(definition.rootFrequency);
+
+    int tableSize;
+    definition.calculateMtsRootAndTableSize(rootIndex, tableSize);
+    setTableSize(tableSize);
+    publishLazyRoot();
+
+    if (tableSize > 0 && frequencies.size() == tableSize && mts.size() == tableSize)
+    {
+        setTableWithViews(frequencies, mts, storage);
+        tablesAreBuilt.store(true, std::memory_order_release);
     }
+    else
+        cacheTables();
 }
 
 FunctionalTuning::FunctionalTuning(const FunctionalTuning& tuning)
     : TuningTable(static_cast<const TuningTable&>(tuning)),
       centsMap(tuning.centsMap),
-      tablesAreBuilt(tuning.tablesAreBuilt),
+      tablesAreBuilt(tuning.hasCachedTables()),
+      lazyTableSize(tuning.hasCachedTables() ? 0 : tuning.lazyTableSize),
+      lazyFrequencies(new LazyEntry[lazyTableSize]),
+      lazyMts(new LazyEntry[lazyTableSize]),
+      intervalCents(tuning.intervalCents),
       tuningSize(tuning.tuningSize),
       periodCents(tuning.periodCents),
       periodRatio(tuning.periodRatio)
 {
     setTableSize(tuning.getTableSize());
+    publishLazyRoot();
+
+    // Entries already calculated by the other tuning are valid in the first generation of this one
+    auto generation = tuning.lazyGeneration.load(std::memory_order_acquire);
+    auto copyEntries = [&](LazyEntry* entries, const LazyEntry* source)
+    {
+        for (int i = 0; i < lazyTableSize; i++)
+        {
+            if (source[i].generation.load(std::memory_order_acquire) == generation)
+            {
+                entries[i].value.store(source[i].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                entries[i].generation.store(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    copyEntries(lazyFrequencies.get(), tuning.lazyFrequencies.get());
+    copyEntries(lazyMts.get(), tuning.lazyMts.get());
 }
 
 void FunctionalTuning::setupCentsMap(const juce::Array<double>& cents)
 {
+    intervalCents = cents;
     tuningSize  = cents.size();
     periodCents = cents.getLast();
     periodRatio = centsToRatio(periodCents);
@@ -61,6 +109,92 @@ void FunctionalTuning::setupCentsMap(const juce::Array<double>& cents)
     centsMap = Map<double>(definition);
 }
 
+int FunctionalTuning::lazyTableSizeOf(const CentsDefinition& definition, bool buildTables)
+{
+    if (buildTables)
+        return 0;
+
+    int root, size;
+    definition.calculateMtsRootAndTableSize(root, size);
+    return juce::jmax(0, size);
+}
+
+void FunctionalTuning::publishLazyRoot()
+{
+    // Odd while writing
+    auto sequence = lazyRootSequence.load(std::memory_order_relaxed);
+    lazyRootSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    lazyRootFrequency.store(rootFrequency, std::memory_order_relaxed);
+    lazyRootIndex.store(rootIndex, std::memory_order_relaxed);
+
+    lazyRootSequence.store(sequence + 2, std::memory_order_release);
+}
+
+FunctionalTuning::LazyRoot FunctionalTuning::readLazyRoot() const
+{
+    // The writer only stores two values, so a read that overlaps it retries right away
+    LazyRoot root;
+    while (true)
+    {
+        auto sequence = lazyRootSequence.load(std::memory_order_acquire);
+        root.frequency = lazyRootFrequency.load(std::memory_order_relaxed);
+        root.index = lazyRootIndex.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if ((sequence & 1) == 0 && sequence == lazyRootSequence.load(std::memory_order_relaxed))
+            return root;
+    }
+}
+
+double FunctionalTuning::frequencyFromLazyRoot(const LazyRoot& root, int index) const
+{
+    return root.frequency * centsToRatio(centsMap.at(index - root.index));
+}
+
+void FunctionalTuning::invalidateLazyTables()
+{
+    // Entries never take the generation used while they're being written, nor the initial one
+    auto generation = lazyGeneration.load(std::memory_order_relaxed) + 1;
+    if (generation == entryBeingWritten)
+        generation = 1;
+
+    lazyGeneration.store(generation, std::memory_order_release);
+}
+
+template <typename Calculate>
+double FunctionalTuning::lazyEntryAt(LazyEntry* entries, int index, Calculate calculate) const
+{
+    // The root is read after the generation, so a value calculated from an older root keeps the older generation
+    auto generation = lazyGeneration.load(std::memory_order_acquire);
+    auto& entry = entries[index];
+
+    auto entryGeneration = entry.generation.load(std::memory_order_acquire);
+    if (entryGeneration == generation)
+        return entry.value.load(std::memory_order_relaxed);
+
+    auto value = calculate();
+
+    // Only one thread stores a stale entry, others return what they calculated
+    if (entryGeneration != entryBeingWritten
+        && entry.generation.compare_exchange_strong(entryGeneration, entryBeingWritten, std::memory_order_acquire))
+    {
+        entry.value.store(value, std::memory_order_relaxed);
+        entry.generation.store(generation, std::memory_order_release);
+    }
+
+    return value;
+}
+
+double FunctionalTuning::lazyFrequencyAt(int index) const
+{
+    if (index < 0 || index >= lazyTableSize)
+        return frequencyFromLazyRoot(readLazyRoot(), index);
+
+    return lazyEntryAt(lazyFrequencies.get(), index, [&]() { return frequencyFromLazyRoot(readLazyRoot(), index); });
+}
+
 //int FunctionalTuning::setupRootIndexAndGetTableSize()
 //{
 //    int lookupTableSize;
@@ -102,7 +236,7 @@ void FunctionalTuning::cacheTables()
 {
     auto table = buildFrequencyTable();
     setTableWithFrequencies(table);
-    tablesAreBuilt = true;
+    tablesAreBuilt.store(true, std::memory_order_release);
 }
 
 CentsDefinition FunctionalTuning::getDefinition() const
@@ -151,13 +285,12 @@ double FunctionalTuning::calculateSemitonesFromRoot(int stepsFromRoot) const
 juce::Array<double> FunctionalTuning::getIntervalCentsList() const
 {
     // Don't include unison
-    juce::Array<double> cents;
-    for (int i = 1; i <= tuningSize; i++)
-    {
-        cents.add(centsMap.at(i));
-    }
+    return intervalCents;
+}
 
-    return cents;
+TableView<double> FunctionalTuning::getIntervalCentsView() const
+{
+    return TableView<double>(intervalCents.data(), intervalCents.size());
 }
 
 juce::Array<double> FunctionalTuning::getIntervalRatioList() const
@@ -179,16 +312,17 @@ void FunctionalTuning::setRootFrequency(double frequency)
     rootFrequency = frequency;
 
     int tableSize;
-    auto cents = getIntervalCentsList();
-    CentsDefinition::calculateMtsRootAndTableSize(cents, rootFrequency, rootIndex, tableSize);
+    CentsDefinition::calculateMtsRootAndTableSize(intervalCents, rootFrequency, rootIndex, tableSize);
+    publishLazyRoot();
     
-    if (tablesAreBuilt)
+    if (hasCachedTables())
     {
         auto frequencyTable = buildFrequencyTable(tableSize);
         return setTableWithFrequencies(frequencyTable);
     }
 
     setTableSize(tableSize);
+    invalidateLazyTables();
 }
 
 int FunctionalTuning::getTableSize() const
@@ -201,8 +335,7 @@ int FunctionalTuning::getTableSize(bool calculate) const
     if (calculate)
     {
         int root, size;
-        auto cents = getIntervalCentsList();
-        CentsDefinition::calculateMtsRootAndTableSize(cents, rootFrequency, root, size);
+        CentsDefinition::calculateMtsRootAndTableSize(intervalCents, rootFrequency, root, size);
         return size;
     }
     
@@ -211,7 +344,7 @@ int FunctionalTuning::getTableSize(bool calculate) const
 
 juce::Array<double> FunctionalTuning::getFrequencyTable() const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::getFrequencyTable();
 
     return buildFrequencyTable();
@@ -219,52 +352,72 @@ juce::Array<double> FunctionalTuning::getFrequencyTable() const
 
 juce::Array<double> FunctionalTuning::getMtsTable() const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::getMtsTable();
 
     auto frequencies = buildFrequencyTable();
     return frequencyToMtsTable(frequencies);
 }
 
+TableView<double> FunctionalTuning::getFrequencyTableView() const
+{
+    if (hasCachedTables())
+        return TuningTable::getFrequencyTableView();
+
+    return TableView<double>();
+}
+
+TableView<double> FunctionalTuning::getMtsTableView() const
+{
+    if (hasCachedTables())
+        return TuningTable::getMtsTableView();
+
+    return TableView<double>();
+}
+
 double FunctionalTuning::centsAt(int index) const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::centsAt(index);
 
-    return calculateCentsFromRoot(index - rootIndex);
+    return calculateCentsFromRoot(index - readLazyRoot().index);
 }
 
 double FunctionalTuning::frequencyAt(int index) const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::frequencyAt(index);
 
-    return calculateFrequencyFromRoot(index - rootIndex);
+    return lazyFrequencyAt(index);
 }
 
 double FunctionalTuning::mtsAt(int index) const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::mtsAt(index);
 
-    return calculateMtsFromRoot(index - rootIndex);
+    if (index < 0 || index >= lazyTableSize)
+        return roundN(8, frequencyToMTS(frequencyFromLazyRoot(readLazyRoot(), index)));
+
+    return lazyEntryAt(lazyMts.get(), index, [&]() { return roundN(8, frequencyToMTS(lazyFrequencyAt(index))); });
 }
 
 int FunctionalTuning::closestIndexToFrequency(double frequency) const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::closestIndexToFrequency(frequency);
 
-    auto cents = ratioToCents(frequency / rootFrequency);
-    return closestIndexToCents(cents);
+    auto root = readLazyRoot();
+    auto cents = ratioToCents(frequency / root.frequency);
+    return centsMap.closestIndexTo(cents) + root.index;
 }
 
 int FunctionalTuning::closestIndexToCents(double centsFromRoot) const
 {
-    if (tablesAreBuilt)
+    if (hasCachedTables())
         return TuningTable::closestIndexToCents(centsFromRoot);
 
-    return centsMap.closestIndexTo(centsFromRoot) + rootIndex;
+    return centsMap.closestIndexTo(centsFromRoot) + readLazyRoot().index;
 }
 
 juce::Array<double> FunctionalTuning::buildFrequencyTable(int tableSize) const
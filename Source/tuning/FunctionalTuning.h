@@ -11,11 +11,45 @@
 #pragma once
 #include "./CentsDefinition.h"
 #include "./TuningTable.h"
+#include <atomic>
 
 class FunctionalTuning : public TuningTable
 {
     Map<double> centsMap;
-    bool tablesAreBuilt = false;
+    std::atomic<bool> tablesAreBuilt { false };
+
+    // An entry is valid while its generation is the current one
+    struct LazyEntry
+    {
+        std::atomic<double> value { 0 };
+        std::atomic<juce::uint32> generation { 0 };
+    };
+
+    static constexpr juce::uint32 entryBeingWritten = 0xffffffff;
+
+    // Entries are calculated on first read if tables are not cached.
+    // Storage is allocated once with the table size at construction, and is never replaced,
+    // so the audio thread can read while the root changes. Changing the root only starts a new
+    // generation. Indices past the storage, if the table grows, are calculated on every read.
+    const int lazyTableSize;
+    std::unique_ptr<LazyEntry[]> lazyFrequencies;
+    std::unique_ptr<LazyEntry[]> lazyMts;
+    std::atomic<juce::uint32> lazyGeneration { 1 };
+
+    // Root of the lookups without cached tables. The message thread writes it with a seqlock,
+    // and lookups on other threads read a frequency and index of the same root once per lookup.
+    struct LazyRoot
+    {
+        double frequency = 0;
+        int index = 0;
+    };
+
+    std::atomic<double> lazyRootFrequency { 0 };
+    std::atomic<int> lazyRootIndex { 0 };
+    std::atomic<juce::uint32> lazyRootSequence { 0 };
+
+    // Interval list excluding unison and ending with the period
+    juce::Array<double> intervalCents;
 
     int tuningSize;
 
@@ -26,6 +60,23 @@ private:
 
     void setupCentsMap(const juce::Array<double>& cents);
 
+    // Call on the message thread after the root changes, before invalidating the lazy tables
+    void publishLazyRoot();
+    LazyRoot readLazyRoot() const;
+
+    double frequencyFromLazyRoot(const LazyRoot& root, int index) const;
+
+    // Call on the message thread after the root changes
+    void invalidateLazyTables();
+
+    // Returns the cached entry, or calculates it and stores it if no other thread is storing it
+    template <typename Calculate>
+    double lazyEntryAt(LazyEntry* entries, int index, Calculate calculate) const;
+
+    double lazyFrequencyAt(int index) const;
+
+    static int lazyTableSizeOf(const CentsDefinition& definition, bool buildTables);
+
     static TuningTable::Definition setupEmptyTableDefinition(const CentsDefinition& definition);
 
 public:
@@ -35,18 +86,29 @@ public:
     */
     FunctionalTuning(CentsDefinition definition = CentsDefinition(), bool buildTables = false);
 
+    /*
+        Uses frequency & MTS tables stored elsewhere as the cached tables, without copying them.
+        The tables are built instead if they don't match the definition's table size.
+    */
+    FunctionalTuning(CentsDefinition definition, TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage);
+
     FunctionalTuning(const FunctionalTuning&);
     
     virtual bool operator==(const FunctionalTuning&);
     virtual bool operator!=(const FunctionalTuning&);
 
+    // Explicitly build the frequency & MTS tables so that table views are available
     void cacheTables();
 
+    bool hasCachedTables() const { return tablesAreBuilt.load(std::memory_order_acquire); }
+
     virtual CentsDefinition getDefinition() const;
 
     virtual juce::Array<double> getIntervalCentsList() const;
     virtual juce::Array<double> getIntervalRatioList() const;
 
+    virtual TableView<double> getIntervalCentsView() const;
+
     virtual double getPeriodCents() const;
     virtual double getPeriodSemitones() const;
     virtual double getPeriodRatio() const;
@@ -71,6 +133,10 @@ public:
     virtual juce::Array<double> getFrequencyTable() const override;
     virtual juce::Array<double> getMtsTable() const override;
 
+    // Empty unless cacheTables() was called
+    virtual TableView<double> getFrequencyTableView() const override;
+    virtual TableView<double> getMtsTableView() const override;
+
     virtual double centsAt(int index) const override;
     virtual double frequencyAt(int index) const override;
     virtual double mtsAt(int index) const override;
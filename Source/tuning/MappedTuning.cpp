@@ -91,14 +91,21 @@ double MappedTuningTable::centsAt(int midiNote, int midiChannel) const
 
 double MappedTuningTable::frequencyAt(int midiNote, int midiChannel) const
 {
-    auto index = tuningIndexAt(midiNote, midiChannel);
-    return tuning->frequencyAt(index);
+    auto mapped = mapping->getMappedNote(midiChannel, midiNote);
+    if (!mapped.mapped)
+        return 0.0;
+
+    return tuning->frequencyAt(mapped.index);
 }
 
 double MappedTuningTable::mtsAt(int midiNote, int midiChannel) const
 {
-    auto index = tuningIndexAt(midiNote, midiChannel);
-    return tuning->mtsAt(index);
+    // Out of the MTS range, so unmapped keys don't get a pitch
+    auto mapped = mapping->getMappedNote(midiChannel, midiNote);
+    if (!mapped.mapped)
+        return -1.0;
+
+    return tuning->mtsAt(mapped.index);
 }
 
 void MappedTuningTable::setFrequencyReference(MappedTuningTable::FrequencyReference newReference)
@@ -169,6 +176,16 @@ juce::Array<double> MappedTuningTable::getMtsTable() const
     return tuning->getMtsTable();
 }
 
+TableView<double> MappedTuningTable::getFrequencyTableView() const
+{
+    return tuning->getFrequencyTableView();
+}
+
+TableView<double> MappedTuningTable::getMtsTableView() const
+{
+    return tuning->getMtsTableView();
+}
+
 void MappedTuningTable::setRootFrequency(double frequency)
 {
     setRootFrequency(frequency, false);
@@ -34,12 +34,6 @@ public:
             return !ChannelInMidiRange(midiChannel) || !NoteInMidiRange(midiNote);
         }
         
-        void operator=(const FrequencyReference& reference)
-        {
-            midiChannel = reference.midiChannel;
-            midiNote = reference.midiNote;
-        }
-
         bool operator==(const FrequencyReference& reference) const
         {
             return midiChannel == reference.midiChannel
@@ -110,9 +104,9 @@ public:
 
     virtual double centsAt(int midiNote, int midiChannel) const;
 
-    virtual double frequencyAt(int midiNote, int midiChannel) const;
+    double frequencyAt(int midiNote, int midiChannel) const;
 
-    virtual double mtsAt(int midiNote, int midiChannel) const;
+    double mtsAt(int midiNote, int midiChannel) const;
 
 
     virtual void setFrequencyReference(MappedTuningTable::FrequencyReference newReference);
@@ -135,6 +129,9 @@ public:
     virtual juce::Array<double> getFrequencyTable() const override;
     virtual juce::Array<double> getMtsTable() const override;
 
+    virtual TableView<double> getFrequencyTableView() const override;
+    virtual TableView<double> getMtsTableView() const override;
+
 
     // TuningBase implementation
 
@@ -135,10 +135,16 @@ static double mtsToFrequency(double mts)
 	return pow(2, (mts - 69) / 12.0) * 440.0;
 }
 
+// The fine bytes are a 14-bit fraction of a semitone
+static double mtsTripletToMts(MTSTriplet mts)
+{
+    double fine = ((mts.fineUpper << 7) | mts.fineLower) / (double)(1 << 14);
+    return mts.coarse + fine;
+}
+
 static double mtsTripletToFrequency(MTSTriplet mts)
 {
-    double fine = mts.fineUpper / (1 << 7) + mts.fineLower / (1 << 14);
-    return mtsToFrequency(mts.coarse + fine);
+    return mtsToFrequency(mtsTripletToMts(mts));
 }
 
 static double frequencyToMTS(double freqIn)
@@ -21,24 +21,65 @@ TuningTable::TuningTable(TuningTable::Definition definition)
     refreshTableMetadata();
 }
 
+TuningTable::TuningTable(TuningTable::Definition definition, TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage)
+    : periodString(definition.periodString),
+      virtualPeriod(definition.virtualPeriod),
+      virtualSize(definition.virtualSize),
+      TuningTableBase(definition.rootIndex, frequencies.at(definition.rootIndex), definition.name, definition.description)
+{
+    setTableWithViews(frequencies, mts, storage);
+}
+
 TuningTable::TuningTable(const TuningTable& tuning)
     : frequencyTable(tuning.frequencyTable),
+      tableSize(tuning.tableSize),
       periodString(tuning.periodString),
       virtualPeriod(tuning.virtualPeriod),
       virtualSize(tuning.virtualSize),
       TuningTableBase(tuning.rootIndex, tuning.rootFrequency, tuning.name, tuning.description),
       mtsTable(tuning.mtsTable),
-      rootMts(tuning.rootMts)
+      rootMts(tuning.rootMts),
+      externalStorage(tuning.externalStorage),
+      frequencyView(tuning.frequencyView),
+      mtsView(tuning.mtsView)
 {
+    refreshTableViews();
 }
 
 void TuningTable::refreshTableMetadata()
 {
+    externalStorage = nullptr;
     tableSize = frequencyTable.size();
 
     // Rebuild MTS table
     mtsTable = frequencyToMtsTable(frequencyTable);
     rootMts = frequencyToMTS(rootFrequency);
+    refreshTableViews();
+}
+
+void TuningTable::refreshTableViews()
+{
+    if (externalStorage != nullptr)
+        return;
+
+    frequencyView = TableView<double>(frequencyTable.data(), frequencyTable.size());
+    mtsView = TableView<double>(mtsTable.data(), mtsTable.size());
+}
+
+void TuningTable::setTableWithViews(TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage)
+{
+    jassert(frequencies.size() == mts.size());
+
+    frequencyTable.clear();
+    mtsTable.clear();
+
+    externalStorage = storage;
+    frequencyView = frequencies;
+    mtsView = mts;
+
+    tableSize = frequencyView.size();
+    rootFrequency = frequencyView.at(rootIndex);
+    rootMts = frequencyToMTS(rootFrequency);
 }
 
 void TuningTable::setVirtualPeriod(double period, juce::String periodStr)
@@ -67,20 +108,24 @@ void TuningTable::setTableWithMts(juce::Array<double> mts, int newRootIndex)
     if (newRootIndex < 0)
         newRootIndex = rootIndex;
 
+    externalStorage = nullptr;
     mtsTable = mts;
     frequencyTable = mtsToFrequencyTable(mtsTable);
     rootFrequency = frequencyTable[rootIndex];
     rootMts = frequencyToMTS(rootFrequency);
+    refreshTableViews();
 }
 
 void TuningTable::transposeTableByRatio(double ratio)
 {
-    auto previousTable = frequencyTable;
-    for (int i = 0; i < previousTable.size(); i++)
-    {
-        auto newFrequency = roundN(8, previousTable[i] * ratio);
-        frequencyTable.set(i, newFrequency);
-    }
+    // Reads the previous table through its view, so external tables are copied here
+    juce::Array<double> transposed;
+    transposed.ensureStorageAllocated(frequencyView.size());
+
+    for (auto frequency : frequencyView)
+        transposed.add(roundN(8, frequency * ratio));
+
+    frequencyTable.swapWith(transposed);
 
     rootFrequency = frequencyTable[rootIndex];
     refreshTableMetadata();
@@ -94,7 +139,7 @@ void TuningTable::transposeTableByRatio(double ratio)
 
 void TuningTable::setRootFrequency(double frequency)
 {
-    if (frequencyTable.size() == 0)
+    if (frequencyView.isEmpty())
     {
         rootFrequency = frequency;
         return;
@@ -104,7 +149,7 @@ void TuningTable::setRootFrequency(double frequency)
     auto newRoot = closestIndexToFrequency(frequency);
     rootIndex = newRoot;
 
-    auto ratio = frequency / frequencyTable[newRoot];
+    auto ratio = frequency / frequencyView[newRoot];
     transposeTableByRatio(ratio);
 }
 
@@ -117,13 +162,13 @@ double TuningTable::centsAt(int index) const
 double TuningTable::frequencyAt(int index) const
 {
     auto tableIndex = mod(index, getTableSize());
-    return frequencyTable[tableIndex];
+    return frequencyView.at(tableIndex);
 }
 
 double TuningTable::mtsAt(int index) const
 {
     auto tableIndex = mod(index, getTableSize());
-    return mtsTable[tableIndex];
+    return mtsView.at(tableIndex);
 }
 
 int TuningTable::closestIndexToFrequency(double frequency) const
@@ -131,9 +176,9 @@ int TuningTable::closestIndexToFrequency(double frequency) const
     // Uncertain if quotients should be preferred with "closest frequency"
     double difference, discrepancy = 10e10;
     int closestIndex = -1;
-    for (int i = 0; i < frequencyTable.size(); i++)
+    for (int i = 0; i < frequencyView.size(); i++)
     {
-        difference = abs(roundN(8, frequency - frequencyTable[i]));
+        difference = abs(roundN(8, frequency - frequencyView[i]));
         if (difference < discrepancy)
         {
             discrepancy = difference;
@@ -163,7 +208,7 @@ TuningTable::Definition TuningTable::getDefinition() const
 {
     return Definition
     {
-        frequencyTable,
+        getFrequencyTable(),
         rootIndex,
         name,
         description,
@@ -252,12 +297,22 @@ double TuningTable::getRootMts() const
 
 juce::Array<double> TuningTable::getFrequencyTable() const
 {
-    return frequencyTable;
+    return juce::Array<double>(frequencyView.data(), frequencyView.size());
 }
 
 juce::Array<double> TuningTable::getMtsTable() const
 {
-    return mtsTable;
+    return juce::Array<double>(mtsView.data(), mtsView.size());
+}
+
+TableView<double> TuningTable::getFrequencyTableView() const
+{
+    return frequencyView;
+}
+
+TableView<double> TuningTable::getMtsTableView() const
+{
+    return mtsView;
 }
 
 juce::Array<double> TuningTable::frequencyToMtsTable(juce::Array<double> frequenciesIn)
@@ -14,6 +14,7 @@
 
 #include "TuningBase.h"
 #include "../mapping/Map.h"
+#include "../TableView.h"
 
 class TuningTableBase : public TuningBase
 {
@@ -32,6 +33,10 @@ public:
 
 	virtual juce::Array<double> getFrequencyTable() const = 0;
 	virtual juce::Array<double> getMtsTable() const = 0;
+
+	// Read-only views of cached tables, these are empty if the tables are not built
+	virtual TableView<double> getFrequencyTableView() const = 0;
+	virtual TableView<double> getMtsTableView() const = 0;
 };
 
 class TuningTable : public TuningTableBase
@@ -75,10 +80,19 @@ private:
     juce::Array<double> mtsTable;
 	double rootMts;
 
+	// Tables are read through views, which point at the arrays above, or at storage
+	// owned elsewhere, such as a mapped TuningBundle, that is kept alive with the tuning.
+	// External tables are copied into the arrays before they're changed.
+	std::shared_ptr<const void> externalStorage;
+	TableView<double> frequencyView;
+	TableView<double> mtsView;
+
 private:
 
 	void refreshTableMetadata();
 
+	void refreshTableViews();
+
 protected:
 
 	void setVirtualPeriod(double period, juce::String periodStr = "");
@@ -91,10 +105,16 @@ protected:
 
 	void transposeTableByRatio(double ratio);
 
+	// The tables must have the same size and stay valid while the storage is held
+	void setTableWithViews(TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage);
+
 public:
 
 	TuningTable(Definition definition);
 
+	// Reads the tables in place instead of copying them, definition.frequencies is not used
+	TuningTable(Definition definition, TableView<double> frequencies, TableView<double> mts, std::shared_ptr<const void> storage);
+
     TuningTable(const TuningTable&);
 
 	virtual bool operator==(const TuningTable&);
@@ -116,6 +136,9 @@ public:
 
 	virtual juce::Array<double> getFrequencyTable() const override;
 	virtual juce::Array<double> getMtsTable() const override;
+
+	virtual TableView<double> getFrequencyTableView() const override;
+	virtual TableView<double> getMtsTableView() const override;
 	//virtual juce::Array<MTSTriplet> getMTSDataTable() const; // this should have some parameters, or maybe even be static
 
 	//virtual juce::Array<double> getIntervalCentsList() const override;
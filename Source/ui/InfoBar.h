@@ -124,6 +124,13 @@ public:
         resized();
     }
 
+    // Replaced by the next call to setDisplayedTuning()
+    void setStatusMessage(juce::String message)
+    {
+        nameValueLabel->setText(message, juce::NotificationType::dontSendNotification);
+        resized();
+    }
+
     void setButtonBackState(bool isBackButton)
     {
         buttonIsBack = isBackButton;
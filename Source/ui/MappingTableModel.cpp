@@ -86,7 +86,8 @@ juce::Component* MappingTableModel::refreshComponentForCell(int rowNumber, int c
         {
             label->setName("TuningIndex" + indexString + "Label");
             auto index = mapping->tableAt(rowNumber);
-            label->setText(juce::String(index), juce::NotificationType::dontSendNotification);
+            auto indexText = (index == TuningTableMap::UnmappedIndex) ? juce::String("x") : juce::String(index);
+            label->setText(indexText, juce::NotificationType::dontSendNotification);
             break;
         }
         }
@@ -27,6 +27,11 @@ MenuPanel::MenuPanel(juce::ApplicationCommandManager* cmdManager)
     openTuningBtn->setButtonText("Open Tuning");
     addAndMakeVisible(*openTuningBtn);
 
+    auto scaleLibraryBtn = menuButtons.add(new juce::TextButton("scaleLibraryBtn"));
+    scaleLibraryBtn->setCommandToTrigger(cmdManager, Everytone::Commands::ScaleLibrary, true);
+    scaleLibraryBtn->setButtonText("Scale Library");
+    addAndMakeVisible(*scaleLibraryBtn);
+
     auto referenceBtn = menuButtons.add(new juce::TextButton("editReferenceBtn"));
     referenceBtn->setCommandToTrigger(cmdManager, Everytone::Commands::EditReference, true);
     referenceBtn->setButtonText("Reference/Mapping");
@@ -36,6 +41,12 @@ MenuPanel::MenuPanel(juce::ApplicationCommandManager* cmdManager)
     showOptions->setCommandToTrigger(cmdManager, Everytone::Commands::ShowOptions, true);
     showOptions->setButtonText("Options");
     addAndMakeVisible(*showOptions);
+
+    auto captureMidiBtn = menuButtons.add(new juce::TextButton("captureMidiBtn"));
+    captureMidiBtn->setCommandToTrigger(cmdManager, Everytone::Commands::CaptureMidi, true);
+    captureMidiBtn->setButtonText("Capture MIDI");
+    captureMidiBtn->setClickingTogglesState(true);
+    addAndMakeVisible(*captureMidiBtn);
 }
 
 MenuPanel::~MenuPanel()
@@ -47,6 +47,8 @@ OptionsPanel::OptionsPanel(Everytone::Options options)
     bendModeBox = std::make_unique<juce::ComboBox>("bendModeBox");
     bendModeBox->addItem("Static", (int)Everytone::BendMode::Static);
     bendModeBox->addItem("Persistent", (int)Everytone::BendMode::Persistent);
+    bendModeBox->addItem("Dynamic", (int)Everytone::BendMode::Dynamic);
+    bendModeBox->addItem("Adaptive JI", (int)Everytone::BendMode::Adaptive);
     bendModeBox->setSelectedId((int)options.bendMode);
     bendModeBox->onChange = [&]() { optionsWatchers.call(&OptionsWatcher::bendModeChanged, Everytone::BendMode(bendModeBox->getSelectedId())); };
     addAndMakeVisible(*bendModeBox);
@@ -56,6 +58,33 @@ OptionsPanel::OptionsPanel(Everytone::Options options)
     addAndMakeVisible(*bendModeLabel);
 
 
+    sharedTuningBox = std::make_unique<juce::ComboBox>("sharedTuningBox");
+    sharedTuningBox->addItem("Off", (int)Everytone::SharedTuningMode::Off);
+    sharedTuningBox->addItem("Master", (int)Everytone::SharedTuningMode::Master);
+    sharedTuningBox->addItem("Client", (int)Everytone::SharedTuningMode::Client);
+    sharedTuningBox->setSelectedId((int)options.sharedTuning, juce::NotificationType::dontSendNotification);
+    sharedTuningBox->onChange = [&]() 
+    { 
+        optionsWatchers.call(&OptionsWatcher::sharedTuningModeChanged, Everytone::SharedTuningMode(sharedTuningBox->getSelectedId())); 
+    };
+    addAndMakeVisible(*sharedTuningBox);
+
+    auto sharedTuningLabel = labels.add(new juce::Label("SharedTuningLabel", "Shared Tuning:"));
+    sharedTuningLabel->attachToComponent(sharedTuningBox.get(), false);
+    addAndMakeVisible(*sharedTuningLabel);
+
+    inputPitchBox = std::make_unique<juce::ComboBox>("inputPitchBox");
+    inputPitchBox->addItem("Bend", (int)Everytone::InputPitchMode::Bend);
+    inputPitchBox->addItem("Quantise", (int)Everytone::InputPitchMode::Quantise);
+    inputPitchBox->setSelectedId((int)options.inputPitchMode, juce::NotificationType::dontSendNotification);
+    inputPitchBox->onChange = [&]() { optionsWatchers.call(&OptionsWatcher::inputPitchModeChanged, Everytone::InputPitchMode(inputPitchBox->getSelectedId())); };
+    addAndMakeVisible(*inputPitchBox);
+
+    auto inputPitchLabel = labels.add(new juce::Label("InputPitchLabel", "Input Pitch:"));
+    inputPitchLabel->attachToComponent(inputPitchBox.get(), false);
+    addAndMakeVisible(*inputPitchLabel);
+
+
     mpeZoneBox = std::make_unique<juce::ComboBox>("mpeZoneBox");
     mpeZoneBox->addItem("Lower", (int)Everytone::MpeZone::Lower);
     mpeZoneBox->addItem("Upper", (int)Everytone::MpeZone::Upper);
@@ -108,12 +137,39 @@ OptionsPanel::OptionsPanel(Everytone::Options options)
     pitchbendRangeLabel = labels.add(new juce::Label("pitchbendLabel", "Pitchbend Range:"));
     pitchbendRangeLabel->attachToComponent(pitchbendRangeValue.get(), true);
     addAndMakeVisible(pitchbendRangeLabel);
+
+
+    inputPitchbendRangeValue = std::make_unique<LabelMouseHighlight>("inputPitchbendRangeValue");
+    inputPitchbendRangeValue->setEditable(false, true);
+    addAndMakeVisible(*inputPitchbendRangeValue);
+    inputPitchbendRangeValue->onEditorShow = [&]()
+    {
+        auto editor = inputPitchbendRangeValue->getCurrentTextEditor();
+        if (editor)
+        {
+            auto pitchbendText = inputPitchbendRangeValue->getText();
+            auto rangeString = juce::StringArray::fromTokens(pitchbendText, false)[1];
+            auto range = rangeString.getDoubleValue() * 2;
+            editor->setText(juce::String(range), juce::NotificationType::dontSendNotification);
+        }
+    };
+    inputPitchbendRangeValue->onTextChange = [&]()
+    {
+        auto newRange = inputPitchbendRangeValue->getText().getIntValue();
+        optionsWatchers.call(&OptionsWatcher::inputPitchbendRangeChanged, newRange);
+    };
+    setInputPitchbendRangeText(options.inputPitchbendRange);
+
+    inputPitchbendRangeLabel = labels.add(new juce::Label("inputPitchbendLabel", "Input Pitchbend Range:"));
+    inputPitchbendRangeLabel->attachToComponent(inputPitchbendRangeValue.get(), true);
+    addAndMakeVisible(inputPitchbendRangeLabel);
 }
 
 OptionsPanel::~OptionsPanel()
 {
     labels.clear();
 
+    inputPitchbendRangeValue = nullptr;
     pitchbendRangeValue = nullptr;
     voiceLimitValueLabel = nullptr;
     mpeZoneBox = nullptr;
@@ -152,6 +208,8 @@ void OptionsPanel::resized()
     leftHalf.items.add(juce::FlexItem(controlWidth, controlHeight, *channelModeBox).withMargin(controlMargin));
     //leftHalf.items.add(juce::FlexItem(controlWidth, controlHeight, *channelRulesBox).withMargin(controlMargin));
     leftHalf.items.add(juce::FlexItem(controlWidth, controlHeight, *bendModeBox).withMargin(controlMargin));
+    leftHalf.items.add(juce::FlexItem(controlWidth, controlHeight, *sharedTuningBox).withMargin(controlMargin));
+    leftHalf.items.add(juce::FlexItem(controlWidth, controlHeight, *inputPitchBox).withMargin(controlMargin));
 
     juce::FlexBox rightHalf;
     rightHalf.flexDirection = juce::FlexBox::Direction::column;
@@ -172,6 +230,13 @@ void OptionsPanel::resized()
     rightHalf.items.add(juce::FlexItem(pitchbendWidth, controlHeight, *pitchbendRangeValue).withMargin(pitchbendItemMargin));
 
 
+    auto inputPitchbendWidth = inputPitchbendRangeValue->getFont().getStringWidth(inputPitchbendRangeValue->getText()) + margin;
+    auto inputPitchbendLabelWidth = inputPitchbendRangeLabel->getFont().getStringWidth(inputPitchbendRangeLabel->getText());
+    auto inputPitchbendItemMargin = controlMargin;
+    inputPitchbendItemMargin.left = inputPitchbendLabelWidth + margin;
+    rightHalf.items.add(juce::FlexItem(inputPitchbendWidth, controlHeight, *inputPitchbendRangeValue).withMargin(inputPitchbendItemMargin));
+
+
     auto layoutMargin = juce::FlexItem::Margin(0, margin, 0, margin);
 
     juce::FlexBox flexBox;
@@ -189,3 +254,9 @@ void OptionsPanel::setPitchbendRangeText(int pitchbendRange)
     auto value = "+/- " + juce::String(pitchbendRange / 2) + " semitones";
     pitchbendRangeValue->setText(value, juce::NotificationType::dontSendNotification);
 }
+
+void OptionsPanel::setInputPitchbendRangeText(int pitchbendRange)
+{
+    auto value = "+/- " + juce::String(pitchbendRange / 2) + " semitones";
+    inputPitchbendRangeValue->setText(value, juce::NotificationType::dontSendNotification);
+}
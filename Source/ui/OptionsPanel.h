@@ -26,6 +26,7 @@ public:
     void resized() override;
 
     void setPitchbendRangeText(int pitchbendRange);
+    void setInputPitchbendRangeText(int pitchbendRange);
 
 private:
     
@@ -34,12 +35,16 @@ private:
     std::unique_ptr<juce::ComboBox> channelModeBox;
     std::unique_ptr<juce::ComboBox> channelRulesBox;
     std::unique_ptr<juce::ComboBox> bendModeBox;
+    std::unique_ptr<juce::ComboBox> sharedTuningBox;
+    std::unique_ptr<juce::ComboBox> inputPitchBox;
     std::unique_ptr<juce::ComboBox> mpeZoneBox;
     std::unique_ptr<LabelMouseHighlight> voiceLimitValueLabel;
     std::unique_ptr<LabelMouseHighlight> pitchbendRangeValue;
+    std::unique_ptr<LabelMouseHighlight> inputPitchbendRangeValue;
 
     juce::Label* voiceLimitLabel;
     juce::Label* pitchbendRangeLabel;
+    juce::Label* inputPitchbendRangeLabel;
 
     juce::OwnedArray<juce::Label> labels;
 
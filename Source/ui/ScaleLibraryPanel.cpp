@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+    ScaleLibraryPanel.cpp
+    Created: 20 Oct 2026 4:38:15pm
+    Author:  Vincenzo
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "ScaleLibraryPanel.h"
+
+//==============================================================================
+ScaleLibraryPanel::ScaleLibraryPanel()
+{
+    searchBox = std::make_unique<juce::TextEditor>("scaleSearchBox");
+    searchBox->setTextToShowWhenEmpty("Search by name or number of notes", juce::Colours::grey);
+    searchBox->addListener(this);
+    addAndMakeVisible(*searchBox);
+
+    rescanButton = std::make_unique<juce::TextButton>("rescanButton");
+    rescanButton->setButtonText("Rescan");
+    rescanButton->onClick = [&]() { onRescan(); };
+    addAndMakeVisible(*rescanButton);
+
+    resultList = std::make_unique<juce::ListBox>("scaleResultList", this);
+    addAndMakeVisible(*resultList);
+
+    statusLabel = std::make_unique<juce::Label>("scaleLibraryStatus");
+    addAndMakeVisible(*statusLabel);
+}
+
+ScaleLibraryPanel::~ScaleLibraryPanel()
+{
+    searchBox->removeListener(this);
+    resultList = nullptr;
+}
+
+void ScaleLibraryPanel::paint (juce::Graphics& g)
+{
+
+}
+
+void ScaleLibraryPanel::resized()
+{
+    auto rowHeight = juce::jmin(30, getHeight() / 6);
+    auto margin = 5;
+
+    auto top = getLocalBounds().removeFromTop(rowHeight);
+    rescanButton->setBounds(top.removeFromRight(getWidth() / 5));
+    searchBox->setBounds(top.withTrimmedRight(margin));
+
+    statusLabel->setBounds(getLocalBounds().removeFromBottom(rowHeight));
+    resultList->setBounds(getLocalBounds().withTrimmedTop(rowHeight + margin).withTrimmedBottom(rowHeight));
+}
+
+void ScaleLibraryPanel::setLibrary(std::shared_ptr<const ScaleLibrary> libraryIn, juce::File directory)
+{
+    library = libraryIn;
+    libraryDirectory = directory;
+    updateResults();
+}
+
+void ScaleLibraryPanel::setScanning(bool isScanning)
+{
+    rescanButton->setEnabled(!isScanning);
+
+    if (isScanning)
+        statusLabel->setText("Scanning " + libraryDirectory.getFullPathName() + "...", juce::dontSendNotification);
+    else
+        updateResults();
+}
+
+int ScaleLibraryPanel::getNumRows()
+{
+    return results.size();
+}
+
+void ScaleLibraryPanel::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    if (library == nullptr || rowNumber < 0 || rowNumber >= results.size())
+        return;
+
+    if (rowIsSelected)
+        g.fillAll(getLookAndFeel().findColour(juce::TextEditor::highlightColourId));
+
+    const auto& entry = library->getEntry(results[rowNumber]);
+
+    auto name = entry.name.isNotEmpty() ? entry.name : juce::File(entry.filePath).getFileNameWithoutExtension();
+    auto info = juce::String(entry.size()) + " notes, " + juce::String(entry.periodCents(), 2) + " cents period";
+
+    auto area = juce::Rectangle<int>(width, height).reduced(4, 0);
+    auto infoArea = area.removeFromRight(area.getWidth() * 2 / 5);
+
+    g.setColour(getLookAndFeel().findColour(juce::ListBox::textColourId));
+    g.drawText(name, area, juce::Justification::centredLeft, true);
+    g.drawText(info, infoArea, juce::Justification::centredRight, true);
+}
+
+void ScaleLibraryPanel::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
+{
+    chooseRow(row);
+}
+
+void ScaleLibraryPanel::returnKeyPressed(int lastRowSelected)
+{
+    chooseRow(lastRowSelected);
+}
+
+void ScaleLibraryPanel::textEditorTextChanged(juce::TextEditor&)
+{
+    updateResults();
+}
+
+void ScaleLibraryPanel::updateResults()
+{
+    results.clear();
+
+    if (library != nullptr)
+    {
+        ScaleLibrary::Query query;
+        query.maxResults = 200;
+
+        // A number finds scales with that many notes
+        auto text = searchBox->getText().trim();
+        if (text.isNotEmpty() && text.containsOnly("0123456789"))
+            query.noteCount = text.getIntValue();
+        else
+            query.nameContains = text;
+
+        results = library->search(query);
+    }
+
+    resultList->updateContent();
+    resultList->repaint();
+
+    auto numScales = (library != nullptr) ? library->getNumEntries() : 0;
+    statusLabel->setText(juce::String(numScales) + " scales in " + libraryDirectory.getFullPathName(), juce::dontSendNotification);
+}
+
+void ScaleLibraryPanel::chooseRow(int row)
+{
+    if (library == nullptr || row < 0 || row >= results.size())
+        return;
+
+    onScaleChosen(juce::File(library->getEntry(results[row]).filePath));
+}
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    ScaleLibraryPanel.h
+    Created: 20 Oct 2026 4:38:15pm
+    Author:  Vincenzo
+
+    Search the scale library by name or note count, and load a scale from it
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../io/ScaleLibrary.h"
+
+//==============================================================================
+/*
+*/
+class ScaleLibraryPanel  : public juce::Component,
+                           private juce::ListBoxModel,
+                           private juce::TextEditor::Listener
+{
+public:
+    ScaleLibraryPanel();
+    ~ScaleLibraryPanel() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    void setLibrary(std::shared_ptr<const ScaleLibrary> libraryIn, juce::File directory);
+
+    void setScanning(bool isScanning);
+
+    // Called with the file of a scale that was double clicked or picked with return
+    std::function<void(juce::File)> onScaleChosen = [](juce::File) {};
+
+    std::function<void()> onRescan = []() {};
+
+private:
+
+    //==============================================================================
+    // juce::ListBoxModel implementation
+
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const juce::MouseEvent&) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    //==============================================================================
+    // juce::TextEditor::Listener implementation
+
+    void textEditorTextChanged(juce::TextEditor&) override;
+
+    //==============================================================================
+
+    void updateResults();
+
+    void chooseRow(int row);
+
+private:
+
+    std::shared_ptr<const ScaleLibrary> library;
+    juce::File libraryDirectory;
+
+    juce::Array<int> results;
+
+    std::unique_ptr<juce::TextEditor> searchBox;
+    std::unique_ptr<juce::TextButton> rescanButton;
+    std::unique_ptr<juce::ListBox> resultList;
+    std::unique_ptr<juce::Label> statusLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScaleLibraryPanel)
+};